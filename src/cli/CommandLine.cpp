@@ -0,0 +1,199 @@
+#include "CommandLine.h"
+#include "core/ConfigManager.h"
+#include "core/TerminalLauncher.h"
+#include "ui/ProfileTreeBuilder.h"
+#include "utils/PathUtils.h"
+#include <nlohmann/json.hpp>
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <shellapi.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr int kExitOk = 0;
+constexpr int kExitFailed = 1;
+constexpr int kExitUsage = 2;
+
+void PrintUsage() {
+    std::cerr <<
+        "用法:\n"
+        "  mtc                      启动图形界面\n"
+        "  mtc launch <名称|id>     直接打开配置对应的终端\n"
+        "  mtc list [--json]        列出全部配置\n"
+        "  mtc search <关键字> [--json]\n"
+        "                           按名称、描述、工作目录搜索配置\n";
+}
+
+bool HasFlag(const std::vector<std::string>& args, const std::string& flag) {
+    for (size_t i = 2; i < args.size(); ++i) {
+        if (args[i] == flag) return true;
+    }
+    return false;
+}
+
+// 去掉子命令与 --xxx 选项后的位置参数
+std::vector<std::string> Positionals(const std::vector<std::string>& args) {
+    std::vector<std::string> result;
+    for (size_t i = 2; i < args.size(); ++i) {
+        if (args[i].rfind("--", 0) != 0) result.push_back(args[i]);
+    }
+    return result;
+}
+
+bool InitConfig() {
+    if (!ConfigManager::GetInstance().Initialize(PathUtils::GetExecutableDir())) {
+        std::cerr << "mtc: 无法读取配置文件" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+json ProfileToJson(const Profile& profile) {
+    return {
+        {"id", profile.id},
+        {"name", profile.name},
+        {"description", profile.description},
+        {"workingDirectory", profile.GetWorkingDirectory()},
+        {"terminalType", TerminalTypeToString(profile.terminalType)},
+        {"terminalId", profile.terminalId},
+        {"remote", profile.IsRemote()}
+    };
+}
+
+void PrintProfiles(const std::vector<const Profile*>& profiles, bool asJson) {
+    if (asJson) {
+        json arr = json::array();
+        for (const auto* profile : profiles) {
+            arr.push_back(ProfileToJson(*profile));
+        }
+        std::cout << arr.dump(2) << std::endl;
+        return;
+    }
+    // 每行 "id<TAB>名称"，便于 cut / fzf 等工具处理
+    for (const auto* profile : profiles) {
+        std::cout << profile->id << '\t' << profile->name << '\n';
+    }
+    std::cout.flush();
+}
+
+// 依次按 id、名称精确匹配、名称忽略大小写匹配查找；同一级命中多个视为有歧义
+std::vector<const Profile*> FindProfiles(const std::vector<Profile>& profiles, const std::string& query) {
+    std::vector<const Profile*> matches;
+    for (const auto& profile : profiles) {
+        if (profile.id == query) return {&profile};
+    }
+    for (const auto& profile : profiles) {
+        if (profile.name == query) matches.push_back(&profile);
+    }
+    if (!matches.empty()) return matches;
+
+    const std::string normalized = NormalizeSearchText(query);
+    for (const auto& profile : profiles) {
+        if (NormalizeSearchText(profile.name) == normalized) matches.push_back(&profile);
+    }
+    return matches;
+}
+
+int RunList(const std::vector<std::string>& args) {
+    if (!InitConfig()) return kExitFailed;
+    PrintProfiles(FilterProfiles(ConfigManager::GetInstance().GetProfiles(), ""), HasFlag(args, "--json"));
+    return kExitOk;
+}
+
+int RunSearch(const std::vector<std::string>& args) {
+    auto positionals = Positionals(args);
+    if (positionals.size() != 1) {
+        PrintUsage();
+        return kExitUsage;
+    }
+    if (!InitConfig()) return kExitFailed;
+    PrintProfiles(FilterProfiles(ConfigManager::GetInstance().GetProfiles(), positionals[0]),
+                  HasFlag(args, "--json"));
+    return kExitOk;
+}
+
+int RunLaunch(const std::vector<std::string>& args) {
+    auto positionals = Positionals(args);
+    if (positionals.size() != 1) {
+        PrintUsage();
+        return kExitUsage;
+    }
+    if (!InitConfig()) return kExitFailed;
+
+    auto matches = FindProfiles(ConfigManager::GetInstance().GetProfiles(), positionals[0]);
+    if (matches.empty()) {
+        std::cerr << "mtc: 未找到配置: " << positionals[0] << std::endl;
+        return kExitFailed;
+    }
+    if (matches.size() > 1) {
+        std::cerr << "mtc: 名称有歧义，请改用 id:" << std::endl;
+        for (const auto* profile : matches) {
+            std::cerr << "  " << profile->id << '\t' << profile->name << std::endl;
+        }
+        return kExitFailed;
+    }
+
+    std::string error;
+    if (!TerminalLauncher::Launch(*matches.front(), &error)) {
+        std::cerr << "mtc: 启动失败: " << error << std::endl;
+        return kExitFailed;
+    }
+    return kExitOk;
+}
+
+} // namespace
+
+namespace CommandLine {
+
+bool IsCommand(const std::vector<std::string>& args) {
+    if (args.size() < 2) return false;
+    const std::string& cmd = args[1];
+    return cmd == "launch" || cmd == "list" || cmd == "search" ||
+           cmd == "help" || cmd == "--help" || cmd == "-h";
+}
+
+int Run(const std::vector<std::string>& args) {
+    const std::string& cmd = args[1];
+    if (cmd == "launch") return RunLaunch(args);
+    if (cmd == "list") return RunList(args);
+    if (cmd == "search") return RunSearch(args);
+    PrintUsage();
+    return cmd == "help" || cmd == "--help" || cmd == "-h" ? kExitOk : kExitUsage;
+}
+
+#ifdef _WIN32
+std::vector<std::string> GetWindowsArgs() {
+    std::vector<std::string> args;
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    if (!argv) return args;
+    for (int i = 0; i < argc; ++i) {
+        int len = WideCharToMultiByte(CP_UTF8, 0, argv[i], -1, nullptr, 0, nullptr, nullptr);
+        std::string arg(len > 0 ? len - 1 : 0, '\0');
+        if (len > 1) {
+            WideCharToMultiByte(CP_UTF8, 0, argv[i], -1, &arg[0], len, nullptr, nullptr);
+        }
+        args.push_back(std::move(arg));
+    }
+    LocalFree(argv);
+    return args;
+}
+
+void AttachParentConsole() {
+    if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+        FILE* stream = nullptr;
+        freopen_s(&stream, "CONOUT$", "w", stdout);
+        freopen_s(&stream, "CONOUT$", "w", stderr);
+        SetConsoleOutputCP(CP_UTF8);
+        std::ios::sync_with_stdio(true);
+    }
+}
+#endif
+
+} // namespace CommandLine
@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// 无界面命令行模式：mtc launch / list / search
+//
+// 供 shell 别名、窗口管理器快捷键调用。只用到 ConfigManager + TerminalLauncher，
+// 不初始化 wxWidgets（不建 locale、单实例检测、libssh2、主窗口），进程启动终端后立即退出。
+namespace CommandLine {
+    // args[1] 是否为命令行子命令（args 含程序名）。不是则按图形界面启动。
+    bool IsCommand(const std::vector<std::string>& args);
+
+    // 执行子命令，返回进程退出码：0 成功，1 执行失败/未找到，2 用法错误
+    int Run(const std::vector<std::string>& args);
+
+#ifdef _WIN32
+    // 程序以 GUI 子系统链接，没有 argv：从命令行取参数（UTF-8）
+    std::vector<std::string> GetWindowsArgs();
+    // 挂到父进程（cmd / PowerShell）的控制台，使 stdout/stderr 可见
+    void AttachParentConsole();
+#endif
+}
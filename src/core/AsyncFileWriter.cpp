@@ -0,0 +1,103 @@
+#include "AsyncFileWriter.h"
+#include <algorithm>
+#include <utility>
+
+AsyncFileWriter::AsyncFileWriter(size_t maxQueuedBlocks)
+    : m_maxQueued(std::max<size_t>(maxQueuedBlocks, 1)) {}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    Finish(nullptr);
+}
+
+bool AsyncFileWriter::Open(const std::string& path, bool append, std::string* errorMsg) {
+    m_path = path;
+    m_out.open(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    if (!m_out.is_open()) {
+        if (errorMsg) *errorMsg = "写入本地文件失败: " + path;
+        return false;
+    }
+    m_closing = false;
+    m_failed = false;
+    m_written = 0;
+    m_thread = std::thread(&AsyncFileWriter::WriterLoop, this);
+    return true;
+}
+
+std::vector<char> AsyncFileWriter::AcquireBuffer(size_t size) {
+    std::vector<char> buffer;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_spare.empty()) {
+            buffer = std::move(m_spare.back());
+            m_spare.pop_back();
+        }
+    }
+    buffer.resize(size);
+    return buffer;
+}
+
+bool AsyncFileWriter::Write(std::vector<char> block, size_t size) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_failed || m_queue.size() < m_maxQueued; });
+    if (m_failed) {
+        return false;
+    }
+    size = std::min(size, block.size());
+    m_queue.push_back({std::move(block), size});
+    lock.unlock();
+    m_cv.notify_all();
+    return true;
+}
+
+bool AsyncFileWriter::Finish(std::string* errorMsg) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_out.is_open()) {
+        m_out.close();
+        if (m_out.fail()) {
+            m_failed = true;
+        }
+    }
+    if (m_failed && errorMsg) {
+        *errorMsg = "写入本地文件中断: " + m_path;
+    }
+    return !m_failed;
+}
+
+uint64_t AsyncFileWriter::BytesWritten() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_written;
+}
+
+void AsyncFileWriter::WriterLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_cv.wait(lock, [this] { return m_closing || !m_queue.empty(); });
+        if (m_queue.empty()) {
+            return;     // closing 且已写完
+        }
+        Block block = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+        m_cv.notify_all();     // 队列有空位了
+
+        m_out.write(block.data.data(), static_cast<std::streamsize>(block.size));
+        bool ok = static_cast<bool>(m_out);
+
+        lock.lock();
+        if (!ok) {
+            m_failed = true;
+            m_queue.clear();
+            m_cv.notify_all();
+            return;
+        }
+        m_written += block.size;
+        m_spare.push_back(std::move(block.data));
+    }
+}
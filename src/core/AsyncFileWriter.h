@@ -0,0 +1,55 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 后台顺序写文件：调用方（网络读取线程）把数据块交进来就继续读下一块，
+// 写盘在单独线程按提交顺序进行，两者重叠。排队的块数有上限，写盘慢时 Write 阻塞等待，
+// 内存占用不超过 maxQueuedBlocks 个块。用完的缓冲经 AcquireBuffer 回收复用。
+class AsyncFileWriter {
+public:
+    explicit AsyncFileWriter(size_t maxQueuedBlocks = 8);
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    // 打开文件（append = true 时接在已有内容之后）并启动写线程
+    bool Open(const std::string& path, bool append, std::string* errorMsg = nullptr);
+
+    // 取一块空缓冲（优先复用已写完的），大小调整为 size
+    std::vector<char> AcquireBuffer(size_t size);
+
+    // 排队写入 block 的前 size 字节；之前的写入已出错时返回 false
+    bool Write(std::vector<char> block, size_t size);
+
+    // 等待排队的数据全部落盘并关闭文件；返回整个过程是否无错
+    bool Finish(std::string* errorMsg = nullptr);
+
+    uint64_t BytesWritten() const;
+
+private:
+    struct Block {
+        std::vector<char> data;
+        size_t size = 0;
+    };
+
+    size_t m_maxQueued;
+    std::ofstream m_out;
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Block> m_queue;
+    std::vector<std::vector<char>> m_spare;
+    bool m_closing = false;
+    bool m_failed = false;
+    uint64_t m_written = 0;
+    std::string m_path;
+
+    void WriterLoop();
+};
@@ -1,4 +1,7 @@
 #include "ConfigManager.h"
+#include "ScriptCache.h"
+#include "LaunchTelemetry.h"
+#include "TerminalRegistry.h"
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <iomanip>
@@ -19,7 +22,14 @@ bool ConfigManager::Initialize(const fs::path& appDir) {
     m_configPath = m_dataDir / "config.json";
     
     EnsureDataDirectory();
-    return LoadConfig();
+    ScriptCache::SetDirectory(m_dataDir / "cache");
+    LaunchTelemetry::SetFile(m_dataDir / "launch_log.bin");
+    // 用户自定义 / 覆盖的终端描述；解析失败时沿用内置条目
+    TerminalRegistry::LoadUserDescriptors(m_dataDir / "terminals.json");
+    bool loaded = LoadConfig();
+    // 启动时清理上次运行后已失效的脚本缓存
+    ScriptCache::Collect(m_config.profiles);
+    return loaded;
 }
 
 void ConfigManager::EnsureDataDirectory() {
@@ -36,6 +46,7 @@ void ConfigManager::EnsureDataDirectory() {
 }
 
 bool ConfigManager::LoadConfig() {
+    ++m_profilesRevision;
     if (!fs::exists(m_configPath)) {
         // 创建默认配置
         m_config = AppConfig();
@@ -68,6 +79,7 @@ bool ConfigManager::LoadConfig() {
                 // 解析终端类型
                 std::string termType = jp.value("terminalType", "auto");
                 profile.terminalType = StringToTerminalType(termType);
+                profile.terminalId = jp.value("terminalId", "");
                 
                 // 解析环境变量
                 profile.environmentVariables.clear();
@@ -130,6 +142,7 @@ bool ConfigManager::LoadConfig() {
                 host.host = jh.value("host", "");
                 host.port = jh.value("port", 22);
                 host.username = jh.value("username", "");
+                host.connectTimeoutSec = jh.value("connectTimeout", 10);
                 host.createdAt = jh.value("createdAt", "");
                 host.updatedAt = jh.value("updatedAt", "");
                 if (!host.id.empty()) {
@@ -155,6 +168,27 @@ bool ConfigManager::LoadConfig() {
             }
         }
 
+        // 解析工作区
+        m_config.workspaces.clear();
+        if (j.contains("workspaces")) {
+            for (const auto& jw : j["workspaces"]) {
+                Workspace ws;
+                ws.id = jw.value("id", "");
+                ws.name = jw.value("name", "");
+                ws.layout = StringToWorkspaceLayout(jw.value("layout", "tabs"));
+                if (jw.contains("profileIds")) {
+                    for (const auto& pid : jw["profileIds"]) {
+                        ws.profileIds.push_back(pid.get<std::string>());
+                    }
+                }
+                ws.createdAt = jw.value("createdAt", "");
+                ws.updatedAt = jw.value("updatedAt", "");
+                if (!ws.id.empty()) {
+                    m_config.workspaces.push_back(ws);
+                }
+            }
+        }
+
         // 解析设置
         if (j.contains("settings")) {
             const auto& js = j["settings"];
@@ -163,6 +197,8 @@ bool ConfigManager::LoadConfig() {
             m_config.settings.language = js.value("language", "zh-CN");
             m_config.settings.theme = js.value("theme", "system");
             m_config.settings.autoBackup = js.value("autoBackup", true);
+            m_config.settings.launchHelper = js.value("launchHelper", false);
+            m_config.settings.residentTray = js.value("residentTray", false);
 
             m_config.settings.searchHistory.clear();
             if (js.contains("searchHistory") && js["searchHistory"].is_array()) {
@@ -204,6 +240,7 @@ bool ConfigManager::SaveConfig() {
             jp["linuxWorkingDirectory"] = profile.linuxWorkingDirectory;
             jp["macWorkingDirectory"] = profile.macWorkingDirectory;
             jp["terminalType"] = TerminalTypeToString(profile.terminalType);
+            jp["terminalId"] = profile.terminalId;
             
             // 序列化环境变量
             jp["environmentVariables"] = json::array();
@@ -240,6 +277,7 @@ bool ConfigManager::SaveConfig() {
                 {"host", host.host},
                 {"port", host.port},
                 {"username", host.username},
+                {"connectTimeout", host.connectTimeoutSec},
                 {"createdAt", host.createdAt},
                 {"updatedAt", host.updatedAt}
             });
@@ -258,12 +296,27 @@ bool ConfigManager::SaveConfig() {
             });
         }
 
+        // 序列化工作区
+        j["workspaces"] = json::array();
+        for (const auto& ws : m_config.workspaces) {
+            j["workspaces"].push_back({
+                {"id", ws.id},
+                {"name", ws.name},
+                {"profileIds", ws.profileIds},
+                {"layout", WorkspaceLayoutToString(ws.layout)},
+                {"createdAt", ws.createdAt},
+                {"updatedAt", ws.updatedAt}
+            });
+        }
+
         // 序列化设置
         j["settings"] = {
             {"defaultTerminalType", TerminalTypeToString(m_config.settings.defaultTerminalType)},
             {"language", m_config.settings.language},
             {"theme", m_config.settings.theme},
-            {"autoBackup", m_config.settings.autoBackup}
+            {"autoBackup", m_config.settings.autoBackup},
+            {"launchHelper", m_config.settings.launchHelper},
+            {"residentTray", m_config.settings.residentTray}
         };
 
         json searchHistoryJson = json::array();
@@ -356,6 +409,7 @@ void ConfigManager::AddProfile(const Profile& profile) {
     newProfile.updatedAt = newProfile.createdAt;
     
     m_config.profiles.push_back(newProfile);
+    ++m_profilesRevision;
     SaveConfig();
 }
 
@@ -371,7 +425,9 @@ void ConfigManager::UpdateProfile(const std::string& id, const Profile& profile)
             break;
         }
     }
+    ++m_profilesRevision;
     SaveConfig();
+    ScriptCache::Collect(m_config.profiles);
 }
 
 void ConfigManager::DeleteProfile(const std::string& id) {
@@ -380,7 +436,16 @@ void ConfigManager::DeleteProfile(const std::string& id) {
             [&id](const Profile& p) { return p.id == id; }),
         m_config.profiles.end()
     );
+    // 从工作区里移除对该配置的引用
+    for (auto& ws : m_config.workspaces) {
+        ws.profileIds.erase(
+            std::remove(ws.profileIds.begin(), ws.profileIds.end(), id),
+            ws.profileIds.end()
+        );
+    }
+    ++m_profilesRevision;
     SaveConfig();
+    ScriptCache::Collect(m_config.profiles);
 }
 
 Profile ConfigManager::DuplicateProfile(const std::string& id) {
@@ -396,6 +461,7 @@ Profile ConfigManager::DuplicateProfile(const std::string& id) {
     newProfile.updatedAt = newProfile.createdAt;
 
     m_config.profiles.push_back(newProfile);
+    ++m_profilesRevision;
     SaveConfig();
 
     return newProfile;
@@ -500,6 +566,50 @@ void ConfigManager::DeleteCredential(const std::string& id) {
     SaveConfig();
 }
 
+// ===== 工作区 =====
+const Workspace* ConfigManager::GetWorkspace(const std::string& id) const {
+    for (const auto& w : m_config.workspaces) {
+        if (w.id == id) {
+            return &w;
+        }
+    }
+    return nullptr;
+}
+
+Workspace ConfigManager::AddWorkspace(const Workspace& workspace) {
+    Workspace newWorkspace = workspace;
+    newWorkspace.id = GenerateUuid();
+    newWorkspace.createdAt = GetCurrentTimestamp();
+    newWorkspace.updatedAt = newWorkspace.createdAt;
+    m_config.workspaces.push_back(newWorkspace);
+    SaveConfig();
+    return newWorkspace;
+}
+
+void ConfigManager::UpdateWorkspace(const std::string& id, const Workspace& workspace) {
+    for (auto& w : m_config.workspaces) {
+        if (w.id == id) {
+            std::string oldId = w.id;
+            std::string oldCreatedAt = w.createdAt;
+            w = workspace;
+            w.id = oldId;
+            w.createdAt = oldCreatedAt;
+            w.updatedAt = GetCurrentTimestamp();
+            break;
+        }
+    }
+    SaveConfig();
+}
+
+void ConfigManager::DeleteWorkspace(const std::string& id) {
+    m_config.workspaces.erase(
+        std::remove_if(m_config.workspaces.begin(), m_config.workspaces.end(),
+            [&id](const Workspace& w) { return w.id == id; }),
+        m_config.workspaces.end()
+    );
+    SaveConfig();
+}
+
 bool ConfigManager::ExportConfig(const fs::path& filePath) {
     try {
         fs::copy_file(m_configPath, filePath, fs::copy_options::overwrite_existing);
@@ -535,7 +645,9 @@ bool ConfigManager::ImportConfig(const fs::path& filePath) {
         fs::copy_file(filePath, m_configPath, fs::copy_options::overwrite_existing);
         
         // 重新加载
-        return LoadConfig();
+        bool loaded = LoadConfig();
+        ScriptCache::Collect(m_config.profiles);
+        return loaded;
     }
     catch (...) {
         return false;
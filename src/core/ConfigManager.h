@@ -4,6 +4,7 @@
 #include <string>
 #include <filesystem>
 #include <functional>
+#include <cstdint>
 
 namespace fs = std::filesystem;
 
@@ -31,6 +32,8 @@ public:
     void UpdateProfile(const std::string& id, const Profile& profile);
     void DeleteProfile(const std::string& id);
     Profile DuplicateProfile(const std::string& id);
+    // 配置列表每次变化（增删改、重新加载）都会递增，供搜索索引判断是否需要重建
+    uint64_t GetProfilesRevision() const { return m_profilesRevision; }
 
     // SSH 主机操作
     const std::vector<SshHost>& GetSshHosts() const { return m_config.sshHosts; }
@@ -47,6 +50,13 @@ public:
     void UpdateCredential(const std::string& id, const Credential& cred);
     void DeleteCredential(const std::string& id);
 
+    // 工作区操作
+    const std::vector<Workspace>& GetWorkspaces() const { return m_config.workspaces; }
+    const Workspace* GetWorkspace(const std::string& id) const;
+    Workspace AddWorkspace(const Workspace& workspace);
+    void UpdateWorkspace(const std::string& id, const Workspace& workspace);
+    void DeleteWorkspace(const std::string& id);
+
     // 导入导出
     bool ExportConfig(const fs::path& filePath);
     bool ImportConfig(const fs::path& filePath);
@@ -70,6 +80,7 @@ private:
     AppConfig m_config;
     fs::path m_dataDir;
     fs::path m_configPath;
+    uint64_t m_profilesRevision = 0;
     
     void EnsureDataDirectory();
     std::string GenerateUuid();
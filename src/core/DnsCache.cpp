@@ -0,0 +1,156 @@
+#include "DnsCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  include <winsock2.h>
+#  include <ws2tcpip.h>
+#  pragma comment(lib, "ws2_32.lib")
+#else
+#  include <sys/types.h>
+#  include <sys/socket.h>
+#  include <netdb.h>
+#endif
+
+DnsCache::DnsCache(Resolver resolver, Options options)
+    : m_resolver(std::move(resolver)), m_options(options) {
+    m_options.capacity = std::max<size_t>(m_options.capacity, 1);
+}
+
+DnsCache::DnsCache(Resolver resolver)
+    : DnsCache(std::move(resolver), Options()) {}
+
+DnsCache::~DnsCache() {
+    m_refresher.Shutdown();
+}
+
+DnsCache& DnsCache::Shared() {
+    static DnsCache cache;
+    return cache;
+}
+
+std::string DnsCache::Key(const std::string& host) {
+    std::string key = host;
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
+}
+
+bool DnsCache::SystemResolve(const std::string& host, Addresses& out, std::string& err) {
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;       // IPv4 或 IPv6
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    int rc = getaddrinfo(host.c_str(), nullptr, &hints, &res);
+    if (rc != 0 || !res) {
+        err = "无法解析主机 " + host;
+        return false;
+    }
+    out.clear();
+    for (addrinfo* p = res; p; p = p->ai_next) {
+        ResolvedAddress address;
+        address.family = p->ai_family;
+        address.socktype = p->ai_socktype;
+        address.protocol = p->ai_protocol;
+        const auto* bytes = reinterpret_cast<const uint8_t*>(p->ai_addr);
+        address.sockaddr.assign(bytes, bytes + p->ai_addrlen);
+        out.push_back(std::move(address));
+    }
+    freeaddrinfo(res);
+    return true;
+}
+
+bool DnsCache::Resolve(const std::string& host, Addresses& out, std::string& err, Clock::time_point now) {
+    const std::string key = Key(host);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_items.find(key);
+        if (it != m_items.end()) {
+            Item& item = it->second;
+            const auto age = now - item.fetched;
+            const auto ttl = item.ok ? m_options.ttl : m_options.negativeTtl;
+            const bool fresh = age < ttl;
+            // 过期不久的成功结果先用着，后台换新；失败结果过期后只能同步重试
+            const bool usable = fresh || (item.ok && age < ttl + m_options.maxStale);
+            if (usable) {
+                item.lastUsed = ++m_useCounter;
+                if (!fresh && !item.refreshing) {
+                    item.refreshing = true;
+                    m_refresher.Submit([this, key] { Refresh(key); });
+                }
+                if (item.ok) {
+                    out = item.addresses;
+                } else {
+                    err = item.error;
+                }
+                return item.ok;
+            }
+        }
+    }
+
+    // 同步解析不持锁：其他主机的查询不必等它
+    Addresses addresses;
+    std::string error;
+    bool ok = m_resolver(host, addresses, error);
+    Store(key, ok, addresses, error, now);
+    if (ok) {
+        out = std::move(addresses);
+    } else {
+        err = error;
+    }
+    return ok;
+}
+
+void DnsCache::Refresh(const std::string& key) {
+    Addresses addresses;
+    std::string error;
+    bool ok = m_resolver(key, addresses, error);
+    if (ok) {
+        Store(key, true, std::move(addresses), std::string(), Clock::now());
+        return;
+    }
+    // 后台刷新失败不覆盖旧地址（解析器可能只是暂时不可用），旧地址用到 maxStale 为止
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_items.find(key);
+    if (it != m_items.end()) {
+        it->second.refreshing = false;
+    }
+}
+
+void DnsCache::Store(const std::string& key, bool ok, Addresses addresses, std::string error,
+                     Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_items.find(key) == m_items.end() && m_items.size() >= m_options.capacity) {
+        // 淘汰最久没用过的一项；容量只有一百多，线性查找即可
+        auto oldest = std::min_element(m_items.begin(), m_items.end(), [](const auto& a, const auto& b) {
+            return a.second.lastUsed < b.second.lastUsed;
+        });
+        m_items.erase(oldest);
+    }
+    Item& item = m_items[key];
+    item.ok = ok;
+    item.addresses = std::move(addresses);
+    item.error = std::move(error);
+    item.fetched = now;
+    item.lastUsed = ++m_useCounter;
+    item.refreshing = false;
+}
+
+void DnsCache::Invalidate(const std::string& host) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_items.erase(Key(host));
+}
+
+void DnsCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_items.clear();
+}
+
+size_t DnsCache::Size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_items.size();
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "WorkerPool.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 解析得到的一个地址（端口为 0，连接时再填）
+struct ResolvedAddress {
+    int family = 0;
+    int socktype = 0;
+    int protocol = 0;
+    std::vector<uint8_t> sockaddr;      // sockaddr_in / sockaddr_in6 的原始字节
+};
+
+// 主机名解析缓存
+//
+// getaddrinfo 在分流的 VPN 解析器上可能要数百毫秒甚至数秒，反复连接同一主机时都要付一次。
+// 解析结果缓存 ttl；过期后 maxStale 内仍先返回旧地址，同时在后台重新解析，
+// 连接不必等解析。解析失败的结果缓存 negativeTtl，短时间内重复连接不存在的主机不再逐次等待。
+// getaddrinfo 不报告记录的 TTL，各项一律按固定时长过期。
+// 线程安全：SocketConnector 经 Shared() 在所有 SshClient 之间共用一份。
+class DnsCache {
+public:
+    using Addresses = std::vector<ResolvedAddress>;
+    using Clock = std::chrono::steady_clock;
+    // 解析 host：成功返回 true 与地址（按优先顺序），失败返回 false 与原因
+    using Resolver = std::function<bool(const std::string& host, Addresses& out, std::string& err)>;
+
+    struct Options {
+        std::chrono::seconds ttl{60};
+        std::chrono::seconds negativeTtl{5};
+        std::chrono::seconds maxStale{600};     // 过期超过此时长的不再先用旧地址，同步重新解析
+        size_t capacity = 128;
+    };
+
+    DnsCache(Resolver resolver, Options options);
+    explicit DnsCache(Resolver resolver = SystemResolve);
+    // 等进行中的后台解析结束
+    ~DnsCache();
+
+    DnsCache(const DnsCache&) = delete;
+    DnsCache& operator=(const DnsCache&) = delete;
+
+    // 新鲜的直接返回；过期不久的返回旧地址并在后台刷新；否则同步解析并存入缓存
+    bool Resolve(const std::string& host, Addresses& out, std::string& err,
+                 Clock::time_point now = Clock::now());
+
+    // 按缓存的地址连不上时调用，下次重新解析
+    void Invalidate(const std::string& host);
+    void Clear();
+    size_t Size() const;
+
+    // 等后台刷新全部完成
+    void WaitIdle() { m_refresher.WaitIdle(); }
+
+    static DnsCache& Shared();
+    // 经 getaddrinfo 解析（只取 TCP 地址）
+    static bool SystemResolve(const std::string& host, Addresses& out, std::string& err);
+
+private:
+    struct Item {
+        bool ok = false;
+        Addresses addresses;
+        std::string error;
+        Clock::time_point fetched;
+        uint64_t lastUsed = 0;
+        bool refreshing = false;
+    };
+
+    Resolver m_resolver;
+    Options m_options;
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Item> m_items;
+    uint64_t m_useCounter = 0;
+    WorkerPool m_refresher{1};          // 最后声明：析构时先等后台任务结束，再销毁其余成员
+
+    void Store(const std::string& key, bool ok, Addresses addresses, std::string error,
+               Clock::time_point now);
+    void Refresh(const std::string& key);
+    static std::string Key(const std::string& host);
+};
@@ -0,0 +1,212 @@
+#include "EnvironmentBlock.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+extern char** environ;
+#endif
+
+namespace {
+
+std::mutex g_snapshotMutex;
+std::shared_ptr<const EnvironmentSnapshot> g_snapshot;
+#ifndef _WIN32
+// 捕获时的 environ 指针与各条目的指针，用于检测变化
+char** g_capturedEnviron = nullptr;
+std::vector<const char*> g_capturedEntries;
+
+std::vector<const char*> EnvironEntries() {
+    std::vector<const char*> entries;
+    for (char** e = environ; e && *e; ++e) entries.push_back(*e);
+    return entries;
+}
+
+// setenv 覆盖已有变量时 environ 与条目数都不变，但该项换成新分配的 "name=value"，
+// 所以逐项比较指针；只比指针，不比字符串内容
+bool EnvironChanged() {
+    if (environ != g_capturedEnviron) return true;
+    size_t i = 0;
+    for (char** e = environ; e && *e; ++e, ++i) {
+        if (i >= g_capturedEntries.size() || *e != g_capturedEntries[i]) return true;
+    }
+    return i != g_capturedEntries.size();
+}
+#endif
+
+#ifdef _WIN32
+std::string WideToUtf8(const std::wstring& wstr) {
+    if (wstr.empty()) return std::string();
+    int size = WideCharToMultiByte(CP_UTF8, 0, wstr.data(), (int)wstr.size(), nullptr, 0, nullptr, nullptr);
+    std::string out(size, 0);
+    WideCharToMultiByte(CP_UTF8, 0, wstr.data(), (int)wstr.size(), &out[0], size, nullptr, nullptr);
+    return out;
+}
+
+std::wstring Utf8ToWide(const std::string& str) {
+    if (str.empty()) return std::wstring();
+    int size = MultiByteToWideChar(CP_UTF8, 0, str.data(), (int)str.size(), nullptr, 0);
+    std::wstring out(size, 0);
+    MultiByteToWideChar(CP_UTF8, 0, str.data(), (int)str.size(), &out[0], size);
+    return out;
+}
+#endif
+
+std::vector<std::pair<std::string, std::string>> CaptureProcessEnvironment() {
+    std::vector<std::pair<std::string, std::string>> vars;
+#ifdef _WIN32
+    wchar_t* envStrings = GetEnvironmentStringsW();
+    if (envStrings) {
+        for (wchar_t* p = envStrings; *p; ) {
+            std::wstring entry(p);
+            // 跳过 "=C:=C:\..." 这类以 = 开头的隐藏项
+            size_t pos = entry.find(L'=', 1);
+            if (pos != std::wstring::npos) {
+                vars.emplace_back(WideToUtf8(entry.substr(0, pos)), WideToUtf8(entry.substr(pos + 1)));
+            }
+            p += entry.length() + 1;
+        }
+        FreeEnvironmentStringsW(envStrings);
+    }
+#else
+    for (char** e = environ; e && *e; ++e) {
+        const char* eq = std::strchr(*e, '=');
+        if (eq && eq != *e) {
+            vars.emplace_back(std::string(*e, eq - *e), std::string(eq + 1));
+        }
+    }
+#endif
+    return vars;
+}
+
+bool KeyLess(const EnvEntry& a, const EnvEntry& b) {
+    return a.key < b.key;
+}
+
+} // namespace
+
+EnvKeyRule NativeEnvKeyRule() {
+#ifdef _WIN32
+    return EnvKeyRule::CaseInsensitive;
+#else
+    return EnvKeyRule::CaseSensitive;
+#endif
+}
+
+std::string EnvKey(const std::string& name, EnvKeyRule rule) {
+    if (rule == EnvKeyRule::CaseSensitive) {
+        return name;
+    }
+    // Windows 对环境块按大写形式排序比较；变量名实际只用 ASCII
+    std::string key = name;
+    for (auto& c : key) {
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+    }
+    return key;
+}
+
+EnvironmentSnapshot::EnvironmentSnapshot(
+    std::vector<std::pair<std::string, std::string>> vars,
+    EnvKeyRule rule
+) : m_rule(rule) {
+    m_entries.reserve(vars.size());
+    for (auto& var : vars) {
+        EnvEntry entry;
+        entry.key = EnvKey(var.first, rule);
+        entry.name = std::move(var.first);
+        entry.value = std::move(var.second);
+        m_entries.push_back(std::move(entry));
+    }
+    // 稳定排序后同键只保留最后一项
+    std::stable_sort(m_entries.begin(), m_entries.end(), KeyLess);
+    std::vector<EnvEntry> unique;
+    unique.reserve(m_entries.size());
+    for (auto& entry : m_entries) {
+        if (!unique.empty() && unique.back().key == entry.key) {
+            unique.back() = std::move(entry);
+        } else {
+            unique.push_back(std::move(entry));
+        }
+    }
+    m_entries = std::move(unique);
+}
+
+std::shared_ptr<const EnvironmentSnapshot> EnvironmentSnapshot::Current() {
+    std::lock_guard<std::mutex> lock(g_snapshotMutex);
+#ifndef _WIN32
+    // setenv/putenv/unsetenv 会换掉 environ 或其中的条目指针；都没变时沿用缓存
+    if (g_snapshot && EnvironChanged()) {
+        g_snapshot.reset();
+    }
+#endif
+    if (!g_snapshot) {
+        g_snapshot = std::make_shared<EnvironmentSnapshot>(CaptureProcessEnvironment(), NativeEnvKeyRule());
+#ifndef _WIN32
+        g_capturedEnviron = environ;
+        g_capturedEntries = EnvironEntries();
+#endif
+    }
+    return g_snapshot;
+}
+
+void EnvironmentSnapshot::Refresh() {
+    std::lock_guard<std::mutex> lock(g_snapshotMutex);
+    g_snapshot.reset();
+}
+
+std::vector<EnvEntry> EnvironmentSnapshot::Merge(const std::vector<EnvVariable>& overlay) const {
+    // overlay 通常只有几项：单独排序后与快照做一次有序归并
+    std::vector<EnvEntry> extra;
+    extra.reserve(overlay.size());
+    for (const auto& var : overlay) {
+        if (var.name.empty()) continue;
+        extra.push_back({EnvKey(var.name, m_rule), var.name, var.value});
+    }
+    std::stable_sort(extra.begin(), extra.end(), KeyLess);
+
+    std::vector<EnvEntry> merged;
+    merged.reserve(m_entries.size() + extra.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < m_entries.size() || j < extra.size()) {
+        if (j < extra.size()) {
+            // overlay 内同键取最后一项
+            while (j + 1 < extra.size() && extra[j + 1].key == extra[j].key) ++j;
+        }
+        if (j >= extra.size() || (i < m_entries.size() && m_entries[i].key < extra[j].key)) {
+            merged.push_back(m_entries[i++]);
+        } else {
+            if (i < m_entries.size() && m_entries[i].key == extra[j].key) ++i;
+            merged.push_back(extra[j++]);
+        }
+    }
+    return merged;
+}
+
+std::vector<std::string> EnvironmentSnapshot::BuildEnvp(const std::vector<EnvVariable>& overlay) const {
+    std::vector<EnvEntry> merged = Merge(overlay);
+    std::vector<std::string> envp;
+    envp.reserve(merged.size());
+    for (const auto& entry : merged) {
+        envp.push_back(entry.name + "=" + entry.value);
+    }
+    return envp;
+}
+
+#ifdef _WIN32
+std::wstring EnvironmentSnapshot::BuildWindowsBlock(const std::vector<EnvVariable>& overlay) const {
+    std::wstring block;
+    for (const auto& entry : Merge(overlay)) {
+        block += Utf8ToWide(entry.name);
+        block += L'=';
+        block += Utf8ToWide(entry.value);
+        block += L'\0';
+    }
+    block += L'\0';  // 双 null 结尾
+    return block;
+}
+#endif
@@ -0,0 +1,57 @@
+#pragma once
+#include "Types.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// 环境变量名的比较规则：POSIX 区分大小写；Windows 不区分（按大写折叠）
+enum class EnvKeyRule {
+    CaseSensitive,
+    CaseInsensitive
+};
+
+// 当前平台的规则
+EnvKeyRule NativeEnvKeyRule();
+
+struct EnvEntry {
+    std::string key;     // 排序/比较用的键（按规则折叠后的名称）
+    std::string name;    // 原始名称（保留大小写）
+    std::string value;
+};
+
+// 父进程环境的只读快照，按键有序。
+//
+// 每次启动都把整个 environ 拷进 std::map 代价不小；快照只在首次使用或环境变化时捕获一次，
+// 每个配置的自定义变量以有序归并叠加上去，一趟生成最终的 envp / Windows 环境块。
+class EnvironmentSnapshot {
+public:
+    // 由 name=value 列表构造（后出现的同名项覆盖先出现的）
+    EnvironmentSnapshot(std::vector<std::pair<std::string, std::string>> vars, EnvKeyRule rule);
+
+    // 当前进程环境的共享快照。POSIX 下 environ 或其中任一条目指针变化（setenv、unsetenv、
+    // putenv 新字符串）会自动重新捕获；原地改写 putenv 交出的缓冲区检测不到，需调用 Refresh()
+    static std::shared_ptr<const EnvironmentSnapshot> Current();
+    // 丢弃缓存，下次 Current() 重新捕获（如收到系统环境变更通知后）
+    static void Refresh();
+
+    const std::vector<EnvEntry>& Entries() const { return m_entries; }
+    EnvKeyRule Rule() const { return m_rule; }
+
+    // 叠加自定义变量（同名以 overlay 为准并采用其大小写，overlay 内后者优先），结果按键有序
+    std::vector<EnvEntry> Merge(const std::vector<EnvVariable>& overlay) const;
+
+    // 一趟生成 "NAME=VALUE" 列表，供 execve 使用
+    std::vector<std::string> BuildEnvp(const std::vector<EnvVariable>& overlay) const;
+
+#ifdef _WIN32
+    // CreateProcessW 所需的 Unicode 环境块（已排序，双 null 结尾）
+    std::wstring BuildWindowsBlock(const std::vector<EnvVariable>& overlay) const;
+#endif
+
+private:
+    std::vector<EnvEntry> m_entries;
+    EnvKeyRule m_rule;
+};
+
+// 按规则折叠变量名
+std::string EnvKey(const std::string& name, EnvKeyRule rule);
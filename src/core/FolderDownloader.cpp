@@ -0,0 +1,304 @@
+#include "FolderDownloader.h"
+#include "SshSessionPool.h"
+#include <algorithm>
+#include <system_error>
+#include <thread>
+
+#ifdef _WIN32
+#include <sys/types.h>
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+const char* const kUnsafeNameMessage = "服务器返回的名称不是合法的文件名，已跳过";
+const char* const kOutsideMessage = "本地路径超出目标目录，已跳过";
+
+std::string JoinRemote(const std::string& dir, const std::string& name) {
+    if (dir.empty() || dir.back() == '/') return dir + name;
+    return dir + "/" + name;
+}
+
+// 以 base 开头的每个路径分量逐一相同（不是字符串前缀："/a/bc" 不在 "/a/b" 之下）
+bool IsWithin(const fs::path& path, const fs::path& base) {
+    auto it = path.begin();
+    for (const auto& part : base) {
+        if (part.empty()) continue;     // 末尾的 '/' 产生的空分量
+        if (it == path.end() || *it != part) return false;
+        ++it;
+    }
+    return true;
+}
+}  // namespace
+
+bool FolderDownloader::IsSafeEntryName(const std::string& name) {
+    if (name.empty() || name == "." || name == "..") return false;
+    return name.find_first_of(std::string("/\\\0", 3)) == std::string::npos;
+}
+
+bool FolderDownloader::ResolveLocalPath(const fs::path& localDir, const std::string& relativePath,
+                                        fs::path& out) {
+    out = localDir / fs::u8path(relativePath);
+    std::error_code ec;
+    fs::path base = fs::weakly_canonical(localDir, ec);
+    if (ec) return false;
+    fs::path resolved = fs::weakly_canonical(out, ec);
+    if (ec) return false;
+    return resolved != base && IsWithin(resolved, base);
+}
+
+FolderDownloader::FolderDownloader(const SshHost& host, const Credential& cred, Options options)
+    : m_host(host), m_cred(cred), m_options(std::move(options)) {}
+
+FolderDownloader::FolderDownloader(const SshHost& host, const Credential& cred)
+    : FolderDownloader(host, cred, Options()) {}
+
+FolderDownloadProgress FolderDownloader::Progress() const {
+    FolderDownloadProgress progress;
+    progress.scanning = m_scanning;
+    progress.filesTotal = m_scanning ? 0 : m_files.size();
+    progress.filesDone = m_filesDone;
+    progress.filesFailed = m_filesFailed;
+    progress.bytesTotal = m_bytesTotal;
+    progress.bytesDone = m_bytesDone;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    progress.currentFile = m_currentFile;
+    return progress;
+}
+
+std::vector<FolderDownloader::Failure> FolderDownloader::Failures() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failures;
+}
+
+void FolderDownloader::AddFailure(const std::string& relativePath, const std::string& error) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_failures.push_back({relativePath, error});
+}
+
+bool FolderDownloader::Run(const std::string& remoteDir, const fs::path& localDir,
+                           std::string* errorMsg) {
+    std::string error;
+    {
+        SshSessionPool::Lease lease = SshSessionPool::Acquire(m_host, m_cred, &error, &m_cancelled);
+        if (!lease) {
+            if (errorMsg) *errorMsg = error;
+            return false;
+        }
+        // 读到一部分就出错时（entries 非空）保留已读到的，与单个目录的浏览一致
+        Lister list = [&lease](const std::string& path, std::vector<SshClient::RemoteEntry>& entries,
+                               std::string& listError) {
+            entries = lease->ListDir(path);
+            listError = lease->LastError();
+            return !entries.empty() || listError.empty();
+        };
+        if (!Scan(list, remoteDir, errorMsg)) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::create_directories(localDir, ec);
+    if (!fs::is_directory(localDir, ec)) {
+        if (errorMsg) *errorMsg = "无法创建本地目录: " + localDir.string();
+        return false;
+    }
+    // 父目录在前：被拒的目录建不出来，其下的文件写入前也会被拒
+    for (const auto& dir : m_dirs) {
+        fs::path local;
+        if (!ResolveLocalPath(localDir, dir.relativePath, local)) {
+            AddFailure(dir.relativePath + "/", kOutsideMessage);
+            ++m_filesFailed;
+            continue;
+        }
+        fs::create_directories(local, ec);
+    }
+
+    size_t workers = std::min(std::max<size_t>(m_options.sessions, 1), std::max<size_t>(m_files.size(), 1));
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        threads.emplace_back(&FolderDownloader::Worker, this, localDir);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // 文件写完之后再设目录属性：在目录里建文件会刷新目录的修改时间。子目录先于父目录。
+    for (auto it = m_dirs.rbegin(); it != m_dirs.rend(); ++it) {
+        fs::path local;
+        if (ResolveLocalPath(localDir, it->relativePath, local)) {
+            ApplyAttributes(local, it->mtime, it->permissions);
+        }
+    }
+
+    if (m_cancelled) {
+        if (errorMsg) *errorMsg = "下载已取消";
+        return false;
+    }
+    if (m_filesFailed > 0) {
+        if (errorMsg) *errorMsg = std::to_string(m_filesFailed.load()) + " 项下载失败";
+        return false;
+    }
+    return true;
+}
+
+bool FolderDownloader::Scan(const Lister& list, const std::string& remoteDir, std::string* errorMsg) {
+    // 深度优先遍历，结束后 m_dirs 按层级排序，父目录总在子目录之前
+    std::vector<Item> pending = {Item{remoteDir, std::string(), true}};
+    bool root = true;
+    while (!pending.empty() && !m_cancelled) {
+        Item dir = std::move(pending.back());
+        pending.pop_back();
+
+        std::vector<SshClient::RemoteEntry> entries;
+        std::string error;
+        if (!list(dir.remotePath, entries, error)) {
+            if (root) {
+                if (errorMsg) *errorMsg = error;
+                return false;
+            }
+            // 子目录读不了（无权限等）不中断整个下载，记为失败
+            AddFailure(dir.relativePath + "/", error);
+            ++m_filesFailed;
+            continue;
+        }
+        root = false;
+
+        for (const auto& entry : entries) {
+            if (entry.isLink) {
+                continue;
+            }
+            const std::string relativePath =
+                dir.relativePath.empty() ? entry.name : dir.relativePath + "/" + entry.name;
+            if (!IsSafeEntryName(entry.name)) {
+                AddFailure(relativePath, kUnsafeNameMessage);
+                ++m_filesFailed;
+                continue;
+            }
+            Item item;
+            item.remotePath = JoinRemote(dir.remotePath, entry.name);
+            item.relativePath = relativePath;
+            item.isDir = entry.isDir;
+            item.size = entry.size;
+            item.mtime = entry.mtime;
+            item.permissions = entry.permissions;
+            if (entry.isDir) {
+                pending.push_back(item);
+                m_dirs.push_back(std::move(item));
+            } else {
+                m_bytesTotal += item.size;
+                m_files.push_back(std::move(item));
+            }
+        }
+    }
+    if (m_cancelled) {
+        if (errorMsg) *errorMsg = "下载已取消";
+        return false;
+    }
+    // 先大后小：大文件尽早开始，末尾不会只剩一个大文件拖着
+    std::stable_sort(m_files.begin(), m_files.end(),
+                     [](const Item& a, const Item& b) { return a.size > b.size; });
+    std::stable_sort(m_dirs.begin(), m_dirs.end(), [](const Item& a, const Item& b) {
+        return std::count(a.relativePath.begin(), a.relativePath.end(), '/') <
+               std::count(b.relativePath.begin(), b.relativePath.end(), '/');
+    });
+    m_scanning = false;
+    return true;
+}
+
+void FolderDownloader::Worker(const fs::path& localDir) {
+    SshSessionPool::Lease lease;
+    while (!m_cancelled) {
+        size_t index = m_nextFile.fetch_add(1);
+        if (index >= m_files.size()) {
+            break;
+        }
+        const Item& item = m_files[index];
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_currentFile = item.relativePath;
+        }
+
+        fs::path local;
+        if (!ResolveLocalPath(localDir, item.relativePath, local)) {
+            ++m_filesFailed;
+            AddFailure(item.relativePath, kOutsideMessage);
+            ++m_filesDone;
+            continue;
+        }
+
+        std::string error;
+        bool ok = false;
+        for (int attempt = 0; attempt <= m_options.retries && !m_cancelled; ++attempt) {
+            // 连接断了（或还没有）就重新借一个会话
+            if (!lease || !lease->IsConnected()) {
+                lease = SshSessionPool::Acquire(m_host, m_cred, &error, &m_cancelled);
+                if (!lease) {
+                    continue;
+                }
+            }
+            if (DownloadOne(*lease, item, local)) {
+                ok = true;
+                break;
+            }
+            error = lease->LastError();
+        }
+
+        if (!ok && !m_cancelled) {
+            ++m_filesFailed;
+            AddFailure(item.relativePath, error);
+        }
+        ++m_filesDone;
+    }
+}
+
+bool FolderDownloader::DownloadOne(SshClient& client, const Item& item, const fs::path& localPath) {
+    // 进度按增量累加到共享计数；失败重试时先扣掉本次已计入的部分（续传的进度从断点算起，会重新计入）
+    uint64_t counted = 0;
+    // 重试（以及下次对同一目标目录再下载）从部分文件断点继续
+    SftpDownloadOptions transfer = m_options.transfer;
+    transfer.resume = true;
+    transfer.progress = [this, &counted](uint64_t done, uint64_t) {
+        m_bytesDone += done - counted;
+        counted = done;
+        return !m_cancelled.load();
+    };
+
+    bool ok = client.DownloadFile(item.remotePath, localPath.string(), transfer);
+    if (!ok) {
+        m_bytesDone -= counted;
+        return false;
+    }
+    // 远程文件在遍历之后变大或变小时，以实际下载量为准修正总量
+    if (counted != item.size) {
+        m_bytesTotal += counted;
+        m_bytesTotal -= item.size;
+    }
+    ApplyAttributes(localPath, item.mtime, item.permissions);
+    return true;
+}
+
+void FolderDownloader::ApplyAttributes(const fs::path& path, int64_t mtime, uint32_t permissions) {
+    std::error_code ec;
+    if (permissions != 0) {
+        // Windows 上只有只读位有意义，由 std::filesystem 映射
+        fs::permissions(path, static_cast<fs::perms>(permissions & 0777), fs::perm_options::replace, ec);
+    }
+    if (mtime > 0) {
+#ifdef _WIN32
+        struct __utimbuf64 times;
+        times.actime = mtime;
+        times.modtime = mtime;
+        _wutime64(path.wstring().c_str(), &times);
+#else
+        struct utimbuf times;
+        times.actime = static_cast<time_t>(mtime);
+        times.modtime = static_cast<time_t>(mtime);
+        utime(path.c_str(), &times);
+#endif
+    }
+}
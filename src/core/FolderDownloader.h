@@ -0,0 +1,106 @@
+#pragma once
+#include "SshClient.h"
+#include "Types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 下载进度快照（各计数由多个工作线程并发累加）
+struct FolderDownloadProgress {
+    bool scanning = true;       // 仍在遍历远程目录树
+    size_t filesTotal = 0;
+    size_t filesDone = 0;       // 含失败的
+    size_t filesFailed = 0;
+    uint64_t bytesTotal = 0;
+    uint64_t bytesDone = 0;
+    std::string currentFile;    // 最近开始下载的文件（相对路径）
+};
+
+// 递归下载远程目录
+//
+// 先用一个会话遍历目录树得到文件清单，再由 N 个工作线程各自从 SshSessionPool 借一个会话，
+// 并发下载清单中的文件；单个文件失败按次数重试（连接断开时换一个会话，从部分文件断点续传），
+// 全部完成后按远程属性恢复文件与目录的修改时间和权限。符号链接不跟随，直接跳过。
+// 名称不是单个路径分量的条目（"..", 含 '/' '\\' 等，服务器不可信）记为失败，不写本地；
+// 写入前再确认解析后的本地路径仍在 localDir 之下（已有的本地符号链接也不能把文件引出去）。
+// Run 阻塞执行，其他线程可随时 Cancel（在途的网络等待立即中断）并读取 Progress。
+class FolderDownloader {
+public:
+    struct Options {
+        size_t sessions = 4;        // 并发会话数
+        int retries = 2;            // 单个文件失败后的重试次数
+        SftpDownloadOptions transfer;
+    };
+
+    struct Failure {
+        std::string relativePath;
+        std::string error;
+    };
+
+    // 列出一个远程目录；失败返回 false 与原因。Run 用会话池借来的会话，测试可换成桩
+    using Lister = std::function<bool(const std::string& remotePath,
+                                      std::vector<SshClient::RemoteEntry>& entries, std::string& error)>;
+
+    FolderDownloader(const SshHost& host, const Credential& cred, Options options);
+    FolderDownloader(const SshHost& host, const Credential& cred);
+
+    // 把 remoteDir 的内容下载到 localDir（不存在时创建）。
+    // 全部文件成功返回 true；取消或有文件失败返回 false（已下载的文件保留）。
+    bool Run(const std::string& remoteDir, const std::filesystem::path& localDir,
+             std::string* errorMsg = nullptr);
+
+    void Cancel() { m_cancelled = true; }
+    bool IsCancelled() const { return m_cancelled; }
+
+    FolderDownloadProgress Progress() const;
+    std::vector<Failure> Failures() const;
+
+    // Run 的第一步：遍历 remoteDir 得到下载清单。根目录读不了或取消时返回 false
+    bool Scan(const Lister& list, const std::string& remoteDir, std::string* errorMsg = nullptr);
+
+    // 服务器给的条目名能否原样用作本地文件名：非空、不是 "." / ".."，不含 '/' '\\' 与 NUL
+    static bool IsSafeEntryName(const std::string& name);
+    // localDir 下 relativePath 对应的本地路径；解析后（跟随已存在的符号链接）不在 localDir 之下时返回 false
+    static bool ResolveLocalPath(const std::filesystem::path& localDir, const std::string& relativePath,
+                                 std::filesystem::path& out);
+
+private:
+    struct Item {
+        std::string remotePath;
+        std::string relativePath;   // 相对 remoteDir，用 '/' 分隔
+        bool isDir = false;
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint32_t permissions = 0;
+    };
+
+    SshHost m_host;
+    Credential m_cred;
+    Options m_options;
+
+    std::vector<Item> m_dirs;       // 先序：父目录在子目录之前
+    std::vector<Item> m_files;
+    std::atomic<size_t> m_nextFile{0};
+    std::atomic<bool> m_cancelled{false};
+    std::atomic<bool> m_scanning{true};
+    std::atomic<size_t> m_filesDone{0};
+    std::atomic<size_t> m_filesFailed{0};
+    std::atomic<uint64_t> m_bytesTotal{0};
+    std::atomic<uint64_t> m_bytesDone{0};
+
+    mutable std::mutex m_mutex;     // 保护 m_failures、m_currentFile
+    std::vector<Failure> m_failures;
+    std::string m_currentFile;
+
+    void Worker(const std::filesystem::path& localDir);
+    bool DownloadOne(SshClient& client, const Item& item, const std::filesystem::path& localPath);
+    void AddFailure(const std::string& relativePath, const std::string& error);
+
+    // 按远程属性设置本地文件 / 目录的修改时间与权限（尽力而为）
+    static void ApplyAttributes(const std::filesystem::path& path, int64_t mtime, uint32_t permissions);
+};
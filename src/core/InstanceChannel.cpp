@@ -0,0 +1,349 @@
+#include "InstanceChannel.h"
+#include "TempArtifacts.h"
+#include "utils/PathUtils.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t kMaxMessage = 4096;
+
+std::mutex g_mutex;
+std::thread g_thread;
+std::atomic<bool> g_stopping{false};
+InstanceChannel::Handler g_handler;
+#ifndef _WIN32
+int g_listenFd = -1;
+int g_wakePipe[2] = {-1, -1};
+std::string g_socketPath;
+#endif
+
+void Dispatch(const std::string& message) {
+    InstanceRequest request;
+    if (!InstanceChannel::Decode(message, request)) return;
+    InstanceChannel::Handler handler;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        handler = g_handler;
+    }
+    if (handler) handler(request);
+}
+
+// 程序目录的短哈希，作为端点名的一部分（与单实例检测同样按目录区分）
+std::string EndpointId() {
+    std::string dir = PathUtils::GetExecutableDir().string();
+#ifdef _WIN32
+    for (auto& c : dir) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+#endif
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : dir) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+    return buf;
+}
+
+#ifdef _WIN32
+std::wstring PipeName() {
+    std::string id = EndpointId();
+    return L"\\\\.\\pipe\\MTC-" + std::wstring(id.begin(), id.end());
+}
+
+void ServeLoop() {
+    const std::wstring name = PipeName();
+    while (!g_stopping) {
+        HANDLE pipe = CreateNamedPipeW(name.c_str(), PIPE_ACCESS_INBOUND,
+                                       PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT |
+                                       PIPE_REJECT_REMOTE_CLIENTS,
+                                       1, 0, kMaxMessage, 0, nullptr);
+        if (pipe == INVALID_HANDLE_VALUE) return;
+
+        BOOL connected = ConnectNamedPipe(pipe, nullptr) ? TRUE : (GetLastError() == ERROR_PIPE_CONNECTED);
+        if (connected && !g_stopping) {
+            char buf[kMaxMessage];
+            DWORD read = 0;
+            if (ReadFile(pipe, buf, sizeof(buf), &read, nullptr)) {
+                Dispatch(std::string(buf, read));
+            }
+        }
+        DisconnectNamedPipe(pipe);
+        CloseHandle(pipe);
+    }
+}
+#else
+// socket 所在目录：优先 XDG_RUNTIME_DIR，否则 MTC 的临时根目录（<temp>/mtc-<uid>）。
+// 共享 /tmp 下的固定文件名可以被别的用户抢先创建（粘滞位让我们删不掉），所以目录必须只属于本用户；
+// 核对不通过时返回空
+std::string SocketPath() {
+    const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+    std::filesystem::path dir = (runtimeDir && *runtimeDir) ? std::filesystem::path(runtimeDir)
+                                                              : TempArtifacts::Root();
+    if (dir.empty() || !TempArtifacts::EnsurePrivateDirectory(dir)) return std::string();
+    return (dir / ("mtc-" + EndpointId() + ".sock")).string();
+}
+
+// 对端与本进程是同一用户
+bool PeerIsSameUser(int fd) {
+#if defined(__linux__)
+    ucred cred{};
+    socklen_t len = sizeof(cred);
+    return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0 && cred.uid == getuid();
+#else
+    uid_t uid = 0;
+    gid_t gid = 0;
+    return getpeereid(fd, &uid, &gid) == 0 && uid == getuid();
+#endif
+}
+
+// 监听端与唤醒管道不能被启动的终端继承（macOS 没有 SOCK_CLOEXEC，统一用 fcntl）
+void SetCloseOnExec(int fd) {
+    fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+}
+
+bool FillAddress(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return false;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+void ServeLoop() {
+    for (;;) {
+        pollfd fds[2] = {{g_listenFd, POLLIN, 0}, {g_wakePipe[0], POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[1].revents || g_stopping) return;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        int client = accept(g_listenFd, nullptr, nullptr);
+        if (client < 0) continue;
+        SetCloseOnExec(client);
+
+        // 只接受同一用户的连接（目录 0700、socket 文件 0600，这里再核对对端身份）
+        if (PeerIsSameUser(client)) {
+            timeval timeout{1, 0};
+            setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            std::string message;
+            char buf[1024];
+            ssize_t n;
+            while (message.size() < kMaxMessage && (n = read(client, buf, sizeof(buf))) > 0) {
+                message.append(buf, static_cast<size_t>(n));
+            }
+            if (n == 0) {
+                (void)!write(client, "ok", 2);
+                Dispatch(message);
+            }
+        }
+        close(client);
+    }
+}
+#endif
+
+} // namespace
+
+bool InstanceChannel::Start(Handler handler) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_thread.joinable()) return true;
+    g_handler = std::move(handler);
+    g_stopping = false;
+
+#ifndef _WIN32
+    g_socketPath = SocketPath();
+    sockaddr_un addr;
+    if (g_socketPath.empty() || !FillAddress(g_socketPath, addr)) return false;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    SetCloseOnExec(fd);
+    // 单实例检测已保证没有别的实例在监听，私有目录里残留的 socket 文件可直接删除
+    unlink(g_socketPath.c_str());
+    mode_t oldMask = umask(0077);
+    bool bound = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    umask(oldMask);
+    if (!bound || listen(fd, 8) != 0 || pipe(g_wakePipe) != 0) {
+        close(fd);
+        unlink(g_socketPath.c_str());
+        return false;
+    }
+    g_listenFd = fd;
+    SetCloseOnExec(g_wakePipe[0]);
+    SetCloseOnExec(g_wakePipe[1]);
+#endif
+
+    g_thread = std::thread(ServeLoop);
+    return true;
+}
+
+void InstanceChannel::Stop() {
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (!g_thread.joinable()) return;
+        g_stopping = true;
+        thread = std::move(g_thread);
+        g_handler = nullptr;
+    }
+
+#ifdef _WIN32
+    // 自己连一次管道，唤醒阻塞在 ConnectNamedPipe 上的线程
+    HANDLE h = CreateFileW(PipeName().c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (h != INVALID_HANDLE_VALUE) CloseHandle(h);
+    thread.join();
+#else
+    (void)!write(g_wakePipe[1], "x", 1);
+    thread.join();
+    close(g_listenFd);
+    close(g_wakePipe[0]);
+    close(g_wakePipe[1]);
+    g_listenFd = g_wakePipe[0] = g_wakePipe[1] = -1;
+    unlink(g_socketPath.c_str());
+#endif
+}
+
+bool InstanceChannel::Send(const InstanceRequest& request, std::string* errorMsg) {
+    const std::string message = Encode(request);
+    if (message.size() > kMaxMessage) {
+        if (errorMsg) *errorMsg = "Request too long";
+        return false;
+    }
+
+#ifdef _WIN32
+    const std::wstring name = PipeName();
+    HANDLE pipe = CreateFileW(name.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (pipe == INVALID_HANDLE_VALUE && GetLastError() == ERROR_PIPE_BUSY) {
+        // 监听线程正在处理上一个连接，稍等片刻
+        if (WaitNamedPipeW(name.c_str(), 1000)) {
+            pipe = CreateFileW(name.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+        }
+    }
+    if (pipe == INVALID_HANDLE_VALUE) {
+        if (errorMsg) *errorMsg = "No running instance";
+        return false;
+    }
+    DWORD written = 0;
+    BOOL ok = WriteFile(pipe, message.data(), static_cast<DWORD>(message.size()), &written, nullptr);
+    CloseHandle(pipe);
+    if (!ok || written != message.size()) {
+        if (errorMsg) *errorMsg = "Failed to write to running instance";
+        return false;
+    }
+    return true;
+#else
+    const std::string path = SocketPath();
+    if (path.empty()) {
+        if (errorMsg) *errorMsg = "No private directory for the instance socket";
+        return false;
+    }
+    sockaddr_un addr;
+    if (!FillAddress(path, addr)) {
+        if (errorMsg) *errorMsg = "Socket path too long";
+        return false;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        if (errorMsg) *errorMsg = std::strerror(errno);
+        return false;
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        if (errorMsg) *errorMsg = "No running instance";
+        close(fd);
+        return false;
+    }
+    // 请求里有配置 id / 搜索词，只交给同一用户的实例
+    if (!PeerIsSameUser(fd)) {
+        if (errorMsg) *errorMsg = "Instance socket belongs to another user";
+        close(fd);
+        return false;
+    }
+
+    // 写完后半关闭，对端读到 EOF 即得到完整请求；等待 "ok" 确认已被接收
+    bool ok = write(fd, message.data(), message.size()) == static_cast<ssize_t>(message.size()) &&
+              shutdown(fd, SHUT_WR) == 0;
+    if (ok) {
+        timeval timeout{1, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        char reply[2];
+        ok = read(fd, reply, sizeof(reply)) == 2 && reply[0] == 'o' && reply[1] == 'k';
+    }
+    close(fd);
+    if (!ok && errorMsg) *errorMsg = "Running instance did not accept the request";
+    return ok;
+#endif
+}
+
+std::string InstanceChannel::Encode(const InstanceRequest& request) {
+    const char* verb = "activate";
+    switch (request.kind) {
+        case InstanceRequest::Kind::Launch: verb = "launch"; break;
+        case InstanceRequest::Kind::Search: verb = "search"; break;
+        case InstanceRequest::Kind::QuickLaunch: verb = "palette"; break;
+        case InstanceRequest::Kind::Activate: break;
+    }
+    return std::string(verb) + "\n" + request.argument;
+}
+
+bool InstanceChannel::Decode(const std::string& message, InstanceRequest& request) {
+    size_t nl = message.find('\n');
+    std::string verb = message.substr(0, nl);
+    request.argument = nl == std::string::npos ? std::string() : message.substr(nl + 1);
+    if (verb == "activate") {
+        request.kind = InstanceRequest::Kind::Activate;
+    } else if (verb == "launch") {
+        request.kind = InstanceRequest::Kind::Launch;
+    } else if (verb == "search") {
+        request.kind = InstanceRequest::Kind::Search;
+    } else if (verb == "palette") {
+        request.kind = InstanceRequest::Kind::QuickLaunch;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool InstanceChannel::ParseArgs(const std::vector<std::string>& args, InstanceRequest& request) {
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (args[i] == "--palette") {
+            request.kind = InstanceRequest::Kind::QuickLaunch;
+            request.argument.clear();
+            return true;
+        }
+        if (i + 1 >= args.size()) break;
+        if (args[i] == "--launch") {
+            request.kind = InstanceRequest::Kind::Launch;
+            request.argument = args[i + 1];
+            return true;
+        }
+        if (args[i] == "--search") {
+            request.kind = InstanceRequest::Kind::Search;
+            request.argument = args[i + 1];
+            return true;
+        }
+    }
+    return false;
+}
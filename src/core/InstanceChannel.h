@@ -0,0 +1,45 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+// 发给已运行实例的请求
+struct InstanceRequest {
+    enum class Kind {
+        Activate,   // 仅把主窗口提到前台
+        Launch,     // 启动指定 id 的配置
+        Search,     // 在主窗口里执行搜索
+        QuickLaunch // 弹出快速启动面板
+    };
+    Kind kind = Kind::Activate;
+    std::string argument;
+};
+
+// 实例间本地通道
+//
+// 第一个实例监听（POSIX：Unix domain socket；Windows：命名管道），端点名由程序目录
+// 推导，与单实例检测一致：不同目录的程序互不干扰。
+// POSIX 上 socket 放在只属于本用户的 0700 目录里（XDG_RUNTIME_DIR，没有时为 MTC 的临时根目录），
+// 别的用户无法抢先占住路径；连接两端都核对对方的 uid，只和同一用户的进程通信。第二次运行带参数时
+// （mtc --launch <id> / mtc --search <关键字> / mtc --palette）把请求交给已加载好配置的实例后立即退出，
+// 不初始化 wxWidgets。
+class InstanceChannel {
+public:
+    using Handler = std::function<void(const InstanceRequest&)>;
+
+    // 开始监听。handler 在通道线程上调用，UI 操作需自行转到主线程。
+    static bool Start(Handler handler);
+
+    // 停止监听并回收线程
+    static void Stop();
+
+    // 把请求发给正在运行的实例；没有实例在监听时很快返回 false
+    static bool Send(const InstanceRequest& request, std::string* errorMsg = nullptr);
+
+    // 解析 --launch <id> / --search <关键字> / --palette（args 含程序名）；没有这类参数返回 false
+    static bool ParseArgs(const std::vector<std::string>& args, InstanceRequest& request);
+
+    // 消息格式：第一行为动作，其余为参数。动作不认识时 Decode 返回 false
+    static std::string Encode(const InstanceRequest& request);
+    static bool Decode(const std::string& message, InstanceRequest& request);
+};
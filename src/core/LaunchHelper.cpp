@@ -0,0 +1,364 @@
+#include "LaunchHelper.h"
+#include "WorkerPool.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <cerrno>
+#include <csignal>
+#include <fstream>
+#include <string>
+#endif
+
+namespace {
+
+#ifdef __linux__
+constexpr size_t kHelperThreads = 4;
+
+// 多个线程（批量启动的工作线程池）可同时有请求在途，应答按请求 id 分发
+std::mutex g_mutex;                     // 保护以下全部状态
+std::condition_variable g_replyCv;      // 有应答到达或通道出错
+std::condition_variable g_idleCv;       // 在途请求数归零
+std::mutex g_sendMutex;                 // 整帧写出，不与其他请求交错
+pid_t g_helperPid = -1;
+int g_socket = -1;
+bool g_broken = false;                  // 通道已出错，等在途请求离开后关闭
+bool g_stopping = false;                // Stop 在等在途请求完成，不再接受新请求
+bool g_reading = false;                 // 有一个等待者正在读通道
+uint32_t g_nextId = 0;
+size_t g_inFlight = 0;
+std::map<uint32_t, std::string> g_replies;  // 已读到、尚未被取走的应答（去掉 id 的部分）
+
+// ===== 消息编解码：u32 长度前缀的字符串序列 =====
+void PutU32(std::string& out, uint32_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+void PutString(std::string& out, const std::string& s) {
+    PutU32(out, static_cast<uint32_t>(s.size()));
+    out += s;
+}
+
+bool GetU32(const std::string& in, size_t& pos, uint32_t& v) {
+    if (pos + sizeof(v) > in.size()) return false;
+    std::memcpy(&v, in.data() + pos, sizeof(v));
+    pos += sizeof(v);
+    return true;
+}
+
+bool GetString(const std::string& in, size_t& pos, std::string& s) {
+    uint32_t len = 0;
+    if (!GetU32(in, pos, len) || pos + len > in.size()) return false;
+    s.assign(in, pos, len);
+    pos += len;
+    return true;
+}
+
+// 请求帧：u32 请求 id + argv + 环境变量 + 工作目录 + 经描述符继承的脚本；应答帧：u32 请求 id + 成功标志 + 错误信息
+std::string EncodeRequest(uint32_t id, const SpawnRequest& request) {
+    std::string out;
+    PutU32(out, id);
+    PutU32(out, static_cast<uint32_t>(request.argv.size()));
+    for (const auto& arg : request.argv) PutString(out, arg);
+    PutU32(out, static_cast<uint32_t>(request.env.size()));
+    for (const auto& var : request.env) {
+        PutString(out, var.name);
+        PutString(out, var.value);
+    }
+    PutString(out, request.workingDirectory);
+    PutString(out, request.inheritedScript);
+    return out;
+}
+
+bool DecodeRequest(const std::string& in, size_t pos, SpawnRequest& request) {
+    uint32_t count = 0;
+    if (!GetU32(in, pos, count)) return false;
+    request.argv.resize(count);
+    for (auto& arg : request.argv) {
+        if (!GetString(in, pos, arg)) return false;
+    }
+    if (!GetU32(in, pos, count)) return false;
+    request.env.resize(count);
+    for (auto& var : request.env) {
+        if (!GetString(in, pos, var.name) || !GetString(in, pos, var.value)) return false;
+    }
+    return GetString(in, pos, request.workingDirectory) &&
+           GetString(in, pos, request.inheritedScript);
+}
+
+bool WriteAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool ReadAll(int fd, char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = recv(fd, data, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool WriteFrame(int fd, const std::string& payload) {
+    uint32_t len = static_cast<uint32_t>(payload.size());
+    return WriteAll(fd, reinterpret_cast<const char*>(&len), sizeof(len)) &&
+           WriteAll(fd, payload.data(), payload.size());
+}
+
+bool ReadFrame(int fd, std::string& payload) {
+    uint32_t len = 0;
+    if (!ReadAll(fd, reinterpret_cast<char*>(&len), sizeof(len))) return false;
+    if (len > 16 * 1024 * 1024) return false;
+    payload.resize(len);
+    return len == 0 || ReadAll(fd, &payload[0], len);
+}
+
+// 助手进程主循环：收请求 → 交给线程池启动 → 回结果。GUI 关闭通道后等在途的启动结束再退出。
+// 启动在 kHelperThreads 个线程上并发进行（fork 后等 exec 完成的时间可以重叠），
+// 应答按完成先后写回，由请求 id 对应。
+[[noreturn]] void RunHelper(int sock) {
+    // 已启动的终端由内核自动回收，避免僵尸进程（子进程 exec 前恢复默认，见 ProcessSpawner）
+    signal(SIGCHLD, SIG_IGN);
+    signal(SIGPIPE, SIG_IGN);
+
+    // 不把 GUI 的其他描述符（X11 连接、日志等）带给终端
+    long maxFd = sysconf(_SC_OPEN_MAX);
+    if (maxFd < 0 || maxFd > 4096) maxFd = 4096;
+    for (int fd = 3; fd < maxFd; ++fd) {
+        if (fd != sock) close(fd);
+    }
+
+    std::mutex writeMutex;
+    {
+        WorkerPool pool(kHelperThreads);
+        std::string frame;
+        while (ReadFrame(sock, frame)) {
+            pool.Submit([sock, frame, &writeMutex] {
+                size_t pos = 0;
+                uint32_t id = 0;
+                if (!GetU32(frame, pos, id)) return;
+                std::string reply;
+                PutU32(reply, id);
+                SpawnRequest request;
+                if (!DecodeRequest(frame, pos, request)) {
+                    reply += '\0';
+                    PutString(reply, "Malformed launch request");
+                } else {
+                    std::string err;
+                    bool ok = ProcessSpawner::SpawnDetached(request, &err);
+                    reply += ok ? '\1' : '\0';
+                    PutString(reply, err);
+                }
+                std::lock_guard<std::mutex> lock(writeMutex);
+                if (!WriteFrame(sock, reply)) {
+                    // GUI 端已不在：让主循环的读也结束
+                    shutdown(sock, SHUT_RDWR);
+                }
+            });
+        }
+    }
+    _exit(0);
+}
+
+// 关闭通道并回收助手。只在没有在途请求时调用，避免别的线程读写一个已被复用的描述符
+void CloseChannelLocked() {
+    if (g_socket != -1) {
+        close(g_socket);
+        g_socket = -1;
+    }
+    if (g_helperPid > 0) {
+        waitpid(g_helperPid, nullptr, 0);
+        g_helperPid = -1;
+    }
+    g_broken = false;
+    g_replies.clear();
+}
+
+// /proc/self/status 的线程数；读不到时返回 0
+long ThreadCount() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 8, "Threads:") == 0) {
+            return std::strtol(line.c_str() + 8, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+// 通道出错：唤醒所有等应答的请求，由最后一个离开的请求关闭通道
+void MarkBrokenLocked() {
+    if (!g_broken && g_socket != -1) {
+        g_broken = true;
+        shutdown(g_socket, SHUT_RDWR);
+    }
+    g_replyCv.notify_all();
+}
+
+enum class RoundTripResult {
+    Replied,
+    NotSent,        // 助手没收到完整的请求，可以改由本进程启动
+    Lost,           // 请求已发出但没等到应答，助手可能已经启动了终端
+};
+
+// 发出请求并等它的应答。同一时间只有一个等待者在读通道，读到别人的应答放进 g_replies 并唤醒对方。
+RoundTripResult RoundTrip(const SpawnRequest& request, std::string& reply) {
+    std::unique_lock<std::mutex> lock(g_mutex);
+    if (g_socket == -1 || g_broken || g_stopping) return RoundTripResult::NotSent;
+    const int sock = g_socket;
+    const uint32_t id = ++g_nextId;
+    ++g_inFlight;
+
+    RoundTripResult result = RoundTripResult::Lost;
+    {
+        const std::string payload = EncodeRequest(id, request);
+        lock.unlock();
+        bool sent;
+        {
+            std::lock_guard<std::mutex> sendLock(g_sendMutex);
+            sent = WriteFrame(sock, payload);
+        }
+        lock.lock();
+        // 写一半断开时助手读不到完整的帧，不会执行
+        if (!sent) {
+            result = RoundTripResult::NotSent;
+            MarkBrokenLocked();
+        }
+    }
+    while (!g_broken) {
+        auto it = g_replies.find(id);
+        if (it != g_replies.end()) {
+            reply = std::move(it->second);
+            g_replies.erase(it);
+            result = RoundTripResult::Replied;
+            break;
+        }
+        if (g_reading) {
+            g_replyCv.wait(lock);
+            continue;
+        }
+        g_reading = true;
+        lock.unlock();
+        std::string frame;
+        bool read = ReadFrame(sock, frame);
+        lock.lock();
+        g_reading = false;
+        size_t pos = 0;
+        uint32_t replyId = 0;
+        if (!read || !GetU32(frame, pos, replyId)) {
+            MarkBrokenLocked();
+            break;
+        }
+        g_replies[replyId] = frame.substr(pos);
+        g_replyCv.notify_all();
+    }
+
+    if (--g_inFlight == 0) {
+        if (g_broken) CloseChannelLocked();
+        g_idleCv.notify_all();
+    }
+    return result;
+}
+#endif
+
+} // namespace
+
+bool LaunchHelper::Start() {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_socket != -1) return !g_broken;
+    // 助手 fork 后不 exec 就建线程：父进程多线程时别的线程持有的锁会永远锁在子进程里
+    if (ThreadCount() != 1) return false;
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == -1) {
+        return false;
+    }
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        RunHelper(fds[1]);
+    }
+
+    close(fds[1]);
+    g_socket = fds[0];
+    g_helperPid = pid;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LaunchHelper::Stop() {
+#ifdef __linux__
+    std::unique_lock<std::mutex> lock(g_mutex);
+    // 等在途的请求拿到应答再关闭，不让已发出的请求落空
+    g_stopping = true;
+    g_idleCv.wait(lock, [] { return g_inFlight == 0; });
+    CloseChannelLocked();
+    g_stopping = false;
+#endif
+}
+
+bool LaunchHelper::IsRunning() {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_socket != -1 && !g_broken && !g_stopping;
+#else
+    return false;
+#endif
+}
+
+bool LaunchHelper::Spawn(const SpawnRequest& request, std::string* errorMsg) {
+#ifdef __linux__
+    std::string reply;
+    switch (RoundTrip(request, reply)) {
+        case RoundTripResult::Replied: {
+            size_t pos = 1;
+            std::string err;
+            if (!reply.empty() && GetString(reply, pos, err)) {
+                if (reply[0] == '\1') return true;
+                if (errorMsg) *errorMsg = err;
+                return false;
+            }
+            if (errorMsg) *errorMsg = "启动助手的应答无法解析";
+            return false;
+        }
+        case RoundTripResult::Lost:
+            // 再启动一次可能开出两个终端，交给用户决定
+            if (errorMsg) *errorMsg = "启动助手在启动过程中断开，终端可能已经打开";
+            return false;
+        case RoundTripResult::NotSent:
+            // 助手没收到请求（已退出、通道已关闭）：退回本进程启动
+            break;
+    }
+#endif
+    return ProcessSpawner::SpawnDetached(request, errorMsg);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "ProcessSpawner.h"
+#include <string>
+
+// 常驻启动助手（zygote）
+//
+// 在 main() 里、wxEntry 之前 fork 出一个精简的常驻子进程，二者之间是一对 Unix socket。
+// 此时进程还是单线程、堆也很小：助手不 exec，fork 之后还要建线程、分配内存，
+// 只有从单线程进程 fork 出来才是安全的，所以进程已有其他线程时 Start 直接拒绝。
+// TerminalLauncher 把启动请求（argv + 自定义环境变量 + 工作目录）序列化发过去，
+// 由助手完成 fork/exec 并回传结果，GUI 进程本身不再 fork 这个大进程。
+// 多个线程可同时调用 Spawn：请求带 id，应答按 id 交还，助手在几个线程上并发启动。
+//
+// 仅 Linux 启用（由设置项 launchHelper 控制）；其他平台 Start 返回 false。
+// 助手意外退出时，请求还没发出去的 Spawn 退回到本进程直接启动；已经发出的报错，
+// 不再启动第二次（助手可能已经把终端启动了）。
+class LaunchHelper {
+public:
+    // 启动助手进程。已在运行时直接返回 true；进程已有多个线程时返回 false。
+    static bool Start();
+
+    // 关闭通道并回收助手进程。
+    static void Stop();
+
+    static bool IsRunning();
+
+    // 交给助手启动；exec 失败时返回 false 并带回原因。
+    static bool Spawn(const SpawnRequest& request, std::string* errorMsg = nullptr);
+};
@@ -0,0 +1,371 @@
+#include "LaunchTelemetry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr char kMagic[8] = {'M', 'T', 'C', 'L', 'L', 'O', 'G', '1'};
+constexpr uint32_t kVersion = 1;
+
+// 文件头与槽位按本机字节序原样读写：日志只在本机使用
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t recordSize;
+    uint32_t reserved;
+    uint64_t written;           // 累计写入条数；下一条写入槽位 written % capacity
+};
+static_assert(sizeof(FileHeader) == 32, "FileHeader layout");
+
+enum : uint8_t { kFlagSuccess = 1, kFlagRemote = 2 };
+
+struct DiskRecord {
+    int64_t timestampMs;
+    uint32_t phaseMicros[kLaunchPhaseCount];
+    uint8_t flags;
+    uint8_t reserved[3];
+    char terminal[16];
+    char profileId[40];         // 配置 id 为 36 字符 UUID；更长的 id 被截断
+};
+static_assert(sizeof(DiskRecord) == 88, "DiskRecord layout");
+
+// 跨进程锁：命令行（mtc --launch）与界面共用同一个日志文件，g_mutex 只管得到本进程。
+// 锁加在旁边的 .lock 文件上（CreateLog 会截断重建日志本身），析构时释放。
+// 锁文件打不开时照常读写，退回只有进程内互斥。
+class FileLock {
+public:
+    FileLock(const fs::path& logFile, bool exclusive) {
+        fs::path lockPath = logFile;
+        lockPath += ".lock";
+        std::error_code ec;
+        fs::create_directories(lockPath.parent_path(), ec);
+#ifdef _WIN32
+        m_handle = CreateFileW(lockPath.wstring().c_str(), GENERIC_READ | GENERIC_WRITE,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                               OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_handle != INVALID_HANDLE_VALUE) {
+            OVERLAPPED overlapped = {};
+            LockFileEx(m_handle, exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0, 0, MAXDWORD, MAXDWORD, &overlapped);
+        }
+#else
+        m_fd = open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (m_fd != -1) {
+            while (flock(m_fd, exclusive ? LOCK_EX : LOCK_SH) == -1 && errno == EINTR) {
+            }
+        }
+#endif
+    }
+
+    ~FileLock() {
+        // 关闭句柄即释放锁
+#ifdef _WIN32
+        if (m_handle != INVALID_HANDLE_VALUE) CloseHandle(m_handle);
+#else
+        if (m_fd != -1) close(m_fd);
+#endif
+    }
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+private:
+#ifdef _WIN32
+    HANDLE m_handle = INVALID_HANDLE_VALUE;
+#else
+    int m_fd = -1;
+#endif
+};
+
+std::mutex g_mutex;
+fs::path g_file;
+uint32_t g_capacity = LaunchTelemetry::kDefaultCapacity;
+
+struct CurrentTrace {
+    bool active = false;
+    LaunchRecord record;
+};
+thread_local CurrentTrace t_trace;
+
+template <size_t N>
+void CopyField(char (&dest)[N], const std::string& value) {
+    std::memset(dest, 0, N);
+    std::memcpy(dest, value.data(), std::min(value.size(), N - 1));
+}
+
+template <size_t N>
+std::string ReadField(const char (&src)[N]) {
+    return std::string(src, strnlen(src, N));
+}
+
+bool ReadHeader(std::fstream& file, FileHeader& header) {
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    return std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+           header.version == kVersion &&
+           header.recordSize == sizeof(DiskRecord) &&
+           header.capacity > 0;
+}
+
+// 新建（或格式不符时重建）日志文件，槽位在写入时才占用空间
+bool CreateLog(const fs::path& path, uint32_t capacity, std::string* errorMsg) {
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        if (errorMsg) *errorMsg = "无法创建启动日志: " + path.string();
+        return false;
+    }
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.capacity = capacity;
+    header.recordSize = sizeof(DiskRecord);
+    header.written = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(out);
+}
+
+DiskRecord ToDisk(const LaunchRecord& record) {
+    DiskRecord disk{};
+    disk.timestampMs = record.timestampMs;
+    std::copy(record.phaseMicros.begin(), record.phaseMicros.end(), disk.phaseMicros);
+    disk.flags = (record.success ? kFlagSuccess : 0) | (record.remote ? kFlagRemote : 0);
+    CopyField(disk.terminal, record.terminal);
+    CopyField(disk.profileId, record.profileId);
+    return disk;
+}
+
+LaunchRecord FromDisk(const DiskRecord& disk) {
+    LaunchRecord record;
+    record.timestampMs = disk.timestampMs;
+    std::copy(std::begin(disk.phaseMicros), std::end(disk.phaseMicros), record.phaseMicros.begin());
+    record.success = (disk.flags & kFlagSuccess) != 0;
+    record.remote = (disk.flags & kFlagRemote) != 0;
+    record.terminal = ReadField(disk.terminal);
+    record.profileId = ReadField(disk.profileId);
+    return record;
+}
+
+uint32_t ElapsedMicros(std::chrono::steady_clock::time_point start) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return static_cast<uint32_t>(std::min<long long>(us, UINT32_MAX));
+}
+}  // namespace
+
+std::string LaunchPhaseDisplayName(LaunchPhase phase) {
+    switch (phase) {
+        case LaunchPhase::Resolve: return "探测终端";
+        case LaunchPhase::Script: return "生成脚本";
+        case LaunchPhase::Ipc: return "IPC 开窗";
+        case LaunchPhase::Spawn: return "启动进程";
+        case LaunchPhase::Total: return "总耗时";
+        default: return "";
+    }
+}
+
+void LaunchTelemetry::SetFile(const fs::path& path, uint32_t capacity) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_file = path;
+    g_capacity = std::max<uint32_t>(capacity, 1);
+}
+
+bool LaunchTelemetry::Append(const LaunchRecord& record, std::string* errorMsg) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_file.empty()) {
+        if (errorMsg) *errorMsg = "未设置启动日志文件";
+        return false;
+    }
+
+    // 读文件头、写槽位、写回文件头之间不能插进别的进程的写入，否则累计条数会丢
+    FileLock fileLock(g_file, true);
+    std::fstream file(g_file, std::ios::in | std::ios::out | std::ios::binary);
+    FileHeader header{};
+    // 容量变化时旧槽位的顺序无法保持，直接重建
+    if (!file || !ReadHeader(file, header) || header.capacity != g_capacity) {
+        file.close();
+        if (!CreateLog(g_file, g_capacity, errorMsg)) {
+            return false;
+        }
+        file.open(g_file, std::ios::in | std::ios::out | std::ios::binary);
+        if (!file || !ReadHeader(file, header)) {
+            if (errorMsg) *errorMsg = "无法打开启动日志: " + g_file.string();
+            return false;
+        }
+    }
+
+    DiskRecord disk = ToDisk(record);
+    uint64_t slot = header.written % header.capacity;
+    file.seekp(static_cast<std::streamoff>(sizeof(FileHeader) + slot * sizeof(DiskRecord)));
+    file.write(reinterpret_cast<const char*>(&disk), sizeof(disk));
+
+    ++header.written;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.flush();
+    if (!file) {
+        if (errorMsg) *errorMsg = "写入启动日志失败: " + g_file.string();
+        return false;
+    }
+    return true;
+}
+
+std::vector<LaunchRecord> LaunchTelemetry::ReadAll() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    std::vector<LaunchRecord> records;
+    if (g_file.empty()) {
+        return records;
+    }
+
+    FileLock fileLock(g_file, false);
+    std::fstream file(g_file, std::ios::in | std::ios::binary);
+    FileHeader header{};
+    if (!file || !ReadHeader(file, header)) {
+        return records;
+    }
+
+    uint64_t count = std::min<uint64_t>(header.written, header.capacity);
+    uint64_t first = header.written - count;
+    records.reserve(static_cast<size_t>(count));
+    for (uint64_t i = first; i < header.written; ++i) {
+        uint64_t slot = i % header.capacity;
+        DiskRecord disk{};
+        file.seekg(static_cast<std::streamoff>(sizeof(FileHeader) + slot * sizeof(DiskRecord)));
+        if (!file.read(reinterpret_cast<char*>(&disk), sizeof(disk))) {
+            break;  // 文件被截断：只返回读得到的部分
+        }
+        records.push_back(FromDisk(disk));
+    }
+    return records;
+}
+
+void LaunchTelemetry::Clear() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_file.empty()) {
+        FileLock fileLock(g_file, true);
+        CreateLog(g_file, g_capacity, nullptr);
+    }
+}
+
+uint32_t LaunchTelemetry::Percentile(std::vector<uint32_t> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    p = std::min(std::max(p, 0.0), 100.0);
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+    size_t index = rank == 0 ? 0 : rank - 1;
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+std::vector<LaunchStatsRow> LaunchTelemetry::Summarize(const std::vector<LaunchRecord>& records,
+                                                      GroupBy groupBy, LaunchPhase phase) {
+    struct Group {
+        size_t failures = 0;
+        std::vector<uint32_t> micros;
+    };
+    std::map<std::string, Group> groups;
+    size_t phaseIndex = static_cast<size_t>(phase);
+    for (const auto& record : records) {
+        const std::string key = groupBy == GroupBy::TerminalType
+            ? (record.terminal.empty() ? std::string("auto") : record.terminal)
+            : record.profileId;
+        Group& group = groups[key];
+        if (!record.success) {
+            ++group.failures;
+        }
+        group.micros.push_back(record.phaseMicros[phaseIndex]);
+    }
+
+    std::vector<LaunchStatsRow> rows;
+    rows.reserve(groups.size());
+    for (auto& [key, group] : groups) {
+        LaunchStatsRow row;
+        row.key = key;
+        row.count = group.micros.size();
+        row.failures = group.failures;
+        row.p50Ms = Percentile(group.micros, 50) / 1000.0;
+        row.p95Ms = Percentile(group.micros, 95) / 1000.0;
+        row.p99Ms = Percentile(std::move(group.micros), 99) / 1000.0;
+        rows.push_back(std::move(row));
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const LaunchStatsRow& a, const LaunchStatsRow& b) {
+        return a.count > b.count;
+    });
+    return rows;
+}
+
+LaunchTelemetry::Trace::Trace(const std::string& profileId, bool remote) {
+    if (t_trace.active) {
+        return;
+    }
+    m_active = true;
+    m_start = std::chrono::steady_clock::now();
+    t_trace.active = true;
+    t_trace.record = LaunchRecord();
+    t_trace.record.timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    t_trace.record.profileId = profileId;
+    t_trace.record.remote = remote;
+}
+
+LaunchTelemetry::Trace::~Trace() {
+    if (!m_active) {
+        return;
+    }
+    t_trace.record.phaseMicros[static_cast<size_t>(LaunchPhase::Total)] = ElapsedMicros(m_start);
+    LaunchRecord record = std::move(t_trace.record);
+    t_trace.active = false;
+    // 日志写不进去不影响启动本身。
+    // 这里在启动线程上同步写文件（含等文件锁）：一次只写 88 字节的槽位和文件头，
+    // 比起启动终端可以忽略；若在慢盘或网络盘上显出延迟，再改为交给后台线程写
+    Append(record, nullptr);
+}
+
+void LaunchTelemetry::Trace::SetSuccess(bool success) {
+    if (m_active) {
+        t_trace.record.success = success;
+    }
+}
+
+LaunchTelemetry::PhaseTimer::PhaseTimer(LaunchPhase phase)
+    : m_phase(phase), m_start(std::chrono::steady_clock::now()) {}
+
+LaunchTelemetry::PhaseTimer::~PhaseTimer() {
+    Stop();
+}
+
+void LaunchTelemetry::PhaseTimer::Stop() {
+    if (m_stopped || !t_trace.active) {
+        return;
+    }
+    m_stopped = true;
+    uint32_t& slot = t_trace.record.phaseMicros[static_cast<size_t>(m_phase)];
+    slot = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(slot) + ElapsedMicros(m_start), UINT32_MAX));
+}
+
+void LaunchTelemetry::SetTerminal(const std::string& terminal) {
+    if (t_trace.active) {
+        t_trace.record.terminal = terminal;
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// 启动各阶段（见 TerminalLauncher::Launch）
+enum class LaunchPhase : uint8_t {
+    Resolve,    // 探测 / 解析终端
+    Script,     // 生成或写入初始化脚本、拼 ssh 命令
+    Ipc,        // 让运行中的终端实例开新窗口
+    Spawn,      // fork/exec、osascript、CreateProcess
+    Total,      // 整次启动
+    Count
+};
+
+constexpr size_t kLaunchPhaseCount = static_cast<size_t>(LaunchPhase::Count);
+
+std::string LaunchPhaseDisplayName(LaunchPhase phase);
+
+// 一次启动的计时记录
+struct LaunchRecord {
+    int64_t timestampMs = 0;                                  // 启动时刻（Unix 毫秒）
+    std::array<uint32_t, kLaunchPhaseCount> phaseMicros{};    // 各阶段耗时（微秒，单调时钟）
+    std::string terminal;                                     // 实际使用的终端（描述符 id，如 "alacritty"）
+    bool success = false;
+    bool remote = false;
+    std::string profileId;
+};
+
+// 分组统计的一行：某阶段耗时的 p50 / p95 / p99（毫秒）
+struct LaunchStatsRow {
+    std::string key;            // 终端 id 或配置 id
+    size_t count = 0;
+    size_t failures = 0;
+    double p50Ms = 0;
+    double p95Ms = 0;
+    double p99Ms = 0;
+};
+
+// 启动遥测
+//
+// Launch 在当前线程上开启一次 Trace，各阶段用 PhaseTimer 把单调时钟耗时累加进去；
+// Trace 结束时把记录追加到 data/launch_log.bin。日志是固定容量的二进制环形缓冲：
+// 文件头（魔数、版本、容量、记录大小、累计写入数）之后是 capacity 个定长槽位，
+// 写满后覆盖最旧的记录，文件大小不随使用时间增长。
+// 命令行启动与界面可能同时写同一个日志，读写都在旁边的 .lock 文件上加跨进程锁。
+class LaunchTelemetry {
+public:
+    static constexpr uint32_t kDefaultCapacity = 4096;
+
+    // 设置日志文件（ConfigManager 初始化时调用）；未设置时不记录
+    static void SetFile(const std::filesystem::path& path, uint32_t capacity = kDefaultCapacity);
+
+    // 追加一条记录，满了覆盖最旧的
+    static bool Append(const LaunchRecord& record, std::string* errorMsg = nullptr);
+
+    // 读出全部记录（从旧到新）
+    static std::vector<LaunchRecord> ReadAll();
+
+    static void Clear();
+
+    // 最近秩法百分位（p 取 0~100）；values 为空时返回 0
+    static uint32_t Percentile(std::vector<uint32_t> values, double p);
+
+    // 按终端类型 / 配置分组统计 phase 阶段的耗时分布，按次数降序
+    enum class GroupBy { TerminalType, Profile };
+    static std::vector<LaunchStatsRow> Summarize(const std::vector<LaunchRecord>& records,
+                                                 GroupBy groupBy, LaunchPhase phase);
+
+    // 一次启动的计时范围：构造时开始，析构时记下总耗时并写日志。
+    // 同一线程上嵌套的 Trace 不重复记录（由最外层负责）。
+    class Trace {
+    public:
+        Trace(const std::string& profileId, bool remote);
+        ~Trace();
+        Trace(const Trace&) = delete;
+        Trace& operator=(const Trace&) = delete;
+
+        void SetSuccess(bool success);
+
+    private:
+        bool m_active = false;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    // 阶段计时：析构（或 Stop）时把耗时累加到当前线程的 Trace（没有 Trace 时什么也不做）
+    class PhaseTimer {
+    public:
+        explicit PhaseTimer(LaunchPhase phase);
+        ~PhaseTimer();
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+        // 提前结束计时（之后析构不再累加）
+        void Stop();
+
+    private:
+        LaunchPhase m_phase;
+        std::chrono::steady_clock::time_point m_start;
+        bool m_stopped = false;
+    };
+
+    // 记下当前 Trace 实际使用的终端（描述符 id；用户自定义终端不在 TerminalType 枚举里）
+    static void SetTerminal(const std::string& terminal);
+};
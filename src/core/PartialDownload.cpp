@@ -0,0 +1,94 @@
+#include "PartialDownload.h"
+#include <cstdlib>
+#include <fstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+fs::path PartialDownload::PartPath(const fs::path& target) {
+    fs::path part = target;
+    part += ".part";
+    return part;
+}
+
+fs::path PartialDownload::MetaPath(const fs::path& target) {
+    fs::path meta = target;
+    meta += ".part.meta";
+    return meta;
+}
+
+bool PartialDownload::SaveState(const fs::path& target, const PartialDownloadState& state) {
+    // 每行 key=value；远程路径放最后，路径里的 '=' 不影响解析
+    std::ofstream out(MetaPath(target), std::ios::trunc);
+    out << "size=" << state.remoteSize << "\n"
+        << "mtime=" << state.remoteMtime << "\n"
+        << "done=" << state.bytesDone << "\n"
+        << "remote=" << state.remotePath << "\n";
+    return static_cast<bool>(out);
+}
+
+bool PartialDownload::LoadState(const fs::path& target, PartialDownloadState& state) {
+    std::ifstream in(MetaPath(target));
+    if (!in) {
+        return false;
+    }
+    state = PartialDownloadState();
+    bool hasRemote = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+        if (key == "size") {
+            state.remoteSize = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "mtime") {
+            state.remoteMtime = std::strtoll(value.c_str(), nullptr, 10);
+        } else if (key == "done") {
+            state.bytesDone = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "remote") {
+            state.remotePath = value;
+            hasRemote = true;
+        }
+    }
+    return hasRemote;
+}
+
+uint64_t PartialDownload::ResumeOffset(const fs::path& target, const PartialDownloadState& remote) {
+    PartialDownloadState saved;
+    std::error_code ec;
+    uint64_t partSize = fs::file_size(PartPath(target), ec);
+    if (!ec && LoadState(target, saved) &&
+        saved.remotePath == remote.remotePath &&
+        saved.remoteSize == remote.remoteSize &&
+        saved.remoteMtime == remote.remoteMtime) {
+        return partSize > remote.remoteSize ? 0 : partSize;
+    }
+    Discard(target);
+    return 0;
+}
+
+bool PartialDownload::Truncate(const fs::path& target, uint64_t size) {
+    std::error_code ec;
+    fs::resize_file(PartPath(target), size, ec);
+    return !ec;
+}
+
+bool PartialDownload::Commit(const fs::path& target, std::string* errorMsg) {
+    std::error_code ec;
+    // Windows 上 rename 不覆盖已有文件
+    fs::remove(target, ec);
+    fs::rename(PartPath(target), target, ec);
+    if (ec) {
+        if (errorMsg) *errorMsg = "无法保存下载的文件 " + target.string() + ": " + ec.message();
+        return false;
+    }
+    fs::remove(MetaPath(target), ec);
+    return true;
+}
+
+void PartialDownload::Discard(const fs::path& target) {
+    std::error_code ec;
+    fs::remove(PartPath(target), ec);
+    fs::remove(MetaPath(target), ec);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// 远程文件在开始下载时的身份：续传前据此判断远程文件是否变过
+struct PartialDownloadState {
+    std::string remotePath;
+    uint64_t remoteSize = 0;
+    int64_t remoteMtime = 0;
+    uint64_t bytesDone = 0;     // 上次结束时已落盘的字节数（仅供参考，续传以部分文件长度为准）
+};
+
+// 可续传下载的部分文件管理
+//
+// 下载写入 <目标>.part，旁边的 <目标>.part.meta 记录远程路径、大小、修改时间和已完成字节数。
+// 中断后部分文件与记录都保留；再次下载同一目标时，若记录与远程文件一致，
+// 从部分文件末尾继续（数据按顺序追加，部分文件的长度就是连续完成的字节数）。
+// 完成后 Commit 把部分文件改名为目标文件并删除记录。
+class PartialDownload {
+public:
+    static std::filesystem::path PartPath(const std::filesystem::path& target);
+    static std::filesystem::path MetaPath(const std::filesystem::path& target);
+
+    // 续传起点：记录与 remote 的路径、大小、修改时间一致时为部分文件的长度（不超过远程大小），
+    // 否则为 0，并删掉过期的部分文件与记录
+    static uint64_t ResumeOffset(const std::filesystem::path& target, const PartialDownloadState& remote);
+
+    static bool SaveState(const std::filesystem::path& target, const PartialDownloadState& state);
+    static bool LoadState(const std::filesystem::path& target, PartialDownloadState& state);
+
+    // 把部分文件截到 size 字节（尾部校验不通过时退回重下）
+    static bool Truncate(const std::filesystem::path& target, uint64_t size);
+
+    // 部分文件改名为目标文件（覆盖已有的），删除记录
+    static bool Commit(const std::filesystem::path& target, std::string* errorMsg = nullptr);
+
+    // 删除部分文件与记录
+    static void Discard(const std::filesystem::path& target);
+};
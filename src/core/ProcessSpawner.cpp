@@ -0,0 +1,358 @@
+#include "ProcessSpawner.h"
+#include "EnvironmentBlock.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <sys/ioctl.h>
+#endif
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#ifndef _WIN32
+namespace {
+
+// 追加到子进程 PATH 末尾的标准目录
+constexpr const char* kExtraPath = "/usr/bin:/usr/local/bin:/bin:/snap/bin";
+
+// 按 PATH 查找可执行文件（含 / 的名称原样返回）；找不到时返回空
+std::string ResolveExecutable(const std::string& name, const std::string& path) {
+    if (name.find('/') != std::string::npos) {
+        return name;
+    }
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find(':', start);
+        if (end == std::string::npos) end = path.size();
+        std::string dir = path.substr(start, end - start);
+        std::string candidate = (dir.empty() ? std::string(".") : dir) + "/" + name;
+        if (access(candidate.c_str(), X_OK) == 0) {
+            return candidate;
+        }
+        start = end + 1;
+    }
+    return std::string();
+}
+
+} // namespace
+#endif
+
+namespace ProcessSpawner {
+
+#ifndef _WIN32
+std::string FindExecutable(const std::string& name) {
+    // 与 SpawnDetached 使用同样的搜索路径：当前 PATH + 标准目录
+    const char* path = std::getenv("PATH");
+    std::string searchPath = (path && *path) ? std::string(path) + ":" + kExtraPath : kExtraPath;
+    return ResolveExecutable(name, searchPath);
+}
+
+namespace {
+
+bool CloexecPipe(int fds[2]) {
+#ifdef __APPLE__
+    // macOS 没有 pipe2
+    if (pipe(fds) == -1) return false;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+#else
+    return pipe2(fds, O_CLOEXEC) == 0;
+#endif
+}
+
+// 打开一对伪终端，两端都带 CLOEXEC（forkpty 在 fork 之后才返回主端，来不及设）
+bool OpenPty(const winsize& size, int& master, int& slave, std::string* errorMsg) {
+#ifdef __APPLE__
+    // macOS 的 posix_openpt 不接受 O_CLOEXEC，只能打开后立即补上
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master != -1) fcntl(master, F_SETFD, FD_CLOEXEC);
+#else
+    master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+#endif
+    if (master == -1 || grantpt(master) == -1 || unlockpt(master) == -1) {
+        if (errorMsg) *errorMsg = "Failed to open pty: " + std::string(strerror(errno));
+        if (master != -1) close(master);
+        return false;
+    }
+    char name[128];
+    if (ptsname_r(master, name, sizeof(name)) != 0) {
+        if (errorMsg) *errorMsg = "Failed to open pty: " + std::string(strerror(errno));
+        close(master);
+        return false;
+    }
+    slave = open(name, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (slave == -1) {
+        if (errorMsg) *errorMsg = "Failed to open pty: " + std::string(strerror(errno));
+        close(master);
+        return false;
+    }
+    ioctl(slave, TIOCSWINSZ, &size);
+    return true;
+}
+
+// 把 content 写进一个匿名内存文件（CLOEXEC，读位置回到开头），返回描述符；失败返回 -1
+int OpenScriptMemfd(const std::string& content, std::string* errorMsg) {
+#ifdef __linux__
+    int fd = memfd_create("mtc-script", MFD_CLOEXEC);
+    if (fd == -1) {
+        if (errorMsg) *errorMsg = "Failed to create memfd: " + std::string(strerror(errno));
+        return -1;
+    }
+    size_t written = 0;
+    while (written < content.size()) {
+        ssize_t n = write(fd, content.data() + written, content.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            if (errorMsg) *errorMsg = "Failed to write memfd: " + std::string(strerror(errno));
+            close(fd);
+            return -1;
+        }
+        written += static_cast<size_t>(n);
+    }
+    lseek(fd, 0, SEEK_SET);
+    return fd;
+#else
+    (void)content;
+    if (errorMsg) *errorMsg = "Inherited scripts are only supported on Linux";
+    return -1;
+#endif
+}
+
+// fork + execve；exec 成功后返回子进程 pid。quiet 时子进程的 stdout/stderr 指向 /dev/null。
+// ptySize 非空时另开一对伪终端：子进程成为新会话首进程，标准输入输出接到 pty 从端，主端经 ptyMaster 返回。
+bool ForkExec(const SpawnRequest& request, bool quiet, const winsize* ptySize,
+              pid_t& childPid, int* ptyMaster, std::string* errorMsg) {
+    if (request.argv.empty()) {
+        if (errorMsg) *errorMsg = "Empty command line";
+        return false;
+    }
+
+    // 最终环境 = 父进程环境快照 + 自定义变量，在 fork 前一次生成；
+    // 子进程里只做 chdir/execve，不再逐个 setenv（多线程进程 fork 后调用 setenv 并不安全）
+    std::vector<EnvEntry> merged = EnvironmentSnapshot::Current()->Merge(request.env);
+
+    // Ensure PATH includes standard directories so terminal emulators can be found
+    const std::string extraPath = std::string(":") + kExtraPath;
+    auto pathIt = std::lower_bound(merged.begin(), merged.end(), std::string("PATH"),
+        [](const EnvEntry& e, const std::string& key) { return e.key < key; });
+    if (pathIt != merged.end() && pathIt->key == "PATH") {
+        pathIt->value += extraPath;
+    } else {
+        pathIt = merged.insert(pathIt, EnvEntry{"PATH", "PATH", kExtraPath});
+    }
+
+    std::string executable = ResolveExecutable(request.argv[0], pathIt->value);
+    if (executable.empty()) {
+        if (errorMsg) *errorMsg = "Failed to exec " + request.argv[0] + ": " + strerror(ENOENT) +
+                                  " (PATH=" + pathIt->value + ")";
+        return false;
+    }
+
+    std::vector<std::string> envStrings;
+    envStrings.reserve(merged.size());
+    for (const auto& entry : merged) {
+        envStrings.push_back(entry.name + "=" + entry.value);
+    }
+    std::vector<char*> envp;
+    envp.reserve(envStrings.size() + 1);
+    for (auto& str : envStrings) {
+        envp.push_back(&str[0]);
+    }
+    envp.push_back(nullptr);
+
+    // argv 在 fork 前准备好
+    std::vector<char*> argv;
+    argv.reserve(request.argv.size() + 1);
+    for (const auto& arg : request.argv) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    // 描述符一创建就带 CLOEXEC：批量启动时别的线程可能同时 fork，
+    // 先建后设之间的空隙会把它们漏给无关的子进程（管道写端漏出去后，下面的 read 要等那个进程退出）
+    int pipefd[2];
+    if (!CloexecPipe(pipefd)) {
+        if (errorMsg) *errorMsg = "Failed to create pipe: " + std::string(strerror(errno));
+        return false;
+    }
+
+    int scriptFd = -1;
+    if (!request.inheritedScript.empty()) {
+        scriptFd = OpenScriptMemfd(request.inheritedScript, errorMsg);
+        if (scriptFd == -1) {
+            close(pipefd[0]);
+            close(pipefd[1]);
+            return false;
+        }
+    }
+
+    int master = -1;
+    int slave = -1;
+    if (ptySize && !OpenPty(*ptySize, master, slave, errorMsg)) {
+        close(pipefd[0]);
+        close(pipefd[1]);
+        if (scriptFd >= 0) close(scriptFd);
+        return false;
+    }
+
+    pid_t pid = fork();
+
+    if (pid == -1) {
+        if (errorMsg) *errorMsg = "Failed to fork: " + std::string(strerror(errno));
+        close(pipefd[0]);
+        close(pipefd[1]);
+        if (master >= 0) close(master);
+        if (slave >= 0) close(slave);
+        if (scriptFd >= 0) close(scriptFd);
+        return false;
+    }
+
+    if (pid == 0) {
+        // Child
+        close(pipefd[0]);
+
+        // 伪终端：新会话首进程，从端成为控制终端并接到标准输入输出（dup2 出的描述符不带 CLOEXEC）
+        if (slave >= 0) {
+            setsid();
+            ioctl(slave, TIOCSCTTY, 0);
+            dup2(slave, STDIN_FILENO);
+            dup2(slave, STDOUT_FILENO);
+            dup2(slave, STDERR_FILENO);
+        }
+
+        // 脚本 memfd 放到固定的 3 号描述符并去掉 CLOEXEC；管道写端若恰好占着 3 号，先挪开
+        if (scriptFd >= 0) {
+            if (pipefd[1] == kInheritedScriptFd) {
+                pipefd[1] = fcntl(pipefd[1], F_DUPFD_CLOEXEC, kInheritedScriptFd + 1);
+            }
+            if (scriptFd == kInheritedScriptFd) {
+                fcntl(scriptFd, F_SETFD, 0);
+            } else {
+                dup2(scriptFd, kInheritedScriptFd);
+            }
+        }
+
+        // 忽略的信号与阻塞掩码会经 exec 保留：常驻助手为自动回收子进程忽略了 SIGCHLD、SIGPIPE，
+        // 不能带给终端及其中的程序（管道写端收不到 SIGPIPE，waitpid 得到 ECHILD）
+        struct sigaction defaultAction = {};
+        defaultAction.sa_handler = SIG_DFL;
+        sigaction(SIGPIPE, &defaultAction, nullptr);
+        sigaction(SIGCHLD, &defaultAction, nullptr);
+        sigset_t emptyMask;
+        sigemptyset(&emptyMask);
+        sigprocmask(SIG_SETMASK, &emptyMask, nullptr);
+
+        if (!request.workingDirectory.empty()) {
+            (void)chdir(request.workingDirectory.c_str());
+        }
+        if (quiet) {
+            int devNull = open("/dev/null", O_WRONLY);
+            if (devNull >= 0) {
+                dup2(devNull, STDOUT_FILENO);
+                dup2(devNull, STDERR_FILENO);
+                close(devNull);
+            }
+        }
+
+        execve(executable.c_str(), argv.data(), envp.data());
+
+        // If we get here, exec failed: send errno back, the parent formats the message
+        int err = errno;
+        (void)write(pipefd[1], &err, sizeof(err));
+        _exit(1);
+    }
+
+    // Parent
+    close(pipefd[1]);
+    if (slave >= 0) close(slave);
+    if (scriptFd >= 0) close(scriptFd);
+
+    int childErrno = 0;
+    ssize_t count = read(pipefd[0], &childErrno, sizeof(childErrno));
+    if (count == static_cast<ssize_t>(sizeof(childErrno))) {
+        if (errorMsg) *errorMsg = "Failed to exec " + executable + ": " + strerror(childErrno);
+    } else if (count > 0) {
+        if (errorMsg) *errorMsg = "Unknown launch error";
+    }
+    close(pipefd[0]);
+
+    if (count > 0) {
+        if (master >= 0) close(master);
+        waitpid(pid, nullptr, 0);
+        return false;
+    }
+
+    if (master >= 0) {
+        *ptyMaster = master;
+    }
+    childPid = pid;
+    return true;
+}
+
+} // namespace
+
+bool SpawnDetached(const SpawnRequest& request, std::string* errorMsg) {
+    pid_t pid = -1;
+    return ForkExec(request, false, nullptr, pid, nullptr, errorMsg);
+}
+
+bool SpawnInPty(const SpawnRequest& request, int cols, int rows,
+                int& masterFd, pid_t& childPid, std::string* errorMsg) {
+    winsize size{};
+    size.ws_col = static_cast<unsigned short>(std::max(cols, 1));
+    size.ws_row = static_cast<unsigned short>(std::max(rows, 1));
+    return ForkExec(request, false, &size, childPid, &masterFd, errorMsg);
+}
+
+int RunAndWait(const SpawnRequest& request, int timeoutMs, std::string* errorMsg) {
+    pid_t pid = -1;
+    if (!ForkExec(request, true, nullptr, pid, nullptr, errorMsg)) {
+        return -1;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;) {
+        int status = 0;
+        pid_t result = waitpid(pid, &status, WNOHANG);
+        if (result == pid) {
+            if (WIFEXITED(status)) {
+                return WEXITSTATUS(status);
+            }
+            if (errorMsg) *errorMsg = request.argv[0] + " terminated by signal";
+            return -1;
+        }
+        if (result < 0) {
+            if (errorMsg) *errorMsg = "waitpid failed: " + std::string(strerror(errno));
+            return -1;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            kill(pid, SIGKILL);
+            waitpid(pid, nullptr, 0);
+            if (errorMsg) *errorMsg = request.argv[0] + " timed out";
+            return -1;
+        }
+        usleep(2000);
+    }
+}
+#else
+bool SpawnDetached(const SpawnRequest& request, std::string* errorMsg) {
+    if (errorMsg) *errorMsg = "Unsupported platform";
+    return false;
+}
+
+int RunAndWait(const SpawnRequest& request, int timeoutMs, std::string* errorMsg) {
+    if (errorMsg) *errorMsg = "Unsupported platform";
+    return -1;
+}
+#endif
+
+} // namespace ProcessSpawner
@@ -0,0 +1,42 @@
+#pragma once
+#include "Types.h"
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+// 一次外部进程启动请求（终端模拟器 argv + 自定义环境变量 + 工作目录）
+struct SpawnRequest {
+    std::vector<std::string> argv;          // argv[0] 按 PATH 查找
+    std::vector<EnvVariable> env;           // 覆盖到继承环境之上的自定义变量
+    std::string workingDirectory;           // 空 = 不切换
+    // 非空时写入 memfd，在子进程中以描述符 kInheritedScriptFd 打开（仅 Linux）。
+    // 用于把初始化脚本交给 `bash /dev/fd/3`：脚本里的变量值不出现在 argv 中，
+    // 其他用户无法经 /proc/<pid>/cmdline 或 ps 读到，也不受单个参数 128 KiB 的限制。
+    std::string inheritedScript;
+};
+
+namespace ProcessSpawner {
+    // SpawnRequest::inheritedScript 在子进程中的描述符与路径
+    constexpr int kInheritedScriptFd = 3;
+    constexpr const char* kInheritedScriptPath = "/dev/fd/3";
+
+    // 以分离方式启动进程（POSIX：fork + execvp），不等待其结束。
+    // exec 失败时经 CLOEXEC 管道把原因带回父进程，返回 false。
+    bool SpawnDetached(const SpawnRequest& request, std::string* errorMsg = nullptr);
+
+    // 启动进程并等待其结束（输出丢弃），返回退出码；启动失败、被信号终止或超时（会被杀掉）返回 -1
+    int RunAndWait(const SpawnRequest& request, int timeoutMs, std::string* errorMsg = nullptr);
+
+#ifndef _WIN32
+    // 按 PATH（加上标准目录）查找可执行文件，返回完整路径；找不到返回空
+    std::string FindExecutable(const std::string& name);
+
+    // 在新的伪终端里启动进程：子进程为会话首进程，stdin/stdout/stderr 接到 pty 从端。
+    // 成功时返回 pty 主端（CLOEXEC）与子进程 pid，关闭主端与回收子进程由调用方负责。
+    bool SpawnInPty(const SpawnRequest& request, int cols, int rows,
+                    int& masterFd, pid_t& childPid, std::string* errorMsg = nullptr);
+#endif
+}
@@ -0,0 +1,155 @@
+#include "PtySession.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+PtySession::~PtySession() {
+    Close();
+}
+
+#ifndef _WIN32
+namespace {
+
+// 回收子进程并换算退出码；graceMs 内未退出时返回 false
+bool ReapChild(pid_t pid, int graceMs, int& exitCode) {
+    for (int waited = 0; ; waited += 5) {
+        int status = 0;
+        pid_t result = waitpid(pid, &status, WNOHANG);
+        if (result == pid) {
+            exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+            return true;
+        }
+        if (result < 0 || waited >= graceMs) {
+            return result < 0;
+        }
+        usleep(5000);
+    }
+}
+
+} // namespace
+
+bool PtySession::Start(const SpawnRequest& request, int cols, int rows,
+                       OutputHandler onOutput, ExitHandler onExit, std::string* errorMsg) {
+    if (m_running.load() || m_reader.joinable()) {
+        if (errorMsg) *errorMsg = "Session already started";
+        return false;
+    }
+
+    // 配置里的同名变量仍可覆盖 TERM
+    SpawnRequest ptyRequest = request;
+    ptyRequest.env.insert(ptyRequest.env.begin(), {EnvVariable{"TERM", "xterm-256color"},
+                                                  EnvVariable{"COLORTERM", "truecolor"}});
+
+    if (pipe(m_wakePipe) == -1) {
+        if (errorMsg) *errorMsg = "Failed to create pipe: " + std::string(strerror(errno));
+        return false;
+    }
+    fcntl(m_wakePipe[0], F_SETFD, FD_CLOEXEC);
+    fcntl(m_wakePipe[1], F_SETFD, FD_CLOEXEC);
+
+    if (!ProcessSpawner::SpawnInPty(ptyRequest, cols, rows, m_master, m_pid, errorMsg)) {
+        close(m_wakePipe[0]);
+        close(m_wakePipe[1]);
+        m_wakePipe[0] = m_wakePipe[1] = -1;
+        return false;
+    }
+
+    m_running = true;
+    m_reader = std::thread(&PtySession::ReadLoop, this, std::move(onOutput), std::move(onExit));
+    return true;
+}
+
+void PtySession::ReadLoop(OutputHandler onOutput, ExitHandler onExit) {
+    char buffer[16384];
+    bool hungUp = false;
+    for (;;) {
+        pollfd fds[2] = {{m_master, POLLIN, 0}, {m_wakePipe[0], POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) {
+            hungUp = true;   // Close 主动挂断
+            break;
+        }
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t n = read(m_master, buffer, sizeof(buffer));
+            if (n > 0) {
+                if (onOutput) onOutput(buffer, static_cast<size_t>(n));
+                continue;
+            }
+            if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+            break;   // EOF / EIO：从端已全部关闭，shell 退出
+        }
+    }
+
+    int exitCode = -1;
+    if (!ReapChild(m_pid, hungUp ? 0 : 1000, exitCode)) {
+        // 仍在运行（Close 挂断，或 shell 关闭了终端却未退出）：先 SIGHUP，再强杀
+        kill(m_pid, SIGHUP);
+        if (!ReapChild(m_pid, 500, exitCode)) {
+            kill(m_pid, SIGKILL);
+            ReapChild(m_pid, 1000, exitCode);
+        }
+    }
+    m_running = false;
+    if (onExit && !hungUp) onExit(exitCode);
+}
+
+void PtySession::Write(const std::string& data) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (m_master < 0 || !m_running.load()) return;
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t n = write(m_master, data.data() + offset, data.size() - offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN) { usleep(1000); continue; }
+            return;
+        }
+        offset += static_cast<size_t>(n);
+    }
+}
+
+void PtySession::Resize(int cols, int rows) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (m_master < 0) return;
+    winsize size{};
+    size.ws_col = static_cast<unsigned short>(cols > 0 ? cols : 1);
+    size.ws_row = static_cast<unsigned short>(rows > 0 ? rows : 1);
+    ioctl(m_master, TIOCSWINSZ, &size);
+}
+
+void PtySession::Close() {
+    if (m_reader.joinable()) {
+        char byte = 0;
+        (void)write(m_wakePipe[1], &byte, 1);
+        m_reader.join();
+    }
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    for (int* fd : {&m_master, &m_wakePipe[0], &m_wakePipe[1]}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+    m_pid = -1;
+}
+#else
+bool PtySession::Start(const SpawnRequest&, int, int, OutputHandler, ExitHandler, std::string* errorMsg) {
+    if (errorMsg) *errorMsg = "Unsupported platform";
+    return false;
+}
+
+void PtySession::Write(const std::string&) {}
+void PtySession::Resize(int, int) {}
+void PtySession::Close() {}
+#endif
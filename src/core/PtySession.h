@@ -0,0 +1,50 @@
+#pragma once
+#include "ProcessSpawner.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 伪终端会话：在 pty 里运行一个 shell，供内置终端面板使用（POSIX）
+//
+// 读线程把 pty 输出原样交给 OutputHandler；shell 退出（读到 EOF/EIO）后回收子进程
+// 并调用 ExitHandler。两个回调都在读线程上执行，调用方自行切回 UI 线程。
+class PtySession {
+public:
+    using OutputHandler = std::function<void(const char* data, size_t size)>;
+    using ExitHandler = std::function<void(int exitCode)>;   // 被信号终止时为 -1
+
+    PtySession() = default;
+    ~PtySession();
+
+    PtySession(const PtySession&) = delete;
+    PtySession& operator=(const PtySession&) = delete;
+
+    // 启动进程；request.env 之外额外设置 TERM=xterm-256color
+    bool Start(const SpawnRequest& request, int cols, int rows,
+               OutputHandler onOutput, ExitHandler onExit, std::string* errorMsg = nullptr);
+
+    // 写入键盘输入（任意线程）
+    void Write(const std::string& data);
+
+    // 调整窗口大小，子进程收到 SIGWINCH
+    void Resize(int cols, int rows);
+
+    // 挂断会话（SIGHUP，必要时 SIGKILL）并等待读线程结束；析构时自动调用
+    void Close();
+
+    bool IsRunning() const { return m_running.load(); }
+
+private:
+#ifndef _WIN32
+    int m_master = -1;
+    int m_wakePipe[2] = {-1, -1};   // Close 时唤醒读线程
+    pid_t m_pid = -1;
+#endif
+    std::thread m_reader;
+    std::mutex m_writeMutex;
+    std::atomic<bool> m_running{false};
+
+    void ReadLoop(OutputHandler onOutput, ExitHandler onExit);
+};
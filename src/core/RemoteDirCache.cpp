@@ -0,0 +1,72 @@
+#include "RemoteDirCache.h"
+#include <algorithm>
+#include <utility>
+
+RemoteDirCache::RemoteDirCache(std::chrono::seconds ttl, size_t capacity)
+    : m_ttl(ttl), m_capacity(std::max<size_t>(capacity, 1)) {}
+
+std::string RemoteDirCache::Normalize(const std::string& path) {
+    std::string key = path;
+    while (key.size() > 1 && key.back() == '/') {
+        key.pop_back();
+    }
+    return key;
+}
+
+RemoteDirCache::State RemoteDirCache::Lookup(const std::string& path, Clock::time_point now,
+                                             Entries* entries) {
+    auto it = m_items.find(Normalize(path));
+    if (it == m_items.end()) {
+        return State::Missing;
+    }
+    if (now - it->second.fetched >= m_ttl) {
+        return State::Stale;
+    }
+    it->second.lastUsed = ++m_useCounter;
+    if (entries) *entries = it->second.entries;
+    return State::Fresh;
+}
+
+bool RemoteDirCache::Revalidate(const std::string& path, int64_t dirMtime, Clock::time_point now,
+                                Entries* entries) {
+    auto it = m_items.find(Normalize(path));
+    if (it == m_items.end()) {
+        return false;
+    }
+    // 与 git 索引的 racy 判定相同：同一秒内列出之后的修改不一定让修改时间变化
+    const Item& item = it->second;
+    if (dirMtime == 0 || item.dirMtime != dirMtime || item.dirMtime >= item.listedAt - 1) {
+        m_items.erase(it);
+        return false;
+    }
+    it->second.fetched = now;
+    it->second.lastUsed = ++m_useCounter;
+    if (entries) *entries = it->second.entries;
+    return true;
+}
+
+void RemoteDirCache::Store(const std::string& path, int64_t dirMtime, int64_t listedAt, Entries entries,
+                           Clock::time_point now) {
+    const std::string key = Normalize(path);
+    if (m_items.find(key) == m_items.end() && m_items.size() >= m_capacity) {
+        // 淘汰最久没用过的一项；容量只有几百，线性查找即可
+        auto oldest = std::min_element(m_items.begin(), m_items.end(), [](const auto& a, const auto& b) {
+            return a.second.lastUsed < b.second.lastUsed;
+        });
+        m_items.erase(oldest);
+    }
+    Item& item = m_items[key];
+    item.entries = std::move(entries);
+    item.dirMtime = dirMtime;
+    item.listedAt = listedAt;
+    item.fetched = now;
+    item.lastUsed = ++m_useCounter;
+}
+
+void RemoteDirCache::Invalidate(const std::string& path) {
+    m_items.erase(Normalize(path));
+}
+
+void RemoteDirCache::Clear() {
+    m_items.clear();
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "SshClient.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 一个 SSH 会话内的远程目录列表缓存
+//
+// TTL 内的列表直接复用；过了 TTL 的先 stat 目录，修改时间没变就续期复用，
+// 省掉打开目录、逐批读取、关闭的多次往返。目录的修改时间只随其中条目的增删改名变化，
+// 文件内容（大小、修改时间）的变化要等 TTL 到期或手动刷新才反映出来。
+// 修改时间只精确到秒：与列出时刻落在同一秒（或前一秒）的修改可能不再推进它，
+// 这样的列表不能靠修改时间续期，过期后照常重新列。
+// 不加锁：只在 SshWorker 的工作线程上使用。
+class RemoteDirCache {
+public:
+    using Entries = std::vector<SshClient::RemoteEntry>;
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::seconds kDefaultTtl{30};
+    static constexpr size_t kDefaultCapacity = 256;
+
+    enum class State {
+        Missing,    // 没有缓存
+        Fresh,      // TTL 内，可直接用
+        Stale       // 已过 TTL，需 stat 目录后 Revalidate
+    };
+
+    explicit RemoteDirCache(std::chrono::seconds ttl = kDefaultTtl, size_t capacity = kDefaultCapacity);
+
+    // Fresh 时 entries 填入缓存的列表
+    State Lookup(const std::string& path, Clock::time_point now, Entries* entries = nullptr);
+
+    // 目录修改时间与缓存时相同、且缓存时它早于列出时刻一秒以上，则续期、填入 entries 并返回 true；
+    // 否则（修改时间变了、未知，或与列出时刻太近）删除该项并返回 false
+    bool Revalidate(const std::string& path, int64_t dirMtime, Clock::time_point now,
+                    Entries* entries = nullptr);
+
+    // dirMtime 为 0 表示未知，此项过期后不能续期，只能重新列；
+    // listedAt 是开始列目录时的墙上时间（Unix 秒），与 dirMtime 比较判断是否可续期
+    void Store(const std::string& path, int64_t dirMtime, int64_t listedAt, Entries entries,
+               Clock::time_point now);
+
+    void Invalidate(const std::string& path);
+    void Clear();
+    size_t Size() const { return m_items.size(); }
+
+    // 缓存键："a/b/" 与 "a/b" 视为同一目录
+    static std::string Normalize(const std::string& path);
+
+private:
+    struct Item {
+        Entries entries;
+        int64_t dirMtime = 0;
+        int64_t listedAt = 0;
+        Clock::time_point fetched;
+        uint64_t lastUsed = 0;
+    };
+
+    std::chrono::seconds m_ttl;
+    size_t m_capacity;
+    uint64_t m_useCounter = 0;
+    std::unordered_map<std::string, Item> m_items;
+};
@@ -0,0 +1,52 @@
+#include "RemoteListing.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <utility>
+
+std::string RemoteListing::SortKey(const std::string& name) {
+    std::string key = name;
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
+}
+
+bool RemoteListing::RowLess(const Row& a, const Row& b) {
+    if (a.entry.isDir != b.entry.isDir) return a.entry.isDir;
+    return a.key < b.key;
+}
+
+void RemoteListing::Sort(std::vector<Entry>& entries) {
+    // 排序键只算一次，避免每次比较都转换大小写
+    RemoteListing listing;
+    listing.Append(entries);
+    entries.clear();
+    entries.reserve(listing.m_rows.size());
+    for (auto& row : listing.m_rows) {
+        entries.push_back(std::move(row.entry));
+    }
+}
+
+void RemoteListing::Append(const std::vector<Entry>& batch) {
+    const size_t middle = m_rows.size();
+    m_rows.reserve(middle + batch.size());
+    for (const auto& entry : batch) {
+        m_rows.push_back(Row{SortKey(entry.name), entry});
+    }
+    auto first = m_rows.begin() + static_cast<std::ptrdiff_t>(middle);
+    std::stable_sort(first, m_rows.end(), RowLess);
+    // 归并是稳定的：键相同时先到的在前
+    std::inplace_merge(m_rows.begin(), first, m_rows.end(), RowLess);
+}
+
+size_t RemoteListing::Find(const std::string& name, bool isDir) const {
+    Row probe{SortKey(name), Entry()};
+    probe.entry.isDir = isDir;
+    auto it = std::lower_bound(m_rows.begin(), m_rows.end(), probe, RowLess);
+    for (; it != m_rows.end() && !RowLess(probe, *it); ++it) {
+        if (it->entry.name == name) {
+            return static_cast<size_t>(std::distance(m_rows.begin(), it));
+        }
+    }
+    return npos;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "SshClient.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 远程目录列表的显示顺序与增量排序
+//
+// 顺序：目录在前、文件在后，各自按名称（大小写不敏感）排序，名称相同时保持到达顺序。
+// 流式列目录时条目分批到达：每批先在批内排序，再与已排好的部分归并，
+// 任何时刻已收到的条目都是有序的，结果与一次性排序全部条目相同。
+class RemoteListing {
+public:
+    using Entry = SshClient::RemoteEntry;
+
+    static std::string SortKey(const std::string& name);
+    static void Sort(std::vector<Entry>& entries);
+
+    void Clear() { m_rows.clear(); }
+    // 并入一批未排序的条目，开销为 O(已有 + 本批)
+    void Append(const std::vector<Entry>& batch);
+
+    size_t Size() const { return m_rows.size(); }
+    const Entry& At(size_t index) const { return m_rows[index].entry; }
+
+    // 条目的当前下标，没有时返回 npos（归并后恢复选中项用）
+    size_t Find(const std::string& name, bool isDir) const;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    struct Row {
+        std::string key;        // SortKey(entry.name)
+        Entry entry;
+    };
+
+    static bool RowLess(const Row& a, const Row& b);
+
+    std::vector<Row> m_rows;
+};
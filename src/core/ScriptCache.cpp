@@ -0,0 +1,221 @@
+#include "ScriptCache.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::mutex g_mutex;
+fs::path g_dir;
+std::map<std::string, std::string> g_memo;   // "<profileId>-<kind>-<hash>" -> 脚本文本
+
+// FNV-1a 64：字段逐个带长度前缀喂进去，避免 "ab"+"c" 与 "a"+"bc" 撞键
+struct Fnv1a {
+    uint64_t h = 1469598103934665603ULL;
+
+    void Bytes(const char* data, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            h ^= static_cast<unsigned char>(data[i]);
+            h *= 1099511628211ULL;
+        }
+    }
+
+    void Field(const std::string& s) {
+        uint64_t len = s.size();
+        Bytes(reinterpret_cast<const char*>(&len), sizeof(len));
+        Bytes(s.data(), s.size());
+    }
+};
+
+const char* PlatformTag() {
+#ifdef _WIN32
+    return "windows";
+#elif defined(__APPLE__)
+    return "macos";
+#else
+    return "linux";
+#endif
+}
+
+std::string EntryKey(const Profile& profile, const std::string& kind, const std::string& fingerprint) {
+    return profile.id + "-" + kind + "-" + fingerprint;
+}
+
+// 文件名 / 内存键里的 profileId 与哈希：id 本身可能含 '-'（UUID），所以从右侧拆
+bool SplitEntryKey(const std::string& key, std::string& profileId, std::string& fingerprint) {
+    size_t hashPos = key.rfind('-');
+    if (hashPos == std::string::npos || hashPos == 0) return false;
+    size_t kindPos = key.rfind('-', hashPos - 1);
+    if (kindPos == std::string::npos) return false;
+    profileId = key.substr(0, kindPos);
+    fingerprint = key.substr(hashPos + 1);
+    return true;
+}
+
+bool IsLive(const std::map<std::string, std::string>& live, const std::string& key) {
+    std::string profileId, fingerprint;
+    if (!SplitEntryKey(key, profileId, fingerprint)) return false;
+    auto it = live.find(profileId);
+    return it != live.end() && it->second == fingerprint;
+}
+
+// 新建文件并写入全部内容。脚本里有环境变量的值，POSIX 上与 WriteScriptFile 一样只给本人读写。
+bool WriteNewFile(const fs::path& path, const std::string& content) {
+#ifdef _WIN32
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << content;
+    return static_cast<bool>(file);
+#else
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        return false;
+    }
+    size_t written = 0;
+    while (written < content.size()) {
+        ssize_t n = write(fd, content.data() + written, content.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            close(fd);
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return close(fd) == 0;
+#endif
+}
+
+} // namespace
+
+void ScriptCache::SetDirectory(const fs::path& dir) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_dir = dir;
+    std::error_code ec;
+    fs::create_directories(g_dir, ec);
+}
+
+std::string ScriptCache::Fingerprint(const Profile& profile) {
+    Fnv1a hash;
+    hash.Field(PlatformTag());
+    hash.Field(std::to_string(kFormatVersion));
+    hash.Field(profile.GetWorkingDirectory());
+    hash.Field(profile.remoteWorkingDirectory);
+    hash.Field(std::to_string(profile.environmentVariables.size()));
+    for (const auto& var : profile.environmentVariables) {
+        hash.Field(var.name);
+        hash.Field(var.value);
+    }
+    hash.Field(std::to_string(profile.startupCommands.size()));
+    for (const auto& cmd : profile.startupCommands) {
+        hash.Field(cmd);
+    }
+
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash.h));
+    return buf;
+}
+
+std::string ScriptCache::GetOrBuild(const Profile& profile, const std::string& kind,
+                                    const std::function<std::string()>& build) {
+    std::string key = EntryKey(profile, kind, Fingerprint(profile));
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_memo.find(key);
+        if (it != g_memo.end()) {
+            return it->second;
+        }
+    }
+
+    // 生成放在锁外；并发生成同一键时结果相同，后写入者覆盖即可
+    std::string text = build();
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_memo[key] = text;
+    return text;
+}
+
+fs::path ScriptCache::Materialize(const Profile& profile, const std::string& kind,
+                                  const std::string& extension,
+                                  const std::function<std::string()>& build) {
+    fs::path dir;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        dir = g_dir;
+    }
+    if (dir.empty()) {
+        return fs::path();
+    }
+
+    fs::path target = dir / (EntryKey(profile, kind, Fingerprint(profile)) + extension);
+    std::error_code ec;
+    if (fs::exists(target, ec)) {
+        return target;
+    }
+
+    // 先写临时文件再改名，其他线程/进程要么看不到，要么看到完整内容
+    static std::atomic<unsigned> counter{0};
+    fs::path temp = target;
+    temp += ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+            "_" + std::to_string(counter.fetch_add(1));
+    if (!WriteNewFile(temp, GetOrBuild(profile, kind, build))) {
+        fs::remove(temp, ec);
+        return fs::path();
+    }
+    fs::rename(temp, target, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return fs::exists(target, ec) ? target : fs::path();
+    }
+    return target;
+}
+
+void ScriptCache::Collect(const std::vector<Profile>& profiles) {
+    std::map<std::string, std::string> live;   // profileId -> 当前指纹
+    for (const auto& profile : profiles) {
+        live[profile.id] = Fingerprint(profile);
+    }
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    for (auto it = g_memo.begin(); it != g_memo.end(); ) {
+        it = IsLive(live, it->first) ? std::next(it) : g_memo.erase(it);
+    }
+
+    if (g_dir.empty()) {
+        return;
+    }
+    std::error_code ec;
+    std::set<fs::path> stale;
+    const auto now = fs::file_time_type::clock::now();
+    for (fs::directory_iterator it(g_dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        if (it->path().extension().string().rfind(".tmp", 0) == 0) {
+            // 中途退出遗留的临时文件；刚创建的可能正被其他线程写入，留到下次
+            if (now - it->last_write_time(ec) > std::chrono::minutes(1)) {
+                stale.insert(it->path());
+            }
+            continue;
+        }
+        if (!IsLive(live, it->path().stem().string())) {
+            stale.insert(it->path());
+        }
+    }
+    for (const auto& path : stale) {
+        fs::remove(path, ec);
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "Types.h"
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 生成脚本的内容寻址缓存
+//
+// 初始化脚本 / 远程内层脚本只取决于配置里的少数字段（工作目录、环境变量、启动命令、
+// 远程目录）和平台。以这些字段的哈希为键，生成一次后：
+//   - 内存中按键复用文本（Linux 经 memfd 或 0600 临时文件交给 bash）；
+//   - macOS / Windows 需要脚本文件，落到 data/cache/<profileId>-<kind>-<hash>.<ext>，
+//     之后的启动直接复用该文件。
+// 配置被删除或相关字段变化后，Collect 清理过期条目。
+class ScriptCache {
+public:
+    // 生成脚本的格式版本，计入指纹。修改任何走缓存的脚本生成函数
+    // （TerminalLauncher 的 init / remote 脚本）时必须加一，否则已落盘的旧脚本会继续被复用。
+    static constexpr int kFormatVersion = 1;
+
+    // 设置缓存目录（data/cache），不存在时创建
+    static void SetDirectory(const std::filesystem::path& dir);
+
+    // 配置中影响脚本内容的字段 + 平台 + 格式版本的 64 位哈希（十六进制）
+    static std::string Fingerprint(const Profile& profile);
+
+    // 取缓存文本；未命中时调用 build 生成并记住。kind 区分同一配置的不同脚本。
+    static std::string GetOrBuild(const Profile& profile, const std::string& kind,
+                                  const std::function<std::string()>& build);
+
+    // 取缓存文件路径；不存在时用 build 生成并写入缓存目录（POSIX 上权限 0600）。失败返回空路径。
+    static std::filesystem::path Materialize(const Profile& profile, const std::string& kind,
+                                             const std::string& extension,
+                                             const std::function<std::string()>& build);
+
+    // 删除不再对应任何现存配置（或配置已变化）的内存条目与缓存文件
+    static void Collect(const std::vector<Profile>& profiles);
+};
@@ -0,0 +1,313 @@
+#include "SocketConnector.h"
+#include "DnsCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#ifdef _WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  include <winsock2.h>
+#  include <ws2tcpip.h>
+#  pragma comment(lib, "ws2_32.lib")
+   typedef int socklen_t;
+   namespace {
+   struct WsaInit {
+       WsaInit() { WSADATA d; WSAStartup(MAKEWORD(2, 2), &d); }
+       ~WsaInit() { WSACleanup(); }
+   };
+   WsaInit g_wsaInit;
+   }  // namespace
+#  define MTC_INVALID_SOCKET INVALID_SOCKET
+#  define MTC_POLL WSAPoll
+   typedef WSAPOLLFD mtc_pollfd;
+#else
+#  include <sys/types.h>
+#  include <sys/socket.h>
+#  include <netinet/in.h>
+#  include <arpa/inet.h>
+#  include <unistd.h>
+#  include <fcntl.h>
+#  include <poll.h>
+#  include <cerrno>
+#  define MTC_INVALID_SOCKET (-1)
+#  define MTC_POLL poll
+   typedef struct pollfd mtc_pollfd;
+#endif
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr int kPollSliceMs = 100;   // 检查取消标志的间隔
+
+struct Candidate {
+    int family = 0;
+    int socktype = 0;
+    int protocol = 0;
+    sockaddr_storage addr = {};
+    socklen_t addrLen = 0;
+};
+
+struct Attempt {
+    int sock = MTC_INVALID_SOCKET;
+    size_t index = 0;
+};
+
+std::mutex g_mutex;
+std::map<std::string, int> g_families;      // 主机名（小写）-> 上次胜出的地址族
+
+std::string HostKey(const std::string& host) {
+    std::string key = host;
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
+}
+
+void CloseSocket(int sock) {
+#ifdef _WIN32
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+bool SetNonBlocking(int sock, bool enable) {
+#ifdef _WIN32
+    u_long mode = enable ? 1 : 0;
+    return ioctlsocket(sock, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    if (flags < 0) return false;
+    flags = enable ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return fcntl(sock, F_SETFL, flags) == 0;
+#endif
+}
+
+int LastSocketError() {
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+bool InProgress(int code) {
+#ifdef _WIN32
+    return code == WSAEWOULDBLOCK || code == WSAEINPROGRESS;
+#else
+    return code == EINPROGRESS || code == EWOULDBLOCK;
+#endif
+}
+
+std::string ErrorText(int code) {
+#ifdef _WIN32
+    return "错误码 " + std::to_string(code);
+#else
+    return strerror(code);
+#endif
+}
+
+// 缓存的地址不带端口，连接前填入
+bool SetPort(Candidate& c, int port) {
+    if (c.family == AF_INET && c.addrLen >= sizeof(sockaddr_in)) {
+        reinterpret_cast<sockaddr_in*>(&c.addr)->sin_port = htons(static_cast<uint16_t>(port));
+        return true;
+    }
+    if (c.family == AF_INET6 && c.addrLen >= sizeof(sockaddr_in6)) {
+        reinterpret_cast<sockaddr_in6*>(&c.addr)->sin6_port = htons(static_cast<uint16_t>(port));
+        return true;
+    }
+    return false;
+}
+
+// 非阻塞连接是否失败：SO_ERROR 为 0 表示已连上
+int PendingError(int sock) {
+    int soError = 0;
+    socklen_t len = sizeof(soError);
+    if (getsockopt(sock, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&soError), &len) != 0) {
+        return LastSocketError();
+    }
+    return soError;
+}
+}  // namespace
+
+std::vector<size_t> SocketConnector::AttemptOrder(const std::vector<int>& families, int preferredFamily) {
+    if (families.empty()) {
+        return {};
+    }
+    if (preferredFamily == AF_UNSPEC) {
+        preferredFamily = families.front();
+    }
+    std::vector<size_t> preferred, others;
+    for (size_t i = 0; i < families.size(); ++i) {
+        (families[i] == preferredFamily ? preferred : others).push_back(i);
+    }
+    std::vector<size_t> order;
+    order.reserve(families.size());
+    for (size_t i = 0; i < std::max(preferred.size(), others.size()); ++i) {
+        if (i < preferred.size()) order.push_back(preferred[i]);
+        if (i < others.size()) order.push_back(others[i]);
+    }
+    return order;
+}
+
+int SocketConnector::PreferredFamily(const std::string& host) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto it = g_families.find(HostKey(host));
+    return it == g_families.end() ? AF_UNSPEC : it->second;
+}
+
+void SocketConnector::RememberFamily(const std::string& host, int family) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_families[HostKey(host)] = family;
+}
+
+void SocketConnector::ForgetFamilies() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_families.clear();
+}
+
+bool SocketConnector::Connect(const std::string& host, int port, const Options& options,
+                              int& outSock, std::string& err) {
+    const std::string portStr = std::to_string(port);
+    const std::string target = host + ":" + portStr;
+
+    DnsCache& dns = options.dns ? *options.dns : DnsCache::Shared();
+    DnsCache::Addresses addresses;
+    std::string resolveErr;
+    if (!dns.Resolve(host, addresses, resolveErr)) {
+        err = "无法解析主机 " + target;
+        return false;
+    }
+    std::vector<Candidate> candidates;
+    std::vector<int> families;
+    for (const auto& address : addresses) {
+        if (address.sockaddr.size() > sizeof(sockaddr_storage)) continue;
+        Candidate c;
+        c.family = address.family;
+        c.socktype = address.socktype;
+        c.protocol = address.protocol;
+        std::memcpy(&c.addr, address.sockaddr.data(), address.sockaddr.size());
+        c.addrLen = static_cast<socklen_t>(address.sockaddr.size());
+        if (!SetPort(c, port)) continue;
+        candidates.push_back(c);
+        families.push_back(c.family);
+    }
+
+    const std::vector<size_t> order = AttemptOrder(families, PreferredFamily(host));
+    const int timeoutSec = options.timeoutSec > 0 ? options.timeoutSec : kDefaultTimeoutSec;
+    const auto deadline = Clock::now() + std::chrono::seconds(timeoutSec);
+    auto nextStart = Clock::now();
+    size_t next = 0;
+    std::vector<Attempt> pending;
+    std::string lastErr = "未知错误";
+    int winner = MTC_INVALID_SOCKET;
+    size_t winnerIndex = 0;
+
+    auto closePending = [&pending] {
+        for (const auto& attempt : pending) CloseSocket(attempt.sock);
+        pending.clear();
+    };
+
+    while (winner == MTC_INVALID_SOCKET) {
+        if (options.cancel && options.cancel->load()) {
+            closePending();
+            err = "操作已取消";
+            return false;
+        }
+        auto now = Clock::now();
+
+        // 到点（或没有在途的尝试）就发起下一个
+        if (next < order.size() && (pending.empty() || now >= nextStart)) {
+            const size_t index = order[next++];
+            const Candidate& c = candidates[index];
+            nextStart = now + std::chrono::milliseconds(kAttemptDelayMs);
+            int sock = static_cast<int>(socket(c.family, c.socktype, c.protocol));
+            if (sock == MTC_INVALID_SOCKET) {
+                lastErr = "socket 创建失败: " + ErrorText(LastSocketError());
+                nextStart = now;
+                continue;
+            }
+            if (!SetNonBlocking(sock, true)) {
+                lastErr = "socket 设置失败: " + ErrorText(LastSocketError());
+                CloseSocket(sock);
+                nextStart = now;
+                continue;
+            }
+            if (connect(sock, reinterpret_cast<const sockaddr*>(&c.addr), c.addrLen) == 0) {
+                winner = sock;
+                winnerIndex = index;
+                break;
+            }
+            int code = LastSocketError();
+            if (!InProgress(code)) {
+                lastErr = ErrorText(code);   // 记录原因（如 Network is unreachable）
+                CloseSocket(sock);
+                nextStart = now;
+                continue;
+            }
+            pending.push_back({sock, index});
+        }
+
+        if (pending.empty()) {
+            if (next >= order.size()) break;    // 全部失败
+            continue;
+        }
+        if (now >= deadline) {
+            closePending();
+            err = "连接 " + target + " 超时（" + std::to_string(timeoutSec) + " 秒）";
+            return false;
+        }
+
+        auto wait = std::min(deadline - now, std::chrono::duration_cast<Clock::duration>(
+                                                 std::chrono::milliseconds(kPollSliceMs)));
+        if (next < order.size()) {
+            wait = std::min(wait, std::max(nextStart - now, Clock::duration::zero()));
+        }
+        std::vector<mtc_pollfd> fds(pending.size());
+        for (size_t i = 0; i < pending.size(); ++i) {
+            fds[i].fd = pending[i].sock;
+            fds[i].events = POLLOUT;
+        }
+        int waitMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(wait).count());
+        int ready = MTC_POLL(fds.data(), static_cast<unsigned long>(fds.size()), std::max(waitMs, 0));
+        if (ready <= 0) {
+            continue;   // 超时、EINTR：回到循环开头检查取消、截止时间与下一次尝试
+        }
+
+        // 可写（或出错）的 socket 用 SO_ERROR 区分连上与失败
+        std::vector<Attempt> stillPending;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            if (fds[i].revents == 0 || winner != MTC_INVALID_SOCKET) {
+                stillPending.push_back(pending[i]);
+                continue;
+            }
+            int code = PendingError(pending[i].sock);
+            if (code == 0) {
+                winner = pending[i].sock;
+                winnerIndex = pending[i].index;
+            } else {
+                lastErr = ErrorText(code);
+                CloseSocket(pending[i].sock);
+                nextStart = Clock::now();   // 有尝试失败就不必再等，立即发起下一个
+            }
+        }
+        pending.swap(stillPending);
+    }
+    closePending();
+
+    if (winner == MTC_INVALID_SOCKET) {
+        // 地址可能已变（DHCP、VPN 切换），下次不用缓存的结果
+        dns.Invalidate(host);
+        err = "连接 " + target + " 失败 (" + lastErr + ")";
+        return false;
+    }
+    // 之后的读写由 libssh2 自行管理阻塞模式，交出时恢复为普通的阻塞 socket
+    SetNonBlocking(winner, false);
+    RememberFamily(host, candidates[winnerIndex].family);
+    outSock = winner;
+    return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class DnsCache;
+
+// 建立 TCP 连接（RFC 8305 "Happy Eyeballs"）
+//
+// 主机名经 DnsCache 解析（所有连接共用缓存），
+// 得到的地址按地址族交替排列（上次成功的地址族在前，否则按 getaddrinfo 的顺序），
+// 用非阻塞 socket 依次发起连接：前一个 kAttemptDelayMs 内没连上就并行发起下一个，
+// 某个失败则立即发起下一个；最先连上的胜出，其余关闭。
+// 不可达的 IPv6 地址因此不会把 IPv4 拖到系统默认的连接超时（常在 75 秒以上）之后。
+// 每个主机胜出的地址族记在进程内，之后连接同一主机时优先尝试。
+class SocketConnector {
+public:
+    static constexpr int kDefaultTimeoutSec = 10;
+    static constexpr int kAttemptDelayMs = 250;
+
+    struct Options {
+        int timeoutSec = kDefaultTimeoutSec;            // 整体超时（含全部尝试）
+        const std::atomic<bool>* cancel = nullptr;      // 置位后尽快放弃
+        DnsCache* dns = nullptr;                        // 为空时用 DnsCache::Shared()
+    };
+
+    // 成功时 outSock 为已连接的阻塞 socket；失败返回 false 与原因
+    static bool Connect(const std::string& host, int port, const Options& options,
+                        int& outSock, std::string& err);
+
+    // 尝试顺序：families[i] 为第 i 个地址的地址族，返回地址下标。
+    // preferredFamily 的地址先行，之后两族交替，同族内保持原有顺序
+    static std::vector<size_t> AttemptOrder(const std::vector<int>& families, int preferredFamily);
+
+    // 上次连接 host 时胜出的地址族；没有记录返回 0（AF_UNSPEC）
+    static int PreferredFamily(const std::string& host);
+    static void RememberFamily(const std::string& host, int family);
+    static void ForgetFamilies();
+};
@@ -1,9 +1,14 @@
 #include "SshClient.h"
 #include "SecretStore.h"
+#include "AsyncFileWriter.h"
+#include "PartialDownload.h"
+#include "RemoteListing.h"
+#include "SocketConnector.h"
 
 #include <libssh2.h>
 #include <libssh2_sftp.h>
 
+#include <chrono>
 #include <cstring>
 #include <fstream>
 #include <algorithm>
@@ -24,14 +29,20 @@
    static WsaInit g_wsaInit;
 #  define MTC_INVALID_SOCKET INVALID_SOCKET
 #  define MTC_SOCKET_ERR SOCKET_ERROR
+#  define MTC_POLL WSAPoll
+   typedef WSAPOLLFD mtc_pollfd;
 #else
 #  include <sys/types.h>
 #  include <sys/socket.h>
 #  include <netdb.h>
 #  include <unistd.h>
 #  include <arpa/inet.h>
+#  include <poll.h>
+#  include <cerrno>
 #  define MTC_INVALID_SOCKET (-1)
 #  define MTC_SOCKET_ERR (-1)
+#  define MTC_POLL poll
+   typedef struct pollfd mtc_pollfd;
 #endif
 
 // 全局 libssh2 初始化在 main.cpp 的 OnInit/OnExit 中完成。
@@ -43,66 +54,86 @@ SshClient::~SshClient() {
 }
 
 void SshClient::SetLastError(const std::string& msg) {
+    // 中断后各层调用依次失败，保留最初的取消 / 超时原因
+    if (m_aborted && !m_lastError.empty()) {
+        return;
+    }
     m_lastError = msg;
 }
 
-std::string SshClient::PasswordKey(const std::string& credId) {
-    return "mtc:cred:" + credId + ":password";
-}
-
-std::string SshClient::PassphraseKey(const std::string& credId) {
-    return "mtc:cred:" + credId + ":passphrase";
+bool SshClient::WaitSocket() {
+    auto* session = reinterpret_cast<LIBSSH2_SESSION*>(m_session);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(kIoTimeoutSec);
+    while (!m_aborted) {
+        if (m_cancelFlag && m_cancelFlag->load()) {
+            SetLastError("操作已取消");
+            m_aborted = true;
+            break;
+        }
+        int directions = libssh2_session_block_directions(session);
+        mtc_pollfd pfd = {};
+        pfd.fd = m_socket;
+        if (directions & LIBSSH2_SESSION_BLOCK_INBOUND) pfd.events |= POLLIN;
+        if (directions & LIBSSH2_SESSION_BLOCK_OUTBOUND) pfd.events |= POLLOUT;
+        int ready = MTC_POLL(&pfd, 1, kPollSliceMs);
+        // 不等 SSH socket 的 EAGAIN（如与 ssh-agent 通信）等一个时间片后重试
+        if (ready > 0 || (ready == 0 && pfd.events == 0)) {
+            return true;
+        }
+        if (ready < 0 && errno != EINTR) {
+            SetLastError(std::string("等待网络失败: ") + strerror(errno));
+            m_aborted = true;
+            break;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            SetLastError("操作超时（" + std::to_string(kIoTimeoutSec) + " 秒无响应）");
+            m_aborted = true;
+            break;
+        }
+    }
+    // 会话停在协议中途，之后既不能复用也不能再发 disconnect
+    m_connected = false;
+    return false;
 }
 
-static bool CreateConnectedSocket(const std::string& host, int port, int& outSock, std::string& err) {
-    struct addrinfo hints = {0};
-    hints.ai_family = AF_UNSPEC;       // IPv4 或 IPv6
-    hints.ai_socktype = SOCK_STREAM;
-
-    addrinfo* res = nullptr;
-    std::string portStr = std::to_string(port);
-    int rc = getaddrinfo(host.c_str(), portStr.c_str(), &hints, &res);
-    if (rc != 0 || !res) {
-        err = "无法解析主机 " + host + ":" + portStr;
-        return false;
+template <typename Fn>
+auto SshClient::Drive(Fn fn) -> decltype(fn()) {
+    auto rc = fn();
+    while (rc == LIBSSH2_ERROR_EAGAIN && WaitSocket()) {
+        rc = fn();
     }
+    return rc;
+}
 
-    int sock = MTC_INVALID_SOCKET;
-    std::string lastErr = "未知错误";
-    for (addrinfo* p = res; p; p = p->ai_next) {
-        sock = static_cast<int>(socket(p->ai_family, p->ai_socktype, p->ai_protocol));
-        if (sock == MTC_INVALID_SOCKET) {
-            lastErr = std::string("socket 创建失败: ") + strerror(errno);
-            continue;
-        }
-        if (connect(sock, p->ai_addr, p->ai_addrlen) == 0) {
-            break;  // 连接成功
-        }
-        lastErr = std::string(strerror(errno));  // 记录原因（如 Operation not permitted）
-#ifdef _WIN32
-        closesocket(sock);
-#else
-        close(sock);
-#endif
-        sock = MTC_INVALID_SOCKET;
+template <typename Fn>
+auto SshClient::DrivePtr(Fn fn) -> decltype(fn()) {
+    auto* session = reinterpret_cast<LIBSSH2_SESSION*>(m_session);
+    auto ptr = fn();
+    while (!ptr && libssh2_session_last_errno(session) == LIBSSH2_ERROR_EAGAIN && WaitSocket()) {
+        ptr = fn();
     }
-    freeaddrinfo(res);
+    return ptr;
+}
 
-    if (sock == MTC_INVALID_SOCKET) {
-        err = "连接 " + host + ":" + portStr + " 失败 (" + lastErr + ")";
-        return false;
-    }
+std::string SshClient::PasswordKey(const std::string& credId) {
+    return "mtc:cred:" + credId + ":password";
+}
 
-    outSock = sock;
-    return true;
+std::string SshClient::PassphraseKey(const std::string& credId) {
+    return "mtc:cred:" + credId + ":passphrase";
 }
 
 bool SshClient::Connect(const SshHost& host, const Credential& cred) {
     Close();
+    m_aborted = false;
+    m_lastError.clear();
 
-    // 1. TCP 连接
+    // 1. TCP 连接（各地址族并行竞速）
+    SocketConnector::Options connectOptions;
+    connectOptions.timeoutSec = host.connectTimeoutSec;
+    connectOptions.cancel = m_cancelFlag;
     std::string sockErr;
-    if (!CreateConnectedSocket(host.host, host.port, m_socket, sockErr)) {
+    if (!SocketConnector::Connect(host.host, host.port, connectOptions, m_socket, sockErr)) {
         SetLastError(sockErr);
         return false;
     }
@@ -120,10 +151,10 @@ bool SshClient::Connect(const SshHost& host, const Credential& cred) {
         return false;
     }
     m_session = session;
-    libssh2_session_set_blocking(session, 1);
+    libssh2_session_set_blocking(session, 0);
 
     // 3. 握手
-    int rc = libssh2_session_handshake(session, m_socket);
+    int rc = Drive([&] { return libssh2_session_handshake(session, m_socket); });
     if (rc != 0) {
         char* errmsg = nullptr;
         int errlen = 0;
@@ -140,7 +171,9 @@ bool SshClient::Connect(const SshHost& host, const Credential& cred) {
     if (cred.type == CredentialType::Password) {
         std::string password;
         if (SecretStore::Get(PasswordKey(cred.id), password)) {
-            authed = libssh2_userauth_password(session, username, password.c_str()) == 0;
+            authed = Drive([&] {
+                return libssh2_userauth_password(session, username, password.c_str());
+            }) == 0;
             if (!authed) SetLastError("密码认证失败（用户名或密码错误）");
         } else {
             SetLastError("未在钥匙串中找到密码，请在凭据管理中重新填写");
@@ -149,11 +182,13 @@ bool SshClient::Connect(const SshHost& host, const Credential& cred) {
         std::string passphrase;
         SecretStore::Get(PassphraseKey(cred.id), passphrase);  // 口令可空
         const char* passphrasePtr = passphrase.empty() ? nullptr : passphrase.c_str();
-        rc = libssh2_userauth_publickey_fromfile(
-            session, username,
-            nullptr,                        // publicKey 自动从私钥推导
-            cred.keyPath.c_str(),
-            passphrasePtr);
+        rc = Drive([&] {
+            return libssh2_userauth_publickey_fromfile(
+                session, username,
+                nullptr,                    // publicKey 自动从私钥推导
+                cred.keyPath.c_str(),
+                passphrasePtr);
+        });
         authed = rc == 0;
         if (!authed) {
             char* errmsg = nullptr;
@@ -164,13 +199,13 @@ bool SshClient::Connect(const SshHost& host, const Credential& cred) {
     } else {  // SshAgent
         LIBSSH2_AGENT* agent = libssh2_agent_init(session);
         if (agent) {
-            if (libssh2_agent_connect(agent) == 0 &&
-                libssh2_agent_list_identities(agent) == 0) {
+            if (Drive([&] { return libssh2_agent_connect(agent); }) == 0 &&
+                Drive([&] { return libssh2_agent_list_identities(agent); }) == 0) {
                 struct libssh2_agent_publickey* identity = nullptr;
                 struct libssh2_agent_publickey* prev = nullptr;
                 int arc = 0;
                 while (libssh2_agent_get_identity(agent, &identity, prev) == 0) {
-                    arc = libssh2_agent_userauth(agent, username, identity);
+                    arc = Drive([&] { return libssh2_agent_userauth(agent, username, identity); });
                     if (arc == 0) { authed = true; break; }
                     prev = identity;
                 }
@@ -186,120 +221,378 @@ bool SshClient::Connect(const SshHost& host, const Credential& cred) {
         return false;
     }
 
+    // 空闲时由 Ping 按间隔发 keepalive，防止被服务器或中间的 NAT 断开
+    libssh2_keepalive_config(session, 1, kKeepaliveIntervalSec);
+
     m_connected = true;
     return true;
 }
 
-std::vector<SshClient::RemoteEntry> SshClient::ListDir(const std::string& remotePath) {
-    std::vector<RemoteEntry> result;
+bool SshClient::Ping() {
     if (!m_connected) {
-        SetLastError("未连接");
-        return result;
+        return false;
     }
 
-    LIBSSH2_SFTP* sftp = libssh2_sftp_init(reinterpret_cast<LIBSSH2_SESSION*>(m_session));
-    if (!sftp) {
-        SetLastError("初始化 SFTP 失败");
-        return result;
+    // socket 可读却读不到数据 = 对端已关闭；有数据时留给 libssh2 之后处理
+    // 用 poll 而非 select：描述符号不受 FD_SETSIZE 限制（进程打开的文件多时 socket 可能超过 1024）
+    mtc_pollfd pfd = {};
+    pfd.fd = m_socket;
+    pfd.events = POLLIN;
+    int ready = MTC_POLL(&pfd, 1, 0);
+    bool alive = ready >= 0;
+    if (alive && ready > 0) {
+        char probe;
+        alive = recv(m_socket, &probe, 1, MSG_PEEK) > 0;
+    }
+
+    // 非阻塞模式下发送缓冲满时返回 EAGAIN，包会在下次 I/O 时发出，不算断开
+    int nextSeconds = 0;
+    if (alive) {
+        int rc = libssh2_keepalive_send(reinterpret_cast<LIBSSH2_SESSION*>(m_session), &nextSeconds);
+        alive = rc == 0 || rc == LIBSSH2_ERROR_EAGAIN;
     }
 
-    LIBSSH2_SFTP_HANDLE* handle = libssh2_sftp_opendir(sftp, remotePath.c_str());
+    if (!alive) {
+        SetLastError("连接已断开");
+        m_connected = false;    // 不再向断开的连接发 disconnect
+        Close();
+    }
+    return alive;
+}
+
+namespace {
+SshClient::RemoteEntry EntryFromAttributes(const std::string& name, const LIBSSH2_SFTP_ATTRIBUTES& attrs) {
+    SshClient::RemoteEntry e;
+    e.name = name;
+    if (attrs.flags & LIBSSH2_SFTP_ATTR_PERMISSIONS) {
+        e.isDir = LIBSSH2_SFTP_S_ISDIR(attrs.permissions);
+        e.isLink = LIBSSH2_SFTP_S_ISLNK(attrs.permissions);
+        e.permissions = static_cast<uint32_t>(attrs.permissions & 07777);
+    }
+    e.size = (attrs.flags & LIBSSH2_SFTP_ATTR_SIZE) ? attrs.filesize : 0;
+    e.mtime = (attrs.flags & LIBSSH2_SFTP_ATTR_ACMODTIME) ? attrs.mtime : 0;
+    return e;
+}
+}  // namespace
+
+std::vector<SshClient::RemoteEntry> SshClient::ListDir(const std::string& remotePath, RemoteEntry* self) {
+    std::vector<RemoteEntry> result;
+    ListDirStreaming(remotePath, 1024, [&result](const std::vector<RemoteEntry>& batch) {
+        result.insert(result.end(), batch.begin(), batch.end());
+        return true;
+    }, self);
+    RemoteListing::Sort(result);
+    return result;
+}
+
+bool SshClient::ListDirStreaming(const std::string& remotePath, size_t batchSize,
+                                 const std::function<bool(const std::vector<RemoteEntry>&)>& onBatch,
+                                 RemoteEntry* self) {
+    if (self) *self = RemoteEntry();
+    m_lastError.clear();    // 会话可能来自会话池，不沿用上一个使用者的错误
+    if (!m_connected) {
+        SetLastError("未连接");
+        return false;
+    }
+
+    auto* handle = static_cast<LIBSSH2_SFTP_HANDLE*>(OpenSftpHandle(remotePath, true));
     if (!handle) {
-        char* errmsg = nullptr;
-        int errlen = 0;
-        libssh2_session_last_error(reinterpret_cast<LIBSSH2_SESSION*>(m_session),
-                                   &errmsg, &errlen, 0);
-        SetLastError(std::string("打开目录失败: ") + (errmsg ? errmsg : remotePath));
-        libssh2_sftp_shutdown(sftp);
-        return result;
+        if (m_lastError.empty()) {
+            SetLastError("打开目录失败: " + SessionError());
+        }
+        return false;
     }
 
+    // libssh2 每次只交出一项，但底层一次 READDIR 应答带回多项，攒批不增加往返
+    batchSize = std::max<size_t>(batchSize, 1);
+    std::vector<RemoteEntry> batch;
+    batch.reserve(batchSize);
     char namebuf[512];
     LIBSSH2_SFTP_ATTRIBUTES attrs;
     int rc = 0;
-    while ((rc = libssh2_sftp_readdir(handle, namebuf, sizeof(namebuf), &attrs)) > 0) {
+    bool wanted = true;
+    while ((rc = Drive([&] { return libssh2_sftp_readdir(handle, namebuf, sizeof(namebuf), &attrs); })) > 0) {
         std::string name(namebuf, static_cast<size_t>(rc));
+        if (name == "." && self) {
+            *self = EntryFromAttributes(std::string(), attrs);
+        }
         if (name == "." || name == "..") continue;
-
-        RemoteEntry e;
-        e.name = name;
-        e.isDir = (attrs.flags & LIBSSH2_SFTP_ATTR_PERMISSIONS)
-                  ? LIBSSH2_SFTP_S_ISDIR(attrs.permissions) : false;
-        e.size = (attrs.flags & LIBSSH2_SFTP_ATTR_SIZE) ? attrs.filesize : 0;
-        e.mtime = (attrs.flags & LIBSSH2_SFTP_ATTR_ACMODTIME) ? attrs.mtime : 0;
-        result.push_back(e);
+        batch.push_back(EntryFromAttributes(name, attrs));
+        if (batch.size() >= batchSize) {
+            wanted = onBatch(batch);
+            batch.clear();
+            if (!wanted) break;
+        }
+    }
+    if (wanted && !batch.empty()) {
+        onBatch(batch);
     }
 
-    libssh2_sftp_closedir(handle);
-    libssh2_sftp_shutdown(sftp);
+    Drive([&] { return libssh2_sftp_closedir(handle); });
 
     if (rc < 0) {
         SetLastError("读取目录内容失败");
+        return false;
     }
-
-    // 目录在前、文件在后，各自按名称排序
-    std::sort(result.begin(), result.end(), [](const RemoteEntry& a, const RemoteEntry& b) {
-        if (a.isDir != b.isDir) return a.isDir;
-        // 大小写不敏感比较
-        std::string al = a.name, bl = b.name;
-        std::transform(al.begin(), al.end(), al.begin(), ::tolower);
-        std::transform(bl.begin(), bl.end(), bl.begin(), ::tolower);
-        return al < bl;
-    });
-
-    return result;
+    return true;
 }
 
-bool SshClient::DownloadFile(const std::string& remotePath, const std::string& localPath) {
+bool SshClient::Stat(const std::string& remotePath, RemoteEntry& out) {
+    m_lastError.clear();
     if (!m_connected) {
         SetLastError("未连接");
         return false;
     }
-
-    LIBSSH2_SFTP* sftp = libssh2_sftp_init(reinterpret_cast<LIBSSH2_SESSION*>(m_session));
+    auto* sftp = static_cast<LIBSSH2_SFTP*>(Sftp());
     if (!sftp) {
-        SetLastError("初始化 SFTP 失败");
         return false;
     }
+    LIBSSH2_SFTP_ATTRIBUTES attrs;
+    int rc = Drive([&] {
+        return libssh2_sftp_stat_ex(sftp, remotePath.c_str(), static_cast<unsigned int>(remotePath.size()),
+                                    LIBSSH2_SFTP_STAT, &attrs);
+    });
+    if (rc != 0) {
+        SetLastError("读取属性失败: " + remotePath);
+        return false;
+    }
+    out = EntryFromAttributes(std::string(), attrs);
+    return true;
+}
 
-    LIBSSH2_SFTP_HANDLE* handle = libssh2_sftp_open(sftp, remotePath.c_str(),
-                                                    LIBSSH2_FXF_READ, 0);
+bool SshClient::DownloadFile(const std::string& remotePath, const std::string& localPath,
+                             const SftpDownloadOptions& options) {
+    m_lastError.clear();
+    if (!m_connected) {
+        SetLastError("未连接");
+        return false;
+    }
+
+    auto* handle = static_cast<LIBSSH2_SFTP_HANDLE*>(OpenSftpHandle(remotePath, false));
     if (!handle) {
-        SetLastError("打开远程文件失败: " + remotePath);
-        libssh2_sftp_shutdown(sftp);
+        if (m_lastError.empty()) {
+            SetLastError("打开远程文件失败: " + remotePath);
+        }
         return false;
     }
 
-    std::ofstream out(localPath, std::ios::binary);
-    if (!out.is_open()) {
-        SetLastError("写入本地文件失败: " + localPath);
-        libssh2_sftp_close_handle(handle);
-        libssh2_sftp_shutdown(sftp);
+    uint64_t total = 0;
+    PartialDownloadState remoteState;
+    remoteState.remotePath = remotePath;
+    LIBSSH2_SFTP_ATTRIBUTES attrs;
+    if (Drive([&] { return libssh2_sftp_fstat(handle, &attrs); }) == 0) {
+        if (attrs.flags & LIBSSH2_SFTP_ATTR_SIZE) total = attrs.filesize;
+        if (attrs.flags & LIBSSH2_SFTP_ATTR_ACMODTIME) remoteState.remoteMtime = attrs.mtime;
+    }
+    remoteState.remoteSize = total;
+
+    // 续传要能确认远程文件没变，拿不到大小时只能从头下载
+    const bool resume = options.resume && total > 0;
+    const std::filesystem::path target(localPath);
+    uint64_t offset = 0;
+    if (resume) {
+        offset = PartialDownload::ResumeOffset(target, remoteState);
+        if (offset > 0 && !VerifyPartialTail(handle, target, offset, options.verifyTailBytes)) {
+            PartialDownload::Truncate(target, 0);
+            offset = 0;
+        }
+        // 校验读过尾部后句柄位置已变，统一重新定位（丢弃 libssh2 的预读）
+        libssh2_sftp_seek64(handle, offset);
+    }
+
+    std::string error;
+    AsyncFileWriter writer(options.writeQueueBlocks);
+    const std::string writePath = resume ? PartialDownload::PartPath(target).string() : localPath;
+    if (!writer.Open(writePath, offset > 0, &error)) {
+        SetLastError(error);
+        Drive([&] { return libssh2_sftp_close_handle(handle); });
         return false;
     }
+    if (resume) {
+        // 先落下记录：进程中途退出时部分文件也能被认出来
+        remoteState.bytesDone = offset;
+        PartialDownload::SaveState(target, remoteState);
+    }
 
-    char buf[32 * 1024];
+    // 每次都以完整的 scratch 缓冲调用 libssh2_sftp_read，保持预读窗口不缩小；
+    // 读到的数据攒满一块再交给写线程
+    const size_t blockSize = std::max<size_t>(options.readBufferSize, 32 * 1024);
+    std::vector<char> scratch(blockSize);
+    std::vector<char> block = writer.AcquireBuffer(blockSize);
+    size_t filled = 0;
+    uint64_t done = offset;
     ssize_t n = 0;
     bool ok = true;
-    while ((n = libssh2_sftp_read(handle, buf, sizeof(buf))) > 0) {
-        out.write(buf, static_cast<std::streamsize>(n));
-        if (!out) { ok = false; SetLastError("写入本地文件中断"); break; }
+    while ((n = Drive([&] { return libssh2_sftp_read(handle, scratch.data(), scratch.size()); })) > 0) {
+        size_t pos = 0;
+        while (pos < static_cast<size_t>(n)) {
+            size_t count = std::min(static_cast<size_t>(n) - pos, blockSize - filled);
+            std::memcpy(block.data() + filled, scratch.data() + pos, count);
+            filled += count;
+            pos += count;
+            if (filled == blockSize) {
+                ok = writer.Write(std::move(block), filled);
+                block = writer.AcquireBuffer(blockSize);
+                filled = 0;
+                if (!ok) break;
+            }
+        }
+        done += static_cast<uint64_t>(n);
+        if (!ok) break;
+        if (options.progress && !options.progress(done, total)) {
+            ok = false;
+            SetLastError("下载已取消");
+            break;
+        }
+    }
+    if (ok && n < 0) { ok = false; SetLastError("读取远程文件中断: " + SessionError()); }
+    if (ok && filled > 0) {
+        ok = writer.Write(std::move(block), filled);
     }
-    if (n < 0) { ok = false; SetLastError("读取远程文件中断"); }
+    if (!writer.Finish(&error) && m_lastError.empty()) {
+        ok = false;
+        SetLastError(error);
+    }
+    Drive([&] { return libssh2_sftp_close_handle(handle); });
 
-    out.close();
-    libssh2_sftp_close_handle(handle);
-    libssh2_sftp_shutdown(sftp);
+    if (resume) {
+        if (ok) {
+            if (!PartialDownload::Commit(target, &error)) {
+                SetLastError(error);
+                return false;
+            }
+        } else {
+            // 写线程按顺序落盘，已写入的字节就是连续的前缀，下次从这里继续
+            remoteState.bytesDone = offset + writer.BytesWritten();
+            PartialDownload::SaveState(target, remoteState);
+        }
+    }
     return ok;
 }
 
+bool SshClient::VerifyPartialTail(void* handle, const std::filesystem::path& target,
+                                  uint64_t offset, size_t tailBytes) {
+    auto* sftpHandle = static_cast<LIBSSH2_SFTP_HANDLE*>(handle);
+    const size_t count = static_cast<size_t>(std::min<uint64_t>(tailBytes, offset));
+    if (count == 0) {
+        return true;
+    }
+
+    std::vector<char> local(count);
+    std::ifstream in(PartialDownload::PartPath(target), std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(offset - count));
+    if (!in.read(local.data(), static_cast<std::streamsize>(count))) {
+        return false;
+    }
+
+    // OpenSSH 的 sftp-server 不支持服务器端校验和扩展，只能把这一段读回来直接比较
+    std::vector<char> remote(count);
+    libssh2_sftp_seek64(sftpHandle, offset - count);
+    size_t got = 0;
+    while (got < count) {
+        ssize_t n = Drive([&] { return libssh2_sftp_read(sftpHandle, remote.data() + got, count - got); });
+        if (n <= 0) {
+            return false;
+        }
+        got += static_cast<size_t>(n);
+    }
+    return std::memcmp(local.data(), remote.data(), count) == 0;
+}
+
+std::string SshClient::SessionError() const {
+    char* errmsg = nullptr;
+    int errlen = 0;
+    libssh2_session_last_error(reinterpret_cast<LIBSSH2_SESSION*>(m_session), &errmsg, &errlen, 0);
+    return errmsg && errlen > 0 ? std::string(errmsg, static_cast<size_t>(errlen)) : "未知错误";
+}
+
+void* SshClient::Sftp() {
+    if (!m_sftp) {
+        auto* session = reinterpret_cast<LIBSSH2_SESSION*>(m_session);
+        m_sftp = DrivePtr([&] { return libssh2_sftp_init(session); });
+        if (!m_sftp) {
+            SetLastError("初始化 SFTP 失败: " + SessionError());
+        }
+    }
+    return m_sftp;
+}
+
+void SshClient::ResetSftp() {
+    if (m_sftp) {
+        auto* sftp = static_cast<LIBSSH2_SFTP*>(m_sftp);
+        // 被取消或超时打断时返回 EAGAIN，SFTP 会话还没释放，留给 Close 在关掉 socket 后释放
+        if (Drive([&] { return libssh2_sftp_shutdown(sftp); }) != LIBSSH2_ERROR_EAGAIN) {
+            m_sftp = nullptr;
+        }
+    }
+}
+
+void* SshClient::OpenSftpHandle(const std::string& remotePath, bool directory) {
+    // 子系统通道可能被服务器关掉（如 sftp-server 崩溃或空闲超时），此时重开一次
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        auto* sftp = static_cast<LIBSSH2_SFTP*>(Sftp());
+        if (!sftp) {
+            return nullptr;
+        }
+        LIBSSH2_SFTP_HANDLE* handle = DrivePtr([&] {
+            return directory
+                ? libssh2_sftp_opendir(sftp, remotePath.c_str())
+                : libssh2_sftp_open(sftp, remotePath.c_str(), LIBSSH2_FXF_READ, 0);
+        });
+        if (handle) {
+            return handle;
+        }
+        if (m_aborted) {
+            return nullptr;
+        }
+        if (libssh2_session_last_errno(reinterpret_cast<LIBSSH2_SESSION*>(m_session)) ==
+            LIBSSH2_ERROR_SFTP_PROTOCOL) {
+            // 服务器给出了状态码：路径不存在、无权限等，重试也没用
+            SetLastError(std::string(directory ? "打开目录失败: " : "打开远程文件失败: ") +
+                         remotePath + " (SFTP 状态 " +
+                         std::to_string(libssh2_sftp_last_error(sftp)) + ")");
+            return nullptr;
+        }
+        ResetSftp();
+    }
+    return nullptr;
+}
+
+void SshClient::Abort() {
+    // 不再视为已连接：Close 跳过经网络的 SFTP 关闭与 disconnect，关掉 socket 后在本地释放
+    m_connected = false;
+    Close();
+}
+
 void SshClient::Close() {
+    if (m_connected) {
+        ResetSftp();
+    }
     if (m_session) {
         LIBSSH2_SESSION* session = reinterpret_cast<LIBSSH2_SESSION*>(m_session);
         if (m_connected) {
-            libssh2_session_disconnect(session, "MTC normal shutdown");
+            Drive([&] { return libssh2_session_disconnect(session, "MTC normal shutdown"); });
+        }
+        // 释放前先关掉 socket 的收发。非阻塞会话里还开着通道时（取消、超时后连接停在协议中途，
+        // 上面没有经网络关闭 SFTP），libssh2_sftp_shutdown / libssh2_session_free 要先发关闭通道的包，
+        // 发不出去就返回 EAGAIN 且什么也不释放。socket 关掉后发送立即出错，通道与缓冲区在本地释放
+        if (m_socket != -1) {
+#ifdef _WIN32
+            shutdown(m_socket, SD_BOTH);
+#else
+            shutdown(m_socket, SHUT_RDWR);
+#endif
+        }
+        if (m_sftp) {
+            libssh2_sftp_shutdown(static_cast<LIBSSH2_SFTP*>(m_sftp));
+            m_sftp = nullptr;
+        }
+        // socket 已关，不应再有 EAGAIN；万一有，重试几次而不是直接丢下会话
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            if (libssh2_session_free(session) != LIBSSH2_ERROR_EAGAIN) {
+                break;
+            }
         }
-        libssh2_session_free(session);
         m_session = nullptr;
     }
     if (m_socket != -1) {
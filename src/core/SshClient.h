@@ -1,11 +1,37 @@
 #pragma once
 #include "Types.h"
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <filesystem>
+#include <functional>
 #include <string>
 #include <vector>
 
+// SshClient::DownloadFile 的传输参数
+struct SftpDownloadOptions {
+    // 每次 libssh2_sftp_read 的缓冲大小。libssh2 按缓冲大小预先发出多个读请求
+    // （每个约 30 KB，在途总量为缓冲的数倍），缓冲越大在途请求越多，
+    // 高延迟链路上的吞吐越接近带宽（单请求时只有 块大小 / RTT）。
+    size_t readBufferSize = 1024 * 1024;
+    // 等待写盘的块数上限（每块 readBufferSize）；写盘在后台线程按顺序进行
+    size_t writeQueueBlocks = 8;
+    // 进度（已下载字节, 总字节；总大小未知时为 0），返回 false 取消下载。
+    // 续传时已下载字节包含之前完成的部分
+    std::function<bool(uint64_t, uint64_t)> progress;
+    // 可续传：先写 <本地路径>.part，中断后保留，下次从断点继续（见 PartialDownload）。
+    // 远程文件的大小或修改时间变了则从头下载
+    bool resume = false;
+    // 续传前比对部分文件末尾这么多字节与远程对应位置的内容，不一致则从头下载；0 不校验
+    size_t verifyTailBytes = 64 * 1024;
+};
+
 // SSH/SFTP 客户端（封装 libssh2），仅用于远程文件浏览/下载。
 // 远程终端会话不经此类，直接由 TerminalLauncher 走外部 ssh 命令。
+// SFTP 子系统在会话内只打开一次，之后的列目录、下载都复用它。
+// 会话工作在非阻塞模式：libssh2 返回 EAGAIN 时在 poll() 上等 socket 就绪，
+// 等待期间可经取消标志打断，长时间没有任何网络进展时按超时失败。
+// 各操作对调用线程仍是同步的；不想阻塞界面线程时经 SshWorker 在专用线程上执行。
 class SshClient {
 public:
     SshClient();
@@ -20,29 +46,83 @@ public:
 
     bool IsConnected() const { return m_connected; }
 
-    // 列出远程目录。RemoteEntry.name 仅含文件名（不含路径）。
+    // 取消标志由调用方持有，可在任意线程置位：之后的网络等待立即失败（"操作已取消"），
+    // 会话停在协议中途不能再用，随之视为已断开。传 nullptr 解除。
+    void SetCancelFlag(const std::atomic<bool>* flag) { m_cancelFlag = flag; }
+
+    // 连接健康检查：对端未关闭 socket，且按需发出的 keepalive 写得出去。
+    // 失败时连接视为已断开（IsConnected() 变为 false）。
+    bool Ping();
+
+    // 列出远程目录（按 RemoteListing 的显示顺序排好）。RemoteEntry.name 仅含文件名（不含路径）。
     struct RemoteEntry {
         std::string name;
         bool isDir = false;
+        bool isLink = false;    // 符号链接（isDir 为 false，指向的类型未知）
         uint64_t size = 0;
         int64_t mtime = 0;  // Unix 时间戳（秒）
+        uint32_t permissions = 0;   // 权限位（rwx 等，不含文件类型）；服务器未给出时为 0
     };
-    std::vector<RemoteEntry> ListDir(const std::string& remotePath);
+    // self 非空时填入目录自身的属性（取自服务器返回的 "." 项，没有时 mtime 为 0），
+    // 与列表出自同一次读取，供缓存按修改时间判断目录是否变过
+    std::vector<RemoteEntry> ListDir(const std::string& remotePath, RemoteEntry* self = nullptr);
 
-    // 下载远程文件到本地路径。
-    bool DownloadFile(const std::string& remotePath, const std::string& localPath);
+    // 流式列目录：条目按服务器返回的顺序（未排序），每攒够 batchSize 个交给 onBatch 一次，
+    // 最后不足一批的在结束前交出。大目录不必等全部读完就能开始显示。
+    // 读取中途出错时已交出的批次仍有效，返回 false。
+    // onBatch 返回 false 时不再往下读：关闭目录句柄后返回 true，会话照常可用。
+    bool ListDirStreaming(const std::string& remotePath, size_t batchSize,
+                          const std::function<bool(const std::vector<RemoteEntry>&)>& onBatch,
+                          RemoteEntry* self = nullptr);
+
+    // 取远程路径的属性（跟随符号链接）。name 为空。
+    bool Stat(const std::string& remotePath, RemoteEntry& out);
+
+    // 下载远程文件到本地路径（网络读取与写盘流水线进行，见 SftpDownloadOptions）。
+    // 远程文件用同一句柄从头到尾顺序读取，续传时先 seek 到断点。
+    bool DownloadFile(const std::string& remotePath, const std::string& localPath,
+                      const SftpDownloadOptions& options = SftpDownloadOptions());
 
     void Close();
+    // 立即断开：先关掉 socket 的收发，不再经网络关闭 SFTP、发送 disconnect，只在本地释放。
+    // 对端无响应时 Close 最多要等 kIoTimeoutSec，退出程序时用这个
+    void Abort();
 
     const std::string& LastError() const { return m_lastError; }
 
 private:
     bool m_connected = false;
     void* m_session = nullptr;   // LIBSSH2_SESSION*
+    void* m_sftp = nullptr;      // LIBSSH2_SFTP*，整个会话共用一个，首次使用时打开
     int m_socket = -1;
     std::string m_lastError;
+    const std::atomic<bool>* m_cancelFlag = nullptr;
+    bool m_aborted = false;      // 等待被取消或超时打断，会话状态已不可信
+
+    static constexpr int kKeepaliveIntervalSec = 30;
+    // 一次等待中 socket 持续没有就绪的上限
+    static constexpr int kIoTimeoutSec = 60;
+    // poll 的单次等待时长，决定 Cancel 的响应延迟
+    static constexpr int kPollSliceMs = 100;
 
     void SetLastError(const std::string& msg);
+    // 按 libssh2 所需方向等 socket 就绪；被取消或超时时返回 false 并把会话标为中断
+    bool WaitSocket();
+    // 驱动一个非阻塞 libssh2 调用直到完成：返回码为 EAGAIN（或指针为空且错误为 EAGAIN）时等待后重试
+    template <typename Fn>
+    auto Drive(Fn fn) -> decltype(fn());
+    template <typename Fn>
+    auto DrivePtr(Fn fn) -> decltype(fn());
+    // 取 SFTP 子系统，未打开时打开；失败返回 nullptr
+    void* Sftp();
+    void ResetSftp();
+    // 打开远程文件 / 目录（LIBSSH2_SFTP_HANDLE*）。SFTP 通道已失效时重开一次再试；
+    // 服务器明确拒绝（不存在、无权限）时直接返回 nullptr
+    void* OpenSftpHandle(const std::string& remotePath, bool directory);
+    std::string SessionError() const;
+    // 比对部分文件 [offset - tailBytes, offset) 与远程同一段内容
+    bool VerifyPartialTail(void* handle, const std::filesystem::path& target,
+                           uint64_t offset, size_t tailBytes);
     static std::string PasswordKey(const std::string& credId);
     static std::string PassphraseKey(const std::string& credId);
 };
@@ -0,0 +1,184 @@
+#include "SshSessionPool.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace {
+struct IdleSession {
+    std::string key;
+    std::unique_ptr<SshClient> client;
+    std::chrono::steady_clock::time_point idleSince;
+};
+
+std::mutex g_mutex;
+std::vector<IdleSession> g_idle;     // 按归还先后排列，越靠后越新
+std::chrono::seconds g_idleTimeout = SshSessionPool::kDefaultIdleTimeout;
+uint64_t g_clearCount = 0;           // Clear 的次数：Maintain 检查期间被清空过就不再放回
+
+// 同一主机最多留 kMaxIdlePerKey 个，多余的从最早归还的开始移出（须持锁调用）
+void TrimKey(const std::string& key, std::vector<std::unique_ptr<SshClient>>& evicted) {
+    size_t count = std::count_if(g_idle.begin(), g_idle.end(),
+                                 [&key](const IdleSession& s) { return s.key == key; });
+    for (auto it = g_idle.begin(); count > SshSessionPool::kMaxIdlePerKey && it != g_idle.end();) {
+        if (it->key == key) {
+            evicted.push_back(std::move(it->client));
+            it = g_idle.erase(it);
+            --count;
+        } else {
+            ++it;
+        }
+    }
+}
+}  // namespace
+
+SshSessionPool::Lease::Lease(std::string key, std::unique_ptr<SshClient> client)
+    : m_key(std::move(key)), m_client(std::move(client)) {}
+
+SshSessionPool::Lease::~Lease() {
+    Release();
+}
+
+SshSessionPool::Lease& SshSessionPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        Release();
+        m_key = std::move(other.m_key);
+        m_client = std::move(other.m_client);
+    }
+    return *this;
+}
+
+void SshSessionPool::Lease::Release() {
+    if (m_client) {
+        SshSessionPool::Return(m_key, std::move(m_client));
+    }
+}
+
+std::string SshSessionPool::MakeKey(const SshHost& host, const Credential& cred) {
+    // '\n' 不会出现在这些字段里，用作分隔符
+    return host.host + "\n" + std::to_string(host.port) + "\n" + host.username + "\n" +
+           cred.id + "\n" + CredentialTypeToString(cred.type) + "\n" + cred.keyPath;
+}
+
+SshSessionPool::Lease SshSessionPool::Acquire(const SshHost& host, const Credential& cred,
+                                              std::string* errorMsg, const std::atomic<bool>* cancel) {
+    const std::string key = MakeKey(host, cred);
+
+    // 先取最近归还的空闲会话；健康检查在锁外做，断开的丢弃后继续找
+    while (true) {
+        std::unique_ptr<SshClient> client;
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            auto it = std::find_if(g_idle.rbegin(), g_idle.rend(),
+                                   [&key](const IdleSession& s) { return s.key == key; });
+            if (it == g_idle.rend()) {
+                break;
+            }
+            client = std::move(it->client);
+            g_idle.erase(std::next(it).base());
+        }
+        if (client->Ping()) {
+            client->SetCancelFlag(cancel);
+            return Lease(key, std::move(client));
+        }
+    }
+
+    auto client = std::make_unique<SshClient>();
+    client->SetCancelFlag(cancel);
+    if (!client->Connect(host, cred)) {
+        if (errorMsg) *errorMsg = client->LastError();
+        return Lease();
+    }
+    return Lease(key, std::move(client));
+}
+
+void SshSessionPool::Return(const std::string& key, std::unique_ptr<SshClient> client) {
+    if (!client->IsConnected()) {
+        return;
+    }
+    // 取消标志属于上一个使用者，可能随它一起销毁
+    client->SetCancelFlag(nullptr);
+    Adopt(key, std::move(client), std::chrono::steady_clock::now());
+}
+
+void SshSessionPool::Adopt(const std::string& key, std::unique_ptr<SshClient> client,
+                           std::chrono::steady_clock::time_point idleSince) {
+    std::vector<std::unique_ptr<SshClient>> evicted;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_idle.push_back({key, std::move(client), idleSince});
+        TrimKey(key, evicted);
+    }
+    // evicted 在锁外析构（disconnect 要走网络）
+}
+
+size_t SshSessionPool::Maintain(std::chrono::steady_clock::time_point now) {
+    std::vector<std::unique_ptr<SshClient>> closing;
+    std::vector<IdleSession> checking;
+    uint64_t clearCount = 0;
+    {
+        // 与 Acquire 一样把会话移出来，Ping 在锁外做：keepalive 写不出去时可能要等
+        std::lock_guard<std::mutex> lock(g_mutex);
+        clearCount = g_clearCount;
+        for (auto& session : g_idle) {
+            if (now - session.idleSince >= g_idleTimeout) {
+                closing.push_back(std::move(session.client));
+            } else {
+                checking.push_back(std::move(session));
+            }
+        }
+        g_idle.clear();
+    }
+
+    std::vector<IdleSession> alive;
+    for (auto& session : checking) {
+        if (session.client->Ping()) {
+            alive.push_back(std::move(session));
+        } else {
+            closing.push_back(std::move(session.client));
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (g_clearCount != clearCount) {
+            // 检查期间池被清空（程序退出）：不再放回，就地断开
+            for (auto& session : alive) {
+                session.client->Abort();
+            }
+            return closing.size() + alive.size();
+        }
+        // 放回的会话比检查期间新归还的都早，排在前面；同一主机因此超出上限的，关掉最早的
+        g_idle.insert(g_idle.begin(), std::make_move_iterator(alive.begin()),
+                      std::make_move_iterator(alive.end()));
+        for (const auto& session : alive) {
+            TrimKey(session.key, closing);
+        }
+    }
+    return closing.size();
+}
+
+void SshSessionPool::SetIdleTimeout(std::chrono::seconds timeout) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_idleTimeout = timeout;
+}
+
+void SshSessionPool::Clear() {
+    std::vector<IdleSession> closing;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        closing.swap(g_idle);
+        ++g_clearCount;
+    }
+    // 退出时不等对端应答：对端无响应时正常关闭每个会话都可能卡满 I/O 超时
+    for (auto& session : closing) {
+        session.client->Abort();
+    }
+}
+
+size_t SshSessionPool::IdleCount() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_idle.size();
+}
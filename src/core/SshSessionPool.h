@@ -0,0 +1,75 @@
+#pragma once
+#include "SshClient.h"
+#include "Types.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// 进程内共享的已认证 SSH 会话池
+//
+// 按 (主机地址/端口/用户名, 凭据) 分组保存用完归还的连接。再次打开同一主机的远程浏览器时
+// 直接取出空闲会话，省掉 TCP 连接、握手、认证以及钥匙串查询。
+//   - 取出前做健康检查（Ping），已断开的会话丢弃后重新连接；
+//   - Maintain 定期给空闲会话发 keepalive，并关闭空闲超时的会话；
+//   - 会话同一时刻只借给一个使用者（SshClient 不是线程安全的）。
+class SshSessionPool {
+public:
+    // 借出的会话；析构时自动归还（仍连接着才放回池中）。只能移动。
+    class Lease {
+    public:
+        Lease() = default;
+        ~Lease();
+        Lease(Lease&& other) noexcept = default;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        explicit operator bool() const { return m_client != nullptr; }
+        SshClient* operator->() const { return m_client.get(); }
+        SshClient& operator*() const { return *m_client; }
+
+        // 提前归还
+        void Release();
+
+    private:
+        friend class SshSessionPool;
+        Lease(std::string key, std::unique_ptr<SshClient> client);
+
+        std::string m_key;
+        std::unique_ptr<SshClient> m_client;
+    };
+
+    static constexpr std::chrono::seconds kDefaultIdleTimeout{300};
+    static constexpr size_t kMaxIdlePerKey = 2;
+
+    // 取一个已认证的会话：优先复用健康的空闲会话，否则新建连接（阻塞）。
+    // 失败返回空 Lease，errorMsg 为连接/认证错误。cancel 置位时中断正在进行的连接；
+    // 借出的会话沿用该取消标志，归还时解除。
+    static Lease Acquire(const SshHost& host, const Credential& cred, std::string* errorMsg = nullptr,
+                         const std::atomic<bool>* cancel = nullptr);
+
+    // 定时调用：关闭空闲超过超时时间的会话，其余发 keepalive，顺带剔除已断开的。
+    // 返回关闭的会话数。
+    static size_t Maintain(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+    static void SetIdleTimeout(std::chrono::seconds timeout);
+
+    // 断开并清空全部空闲会话（程序退出、libssh2_exit 之前调用）。
+    // 不经网络道别，先关 socket 再在本地释放，不会卡在无响应的连接上
+    static void Clear();
+
+    static size_t IdleCount();
+
+    // 分组键：主机地址、端口、用户名与凭据的 id / 类型 / 私钥路径。
+    // 主机或凭据被编辑后键随之改变，旧会话不会再被取到，由空闲超时回收。
+    static std::string MakeKey(const SshHost& host, const Credential& cred);
+
+    // 把会话直接放进空闲列表，不检查连接状态（测试用；Return 在检查后经此放回）
+    static void Adopt(const std::string& key, std::unique_ptr<SshClient> client,
+                      std::chrono::steady_clock::time_point idleSince = std::chrono::steady_clock::now());
+
+private:
+    static void Return(const std::string& key, std::unique_ptr<SshClient> client);
+};
@@ -0,0 +1,253 @@
+#include "SshWorker.h"
+#include "RemoteListing.h"
+#include <chrono>
+#include <memory>
+#include <utility>
+
+namespace {
+const char* const kCancelledMessage = "操作已取消";
+
+std::string JoinRemote(const std::string& dir, const std::string& name) {
+    if (dir.empty() || dir.back() == '/') return dir + name;
+    return dir + "/" + name;
+}
+
+// 回调里抛出的异常不能带走工作线程
+template <typename Result, typename Callback>
+void Complete(std::promise<Result>& promise, const Callback& done, const Result& result) {
+    if (done) {
+        try {
+            done(result);
+        } catch (...) {
+        }
+    }
+    promise.set_value(result);
+}
+}  // namespace
+
+SshWorker::SshWorker(const SshHost& host, const Credential& cred)
+    : m_host(host), m_cred(cred) {
+    m_thread = std::thread(&SshWorker::Run, this);
+}
+
+SshWorker::~SshWorker() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_generation;
+        m_stopping = true;
+        m_cancelCurrent = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+void SshWorker::Cancel() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_generation;
+    m_prefetch.clear();
+    m_cancelCurrent = true;
+}
+
+void SshWorker::Submit(std::function<void(SshClient*, const std::string&)> run) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(Job{m_generation, std::move(run)});
+    }
+    m_cv.notify_one();
+}
+
+void SshWorker::Run() {
+    while (true) {
+        Job job;
+        std::string prefetchPath;
+        bool cancelled = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stopping || !m_jobs.empty() || !m_prefetch.empty(); });
+            if (m_stopping && m_jobs.empty()) {
+                break;
+            }
+            if (!m_jobs.empty()) {
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+                // 与 Cancel 在同一把锁下判断：要么此处看到代数已变，要么 Cancel 之后置位的标志打断执行
+                cancelled = job.generation != m_generation;
+            } else {
+                prefetchPath = std::move(m_prefetch.front());
+                m_prefetch.pop_front();
+            }
+            if (!cancelled) {
+                m_cancelCurrent = false;
+            }
+        }
+        if (!job.run) {
+            Prefetch(prefetchPath);
+            continue;
+        }
+        if (cancelled) {
+            job.run(nullptr, kCancelledMessage);
+            continue;
+        }
+
+        std::string error;
+        SshClient* client = Session(error);
+        job.run(client, error);
+    }
+    // 退出前归还会话：被打断的已断开，会话池不会收下
+    m_lease.Release();
+}
+
+SshClient* SshWorker::Session(std::string& error) {
+    if (m_lease && m_lease->IsConnected()) {
+        return &*m_lease;
+    }
+    m_lease = SshSessionPool::Acquire(m_host, m_cred, &error, &m_cancelCurrent);
+    if (!m_lease) {
+        if (m_cancelCurrent) error = kCancelledMessage;
+        return nullptr;
+    }
+    return &*m_lease;
+}
+
+std::future<SshResult> SshWorker::Connect(ResultCallback done) {
+    auto promise = std::make_shared<std::promise<SshResult>>();
+    std::future<SshResult> future = promise->get_future();
+    Submit([promise, done = std::move(done)](SshClient* client, const std::string& error) {
+        SshResult result;
+        result.ok = client != nullptr;
+        result.error = error;
+        Complete(*promise, done, result);
+    });
+    return future;
+}
+
+std::future<SshListResult> SshWorker::ListDir(const std::string& remotePath, ListCallback done,
+                                              bool refresh, BatchCallback onBatch, StopFlag stop) {
+    auto promise = std::make_shared<std::promise<SshListResult>>();
+    std::future<SshListResult> future = promise->get_future();
+    Submit([this, promise, remotePath, refresh, done = std::move(done), onBatch = std::move(onBatch),
+            stop = std::move(stop)](SshClient* client, const std::string& error) {
+        SshListResult result;
+        if (stop && *stop) {
+            result.error = kCancelledMessage;
+        } else if (!client) {
+            result.error = error;
+        } else {
+            StopCheck stopCheck;
+            if (stop) {
+                stopCheck = [&stop](size_t) { return stop->load(); };
+            }
+            result = List(*client, remotePath, refresh, onBatch, stopCheck);
+            if (result.ok) {
+                SchedulePrefetch(remotePath, result.entries);
+            }
+            if (onBatch) {
+                result.entries.clear();
+            }
+        }
+        Complete(*promise, done, result);
+    });
+    return future;
+}
+
+SshListResult SshWorker::List(SshClient& client, const std::string& remotePath, bool refresh,
+                              const BatchCallback& onBatch, const StopCheck& stop, size_t batchSize) {
+    SshListResult result;
+    // 缓存命中时整份列表作为一批交出
+    auto deliverCached = [&result, &onBatch] {
+        result.ok = true;
+        result.cached = true;
+        if (onBatch) onBatch(result.entries);
+        return result;
+    };
+    const auto now = RemoteDirCache::Clock::now();
+    if (refresh) {
+        m_cache.Invalidate(remotePath);
+    } else {
+        switch (m_cache.Lookup(remotePath, now, &result.entries)) {
+            case RemoteDirCache::State::Fresh:
+                return deliverCached();
+            case RemoteDirCache::State::Stale: {
+                // 一次 stat 往返确认目录没变，比重新列出省掉打开、逐批读取与关闭
+                SshClient::RemoteEntry dir;
+                if (client.Stat(remotePath, dir) &&
+                    m_cache.Revalidate(remotePath, dir.mtime, now, &result.entries)) {
+                    return deliverCached();
+                }
+                break;
+            }
+            case RemoteDirCache::State::Missing:
+                break;
+        }
+    }
+
+    SshClient::RemoteEntry self;
+    bool stopped = false;
+    // 取开始列的时刻：列的过程中发生的修改也算作与列表同时
+    const int64_t listedAt = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    client.ListDirStreaming(remotePath, batchSize, [&](const std::vector<SshClient::RemoteEntry>& batch) {
+        result.entries.insert(result.entries.end(), batch.begin(), batch.end());
+        if (onBatch) onBatch(batch);
+        stopped = stop && stop(result.entries.size());
+        return !stopped;
+    }, &self);
+    RemoteListing::Sort(result.entries);
+    result.error = client.LastError();
+    if (stopped && result.error.empty()) {
+        result.error = kCancelledMessage;
+    }
+    result.ok = result.error.empty();
+    if (result.ok) {
+        m_cache.Store(remotePath, self.mtime, listedAt, result.entries, now);
+    }
+    return result;
+}
+
+void SshWorker::SchedulePrefetch(const std::string& dir, const std::vector<SshClient::RemoteEntry>& entries) {
+    std::vector<std::string> paths;
+    const auto now = RemoteDirCache::Clock::now();
+    for (const auto& entry : entries) {
+        if (paths.size() >= kMaxPrefetch) break;
+        if (!entry.isDir || entry.isLink) continue;
+        std::string path = JoinRemote(dir, entry.name);
+        if (m_cache.Lookup(path, now) != RemoteDirCache::State::Fresh) {
+            paths.push_back(std::move(path));
+        }
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_prefetch.assign(paths.begin(), paths.end());
+}
+
+void SshWorker::Prefetch(const std::string& remotePath) {
+    // 预取不为自己建连接；失败（无权限等）不报告，进入时再正常列出
+    if (!m_lease || !m_lease->IsConnected()) {
+        return;
+    }
+    if (m_cache.Lookup(remotePath, RemoteDirCache::Clock::now()) == RemoteDirCache::State::Fresh) {
+        return;
+    }
+    // 有操作提交（或要退出）就让路，停下的目录不再补；太大的目录读到上限即放弃
+    List(*m_lease, remotePath, false, nullptr, [this](size_t listed) {
+        if (listed > kMaxPrefetchEntries) return true;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stopping || !m_jobs.empty();
+    }, kPrefetchBatch);
+}
+
+std::future<SshResult> SshWorker::Download(const std::string& remotePath, const std::string& localPath,
+                                           SftpDownloadOptions options, ResultCallback done) {
+    auto promise = std::make_shared<std::promise<SshResult>>();
+    std::future<SshResult> future = promise->get_future();
+    Submit([promise, remotePath, localPath, options = std::move(options),
+            done = std::move(done)](SshClient* client, const std::string& error) {
+        SshResult result;
+        if (!client) {
+            result.error = error;
+        } else {
+            result.ok = client->DownloadFile(remotePath, localPath, options);
+            result.error = client->LastError();
+        }
+        Complete(*promise, done, result);
+    });
+    return future;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include "RemoteDirCache.h"
+#include "SshClient.h"
+#include "SshSessionPool.h"
+#include "Types.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// SshWorker 操作的结果
+struct SshResult {
+    bool ok = false;
+    std::string error;
+};
+
+struct SshListResult {
+    bool ok = false;
+    std::string error;
+    std::vector<SshClient::RemoteEntry> entries;
+    bool cached = false;        // 取自目录缓存（可能经 stat 确认未变）
+};
+
+// 在专用线程上执行一个远程主机的 SSH 操作
+//
+// 调用方（界面线程）提交 Connect / ListDir / Download 后立即返回，操作在工作线程上
+// 按提交顺序执行；结果经返回的 future 取得，或在完成回调中处理。回调在工作线程上调用，
+// 界面代码需自行转回界面线程（wxEvtHandler::CallAfter）。
+// 会话从 SshSessionPool 借用，断开（或被取消打断）后下一个操作自动重新借一个。
+//
+// 目录列表经 RemoteDirCache 缓存。每次列目录成功后，把其中前几个子目录排入预取队列，
+// 工作线程空闲时（没有提交的操作）在后台列出它们，进入子目录时多半直接命中缓存。
+// 预取按小批读取，每批之间看到有新提交的操作就停下让路；条目过多的目录不预取。
+class SshWorker {
+public:
+    using ResultCallback = std::function<void(const SshResult&)>;
+    using ListCallback = std::function<void(const SshListResult&)>;
+    using BatchCallback = std::function<void(const std::vector<SshClient::RemoteEntry>&)>;
+    // 单个列目录操作的停止标志，由提交方置位
+    using StopFlag = std::shared_ptr<std::atomic<bool>>;
+
+    SshWorker(const SshHost& host, const Credential& cred);
+    // 取消全部操作并等工作线程退出；会话归还会话池
+    ~SshWorker();
+
+    SshWorker(const SshWorker&) = delete;
+    SshWorker& operator=(const SshWorker&) = delete;
+
+    // 借到（或连上）会话即完成；之后的操作无需先调用它，只是便于单独报告连接错误
+    std::future<SshResult> Connect(ResultCallback done = nullptr);
+
+    // refresh 为 true 时跳过缓存，重新列出。
+    // onBatch 非空时为流式列目录：条目边读边分批交给 onBatch（工作线程上调用，批内未排序，
+    // 命中缓存时一次交出全部），结果里的 entries 留空，done 只报告结束与错误。
+    // stop 置位后只停这一个操作：排队中的不再执行，读取中的在下一批之间停下（关闭目录句柄，
+    // 会话保留给后面的操作），都以"操作已取消"完成
+    std::future<SshListResult> ListDir(const std::string& remotePath, ListCallback done = nullptr,
+                                       bool refresh = false, BatchCallback onBatch = nullptr,
+                                       StopFlag stop = nullptr);
+
+    // options.progress 在工作线程上调用
+    std::future<SshResult> Download(const std::string& remotePath, const std::string& localPath,
+                                    SftpDownloadOptions options = SftpDownloadOptions(),
+                                    ResultCallback done = nullptr);
+
+    // 取消此前提交的全部操作（连同预取）：排队中的不再执行，以"操作已取消"完成；
+    // 执行中的在下一次网络等待时被打断（会话随之作废，不归还会话池）
+    void Cancel();
+
+private:
+    struct Job {
+        uint64_t generation = 0;
+        // 参数为 nullptr 表示已取消，只需以取消结果完成
+        std::function<void(SshClient*, const std::string& error)> run;
+    };
+
+    SshHost m_host;
+    Credential m_cred;
+    SshSessionPool::Lease m_lease;          // 只在工作线程上使用
+    RemoteDirCache m_cache;                 // 只在工作线程上使用
+
+    static constexpr size_t kMaxPrefetch = 8;
+    static constexpr size_t kMaxPrefetchEntries = 2000;     // 超过的目录放弃预取，进入时再列
+    static constexpr size_t kListBatch = 1000;
+    static constexpr size_t kPrefetchBatch = 100;           // 约一次 READDIR 应答，让路延迟不超过一个往返
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Job> m_jobs;
+    std::deque<std::string> m_prefetch;     // 待预取的目录，只在 m_jobs 为空时处理
+    uint64_t m_generation = 0;              // Cancel 时递增，早于它提交的操作作废
+    bool m_stopping = false;
+    std::atomic<bool> m_cancelCurrent{false};
+    std::thread m_thread;
+
+    void Run();
+    // 参数为已读到的条目数，返回 true 时停止读取
+    using StopCheck = std::function<bool(size_t listed)>;
+
+    // 在工作线程上列目录：先查缓存（过期的 stat 确认），否则经网络列出并存入缓存。
+    // stop 在每批之间检查；中途停下的结果 ok 为 false，不进缓存，会话保留
+    SshListResult List(SshClient& client, const std::string& remotePath, bool refresh,
+                       const BatchCallback& onBatch = nullptr, const StopCheck& stop = nullptr,
+                       size_t batchSize = kListBatch);
+    // 把 dir 下的子目录排入预取队列（替换之前的队列）
+    void SchedulePrefetch(const std::string& dir, const std::vector<SshClient::RemoteEntry>& entries);
+    void Prefetch(const std::string& remotePath);
+    void Submit(std::function<void(SshClient*, const std::string&)> run);
+    // 取已连接的会话，必要时从会话池重新借；失败返回 nullptr 与原因
+    SshClient* Session(std::string& error);
+};
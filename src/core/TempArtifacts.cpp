@@ -0,0 +1,268 @@
+#include "TempArtifacts.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::mutex g_mutex;
+fs::path g_root;
+std::atomic<unsigned> g_counter{0};
+
+// 条目目录名里没有到期时间（手工放进来的文件等）时，按最后修改时间保留一天
+constexpr std::chrono::hours kUnknownEntryLifetime(24);
+// 旧版本的临时文件可能正被刚启动的终端读取，留出一段时间再删
+constexpr std::chrono::hours kLegacyMinAge(1);
+
+const char* const kLegacyPrefixes[] = {"mtc_init_", "mtc_startup_", "mtc_remote_"};
+
+int CurrentPid() {
+#ifdef _WIN32
+    return _getpid();
+#else
+    return static_cast<int>(getpid());
+#endif
+}
+
+fs::path DefaultRoot() {
+    std::error_code ec;
+    fs::path temp = fs::temp_directory_path(ec);
+    if (ec) return fs::path();
+#ifdef _WIN32
+    return temp / "MTC";
+#else
+    // 共享的 /tmp 里按用户区分，避免不同用户互相干扰
+    return temp / ("mtc-" + std::to_string(getuid()));
+#endif
+}
+
+// 条目目录名开头的到期时间（Unix 秒）；解析失败返回 false
+bool ParseExpiry(const std::string& name, long long& expiry) {
+    size_t dash = name.find('-');
+    if (dash == 0 || dash == std::string::npos) return false;
+    char* end = nullptr;
+    expiry = std::strtoll(name.c_str(), &end, 10);
+    return end == name.c_str() + dash;
+}
+
+std::string SanitizeFileName(const std::string& name) {
+    std::string fileName = name.empty() ? std::string("file") : name;
+    for (auto& c : fileName) {
+        if (c == '/' || c == '\\' || c == ':') c = '_';
+    }
+    if (fileName == "." || fileName == "..") fileName = "file";
+    return fileName;
+}
+
+long long ExpiryAfter(std::chrono::seconds lifetime) {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        (std::chrono::system_clock::now() + lifetime).time_since_epoch()).count();
+}
+
+// FNV-1a：跨进程、跨版本稳定，同一 key 每次得到同一个目录名
+std::string KeyHash(const std::string& key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+    return buf;
+}
+
+bool OwnedByCurrentUser(const fs::path& path) {
+#ifdef _WIN32
+    return true;
+#else
+    struct stat st {};
+    return lstat(path.c_str(), &st) == 0 && st.st_uid == getuid();
+#endif
+}
+
+} // namespace
+
+void TempArtifacts::SetRoot(const fs::path& root) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_root = root;
+}
+
+bool TempArtifacts::EnsurePrivateDirectory(const fs::path& root, std::string* errorMsg) {
+    std::error_code ec;
+#ifdef _WIN32
+    fs::create_directories(root, ec);
+    if (ec) {
+        if (errorMsg) *errorMsg = "无法创建临时目录 " + root.string() + ": " + ec.message();
+        return false;
+    }
+    return true;
+#else
+    fs::create_directories(root.parent_path(), ec);
+    if (mkdir(root.c_str(), 0700) != 0 && errno != EEXIST) {
+        if (errorMsg) *errorMsg = "无法创建临时目录 " + root.string();
+        return false;
+    }
+    struct stat st {};
+    if (lstat(root.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != getuid()) {
+        if (errorMsg) *errorMsg = "临时目录 " + root.string() + " 不属于当前用户";
+        return false;
+    }
+    if ((st.st_mode & 0077) != 0) {
+        chmod(root.c_str(), 0700);
+    }
+    return true;
+#endif
+}
+
+fs::path TempArtifacts::Root() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_root.empty()) {
+        g_root = DefaultRoot();
+    }
+    return g_root;
+}
+
+fs::path TempArtifacts::Allocate(const std::string& name, std::chrono::seconds lifetime,
+                                 std::string* errorMsg) {
+    fs::path root = Root();
+    if (root.empty()) {
+        if (errorMsg) *errorMsg = "无法确定系统临时目录";
+        return fs::path();
+    }
+    if (!EnsurePrivateDirectory(root, errorMsg)) {
+        return fs::path();
+    }
+
+    const std::string fileName = SanitizeFileName(name);
+    fs::path entry = root / (std::to_string(ExpiryAfter(lifetime)) + "-" + std::to_string(CurrentPid()) + "-" +
+                             std::to_string(g_counter.fetch_add(1)));
+    std::error_code ec;
+    if (!fs::create_directory(entry, ec)) {
+        if (errorMsg) *errorMsg = "无法创建临时目录 " + entry.string() + (ec ? ": " + ec.message() : "");
+        return fs::path();
+    }
+    return entry / fileName;
+}
+
+fs::path TempArtifacts::AllocateKeyed(const std::string& key, const std::string& name,
+                                      std::chrono::seconds lifetime, std::string* errorMsg) {
+    fs::path root = Root();
+    if (root.empty()) {
+        if (errorMsg) *errorMsg = "无法确定系统临时目录";
+        return fs::path();
+    }
+    if (!EnsurePrivateDirectory(root, errorMsg)) {
+        return fs::path();
+    }
+
+    const std::string suffix = "-k" + KeyHash(key);
+    const long long nowSeconds = ExpiryAfter(std::chrono::seconds(0));
+    fs::path entry = root / (std::to_string(ExpiryAfter(lifetime)) + suffix);
+
+    std::error_code ec;
+    for (fs::directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string dirName = it->path().filename().string();
+        long long oldExpiry = 0;
+        if (dirName.size() <= suffix.size() ||
+            dirName.compare(dirName.size() - suffix.size(), suffix.size(), suffix) != 0 ||
+            !ParseExpiry(dirName, oldExpiry) || oldExpiry <= nowSeconds) {
+            continue;
+        }
+        // 改名顺延到期时间；改不了（如文件正被打开）就按原名继续用
+        if (it->path() != entry) {
+            std::error_code renameEc;
+            fs::rename(it->path(), entry, renameEc);
+            if (renameEc) {
+                entry = it->path();
+            }
+        }
+        return entry / SanitizeFileName(name);
+    }
+
+    if (!fs::create_directory(entry, ec) && !fs::is_directory(entry)) {
+        if (errorMsg) *errorMsg = "无法创建临时目录 " + entry.string() + (ec ? ": " + ec.message() : "");
+        return fs::path();
+    }
+    return entry / SanitizeFileName(name);
+}
+
+size_t TempArtifacts::SweepExpired(std::chrono::system_clock::time_point now) {
+    fs::path root = Root();
+    std::error_code ec;
+    if (root.empty() || !fs::is_directory(root, ec)) {
+        return 0;
+    }
+
+    const long long nowSeconds = std::chrono::duration_cast<std::chrono::seconds>(
+        now.time_since_epoch()).count();
+    const auto fileNow = fs::file_time_type::clock::now();
+    size_t removed = 0;
+    for (fs::directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        long long expiry = 0;
+        bool expired;
+        if (ParseExpiry(it->path().filename().string(), expiry)) {
+            expired = expiry <= nowSeconds;
+        } else {
+            // 符号链接不是 Allocate 建的，直接删掉链接本身
+            std::error_code timeEc;
+            expired = it->is_symlink(timeEc) ||
+                      (fileNow - it->last_write_time(timeEc) > kUnknownEntryLifetime && !timeEc);
+        }
+        if (!expired) continue;
+        std::error_code removeEc;
+        if (fs::remove_all(it->path(), removeEc) > 0 && !removeEc) {
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+size_t TempArtifacts::SweepLegacy(const fs::path& dir, std::chrono::seconds minAge) {
+    std::error_code ec;
+    const auto now = fs::file_time_type::clock::now();
+    size_t removed = 0;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entryEc;
+        if (!it->is_regular_file(entryEc) || it->is_symlink(entryEc)) continue;
+
+        const std::string name = it->path().filename().string();
+        bool legacy = false;
+        for (const char* prefix : kLegacyPrefixes) {
+            if (name.rfind(prefix, 0) == 0) {
+                legacy = true;
+                break;
+            }
+        }
+        if (!legacy || !OwnedByCurrentUser(it->path())) continue;
+
+        auto mtime = it->last_write_time(entryEc);
+        if (entryEc || now - mtime < minAge) continue;
+        if (fs::remove(it->path(), entryEc)) {
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+size_t TempArtifacts::Sweep() {
+    size_t removed = SweepExpired();
+    std::error_code ec;
+    fs::path systemTemp = fs::temp_directory_path(ec);
+    if (!ec) {
+        removed += SweepLegacy(systemTemp, kLegacyMinAge);
+    }
+    return removed;
+}
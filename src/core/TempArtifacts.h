@@ -0,0 +1,45 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+// MTC 的临时文件管理
+//
+// 临时文件统一放在 MTC 自己的子目录下（POSIX：<temp>/mtc-<uid>，权限 0700；
+// Windows：%TEMP%\MTC），每个文件一个条目目录，目录名以到期时间开头：
+//   <根目录>/<到期 Unix 秒>-<pid>-<序号>/<文件名>
+// 到期时间记录在名字里，进程崩溃或多个实例并存时也能由任意一次清理正确回收。
+// Sweep 删除已到期的条目，以及旧版本遗留在系统临时目录里的 mtc_* 文件。
+class TempArtifacts {
+public:
+    // 根目录（测试用，需在 Allocate / Sweep 之前调用）；默认为系统临时目录下的 MTC 子目录
+    static void SetRoot(const std::filesystem::path& root);
+    static std::filesystem::path Root();
+
+    // 分配一个临时文件路径（条目目录已创建，文件由调用方写入）。
+    // name 保留原文件名以便按扩展名关联打开，其中的路径分隔符会被替换。失败返回空路径。
+    static std::filesystem::path Allocate(const std::string& name, std::chrono::seconds lifetime,
+                                          std::string* errorMsg = nullptr);
+
+    // 同 Allocate，但同一 key 总是得到同一个条目目录（名为 <到期 Unix 秒>-k<key 的哈希>）：
+    // 已有未到期的同 key 条目时沿用它并把到期时间顺延到 lifetime 之后。
+    // 用于可续传的临时下载——再次打开同一远程文件时能找到上次没下完的部分文件。
+    static std::filesystem::path AllocateKeyed(const std::string& key, const std::string& name,
+                                               std::chrono::seconds lifetime,
+                                               std::string* errorMsg = nullptr);
+
+    // 删除已到期的条目，返回删除数量
+    static size_t SweepExpired(std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+    // 删除 dir 中旧版本遗留的 mtc_init_* / mtc_startup_* / mtc_remote_* 文件
+    // （只删本用户的、最后修改早于 minAge 的普通文件），返回删除数量
+    static size_t SweepLegacy(const std::filesystem::path& dir, std::chrono::seconds minAge);
+
+    // 启动时与定时器调用：SweepExpired + 清理系统临时目录中的遗留文件
+    static size_t Sweep();
+
+    // 创建（或核对）只给当前用户用的目录。POSIX 上权限 0700：已存在时必须是本用户的真实目录，
+    // 别人预先放好的目录或符号链接一律拒绝，多余的权限位收回。Windows 上只负责创建
+    static bool EnsurePrivateDirectory(const std::filesystem::path& dir, std::string* errorMsg = nullptr);
+};
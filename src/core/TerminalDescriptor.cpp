@@ -0,0 +1,310 @@
+#include "TerminalDescriptor.h"
+#include <cstdlib>
+
+namespace {
+
+std::string ShellQuote(const std::string& s) {
+    std::string r = "'";
+    for (char c : s) {
+        if (c == '\'') r += "'\\''";
+        else r += c;
+    }
+    r += "'";
+    return r;
+}
+
+struct Placeholders {
+    std::string cwd;
+    std::string title;
+    std::string command;
+};
+
+// 一趟展开占位符；替换进来的值不会再被当作占位符
+std::string Expand(const std::string& templ, const Placeholders& values) {
+    std::string out;
+    for (size_t i = 0; i < templ.size(); ) {
+        if (templ[i] == '{') {
+            size_t close = templ.find('}', i);
+            if (close != std::string::npos) {
+                const std::string name = templ.substr(i + 1, close - i - 1);
+                const std::string* value = name == "cwd" ? &values.cwd
+                                         : name == "title" ? &values.title
+                                         : name == "command" ? &values.command : nullptr;
+                if (value) {
+                    out += *value;
+                    i = close + 1;
+                    continue;
+                }
+            }
+        }
+        out += templ[i++];
+    }
+    return out;
+}
+
+void AppendExpanded(std::vector<std::string>& argv, const std::vector<std::string>& templ,
+                    const Placeholders& values) {
+    for (const auto& arg : templ) {
+        argv.push_back(Expand(arg, values));
+    }
+}
+
+void AppendCommand(std::vector<std::string>& argv, const TerminalDescriptor& descriptor,
+                   const std::string& scriptPath) {
+    argv.insert(argv.end(), descriptor.execArgs.begin(), descriptor.execArgs.end());
+    if (descriptor.commandAsString) {
+        argv.push_back(BashCommandLine(scriptPath));
+    } else {
+        argv.insert(argv.end(), {"/bin/bash", scriptPath});
+    }
+}
+
+} // namespace
+
+std::vector<TerminalDescriptor> BuiltinTerminalDescriptors() {
+    std::vector<TerminalDescriptor> list;
+#ifdef __linux__
+    {
+        // XFCE 标准方式：交给用户选定的默认终端，通常是服务端模式的 xfce4-terminal
+        TerminalDescriptor d;
+        d.id = "exo-open";
+        d.displayName = "XFCE 默认终端";
+        d.binary = "exo-open";
+        d.baseArgs = {"--launch", "TerminalEmulator"};
+        d.commandAsString = true;
+        d.workingDirArgs = {"--working-directory", "{cwd}"};
+        d.inheritsProcessState = false;
+        list.push_back(d);
+    }
+    {
+        TerminalDescriptor d;
+        d.id = "qterminal";
+        d.displayName = "QTerminal";
+        d.binary = "qterminal";
+        d.execArgs = {"-e"};
+        d.commandAsString = true;
+        d.workingDirArgs = {"-w", "{cwd}"};
+        list.push_back(d);
+    }
+    {
+        TerminalDescriptor d;
+        d.id = "gnome-terminal";
+        d.displayName = "GNOME Terminal";
+        d.binary = "gnome-terminal";
+        d.execArgs = {"--"};
+        d.workingDirArgs = {"--working-directory={cwd}"};
+        d.inheritsProcessState = false;
+        d.tabStyle = TerminalTabStyle::Grouped;
+        d.firstTabArgs = {"--window"};
+        d.nextTabArgs = {"--tab"};
+        d.tabCommandArgs = {"--command={command}"};   // gnome-terminal 已不支持 --title
+        list.push_back(d);
+    }
+    {
+        TerminalDescriptor d;
+        d.id = "konsole";
+        d.displayName = "Konsole";
+        d.binary = "konsole";
+        d.execArgs = {"-e"};
+        d.workingDirArgs = {"--workdir", "{cwd}"};
+        d.tabStyle = TerminalTabStyle::PerCall;
+        d.nextTabArgs = {"--new-tab"};
+        d.titleArgs = {"-p", "tabtitle={title}"};
+        list.push_back(d);
+    }
+    {
+        TerminalDescriptor d;
+        d.id = "xfce4-terminal";
+        d.displayName = "Xfce Terminal";
+        d.binary = "xfce4-terminal";
+        d.execArgs = {"--"};
+        d.workingDirArgs = {"--working-directory={cwd}"};
+        d.inheritsProcessState = false;
+        d.tabStyle = TerminalTabStyle::Grouped;
+        d.firstTabArgs = {"--window"};
+        d.nextTabArgs = {"--tab"};
+        d.titleArgs = {"--title={title}"};
+        d.tabCommandArgs = {"--command={command}"};
+        list.push_back(d);
+    }
+    {
+        TerminalDescriptor d;
+        d.id = "mate-terminal";
+        d.displayName = "MATE Terminal";
+        d.binary = "mate-terminal";
+        d.execArgs = {"--"};
+        d.workingDirArgs = {"--working-directory={cwd}"};
+        d.inheritsProcessState = false;
+        d.tabStyle = TerminalTabStyle::Grouped;
+        d.firstTabArgs = {"--window"};
+        d.nextTabArgs = {"--tab"};
+        d.titleArgs = {"--title={title}"};
+        d.tabCommandArgs = {"--command={command}"};
+        list.push_back(d);
+    }
+    {
+        TerminalDescriptor d;
+        d.id = "alacritty";
+        d.displayName = "Alacritty";
+        d.binary = "alacritty";
+        d.execArgs = {"-e"};
+        d.workingDirArgs = {"--working-directory", "{cwd}"};
+        d.ipcArgs = {"msg", "create-window"};
+        d.ipcWorkingDirArgs = {"--working-directory", "{cwd}"};
+        d.ipcExecArgs = {"-e"};
+        d.passesInheritedFds = true;
+        list.push_back(d);
+    }
+    {
+        // kitty @ 需要开启 allow_remote_control 与 listen_on，且只在设置了 KITTY_LISTEN_ON 时
+        // 找得到实例（如 MTC 从 kitty 里启动）；否则直接启动新进程
+        TerminalDescriptor d;
+        d.id = "kitty";
+        d.displayName = "kitty";
+        d.binary = "kitty";
+        d.workingDirArgs = {"--directory", "{cwd}"};
+        d.ipcArgs = {"@", "launch", "--type=os-window"};
+        d.ipcWorkingDirArgs = {"--cwd={cwd}"};
+        d.ipcEnv = "KITTY_LISTEN_ON";
+        list.push_back(d);
+    }
+    {
+        TerminalDescriptor d;
+        d.id = "wezterm";
+        d.displayName = "WezTerm";
+        d.binary = "wezterm";
+        d.baseArgs = {"start"};
+        d.execArgs = {"--"};
+        d.workingDirArgs = {"--cwd", "{cwd}"};
+        d.ipcArgs = {"cli", "spawn", "--new-window"};
+        d.ipcWorkingDirArgs = {"--cwd", "{cwd}"};
+        d.ipcExecArgs = {"--"};
+        list.push_back(d);
+    }
+    {
+        TerminalDescriptor d;
+        d.id = "xterm";
+        d.displayName = "XTerm";
+        d.binary = "xterm";
+        d.execArgs = {"-e"};
+        d.passesInheritedFds = true;
+        list.push_back(d);
+    }
+#endif
+    return list;
+}
+
+bool CanLaunchWithoutScript(const TerminalDescriptor& descriptor, const Profile& profile) {
+    if (!profile.startupCommands.empty()) {
+        return false;
+    }
+    if (descriptor.inheritsProcessState) {
+        // 环境变量与当前目录都由启动进程传给 shell
+        return true;
+    }
+    // 服务端模式：环境变量到不了新 shell，只能靠脚本 export；目录需要终端自己的参数
+    return profile.environmentVariables.empty() &&
+           (profile.GetWorkingDirectory().empty() || !descriptor.workingDirArgs.empty());
+}
+
+std::vector<std::string> BuildDirectTerminalArgv(const TerminalDescriptor& descriptor,
+                                                 const std::string& workingDirectory) {
+    std::vector<std::string> argv{descriptor.binary};
+    argv.insert(argv.end(), descriptor.baseArgs.begin(), descriptor.baseArgs.end());
+    if (!workingDirectory.empty()) {
+        Placeholders values;
+        values.cwd = workingDirectory;
+        AppendExpanded(argv, descriptor.workingDirArgs, values);
+    }
+    return argv;
+}
+
+std::vector<std::string> BuildScriptTerminalArgv(const TerminalDescriptor& descriptor,
+                                                 const std::string& scriptPath) {
+    std::vector<std::string> argv{descriptor.binary};
+    argv.insert(argv.end(), descriptor.baseArgs.begin(), descriptor.baseArgs.end());
+    if (!scriptPath.empty()) {
+        AppendCommand(argv, descriptor, scriptPath);
+    }
+    return argv;
+}
+
+bool HasIpc(const TerminalDescriptor& descriptor) {
+    if (descriptor.ipcArgs.empty()) {
+        return false;
+    }
+    if (descriptor.ipcEnv.empty()) {
+        return true;
+    }
+    const char* value = std::getenv(descriptor.ipcEnv.c_str());
+    return value && *value;
+}
+
+bool CanUseIpcWithoutScript(const TerminalDescriptor& descriptor, const Profile& profile) {
+    return profile.startupCommands.empty() && profile.environmentVariables.empty() &&
+           (profile.GetWorkingDirectory().empty() || !descriptor.ipcWorkingDirArgs.empty());
+}
+
+std::vector<std::string> BuildIpcTerminalArgv(const TerminalDescriptor& descriptor,
+                                              const std::string& workingDirectory,
+                                              const std::string& scriptPath) {
+    std::vector<std::string> argv{descriptor.binary};
+    argv.insert(argv.end(), descriptor.ipcArgs.begin(), descriptor.ipcArgs.end());
+    if (!workingDirectory.empty()) {
+        Placeholders values;
+        values.cwd = workingDirectory;
+        AppendExpanded(argv, descriptor.ipcWorkingDirArgs, values);
+    }
+    if (!scriptPath.empty()) {
+        argv.insert(argv.end(), descriptor.ipcExecArgs.begin(), descriptor.ipcExecArgs.end());
+        argv.insert(argv.end(), {"/bin/bash", scriptPath});
+    }
+    return argv;
+}
+
+std::vector<std::vector<std::string>> BuildTabbedTerminalArgv(
+    const TerminalDescriptor& descriptor,
+    const std::vector<std::pair<std::string, std::string>>& tabs
+) {
+    std::vector<std::vector<std::string>> invocations;
+    switch (descriptor.tabStyle) {
+        case TerminalTabStyle::Grouped: {
+            // 一次调用：第一个标签随新窗口创建，其余追加
+            std::vector<std::string> argv{descriptor.binary};
+            argv.insert(argv.end(), descriptor.baseArgs.begin(), descriptor.baseArgs.end());
+            for (size_t i = 0; i < tabs.size(); ++i) {
+                Placeholders values;
+                values.title = tabs[i].first;
+                values.command = tabs[i].second.empty() ? std::string("/bin/bash")
+                                                        : BashCommandLine(tabs[i].second);
+                AppendExpanded(argv, i == 0 ? descriptor.firstTabArgs : descriptor.nextTabArgs, values);
+                AppendExpanded(argv, descriptor.titleArgs, values);
+                AppendExpanded(argv, descriptor.tabCommandArgs, values);
+            }
+            invocations.push_back(argv);
+            break;
+        }
+        case TerminalTabStyle::PerCall:
+            // 每次调用只带一条命令，由 nextTabArgs 并入已运行的窗口
+            for (const auto& tab : tabs) {
+                std::vector<std::string> argv{descriptor.binary};
+                argv.insert(argv.end(), descriptor.baseArgs.begin(), descriptor.baseArgs.end());
+                Placeholders values;
+                values.title = tab.first;
+                AppendExpanded(argv, descriptor.nextTabArgs, values);
+                AppendExpanded(argv, descriptor.titleArgs, values);
+                if (!tab.second.empty()) {
+                    AppendCommand(argv, descriptor, tab.second);
+                }
+                invocations.push_back(argv);
+            }
+            break;
+        case TerminalTabStyle::None:
+            break;
+    }
+    return invocations;
+}
+
+std::string BashCommandLine(const std::string& scriptPath) {
+    return "/bin/bash " + ShellQuote(scriptPath);
+}
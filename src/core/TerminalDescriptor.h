@@ -0,0 +1,83 @@
+#pragma once
+#include "Types.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+// 终端的标签页能力
+enum class TerminalTabStyle {
+    None,       // 不支持，工作区退回独立窗口
+    Grouped,    // 一次调用开多个标签：firstTabArgs / nextTabArgs 分隔，每个标签带 tabCommandArgs
+    PerCall     // 每个标签一次调用，nextTabArgs 让它并入已运行的窗口（konsole --new-tab）
+};
+
+// 终端模拟器描述：如何调用它、支持哪些参数
+//
+// 参数模板中的占位符：{cwd} 工作目录、{title} 标签标题、{command} 整条 shell 命令。
+// 内置条目覆盖原先 switch 里的各终端；用户可在 data/terminals.json 中覆盖或新增。
+struct TerminalDescriptor {
+    std::string id;                          // 与 TerminalTypeToString 一致；用户新增条目自取
+    std::string displayName;
+    std::string binary;                      // 按 PATH 查找，也用于探测是否安装
+    std::vector<std::string> baseArgs;       // 每次都带，如 exo-open 的 --launch TerminalEmulator
+    std::vector<std::string> execArgs;       // 执行命令前的分隔参数，如 "--" / "-e"
+    bool commandAsString = false;            // 命令须作为一整条字符串传入（exo-open / qterminal）
+    std::vector<std::string> workingDirArgs; // 指定初始目录的参数（含 {cwd}）；空 = 不支持
+    // 新 shell 是否由本次启动的进程直接派生、继承其环境变量与当前目录。
+    // gnome-terminal 等服务端模式的终端由已运行的服务进程派生 shell，这里为 false。
+    bool inheritsProcessState = true;
+    // 本次启动的进程能否把 3 号描述符原样传给 shell，初始化脚本可经 `bash /dev/fd/3` 交过去。
+    // 会关闭多余描述符的终端（kitty、wezterm）、可能转交已运行实例的终端（konsole）
+    // 以及服务端模式的终端为 false，脚本改写进 0600 的临时文件。
+    bool passesInheritedFds = false;
+    TerminalTabStyle tabStyle = TerminalTabStyle::None;
+    std::vector<std::string> firstTabArgs;
+    std::vector<std::string> nextTabArgs;
+    std::vector<std::string> titleArgs;      // 含 {title}；空 = 不支持标签标题
+    std::vector<std::string> tabCommandArgs; // Grouped 方式下每个标签的命令参数（含 {command}）
+
+    // 控制通道：请已运行的实例开新窗口（alacritty msg create-window / kitty @ launch /
+    // wezterm cli spawn），没有实例时该调用以非零退出，由调用方退回启动新进程。
+    // 新 shell 由已运行的实例派生，拿不到本次启动的环境变量与当前目录。
+    std::vector<std::string> ipcArgs;            // 空 = 不支持
+    std::vector<std::string> ipcWorkingDirArgs;  // 含 {cwd}
+    std::vector<std::string> ipcExecArgs;        // 执行命令前的分隔参数
+    // 非空时只有该环境变量非空才尝试控制通道。kitty @ 离了 KITTY_LISTEN_ON 找不到实例，
+    // 否则每次启动都要先多起一个注定失败的进程
+    std::string ipcEnv;
+};
+
+// 当前平台的内置描述（按自动检测的优先级排列）；非 Linux 平台为空
+std::vector<TerminalDescriptor> BuiltinTerminalDescriptors();
+
+// 本地配置能否不经初始化脚本、直接启动终端：没有启动命令，且环境变量与工作目录
+// 能通过进程继承或终端自身参数带过去。
+bool CanLaunchWithoutScript(const TerminalDescriptor& descriptor, const Profile& profile);
+
+// 直接启动：binary + baseArgs + 工作目录参数（终端支持且 cwd 非空时）
+std::vector<std::string> BuildDirectTerminalArgv(const TerminalDescriptor& descriptor,
+                                                 const std::string& workingDirectory);
+
+// 用 `bash scriptPath` 启动；scriptPath 为空时只开终端。
+// 脚本内容（含环境变量的值）不放进 argv，只传路径：/dev/fd/3 或临时文件
+std::vector<std::string> BuildScriptTerminalArgv(const TerminalDescriptor& descriptor,
+                                                 const std::string& scriptPath);
+
+// 是否尝试控制通道：有 ipcArgs，且没有要求 ipcEnv 或该环境变量非空
+bool HasIpc(const TerminalDescriptor& descriptor);
+
+// 经控制通道开窗口时能否不带初始化脚本（没有启动命令和环境变量，目录可用参数指定）
+bool CanUseIpcWithoutScript(const TerminalDescriptor& descriptor, const Profile& profile);
+
+// 控制通道调用：binary + ipcArgs [+ 目录参数] [+ ipcExecArgs + bash scriptPath]
+std::vector<std::string> BuildIpcTerminalArgv(const TerminalDescriptor& descriptor,
+                                              const std::string& workingDirectory,
+                                              const std::string& scriptPath);
+
+// 工作区标签页：tabs 为 (标题, 脚本路径)，返回需要依次执行的终端调用；不支持时为空
+std::vector<std::vector<std::string>> BuildTabbedTerminalArgv(
+    const TerminalDescriptor& descriptor,
+    const std::vector<std::pair<std::string, std::string>>& tabs);
+
+// 供按字符串解析命令的终端使用：/bin/bash '<scriptPath>'
+std::string BashCommandLine(const std::string& scriptPath);
@@ -1,14 +1,25 @@
 #include "TerminalLauncher.h"
 #include "ConfigManager.h"
+#include "LaunchHelper.h"
+#include "WorkerPool.h"
+#include "EnvironmentBlock.h"
+#include "ScriptCache.h"
+#include "TerminalRegistry.h"
+#include "LaunchTelemetry.h"
+#include "TempArtifacts.h"
 #include <cstdlib>
 #include <fstream>
 #include <string>
 #include <ctime>
+#include <mutex>
+#include <algorithm>
+#include <chrono>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <shlwapi.h>
+#include <sstream>
 #pragma comment(lib, "shlwapi.lib")
 #elif defined(__linux__) || defined(__APPLE__)
 #include <unistd.h>
@@ -26,127 +37,321 @@
 extern char** environ;
 #endif
 
-bool TerminalLauncher::Launch(const Profile& profile, std::string* errorMsg) {
-    // 远程配置：走 SSH 路径（在外部终端里跑 ssh）
+#ifdef __linux__
+namespace {
+// 经描述符交给 bash 的脚本先关掉 3 号描述符，免得它一路传给终端里用户的 shell
+const std::string kCloseInheritedScript = "exec 3<&-\n";
+} // namespace
+#endif
+
+LaunchSpec TerminalLauncher::MakeLaunchSpec(const Profile& profile) {
+    LaunchSpec spec;
+    spec.profile = profile;
     if (profile.IsRemote()) {
-        return LaunchRemote(profile, errorMsg);
+        if (const SshHost* host = ConfigManager::GetInstance().GetSshHost(profile.sshHostId)) {
+            spec.sshHost = *host;
+        }
+        if (!profile.credentialId.empty()) {
+            if (const Credential* cred = ConfigManager::GetInstance().GetCredential(profile.credentialId)) {
+                spec.credential = *cred;
+            }
+        }
     }
+    return spec;
+}
+
+bool TerminalLauncher::Launch(const Profile& profile, std::string* errorMsg) {
+    return Launch(MakeLaunchSpec(profile), errorMsg);
+}
 
-    auto env = BuildEnvironment(profile.environmentVariables);
+bool TerminalLauncher::Launch(const LaunchSpec& spec, std::string* errorMsg) {
+    const Profile& profile = spec.profile;
 
+    // 各阶段耗时记入 data/launch_log.bin，见“启动统计”
+    LaunchTelemetry::Trace trace(profile.id, profile.IsRemote());
+    bool ok = false;
+
+    // 远程配置：走 SSH 路径（在外部终端里跑 ssh）
+    if (profile.IsRemote()) {
+        ok = LaunchRemote(spec, errorMsg);
+    } else {
 #ifdef _WIN32
-    return LaunchWindows(profile, env, errorMsg);
+        ok = LaunchWindows(profile, errorMsg);
 #elif defined(__linux__)
-    return LaunchLinux(profile, env, errorMsg);
+        ok = LaunchLinux(profile, errorMsg);
 #elif defined(__APPLE__)
-    return LaunchMacOS(profile, env, errorMsg);
+        ok = LaunchMacOS(profile, errorMsg);
 #else
-    if (errorMsg) *errorMsg = "Unsupported platform";
-    return false;
+        if (errorMsg) *errorMsg = "Unsupported platform";
 #endif
+    }
+
+    trace.SetSuccess(ok);
+    return ok;
 }
 
-std::string TerminalLauncher::ShellSingleQuote(const std::string& s) {
-    std::string r = "'";
-    for (char c : s) {
-        if (c == '\'') r += "'\\''";
-        else r += c;
+std::vector<LaunchResult> TerminalLauncher::LaunchBatch(
+    const std::vector<Profile>& profiles,
+    size_t maxConcurrency
+) {
+    std::vector<LaunchSpec> specs;
+    specs.reserve(profiles.size());
+    for (const auto& profile : profiles) {
+        specs.push_back(MakeLaunchSpec(profile));
     }
-    r += "'";
-    return r;
+    return LaunchBatch(specs, maxConcurrency);
 }
 
-std::string TerminalLauncher::BuildRemoteInnerScript(const Profile& profile) {
-    // 这段脚本将通过 `ssh ... bash -s < script` 由 stdin 送到远程执行，
-    // 因此无需担心命令行的引号转义问题，脚本自身的单引号由远程 bash 正常解析。
-    std::string script = "#!/bin/bash\n";
-    if (!profile.remoteWorkingDirectory.empty()) {
-        script += "cd " + ShellSingleQuote(profile.remoteWorkingDirectory) + " 2>/dev/null\n";
-    }
-    for (const auto& var : profile.environmentVariables) {
-        if (!var.name.empty()) {
-            script += "export " + var.name + "=" + ShellSingleQuote(var.value) + "\n";
+std::vector<LaunchResult> TerminalLauncher::LaunchBatch(
+    const std::vector<LaunchSpec>& specs,
+    size_t maxConcurrency
+) {
+    std::vector<LaunchResult> results(specs.size());
+    if (specs.empty()) {
+        return results;
+    }
+
+    auto launchOne = [&specs, &results](size_t i) {
+        const LaunchSpec& spec = specs[i];
+        LaunchResult& result = results[i];
+        result.profileId = spec.profile.id;
+        result.profileName = spec.profile.name;
+
+        auto start = std::chrono::steady_clock::now();
+        result.success = Launch(spec, &result.errorMsg);
+        result.elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    };
+
+    // 单个配置（主窗口最常见的情况）或不允许并发时，直接在调用线程上跑，不为它起线程池
+    const size_t threads = std::min(std::max<size_t>(maxConcurrency, 1), specs.size());
+    if (threads == 1) {
+        for (size_t i = 0; i < specs.size(); ++i) {
+            launchOne(i);
         }
+        return results;
+    }
+
+    // 每个任务只写自己的结果槽位，无需额外加锁
+    WorkerPool pool(threads);
+    for (size_t i = 0; i < specs.size(); ++i) {
+        pool.Submit([&launchOne, i] { launchOne(i); });
     }
-    for (const auto& cmd : profile.startupCommands) {
-        if (!cmd.empty()) {
-            script += cmd + "\n";
+    pool.WaitIdle();
+
+    return results;
+}
+
+std::vector<LaunchSpec> TerminalLauncher::ResolveWorkspace(const Workspace& workspace) {
+    std::vector<LaunchSpec> specs;
+    for (const auto& id : workspace.profileIds) {
+        if (const Profile* p = ConfigManager::GetInstance().GetProfile(id)) {
+            specs.push_back(MakeLaunchSpec(*p));
         }
     }
-    // 落到交互式远程 shell
-    script += "exec \"$SHELL\" -l -i\n";
-    return script;
+    return specs;
 }
 
-std::map<std::string, std::string> TerminalLauncher::BuildEnvironment(
-    const std::vector<EnvVariable>& customVars
+bool TerminalLauncher::LaunchWorkspace(const Workspace& workspace, std::string* errorMsg) {
+    return LaunchWorkspace(ResolveWorkspace(workspace), workspace.layout, errorMsg);
+}
+
+bool TerminalLauncher::LaunchWorkspace(
+    const std::vector<LaunchSpec>& specs,
+    WorkspaceLayout layout,
+    std::string* errorMsg
 ) {
-    std::map<std::string, std::string> env;
-    
-    // 获取当前环境变量
-#ifdef _WIN32
-    // Helper to convert Wide String to UTF-8
-    auto WideToUtf8 = [](const std::wstring& wstr) -> std::string {
-        if (wstr.empty()) return std::string();
-        int size_needed = WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), NULL, 0, NULL, NULL);
-        std::string strTo(size_needed, 0);
-        WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), &strTo[0], size_needed, NULL, NULL);
-        return strTo;
-    };
+    if (specs.empty()) {
+        if (errorMsg) *errorMsg = "工作区中没有可用的配置";
+        return false;
+    }
 
-    wchar_t* envStrings = GetEnvironmentStringsW();
-    if (envStrings) {
-        for (wchar_t* p = envStrings; *p; ) {
-            std::wstring entry(p);
-            size_t pos = entry.find(L'=');
-            if (pos != std::wstring::npos && pos > 0) {
-                std::wstring wname = entry.substr(0, pos);
-                std::wstring wvalue = entry.substr(pos + 1);
-                
-                std::string name = WideToUtf8(wname);
-                std::string value = WideToUtf8(wvalue);
-                
-                env[name] = value;
-            }
-            p += entry.length() + 1;
+    // 标签页布局：所有配置落到同一个支持标签页的终端时，一次调用全部打开
+    if (layout == WorkspaceLayout::Tabs && specs.size() > 1) {
+#ifdef __linux__
+        auto descriptor = ResolveDescriptor(specs.front().profile);
+        bool sameTerminal = descriptor && std::all_of(specs.begin(), specs.end(),
+            [&descriptor](const LaunchSpec& s) {
+                auto d = ResolveDescriptor(s.profile);
+                return d && d->id == descriptor->id;
+            });
+        if (sameTerminal && descriptor->tabStyle != TerminalTabStyle::None) {
+            return LaunchTabs(specs, *descriptor, errorMsg);
+        }
+#else
+        TerminalType type = ResolveTerminalType(specs.front().profile.terminalType);
+        bool sameTerminal = std::all_of(specs.begin(), specs.end(),
+            [type](const LaunchSpec& s) { return ResolveTerminalType(s.profile.terminalType) == type; });
+        if (sameTerminal && SupportsTabs(type)) {
+            return LaunchTabs(specs, type, errorMsg);
         }
-        FreeEnvironmentStringsW(envStrings);
+#endif
     }
-    
-    // 用自定义变量覆盖 (Windows 大小写不敏感处理)
-    for (const auto& var : customVars) {
-        bool found = false;
-        // 查找是否存在同名变量（忽略大小写）
-        for (auto it = env.begin(); it != env.end(); ++it) {
-            if (_stricmp(it->first.c_str(), var.name.c_str()) == 0) {
-                // 找到同名变量，删除旧的（为了保持用户的大小写偏好），插入新的
-                env.erase(it);
-                env[var.name] = var.value;
-                found = true;
-                break;
+
+    // 退回逐个开窗口
+    auto results = LaunchBatch(specs);
+    std::string failures;
+    for (const auto& r : results) {
+        if (!r.success) {
+            failures += r.profileName + ": " + r.errorMsg + "\n";
+        }
+    }
+    if (!failures.empty()) {
+        failures.pop_back();
+        if (errorMsg) *errorMsg = failures;
+        return false;
+    }
+    return true;
+}
+
+bool TerminalLauncher::SupportsTabs(TerminalType type) {
+#ifdef _WIN32
+    return type == TerminalType::WindowsTerminal && IsTerminalAvailable(type);
+#elif defined(__linux__)
+    if (type == TerminalType::Embedded) {
+        return true;
+    }
+    auto descriptor = TerminalRegistry::Find(TerminalTypeToString(type));
+    return descriptor && descriptor->tabStyle != TerminalTabStyle::None;
+#else
+    // Terminal.app / iTerm2 只能靠 UI 脚本模拟按键开标签，不可靠，统一走独立窗口
+    return false;
+#endif
+}
+
+#ifdef __linux__
+bool TerminalLauncher::LaunchTabs(
+    const std::vector<LaunchSpec>& specs,
+    const TerminalDescriptor& descriptor,
+    std::string* errorMsg
+) {
+    // 标签页的 shell 由终端服务端或已运行的窗口派生，拿不到本进程的描述符，脚本只能落盘
+    std::vector<std::pair<std::string, std::string>> tabs;
+    std::vector<std::string> scriptFiles;
+    auto removeFrom = [&scriptFiles](size_t first) {
+        for (size_t i = first; i < scriptFiles.size(); ++i) {
+            RemoveScriptFile(scriptFiles[i]);
+        }
+    };
+    for (const auto& spec : specs) {
+        std::string script;
+        if (!BuildLinuxScript(spec, script, errorMsg)) {
+            removeFrom(0);
+            return false;
+        }
+        std::string path;
+        if (!script.empty()) {
+            path = WriteScriptFile(script, errorMsg);
+            if (path.empty()) {
+                removeFrom(0);
+                return false;
             }
         }
-        
-        if (!found) {
-            env[var.name] = var.value;
+        scriptFiles.push_back(path);
+        tabs.emplace_back(spec.profile.name, path);
+    }
+
+    // 各配置的自定义环境变量已写进各自的初始化脚本，这里不再额外注入
+    auto invocations = BuildTabbedTerminalArgv(descriptor, tabs);
+    for (size_t i = 0; i < invocations.size(); ++i) {
+        SpawnRequest request;
+        request.argv = invocations[i];
+        if (!SpawnTerminal(request, errorMsg)) {
+            // 删掉还没交出去的脚本：Grouped 只有一次调用，PerCall 第 i 次调用对应第 i 个标签
+            removeFrom(descriptor.tabStyle == TerminalTabStyle::PerCall ? i : 0);
+            return false;
         }
     }
-#else
-    for (char** e = environ; *e; ++e) {
-        std::string entry(*e);
-        size_t pos = entry.find('=');
-        if (pos != std::string::npos) {
-            env[entry.substr(0, pos)] = entry.substr(pos + 1);
+    return true;
+}
+#endif
+
+bool TerminalLauncher::LaunchTabs(
+    const std::vector<LaunchSpec>& specs,
+    TerminalType type,
+    std::string* errorMsg
+) {
+#if defined(_WIN32)
+    // wt.exe 用 ; 串联多个 new-tab 子命令，一次调用开出同一窗口的多个标签
+    std::wstring args;
+    for (const auto& spec : specs) {
+        const Profile& profile = spec.profile;
+        std::wstring tab;
+        if (profile.IsRemote()) {
+            std::string sshCore;
+            std::wstring sshCmdW;
+            if (!BuildSshCore(spec, sshCore, errorMsg) ||
+                !BuildWindowsRemoteCommand(profile, sshCore, sshCmdW, errorMsg)) {
+                return false;
+            }
+            tab = L"new-tab --title \"" + Utf8ToWide(profile.name) + L"\" cmd /k \"" + sshCmdW + L"\"";
+        } else {
+            std::wstring scriptPath = WriteWindowsInitScript(profile);
+            if (scriptPath.empty()) {
+                if (errorMsg) *errorMsg = "无法创建初始化脚本";
+                return false;
+            }
+            tab = BuildWtTabArgs(profile.name, scriptPath);
         }
+        if (!args.empty()) args += L" ; ";
+        args += tab;
     }
-    
-    // 用自定义变量覆盖 (Linux/Mac 大小写敏感)
-    for (const auto& var : customVars) {
-        env[var.name] = var.value;
+
+    std::wstring cmdLine = L"wt.exe " + args;
+    STARTUPINFOW si = { sizeof(si) };
+    PROCESS_INFORMATION pi = { 0 };
+    BOOL ok = CreateProcessW(nullptr, &cmdLine[0], nullptr, nullptr, FALSE,
+                             CREATE_UNICODE_ENVIRONMENT | CREATE_NEW_CONSOLE,
+                             nullptr, nullptr, &si, &pi);
+    DWORD lastError = ::GetLastError();
+    if (ok) {
+        CloseHandle(pi.hProcess);
+        CloseHandle(pi.hThread);
+        return true;
     }
+    if (errorMsg) *errorMsg = GetLastErrorAsString(lastError);
+    return false;
+#else
+    (void)specs;
+    (void)type;
+    if (errorMsg) *errorMsg = "当前平台不支持标签页";
+    return false;
 #endif
-    
-    return env;
+}
+
+std::string TerminalLauncher::ShellSingleQuote(const std::string& s) {
+    std::string r = "'";
+    for (char c : s) {
+        if (c == '\'') r += "'\\''";
+        else r += c;
+    }
+    r += "'";
+    return r;
+}
+
+std::string TerminalLauncher::BuildRemoteInnerScript(const Profile& profile) {
+    // Linux/macOS 由 BuildRemoteCommand 上传到远程临时文件后执行；
+    // Windows 经 `ssh ... bash -s < script` 由 stdin 送到远程执行。两者都不经过 argv。
+    // 改动生成的脚本内容时递增 ScriptCache::kFormatVersion
+    return ScriptCache::GetOrBuild(profile, "remote", [&profile] {
+        std::string script = "#!/bin/bash\n";
+        if (!profile.remoteWorkingDirectory.empty()) {
+            script += "cd " + ShellSingleQuote(profile.remoteWorkingDirectory) + " 2>/dev/null\n";
+        }
+        for (const auto& var : profile.environmentVariables) {
+            if (!var.name.empty()) {
+                script += "export " + var.name + "=" + ShellSingleQuote(var.value) + "\n";
+            }
+        }
+        for (const auto& cmd : profile.startupCommands) {
+            if (!cmd.empty()) {
+                script += cmd + "\n";
+            }
+        }
+        // 落到交互式远程 shell
+        script += "exec \"$SHELL\" -l -i\n";
+        return script;
+    });
 }
 
 std::vector<TerminalType> TerminalLauncher::GetAvailableTerminals() {
@@ -165,7 +370,10 @@ std::vector<TerminalType> TerminalLauncher::GetAvailableTerminals() {
     terminals.push_back(TerminalType::Xfce4Terminal);
     terminals.push_back(TerminalType::MateTerminal);
     terminals.push_back(TerminalType::Alacritty);
+    terminals.push_back(TerminalType::Kitty);
+    terminals.push_back(TerminalType::WezTerm);
     terminals.push_back(TerminalType::Xterm);
+    terminals.push_back(TerminalType::Embedded);
 #elif defined(__APPLE__)
     terminals.push_back(TerminalType::TerminalApp);
     terminals.push_back(TerminalType::ITerm2);
@@ -178,6 +386,34 @@ std::string TerminalLauncher::GetTerminalDisplayName(TerminalType type) {
     return TerminalTypeDisplayName(type);
 }
 
+std::string TerminalLauncher::GetTerminalDisplayName(const Profile& profile) {
+#ifdef __linux__
+    if (!profile.terminalId.empty()) {
+        auto descriptor = TerminalRegistry::Find(profile.terminalId);
+        if (descriptor && !descriptor->displayName.empty()) {
+            return descriptor->displayName;
+        }
+        return profile.terminalId;
+    }
+#endif
+    return TerminalTypeDisplayName(profile.terminalType);
+}
+
+std::vector<std::pair<std::string, std::string>> TerminalLauncher::GetCustomTerminals() {
+    std::vector<std::pair<std::string, std::string>> terminals;
+#ifdef __linux__
+    for (const auto& descriptor : TerminalRegistry::All()) {
+        // 与内置条目同名的只是覆盖参数，已经在 GetAvailableTerminals 里
+        if (descriptor->id == "auto" || StringToTerminalType(descriptor->id) != TerminalType::Auto) {
+            continue;
+        }
+        terminals.emplace_back(descriptor->id,
+                               descriptor->displayName.empty() ? descriptor->id : descriptor->displayName);
+    }
+#endif
+    return terminals;
+}
+
 bool TerminalLauncher::IsTerminalAvailable(TerminalType type) {
 #ifdef _WIN32
     switch (type) {
@@ -192,26 +428,8 @@ bool TerminalLauncher::IsTerminalAvailable(TerminalType type) {
             return false;
     }
 #elif defined(__linux__)
-    switch (type) {
-        case TerminalType::ExoOpen:
-            return system("which exo-open > /dev/null 2>&1") == 0;
-        case TerminalType::QTerminal:
-            return system("which qterminal > /dev/null 2>&1") == 0;
-        case TerminalType::GnomeTerminal:
-            return system("which gnome-terminal > /dev/null 2>&1") == 0;
-        case TerminalType::Konsole:
-            return system("which konsole > /dev/null 2>&1") == 0;
-        case TerminalType::Xfce4Terminal:
-            return system("which xfce4-terminal > /dev/null 2>&1") == 0;
-        case TerminalType::MateTerminal:
-            return system("which mate-terminal > /dev/null 2>&1") == 0;
-        case TerminalType::Alacritty:
-            return system("which alacritty > /dev/null 2>&1") == 0;
-        case TerminalType::Xterm:
-            return system("which xterm > /dev/null 2>&1") == 0;
-        default:
-            return false;
-    }
+    auto descriptor = TerminalRegistry::Find(TerminalTypeToString(type));
+    return descriptor && TerminalRegistry::IsInstalled(*descriptor);
 #elif defined(__APPLE__)
     return type == TerminalType::TerminalApp || type == TerminalType::ITerm2;
 #else
@@ -220,6 +438,29 @@ bool TerminalLauncher::IsTerminalAvailable(TerminalType type) {
 }
 
 TerminalType TerminalLauncher::AutoDetectTerminal() {
+    // 探测要逐个 which，代价不小；找到后在进程内缓存结果
+    static std::mutex detectMutex;
+    static TerminalType detected = TerminalType::Auto;
+    std::lock_guard<std::mutex> lock(detectMutex);
+    if (detected == TerminalType::Auto) {
+        detected = DetectInstalledTerminal();
+    }
+    return detected;
+}
+
+void TerminalLauncher::Prewarm() {
+#ifdef __linux__
+    TerminalRegistry::DetectInstalled();
+#else
+    AutoDetectTerminal();
+#endif
+}
+
+TerminalType TerminalLauncher::ResolveTerminalType(TerminalType requested) {
+    return requested == TerminalType::Auto ? AutoDetectTerminal() : requested;
+}
+
+TerminalType TerminalLauncher::DetectInstalledTerminal() {
 #ifdef _WIN32
     // 优先使用 Windows Terminal
     if (IsTerminalAvailable(TerminalType::WindowsTerminal)) {
@@ -228,32 +469,9 @@ TerminalType TerminalLauncher::AutoDetectTerminal() {
     return TerminalType::Cmd;
     
 #elif defined(__linux__)
-    // 按优先级检测（exo-open 优先，XFCE 标准方式）
-    if (IsTerminalAvailable(TerminalType::ExoOpen)) {
-        return TerminalType::ExoOpen;
-    }
-    if (IsTerminalAvailable(TerminalType::QTerminal)) {
-        return TerminalType::QTerminal;
-    }
-    if (IsTerminalAvailable(TerminalType::GnomeTerminal)) {
-        return TerminalType::GnomeTerminal;
-    }
-    if (IsTerminalAvailable(TerminalType::Konsole)) {
-        return TerminalType::Konsole;
-    }
-    if (IsTerminalAvailable(TerminalType::Xfce4Terminal)) {
-        return TerminalType::Xfce4Terminal;
-    }
-    if (IsTerminalAvailable(TerminalType::MateTerminal)) {
-        return TerminalType::MateTerminal;
-    }
-    if (IsTerminalAvailable(TerminalType::Alacritty)) {
-        return TerminalType::Alacritty;
-    }
-    if (IsTerminalAvailable(TerminalType::Xterm)) {
-        return TerminalType::Xterm;
-    }
-    return TerminalType::Auto;  // 没有找到任何可用终端
+    // 按注册表顺序检测（exo-open 优先，XFCE 标准方式）；用户自定义的终端没有对应枚举值
+    auto descriptor = TerminalRegistry::DetectInstalled();
+    return descriptor ? StringToTerminalType(descriptor->id) : TerminalType::Auto;
     
 #elif defined(__APPLE__)
     return TerminalType::TerminalApp;
@@ -305,88 +523,98 @@ std::string GetLastErrorAsString(DWORD errorMessageID) {
 
 // ... (previous code)
 
+std::wstring TerminalLauncher::WriteWindowsInitScript(const Profile& profile) {
+    try {
+        // 改动生成的脚本内容时递增 ScriptCache::kFormatVersion
+        fs::path scriptPath = ScriptCache::Materialize(profile, "init", ".ps1", [&profile] {
+            std::ostringstream script;
+
+            // 写入 UTF-8 BOM，防止中文乱码
+            script << "\xEF\xBB\xBF";
+            script << "# MTC Initialization Script\n";
+
+            // 设置所有环境变量
+            for (const auto& var : profile.environmentVariables) {
+                // 转义单引号
+                std::string value = var.value;
+                size_t pos = 0;
+                while ((pos = value.find("'", pos)) != std::string::npos) {
+                    value.replace(pos, 1, "''");
+                    pos += 2;
+                }
+
+                script << "$env:" << var.name << " = '" << value << "'\n";
+            }
+
+            // 切换目录
+            std::string effectiveWorkDir = profile.GetWorkingDirectory();
+            if (!effectiveWorkDir.empty()) {
+                std::string wd = effectiveWorkDir;
+                // 转义
+                size_t pos = 0;
+                while ((pos = wd.find("'", pos)) != std::string::npos) {
+                    wd.replace(pos, 1, "''");
+                    pos += 2;
+                }
+                script << "Set-Location '" << wd << "'\n";
+            }
+
+            // Execute startup commands
+            for (const auto& cmd : profile.startupCommands) {
+                if (!cmd.empty()) {
+                    std::string escapedCmd = cmd;
+                    size_t cmdPos = 0;
+                    while ((cmdPos = escapedCmd.find("'", cmdPos)) != std::string::npos) {
+                        escapedCmd.replace(cmdPos, 1, "''");
+                        cmdPos += 2;
+                    }
+                    script << escapedCmd << "\n";
+                }
+            }
+            return script.str();
+        });
+        // 缓存文件由 ScriptCache 管理，脚本不再自删
+        return scriptPath.wstring();
+    } catch (...) {
+        // Fallback to default behavior if script creation fails
+        return std::wstring();
+    }
+}
+
+std::wstring TerminalLauncher::BuildWtTabArgs(const std::string& title, const std::wstring& scriptPath) {
+    return L"new-tab --title \"" + Utf8ToWide(title) +
+           L"\" powershell -NoExit -ExecutionPolicy Bypass -File \"" + scriptPath + L"\"";
+}
+
 bool TerminalLauncher::LaunchWindows(
     const Profile& profile,
-    const std::map<std::string, std::string>& env,
     std::string* errorMsg
 ) {
     std::wstring command, args;
     std::wstring workDir = Utf8ToWide(profile.GetWorkingDirectory());
     
-    TerminalType type = profile.terminalType;
-    if (type == TerminalType::Auto) {
-        type = AutoDetectTerminal();
+    TerminalType type;
+    {
+        LaunchTelemetry::PhaseTimer timer(LaunchPhase::Resolve);
+        type = ResolveTerminalType(profile.terminalType);
     }
+    LaunchTelemetry::SetTerminal(TerminalTypeToString(type));
     
     // Windows Terminal 特殊处理：使用 PowerShell 脚本初始化环境变量
     if (type == TerminalType::WindowsTerminal) {
-        try {
-            fs::path tempDir = fs::temp_directory_path();
-            std::string filename = "mtc_init_" + std::to_string(std::time(nullptr)) + ".ps1";
-            fs::path scriptPath = tempDir / filename;
-            
-            std::ofstream script(scriptPath);
-            if (script.is_open()) {
-                // 写入 UTF-8 BOM，防止中文乱码
-                unsigned char bom[] = { 0xEF, 0xBB, 0xBF };
-                script.write(reinterpret_cast<char*>(bom), sizeof(bom));
-                
-                script << "# MTC Initialization Script" << std::endl;
-                
-                // 设置所有环境变量
-                for (const auto& var : profile.environmentVariables) {
-                    // 转义单引号
-                    std::string value = var.value;
-                    size_t pos = 0;
-                    while ((pos = value.find("'", pos)) != std::string::npos) {
-                        value.replace(pos, 1, "''");
-                        pos += 2;
-                    }
-                    
-                    script << "$env:" << var.name << " = '" << value << "'" << std::endl;
-                }
-                
-                // 切换目录
-                std::string effectiveWorkDir = profile.GetWorkingDirectory();
-                if (!effectiveWorkDir.empty()) {
-                    std::string wd = effectiveWorkDir;
-                    // 转义
-                    size_t pos = 0;
-                    while ((pos = wd.find("'", pos)) != std::string::npos) {
-                        wd.replace(pos, 1, "''");
-                        pos += 2;
-                    }
-                    script << "Set-Location '" << wd << "'" << std::endl;
-                }
-
-                // Execute startup commands
-                for (const auto& cmd : profile.startupCommands) {
-                    if (!cmd.empty()) {
-                        std::string escapedCmd = cmd;
-                        size_t cmdPos = 0;
-                        while ((cmdPos = escapedCmd.find("'", cmdPos)) != std::string::npos) {
-                            escapedCmd.replace(cmdPos, 1, "''");
-                            cmdPos += 2;
-                        }
-                        script << escapedCmd << std::endl;
-                    }
-                }
+        std::wstring scriptPath;
+        {
+            LaunchTelemetry::PhaseTimer timer(LaunchPhase::Script);
+            scriptPath = WriteWindowsInitScript(profile);
+        }
+        if (!scriptPath.empty()) {
+            // 构建 wt 命令行
+            // wt.exe new-tab --title "Name" powershell -NoExit -ExecutionPolicy Bypass -File "path"
+            command = L"wt.exe";
+            args = BuildWtTabArgs(profile.name, scriptPath);
 
-                // 清理脚本自身 (可选，但为了调试先保留，或者利用 Start-Job 删除)
-                // script << "Remove-Item $MyInvocation.MyCommand.Path" << std::endl;
-                
-                script.close();
-                
-                // 构建 wt 命令行
-                // wt.exe new-tab --title "Name" powershell -NoExit -ExecutionPolicy Bypass -File "path"
-                command = L"wt.exe";
-                args = L"new-tab --title \"" + Utf8ToWide(profile.name) + L"\" powershell -NoExit -ExecutionPolicy Bypass -File \"" + scriptPath.wstring() + L"\"";
-                
-                // 启动进程 (wt.exe 不需要特殊的 envBlock，因为它可能复用进程)
-                // 我们仍然传递 envBlock，以防它是新进程
-            }
-        } catch (...) {
-            // Fallback to default behavior if script creation fails
+            // 启动进程 (wt.exe 不需要特殊的 envBlock，因为它可能复用进程)
+            // 我们仍然传递 envBlock，以防它是新进程
         }
     }
     
@@ -421,25 +649,8 @@ bool TerminalLauncher::LaunchWindows(
     }
 
     // 构建 Unicode 环境变量块 (即便是 wt，如果是新进程也需要这个)
-    // Windows 要求环境变量块必须按名称的字母顺序排序（不区分大小写）
-    std::vector<std::pair<std::wstring, std::wstring>> envVars;
-    envVars.reserve(env.size());
-    
-    for (const auto& pair : env) {
-        envVars.emplace_back(Utf8ToWide(pair.first), Utf8ToWide(pair.second));
-    }
-    
-    std::sort(envVars.begin(), envVars.end(), 
-        [](const std::pair<std::wstring, std::wstring>& a, const std::pair<std::wstring, std::wstring>& b) {
-            return _wcsicmp(a.first.c_str(), b.first.c_str()) < 0;
-        }
-    );
-    
-    std::wstring envBlock;
-    for (const auto& pair : envVars) {
-        envBlock += pair.first + L"=" + pair.second + L'\0';
-    }
-    envBlock += L'\0';  // 双 null 结尾
+    // 父进程环境快照已按不区分大小写的键排好序，与自定义变量归并一趟即得
+    std::wstring envBlock = EnvironmentSnapshot::Current()->BuildWindowsBlock(profile.environmentVariables);
     
     std::wstring cmdLine = command + L" " + args;
     
@@ -449,6 +660,7 @@ bool TerminalLauncher::LaunchWindows(
     // 使用 CREATE_NEW_CONSOLE 确保创建新的控制台窗口
     DWORD flags = CREATE_UNICODE_ENVIRONMENT | CREATE_NEW_CONSOLE;
     
+    LaunchTelemetry::PhaseTimer spawnTimer(LaunchPhase::Spawn);
     BOOL success = CreateProcessW(
         nullptr,
         &cmdLine[0],
@@ -482,276 +694,268 @@ bool TerminalLauncher::LaunchWindows(
 #ifdef __linux__
 bool TerminalLauncher::LaunchLinux(
     const Profile& profile,
-    const std::map<std::string, std::string>& env,
     std::string* errorMsg
 ) {
-    // Create a temporary shell script to set up environment
-    bool hasStartupCommands = !profile.startupCommands.empty();
-    std::string scriptPath;
-    std::string effectiveWorkDir = profile.GetWorkingDirectory();
+    // Resolve terminal BEFORE spawning
+    auto descriptor = ResolveTelemetered(profile);
+    if (!descriptor) {
+        if (errorMsg) *errorMsg = NoTerminalMessage();
+        return false;
+    }
+
+    // 已有实例在运行时让它开新窗口，省掉整个终端进程的启动
+    std::string workDir = profile.GetWorkingDirectory();
+    std::error_code ec;
+    if (HasIpc(*descriptor)) {
+        bool bare = CanUseIpcWithoutScript(*descriptor, profile) &&
+                    (workDir.empty() || std::filesystem::is_directory(workDir, ec));
+        std::string script;
+        if (!bare) {
+            LaunchTelemetry::PhaseTimer timer(LaunchPhase::Script);
+            script = BuildLocalInitScript(profile);
+        }
+        if (TryLaunchViaIpc(*descriptor, bare ? workDir : std::string(), script)) {
+            return true;
+        }
+    }
+
+    SpawnRequest request;
+    request.env = profile.environmentVariables;
+
+    // 没有启动命令、环境变量和目录又能直接带给终端时，不生成脚本、不多起一层 bash
+    if (CanLaunchWithoutScript(*descriptor, profile) &&
+        (workDir.empty() || std::filesystem::is_directory(workDir, ec))) {
+        request.argv = BuildDirectTerminalArgv(*descriptor, workDir);
+        request.workingDirectory = workDir;
+        return SpawnTerminal(request, errorMsg);
+    }
+
+    std::string script;
+    {
+        LaunchTelemetry::PhaseTimer timer(LaunchPhase::Script);
+        script = BuildLocalInitScript(profile);
+    }
+    return SpawnWithScript(*descriptor, script, request, errorMsg);
+}
 
-    if (hasStartupCommands || !effectiveWorkDir.empty() || !profile.environmentVariables.empty()) {
-        scriptPath = "/tmp/mtc_init_" + std::to_string(std::time(nullptr)) + ".sh";
-        std::ofstream scriptFile(scriptPath);
-        if (!scriptFile.is_open()) {
-            if (errorMsg) *errorMsg = "Failed to create init script";
+bool TerminalLauncher::TryLaunchViaIpc(const TerminalDescriptor& descriptor,
+                                       const std::string& workingDirectory,
+                                       const std::string& script) {
+    // 没有运行中的实例时 msg / @ / cli 很快以非零退出；卡住的实例由超时兜底
+    LaunchTelemetry::PhaseTimer timer(LaunchPhase::Ipc);
+    // shell 由已运行的实例派生，读不到本进程的描述符，脚本只能落盘
+    std::string scriptFile;
+    if (!script.empty()) {
+        scriptFile = WriteScriptFile(script, nullptr);
+        if (scriptFile.empty()) {
             return false;
         }
+    }
+    SpawnRequest request;
+    request.argv = BuildIpcTerminalArgv(descriptor, workingDirectory, scriptFile);
+    if (ProcessSpawner::RunAndWait(request, kIpcTimeoutMs, nullptr) == 0) {
+        return true;
+    }
+    RemoveScriptFile(scriptFile);
+    return false;
+}
+
+bool TerminalLauncher::BuildLinuxScript(const LaunchSpec& spec, std::string& script, std::string* errorMsg) {
+    // 脚本不作为 `bash -c` 的参数交给终端：argv 对本机所有用户可见，其中的 export 会泄露变量值，
+    // 单个参数也不能超过 128 KiB。由 SpawnWithScript 经继承的描述符或 0600 临时文件交给 bash。
+    if (!spec.profile.IsRemote()) {
+        script = BuildLocalInitScript(spec.profile);
+        return true;
+    }
+
+    return BuildRemoteCommand(spec, script, errorMsg);
+}
 
-        scriptFile << "#!/bin/bash\n";
+std::string TerminalLauncher::BuildLocalInitScript(const Profile& profile) {
+    // 改动生成的脚本内容时递增 ScriptCache::kFormatVersion
+    return ScriptCache::GetOrBuild(profile, "init", [&profile] {
+        bool hasStartupCommands = !profile.startupCommands.empty();
+        std::string effectiveWorkDir = profile.GetWorkingDirectory();
+
+        if (!hasStartupCommands && effectiveWorkDir.empty() && profile.environmentVariables.empty()) {
+            return std::string();
+        }
+
+        std::string script;
 
         // Change directory
         if (!effectiveWorkDir.empty()) {
-            std::string escaped = effectiveWorkDir;
-            for (size_t pos = 0; (pos = escaped.find('\'', pos)) != std::string::npos; pos += 4) {
-                escaped.replace(pos, 1, "'\"'\"'");
-            }
-            scriptFile << "cd '" << escaped << "'\n";
+            script += "cd " + ShellSingleQuote(effectiveWorkDir) + "\n";
         }
 
         // Set environment variables
         for (const auto& var : profile.environmentVariables) {
-            std::string escapedValue = var.value;
-            for (size_t pos = 0; (pos = escapedValue.find('\'', pos)) != std::string::npos; pos += 4) {
-                escapedValue.replace(pos, 1, "'\"'\"'");
-            }
-            scriptFile << "export " << var.name << "='" << escapedValue << "'\n";
+            script += "export " + var.name + "=" + ShellSingleQuote(var.value) + "\n";
         }
 
-        // If there are startup commands, write them to a separate temp file.
-        // They need to run AFTER the user's shell loads (nvm, PATH etc.),
-        // so we use $SHELL -i -c to get full environment first.
+        // Startup commands need to run AFTER the user's shell loads (nvm, PATH etc.),
+        // so we use $SHELL -i -c to get full environment first, then start a clean
+        // interactive shell.
         if (hasStartupCommands) {
-            std::string startupPath = "/tmp/mtc_startup_" + std::to_string(std::time(nullptr)) + ".sh";
-            std::ofstream startupFile(startupPath);
+            std::string startup;
             for (const auto& cmd : profile.startupCommands) {
                 if (!cmd.empty()) {
-                    startupFile << cmd << "\n";
+                    startup += cmd + "\n";
                 }
             }
-            startupFile.close();
-            chmod(startupPath.c_str(), 0600);
-
-            scriptFile << "rm -f '" << scriptPath << "'\n";
-            // Launch user's shell interactively (-i) so .zshrc/.bashrc loads first,
-            // then run startup commands, then start a clean interactive shell
-            scriptFile << "exec \"$SHELL\" -i -c \"source '" << startupPath
-                       << "'; rm -f '" << startupPath << "'; exec \\\"\\$SHELL\\\"\"\n";
+            startup += "exec \"$SHELL\"";
+            script += "exec \"$SHELL\" -i -c " + ShellSingleQuote(startup) + "\n";
         } else {
-            scriptFile << "rm -f '" << scriptPath << "'\n";
-            scriptFile << "exec \"$SHELL\"\n";
+            script += "exec \"$SHELL\"\n";
         }
-        scriptFile.close();
-
-        chmod(scriptPath.c_str(), 0700);
-    }
+        return script;
+    });
+}
 
-    int pipefd[2];
-    if (pipe(pipefd) == -1) {
-        if (errorMsg) *errorMsg = "Failed to create pipe: " + std::string(strerror(errno));
-        if (!scriptPath.empty()) remove(scriptPath.c_str());
-        return false;
+bool TerminalLauncher::SpawnWithScript(const TerminalDescriptor& descriptor, const std::string& script,
+                                       SpawnRequest& request, std::string* errorMsg) {
+    std::string scriptPath;
+    std::string scriptFile;
+    if (!script.empty() && descriptor.passesInheritedFds) {
+        request.inheritedScript = kCloseInheritedScript + script;
+        scriptPath = ProcessSpawner::kInheritedScriptPath;
+    } else if (!script.empty()) {
+        scriptFile = WriteScriptFile(script, errorMsg);
+        if (scriptFile.empty()) {
+            return false;
+        }
+        scriptPath = scriptFile;
     }
-
-    if (fcntl(pipefd[1], F_SETFD, FD_CLOEXEC) == -1) {
-        if (errorMsg) *errorMsg = "Failed to set FD_CLOEXEC: " + std::string(strerror(errno));
-        close(pipefd[0]);
-        close(pipefd[1]);
-        if (!scriptPath.empty()) remove(scriptPath.c_str());
-        return false;
+    request.argv = BuildScriptTerminalArgv(descriptor, scriptPath);
+    if (SpawnTerminal(request, errorMsg)) {
+        return true;
     }
+    RemoveScriptFile(scriptFile);
+    return false;
+}
 
-    // Resolve terminal type BEFORE fork (in parent process)
-    // so system("which ...") works reliably
-    TerminalType type = profile.terminalType;
-    if (type == TerminalType::Auto) {
-        type = AutoDetectTerminal();
+std::shared_ptr<const TerminalDescriptor> TerminalLauncher::ResolveDescriptor(const Profile& profile) {
+    // terminals.json 新增的终端没有对应的 TerminalType，按 id 指定；
+    // 条目被删掉后退回终端类型（通常是自动检测），不让配置因此打不开
+    if (!profile.terminalId.empty()) {
+        if (auto descriptor = TerminalRegistry::Find(profile.terminalId)) {
+            return descriptor;
+        }
     }
-    if (type == TerminalType::Auto) {
-        if (errorMsg) *errorMsg = "未找到支持的终端模拟器，请安装 exo-open、qterminal、gnome-terminal、konsole、xfce4-terminal、mate-terminal、alacritty 或 xterm";
-        close(pipefd[0]);
-        close(pipefd[1]);
-        if (!scriptPath.empty()) remove(scriptPath.c_str());
-        return false;
+    const TerminalType requested = profile.terminalType;
+    // 内置终端只能由界面打开；命令行、工作区等经本类启动时退回外部终端
+    if (requested == TerminalType::Auto || requested == TerminalType::Embedded) {
+        return TerminalRegistry::DetectInstalled();
     }
+    return TerminalRegistry::Find(TerminalTypeToString(requested));
+}
 
-    pid_t pid = fork();
-
-    if (pid == -1) {
-         if (errorMsg) *errorMsg = "Failed to fork: " + std::string(strerror(errno));
-         close(pipefd[0]);
-         close(pipefd[1]);
-         if (!scriptPath.empty()) remove(scriptPath.c_str());
-         return false;
+std::shared_ptr<const TerminalDescriptor> TerminalLauncher::ResolveTelemetered(const Profile& profile) {
+    LaunchTelemetry::PhaseTimer timer(LaunchPhase::Resolve);
+    auto descriptor = ResolveDescriptor(profile);
+    if (descriptor) {
+        LaunchTelemetry::SetTerminal(descriptor->id);
     }
+    return descriptor;
+}
 
-    if (pid == 0) {
-        // Child
-        close(pipefd[0]);
-
-        // Set only custom environment variables (system vars are inherited via fork)
-        // Setting all vars could override PATH and break execlp
-        for (const auto& var : profile.environmentVariables) {
-            setenv(var.name.c_str(), var.value.c_str(), 1);
-        }
-
-        // Ensure PATH includes standard directories so execlp can find terminal emulators
-        const char* currentPath = getenv("PATH");
-        std::string safePath = currentPath ? currentPath : "";
-        safePath += ":/usr/bin:/usr/local/bin:/bin:/snap/bin";
-        setenv("PATH", safePath.c_str(), 1);
-
-        if (!scriptPath.empty()) {
-            switch (type) {
-                case TerminalType::ExoOpen:
-                    execlp("exo-open", "exo-open", "--launch", "TerminalEmulator",
-                           "/bin/bash", scriptPath.c_str(), nullptr);
-                    break;
-                case TerminalType::QTerminal:
-                    execlp("qterminal", "qterminal", "-e",
-                           "/bin/bash", scriptPath.c_str(), nullptr);
-                    break;
-                case TerminalType::GnomeTerminal:
-                    execlp("gnome-terminal", "gnome-terminal", "--",
-                           "/bin/bash", scriptPath.c_str(), nullptr);
-                    break;
-                case TerminalType::Konsole:
-                    execlp("konsole", "konsole", "-e",
-                           "/bin/bash", scriptPath.c_str(), nullptr);
-                    break;
-                case TerminalType::Xfce4Terminal:
-                    execlp("xfce4-terminal", "xfce4-terminal", "--",
-                           "/bin/bash", scriptPath.c_str(), nullptr);
-                    break;
-                case TerminalType::MateTerminal:
-                    execlp("mate-terminal", "mate-terminal", "--",
-                           "/bin/bash", scriptPath.c_str(), nullptr);
-                    break;
-                case TerminalType::Alacritty:
-                    execlp("alacritty", "alacritty", "-e",
-                           "/bin/bash", scriptPath.c_str(), nullptr);
-                    break;
-                case TerminalType::Xterm:
-                default:
-                    execlp("xterm", "xterm", "-e",
-                           "/bin/bash", scriptPath.c_str(), nullptr);
-                    break;
-            }
-        } else {
-            switch (type) {
-                case TerminalType::ExoOpen:
-                    execlp("exo-open", "exo-open", "--launch", "TerminalEmulator", nullptr);
-                    break;
-                case TerminalType::QTerminal:
-                    execlp("qterminal", "qterminal", nullptr);
-                    break;
-                case TerminalType::GnomeTerminal:
-                    execlp("gnome-terminal", "gnome-terminal", "--", nullptr);
-                    break;
-                case TerminalType::Konsole:
-                    execlp("konsole", "konsole", nullptr);
-                    break;
-                case TerminalType::Xfce4Terminal:
-                    execlp("xfce4-terminal", "xfce4-terminal", nullptr);
-                    break;
-                case TerminalType::MateTerminal:
-                    execlp("mate-terminal", "mate-terminal", nullptr);
-                    break;
-                case TerminalType::Alacritty:
-                    execlp("alacritty", "alacritty", nullptr);
-                    break;
-                case TerminalType::Xterm:
-                default:
-                    execlp("xterm", "xterm", nullptr);
-                    break;
-            }
-        }
-
-        // If we get here, exec failed
-        std::string errDetail = "Failed to exec " +
-            TerminalTypeToString(type) + ": " + strerror(errno) +
-            " (PATH=" + (getenv("PATH") ? getenv("PATH") : "(null)") + ")";
-        // Write length + string through pipe
-        size_t len = errDetail.size();
-        (void)write(pipefd[1], &len, sizeof(len));
-        (void)write(pipefd[1], errDetail.c_str(), len);
-        _exit(1);
+std::string TerminalLauncher::NoTerminalMessage() {
+    std::string names;
+    for (const auto& descriptor : TerminalRegistry::All()) {
+        if (!names.empty()) names += "、";
+        names += descriptor->binary;
     }
+    return "未找到支持的终端模拟器，请安装 " + names + " 之一";
+}
 
-    // Parent
-    close(pipefd[1]);
-
-    size_t errLen = 0;
-    ssize_t count = read(pipefd[0], &errLen, sizeof(errLen));
-    if (count > 0 && errLen > 0 && errLen < 4096) {
-        std::vector<char> buf(errLen + 1, '\0');
-        (void)read(pipefd[0], buf.data(), errLen);
-        if (errorMsg) *errorMsg = std::string(buf.data());
-    } else if (count > 0) {
-        if (errorMsg) *errorMsg = "Unknown launch error";
+bool TerminalLauncher::SpawnTerminal(const SpawnRequest& request, std::string* errorMsg) {
+    LaunchTelemetry::PhaseTimer timer(LaunchPhase::Spawn);
+    // 常驻助手在线时只需序列化一条消息，否则在本进程 fork/exec
+    if (LaunchHelper::IsRunning()) {
+        return LaunchHelper::Spawn(request, errorMsg);
     }
-    close(pipefd[0]);
+    return ProcessSpawner::SpawnDetached(request, errorMsg);
+}
+#endif
 
-    if (count > 0) {
-        waitpid(pid, nullptr, 0);
-        if (!scriptPath.empty()) remove(scriptPath.c_str());
-        return false;
+#if defined(__linux__) || defined(__APPLE__)
+std::string TerminalLauncher::WriteScriptFile(const std::string& script, std::string* errorMsg) {
+    std::filesystem::path path = TempArtifacts::Allocate(
+        "init.sh", std::chrono::seconds(kScriptFileLifetimeSec), errorMsg);
+    if (path.empty()) {
+        return std::string();
     }
+    // 条目目录在 0700 的 mtc-<uid> 下，文件本身也只给本人读写
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        if (errorMsg) *errorMsg = "无法写入初始化脚本 " + path.string() + ": " + strerror(errno);
+        return std::string();
+    }
+    const std::string content = "rm -f -- \"$0\"\n" + script;
+    size_t written = 0;
+    while (written < content.size()) {
+        ssize_t n = write(fd, content.data() + written, content.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            if (errorMsg) *errorMsg = "无法写入初始化脚本 " + path.string() + ": " + strerror(errno);
+            close(fd);
+            RemoveScriptFile(path.string());
+            return std::string();
+        }
+        written += static_cast<size_t>(n);
+    }
+    close(fd);
+    return path.string();
+}
 
-    return true;
+void TerminalLauncher::RemoveScriptFile(const std::string& path) {
+    if (!path.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
 }
 #endif
 
 #ifdef __APPLE__
 bool TerminalLauncher::LaunchMacOS(
     const Profile& profile,
-    const std::map<std::string, std::string>& env,
     std::string* errorMsg
 ) {
-    // Create a temporary shell script to set up environment silently
-    std::string scriptPath = "/tmp/mtc_init_" + std::to_string(std::time(nullptr)) + ".sh";
+    LaunchTelemetry::SetTerminal(TerminalTypeToString(TerminalType::TerminalApp));
 
-    std::ofstream scriptFile(scriptPath);
-    if (!scriptFile.is_open()) {
-        if (errorMsg) *errorMsg = "Failed to create init script";
-        return false;
-    }
+    // Init script is cached under data/cache and reused while the profile is unchanged
+    LaunchTelemetry::PhaseTimer scriptTimer(LaunchPhase::Script);
+    fs::path cachedPath = ScriptCache::Materialize(profile, "init", ".sh", [&profile] {
+        std::string script = "#!/bin/bash\n";
 
-    scriptFile << "#!/bin/bash\n";
-
-    // Change directory
-    std::string effectiveWorkDir = profile.GetWorkingDirectory();
-    if (!effectiveWorkDir.empty()) {
-        std::string escaped = effectiveWorkDir;
-        for (size_t pos = 0; (pos = escaped.find('\'', pos)) != std::string::npos; pos += 4) {
-            escaped.replace(pos, 1, "'\"'\"'");
+        // Change directory
+        std::string effectiveWorkDir = profile.GetWorkingDirectory();
+        if (!effectiveWorkDir.empty()) {
+            script += "cd " + ShellSingleQuote(effectiveWorkDir) + "\n";
         }
-        scriptFile << "cd '" << escaped << "'\n";
-    }
 
-    // Set environment variables
-    for (const auto& var : profile.environmentVariables) {
-        std::string escapedName = var.name;
-        std::string escapedValue = var.value;
-        for (size_t pos = 0; (pos = escapedValue.find('\'', pos)) != std::string::npos; pos += 4) {
-            escapedValue.replace(pos, 1, "'\"'\"'");
+        // Set environment variables
+        for (const auto& var : profile.environmentVariables) {
+            script += "export " + var.name + "=" + ShellSingleQuote(var.value) + "\n";
         }
-        scriptFile << "export " << escapedName << "='" << escapedValue << "'\n";
-    }
 
-    // Execute startup commands
-    for (const auto& cmd : profile.startupCommands) {
-        if (!cmd.empty()) {
-            scriptFile << cmd << "\n";
+        // Execute startup commands
+        for (const auto& cmd : profile.startupCommands) {
+            if (!cmd.empty()) {
+                script += cmd + "\n";
+            }
         }
-    }
-
-    // Remove the script itself and clear screen
-    scriptFile << "rm -f '" << scriptPath << "'\n";
-    scriptFile << "clear\n";
-    scriptFile.close();
 
-    chmod(scriptPath.c_str(), 0700);
+        // Clear screen
+        script += "clear\n";
+        return script;
+    });
+    if (cachedPath.empty()) {
+        if (errorMsg) *errorMsg = "Failed to create init script";
+        return false;
+    }
+    std::string scriptPath = ShellSingleQuote(cachedPath.string());
+    scriptTimer.Stop();
 
     // Use AppleScript to open Terminal and source the script
     // Use . (dot) instead of source to avoid quoting issues
@@ -772,9 +976,10 @@ bool TerminalLauncher::LaunchMacOS(
 
     std::string cmd = "osascript -e '" + escapedScript + "' 2>&1";
 
+    // osascript 要等 Terminal.app 执行完 do script 才返回，整段计入启动进程
+    LaunchTelemetry::PhaseTimer spawnTimer(LaunchPhase::Spawn);
     FILE* fp = popen(cmd.c_str(), "r");
     if (!fp) {
-        remove(scriptPath.c_str());
         if (errorMsg) *errorMsg = "Failed to run osascript: " + std::string(strerror(errno));
         return false;
     }
@@ -788,7 +993,6 @@ bool TerminalLauncher::LaunchMacOS(
     int status = pclose(fp);
 
     if (status != 0) {
-        remove(scriptPath.c_str());
         if (errorMsg) {
             if (!result.empty() && result.back() == '\n') {
                 result.pop_back();
@@ -805,52 +1009,163 @@ bool TerminalLauncher::LaunchMacOS(
 // ============================================================================
 // 远程 SSH 启动
 // ============================================================================
-bool TerminalLauncher::LaunchRemote(const Profile& profile, std::string* errorMsg) {
-    const SshHost* host = ConfigManager::GetInstance().GetSshHost(profile.sshHostId);
-    if (!host) {
+#ifdef _WIN32
+bool TerminalLauncher::BuildWindowsRemoteCommand(
+    const Profile& profile,
+    const std::string& sshCore,
+    std::wstring& sshCmdW,
+    std::string* errorMsg
+) {
+    fs::path innerPath = ScriptCache::Materialize(profile, "remote", ".sh", [&profile] {
+        return BuildRemoteInnerScript(profile);
+    });
+    if (innerPath.empty()) {
+        if (errorMsg) *errorMsg = "无法创建远程脚本临时文件";
+        return false;
+    }
+
+    // cmd 支持 < 重定向，把内层脚本通过 stdin 送往远程 bash
+    sshCmdW = Utf8ToWide(sshCore) + L" bash -s < \"" + innerPath.wstring() + L"\"";
+    return true;
+}
+#endif
+
+bool TerminalLauncher::BuildSshTarget(const LaunchSpec& spec, std::string& target, std::string* errorMsg) {
+    if (!spec.sshHost) {
         if (errorMsg) *errorMsg = "找不到 SSH 主机配置（可能已被删除）";
         return false;
     }
-    const Credential* cred = profile.credentialId.empty()
-        ? nullptr
-        : ConfigManager::GetInstance().GetCredential(profile.credentialId);
+    const SshHost* host = &*spec.sshHost;
+    const Credential* cred = spec.credential ? &*spec.credential : nullptr;
 
-    // ssh 主干：-t 强制 TTY；非标准端口加 -p；私钥认证加 -i
+    // 非标准端口加 -p；私钥认证加 -i
     std::string userAtHost = host->host;
     if (!host->username.empty()) {
         userAtHost = host->username + "@" + host->host;
     }
-    std::string sshCore = "ssh -t";
+    target.clear();
     if (host->port != 22) {
-        sshCore += " -p " + std::to_string(host->port);
+        target += "-p " + std::to_string(host->port) + " ";
     }
     if (cred && cred->type == CredentialType::PrivateKey && !cred->keyPath.empty()) {
-        sshCore += " -i " + ShellSingleQuote(cred->keyPath);
+        target += "-i " + ShellSingleQuote(cred->keyPath) + " ";
     }
-    sshCore += " " + userAtHost;
+    target += userAtHost;
+    return true;
+}
 
-    // 远程执行的内层脚本（cd + export + 启动命令 + 交互 shell）
-    std::string innerScript = BuildRemoteInnerScript(profile);
+bool TerminalLauncher::BuildSshCore(const LaunchSpec& spec, std::string& sshCore, std::string* errorMsg) {
+    // -t 强制 TTY
+    std::string target;
+    if (!BuildSshTarget(spec, target, errorMsg)) {
+        return false;
+    }
+    sshCore = "ssh -t " + target;
+    return true;
+}
 
-#if defined(__APPLE__) || defined(__linux__)
-    // 写入临时文件，通过 `bash -s < script` 由 stdin 送往远程，规避命令行转义
-    std::string innerPath = "/tmp/mtc_remote_inner_" +
-        std::to_string(std::time(nullptr)) + ".sh";
+bool TerminalLauncher::BuildRemoteCommand(const LaunchSpec& spec, std::string& command, std::string* errorMsg) {
+    std::string target;
+    if (!BuildSshTarget(spec, target, errorMsg)) {
+        return false;
+    }
+    // 内层脚本里有 export 的变量值：作为 ssh 的参数会出现在本机与远程的进程列表里。
+    // 改为三步，共用一条主连接（ControlMaster），只认证一次：
+    //   1. ssh -f -N -M 建立主连接（密码等提示照常在终端里完成），套接字放在本地 0700 临时目录；
+    //   2. 经主连接执行 mktemp + cat，内层脚本由 here-document 走 stdin 写进远程 0600 临时文件；
+    //   3. 经主连接以 -t 打开交互会话执行该文件，脚本开头先删掉自己。
+    // 远程命令都交给 bash -c，不依赖远程登录 shell 的语法；退出（含终端关闭）时关掉主连接。
+    const std::string inner = "rm -f -- \"$0\"\n" + BuildRemoteInnerScript(spec.profile);
+    std::string delimiter = "MTC_REMOTE_SCRIPT";
+    while (("\n" + inner).find("\n" + delimiter + "\n") != std::string::npos) {
+        delimiter += "_";
+    }
+    const std::string upload =
+        "umask 077 && f=$(mktemp \"${TMPDIR:-/tmp}/mtc-init.XXXXXX\") && cat > \"$f\" && printf '%s\\n' \"$f\"";
+    const std::string mux = "-S \"$mtc_ctl/c\" " + target;
+
+    command = "mtc_ctl=$(mktemp -d \"${TMPDIR:-/tmp}/mtc-ssh.XXXXXX\") || exit 1\n";
+    command += "mtc_close() { ssh -O exit " + mux + " 2>/dev/null; rm -rf \"$mtc_ctl\"; }\n";
+    command += "trap mtc_close EXIT\n";
+    command += "trap 'exit 129' HUP TERM\n";
+    command += "ssh -f -N -M " + mux + " || exit 1\n";
+    // here-document 不放进 $(...)：macOS 自带的 bash 3.2 在命令替换里解析它有问题
+    command += "ssh -T " + mux + " " + ShellSingleQuote("bash -c " + ShellSingleQuote(upload)) +
+               " > \"$mtc_ctl/remote\" <<'" + delimiter + "' || exit 1\n";
+    command += inner;
+    if (!inner.empty() && inner.back() != '\n') command += "\n";
+    command += delimiter + "\n";
+    command += "mtc_remote=$(cat \"$mtc_ctl/remote\")\n";
+    command += "ssh -t " + mux + " \"bash $(printf %q \"$mtc_remote\")\"\n";
+    return true;
+}
+
+bool TerminalLauncher::BuildEmbeddedSession(const LaunchSpec& spec, SpawnRequest& request,
+                                            std::string* errorMsg) {
+#ifdef __linux__
+    std::string script;
+    if (!BuildLinuxScript(spec, script, errorMsg)) {
+        return false;
+    }
+    // 脚本为空（没有目录、变量和启动命令）时直接进入用户的 shell；
+    // 否则经 memfd 交给 bash，变量值不出现在 argv 里
+    request = SpawnRequest();
+    if (script.empty()) {
+        request.argv = {"/bin/bash", "-c", "exec \"${SHELL:-/bin/bash}\""};
+    } else {
+        request.argv = {"/bin/bash", ProcessSpawner::kInheritedScriptPath};
+        request.inheritedScript = kCloseInheritedScript + script;
+    }
+    return true;
+#else
+    if (errorMsg) *errorMsg = "内置终端仅支持 Linux";
+    return false;
+#endif
+}
+
+bool TerminalLauncher::LaunchRemote(const Profile& profile, std::string* errorMsg) {
+    return LaunchRemote(MakeLaunchSpec(profile), errorMsg);
+}
+
+bool TerminalLauncher::LaunchRemote(const LaunchSpec& spec, std::string* errorMsg) {
+#ifdef __linux__
+    std::string script;
     {
-        std::ofstream f(innerPath);
-        if (!f.is_open()) {
-            if (errorMsg) *errorMsg = "无法创建远程脚本临时文件";
+        LaunchTelemetry::PhaseTimer timer(LaunchPhase::Script);
+        if (!BuildLinuxScript(spec, script, errorMsg)) {
             return false;
         }
-        f << innerScript;
     }
-    chmod(innerPath.c_str(), 0600);
 
-    std::string sshCmd = sshCore + " bash -s < " + ShellSingleQuote(innerPath) +
-                         "; rm -f " + ShellSingleQuote(innerPath);
-#endif
+    auto descriptor = ResolveTelemetered(spec.profile);
+    if (!descriptor) {
+        if (errorMsg) *errorMsg = NoTerminalMessage();
+        return false;
+    }
+
+    if (HasIpc(*descriptor) && TryLaunchViaIpc(*descriptor, std::string(), script)) {
+        return true;
+    }
+
+    SpawnRequest request;
+    return SpawnWithScript(*descriptor, script, request, errorMsg);
+#elif defined(__APPLE__)
+    LaunchTelemetry::SetTerminal(TerminalTypeToString(TerminalType::TerminalApp));
+    // do script 的文本会留在 Terminal 的 shell 历史里：只放脚本路径，脚本经 0600 文件交给 bash
+    std::string scriptFile;
+    {
+        LaunchTelemetry::PhaseTimer timer(LaunchPhase::Script);
+        std::string script;
+        if (!BuildRemoteCommand(spec, script, errorMsg)) {
+            return false;
+        }
+        scriptFile = WriteScriptFile(script, errorMsg);
+        if (scriptFile.empty()) {
+            return false;
+        }
+    }
+    std::string sshCmd = "exec /bin/bash " + ShellSingleQuote(scriptFile);
 
-#ifdef __APPLE__
     // AppleScript 字符串里转义反斜杠和双引号
     std::string asCmd;
     for (char c : sshCmd) {
@@ -871,10 +1186,11 @@ bool TerminalLauncher::LaunchRemote(const Profile& profile, std::string* errorMs
     }
     std::string cmd = "osascript -e '" + escapedScript + "' 2>&1";
 
+    LaunchTelemetry::PhaseTimer spawnTimer(LaunchPhase::Spawn);
     FILE* fp = popen(cmd.c_str(), "r");
     if (!fp) {
-        remove(innerPath.c_str());
         if (errorMsg) *errorMsg = "无法运行 osascript: " + std::string(strerror(errno));
+        RemoveScriptFile(scriptFile);
         return false;
     }
     std::array<char, 128> buffer;
@@ -884,108 +1200,38 @@ bool TerminalLauncher::LaunchRemote(const Profile& profile, std::string* errorMs
     }
     int status = pclose(fp);
     if (status != 0) {
-        remove(innerPath.c_str());
         if (errorMsg) {
             if (!result.empty() && result.back() == '\n') result.pop_back();
             *errorMsg = result;
         }
+        RemoveScriptFile(scriptFile);
         return false;
     }
     return true;
-#endif
-
-#ifdef __linux__
-    // 包装脚本：跑 ssh，结束后清理临时文件
-    std::string wrapperPath = "/tmp/mtc_remote_launch_" +
-        std::to_string(std::time(nullptr)) + ".sh";
+#elif defined(_WIN32)
+    std::wstring sshCmdW;
     {
-        std::ofstream f(wrapperPath);
-        if (!f.is_open()) {
-            remove(innerPath.c_str());
-            if (errorMsg) *errorMsg = "无法创建启动脚本临时文件";
+        LaunchTelemetry::PhaseTimer timer(LaunchPhase::Script);
+        std::string sshCore;
+        if (!BuildSshCore(spec, sshCore, errorMsg)) {
             return false;
         }
-        f << "#!/bin/bash\n" << sshCmd << "\n";
-    }
-    chmod(wrapperPath.c_str(), 0700);
-
-    TerminalType type = profile.terminalType;
-    if (type == TerminalType::Auto) type = AutoDetectTerminal();
-    if (type == TerminalType::Auto) {
-        remove(innerPath.c_str());
-        remove(wrapperPath.c_str());
-        if (errorMsg) *errorMsg = "未找到支持的终端模拟器";
-        return false;
-    }
 
-    pid_t pid = fork();
-    if (pid == -1) {
-        remove(innerPath.c_str());
-        remove(wrapperPath.c_str());
-        if (errorMsg) *errorMsg = "fork 失败: " + std::string(strerror(errno));
-        return false;
-    }
-    if (pid == 0) {
-        // 子进程：让 PATH 覆盖常见目录后执行终端模拟器
-        const char* currentPath = getenv("PATH");
-        std::string safePath = currentPath ? currentPath : "";
-        safePath += ":/usr/bin:/usr/local/bin:/bin:/snap/bin";
-        setenv("PATH", safePath.c_str(), 1);
-
-        switch (type) {
-            case TerminalType::ExoOpen:
-                execlp("exo-open", "exo-open", "--launch", "TerminalEmulator",
-                       "/bin/bash", wrapperPath.c_str(), nullptr); break;
-            case TerminalType::QTerminal:
-                execlp("qterminal", "qterminal", "-e",
-                       "/bin/bash", wrapperPath.c_str(), nullptr); break;
-            case TerminalType::GnomeTerminal:
-                execlp("gnome-terminal", "gnome-terminal", "--",
-                       "/bin/bash", wrapperPath.c_str(), nullptr); break;
-            case TerminalType::Konsole:
-                execlp("konsole", "konsole", "-e",
-                       "/bin/bash", wrapperPath.c_str(), nullptr); break;
-            case TerminalType::Xfce4Terminal:
-                execlp("xfce4-terminal", "xfce4-terminal", "--",
-                       "/bin/bash", wrapperPath.c_str(), nullptr); break;
-            case TerminalType::MateTerminal:
-                execlp("mate-terminal", "mate-terminal", "--",
-                       "/bin/bash", wrapperPath.c_str(), nullptr); break;
-            case TerminalType::Alacritty:
-                execlp("alacritty", "alacritty", "-e",
-                       "/bin/bash", wrapperPath.c_str(), nullptr); break;
-            case TerminalType::Xterm:
-            default:
-                execlp("xterm", "xterm", "-e",
-                       "/bin/bash", wrapperPath.c_str(), nullptr); break;
+        // cmd 下单引号不是引号，内层脚本仍以（缓存的）文件经 stdin 送往远程
+        if (!BuildWindowsRemoteCommand(spec.profile, sshCore, sshCmdW, errorMsg)) {
+            return false;
         }
-        _exit(1);
     }
-    return true;
-#endif
 
-#ifdef _WIN32
-    std::filesystem::path tempDir = std::filesystem::temp_directory_path();
-    std::string innerName = "mtc_remote_inner_" + std::to_string(std::time(nullptr)) + ".sh";
-    std::filesystem::path innerPath = tempDir / innerName;
+    bool useWt;
     {
-        std::ofstream f(innerPath);
-        if (!f.is_open()) {
-            if (errorMsg) *errorMsg = "无法创建远程脚本临时文件";
-            return false;
-        }
-        f << innerScript;
+        LaunchTelemetry::PhaseTimer timer(LaunchPhase::Resolve);
+        TerminalType type = ResolveTerminalType(spec.profile.terminalType);
+        useWt = (type == TerminalType::WindowsTerminal) && IsTerminalAvailable(TerminalType::WindowsTerminal);
     }
-
-    // cmd 支持 < 重定向，把内层脚本通过 stdin 送往远程 bash
-    std::wstring innerW = innerPath.wstring();
-    std::wstring sshCmdW = Utf8ToWide(sshCore) + L" bash -s < \"" + innerW + L"\"";
-
-    TerminalType type = profile.terminalType;
-    if (type == TerminalType::Auto) type = AutoDetectTerminal();
+    LaunchTelemetry::SetTerminal(TerminalTypeToString(useWt ? TerminalType::WindowsTerminal : TerminalType::Cmd));
 
     std::wstring command, args;
-    bool useWt = (type == TerminalType::WindowsTerminal) && IsTerminalAvailable(TerminalType::WindowsTerminal);
     if (useWt) {
         command = L"wt.exe";
         args = L"new-tab cmd /k \"" + sshCmdW + L"\"";
@@ -999,6 +1245,7 @@ bool TerminalLauncher::LaunchRemote(const Profile& profile, std::string* errorMs
     PROCESS_INFORMATION pi = { 0 };
     DWORD flags = CREATE_UNICODE_ENVIRONMENT | CREATE_NEW_CONSOLE;
 
+    LaunchTelemetry::PhaseTimer spawnTimer(LaunchPhase::Spawn);
     BOOL ok = CreateProcessW(nullptr, &cmdLine[0], nullptr, nullptr, FALSE,
                              flags, nullptr, nullptr, &si, &pi);
     DWORD lastError = ::GetLastError();
@@ -1009,6 +1256,9 @@ bool TerminalLauncher::LaunchRemote(const Profile& profile, std::string* errorMs
     }
     if (errorMsg) *errorMsg = GetLastErrorAsString(lastError);
     return false;
+#else
+    if (errorMsg) *errorMsg = "Unsupported platform";
+    return false;
 #endif
 }
 
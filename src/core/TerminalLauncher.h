@@ -1,52 +1,149 @@
 #pragma once
 #include "Types.h"
-#include <map>
+#include "ProcessSpawner.h"
+#include "TerminalDescriptor.h"
+#include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+// 一次启动所需数据的快照：配置本身 + 远程配置引用的主机/凭据。
+// 在 UI 线程由 MakeLaunchSpec 解析好，之后可安全交给后台线程，不再访问 ConfigManager。
+struct LaunchSpec {
+    Profile profile;
+    std::optional<SshHost> sshHost;        // 远程配置的主机；找不到时为空
+    std::optional<Credential> credential;
+};
+
+// 单个配置的启动结果（批量启动时逐项汇总）
+struct LaunchResult {
+    std::string profileId;
+    std::string profileName;
+    bool success = false;
+    std::string errorMsg;
+    double elapsedMs = 0;          // 从开始启动到返回的耗时
+};
+
 class TerminalLauncher {
 public:
     // 启动终端（Profile 标记为远程时自动走 SSH 路径）
     static bool Launch(const Profile& profile, std::string* errorMsg = nullptr);
+    static bool Launch(const LaunchSpec& spec, std::string* errorMsg = nullptr);
+
+    // 内置终端面板：生成在 pty 里运行的命令（与外部终端相同的初始化脚本 / ssh 命令）。
+    // 仅 Linux 支持，其他平台返回 false。
+    static bool BuildEmbeddedSession(const LaunchSpec& spec, SpawnRequest& request,
+                                     std::string* errorMsg = nullptr);
+
+    // 从 ConfigManager 解析出启动快照（须在修改配置的线程上调用）
+    static LaunchSpec MakeLaunchSpec(const Profile& profile);
 
     // 启动远程 SSH 会话（在外部系统终端里跑 ssh）。供 Launch 内部分发。
     static bool LaunchRemote(const Profile& profile, std::string* errorMsg = nullptr);
 
+    // 批量启动：在有界工作线程池上并发执行 Launch，结果与输入一一对应；
+    // 只有一项（或 maxConcurrency <= 1）时在调用线程上依次执行
+    static std::vector<LaunchResult> LaunchBatch(const std::vector<Profile>& profiles,
+                                                 size_t maxConcurrency = 4);
+    static std::vector<LaunchResult> LaunchBatch(const std::vector<LaunchSpec>& specs,
+                                                 size_t maxConcurrency = 4);
+
+    // 打开工作区：标签页布局且终端支持时在同一窗口开多个标签，否则逐个开窗口。
+    // 工作区里已删除的配置会被跳过；部分失败时 errorMsg 汇总每个失败项。
+    static bool LaunchWorkspace(const Workspace& workspace, std::string* errorMsg = nullptr);
+    static bool LaunchWorkspace(const std::vector<LaunchSpec>& specs, WorkspaceLayout layout,
+                                std::string* errorMsg = nullptr);
+    // 按顺序解析工作区中仍存在的配置
+    static std::vector<LaunchSpec> ResolveWorkspace(const Workspace& workspace);
+
+    // 提前完成终端自动探测（结果缓存），可在后台线程调用
+    static void Prewarm();
+
     // 获取当前平台可用的终端类型
     static std::vector<TerminalType> GetAvailableTerminals();
 
     // 获取终端类型的显示名称
     static std::string GetTerminalDisplayName(TerminalType type);
+    // 配置所用终端的显示名称：指定了自定义终端时取其 displayName（条目已不存在时为 id）
+    static std::string GetTerminalDisplayName(const Profile& profile);
+
+    // data/terminals.json 中新增的终端（id, 显示名），供配置按 id 指定（Profile::terminalId）。
+    // 覆盖内置条目的不在其中，仍经 TerminalType 选择。仅 Linux，其他平台为空。
+    static std::vector<std::pair<std::string, std::string>> GetCustomTerminals();
 
     // 检查特定终端是否可用
     static bool IsTerminalAvailable(TerminalType type);
 
 private:
-    // 构建环境变量映射
-    static std::map<std::string, std::string> BuildEnvironment(
-        const std::vector<EnvVariable>& customVars
-    );
-
-    // 自动检测最佳终端
+    // 自动检测最佳终端（结果在进程内缓存）
     static TerminalType AutoDetectTerminal();
+    static TerminalType DetectInstalledTerminal();
+    // Auto 解析为自动检测结果，其余原样返回
+    static TerminalType ResolveTerminalType(TerminalType requested);
+
+    // 工作区：该终端能否一次调用打开多个标签页
+    static bool SupportsTabs(TerminalType type);
+    static bool LaunchTabs(const std::vector<LaunchSpec>& specs, TerminalType type,
+                           std::string* errorMsg);
 
     // 远程 SSH：用单引号包裹一个字符串（转义内部单引号）
     static std::string ShellSingleQuote(const std::string& s);
     // 远程 SSH：生成将在远程执行的 bash 脚本（cd + export + 启动命令 + 交互 shell）
     static std::string BuildRemoteInnerScript(const Profile& profile);
+    // 远程 SSH：ssh 的目标部分（-p/-i + user@host），主机缺失时返回 false
+    static bool BuildSshTarget(const LaunchSpec& spec, std::string& target, std::string* errorMsg);
+    // 远程 SSH：ssh 主干命令（-t + 目标部分）
+    static bool BuildSshCore(const LaunchSpec& spec, std::string& sshCore, std::string* errorMsg);
+    // 远程 SSH：本地执行的 bash 脚本。内层脚本经 here-document 写进 stdin 上传到远程 0600 临时文件，
+    // 再复用同一条已认证的连接打开交互会话执行它；变量值不出现在本地或远程任何进程的 argv 里
+    static bool BuildRemoteCommand(const LaunchSpec& spec, std::string& command, std::string* errorMsg);
+    static bool LaunchRemote(const LaunchSpec& spec, std::string* errorMsg);
     
     // 平台特定实现
 #ifdef _WIN32
-    static bool LaunchWindows(const Profile& profile, 
-                              const std::map<std::string, std::string>& env,
-                              std::string* errorMsg);
+    static bool LaunchWindows(const Profile& profile, std::string* errorMsg);
+    // 写 PowerShell 初始化脚本（环境变量 + 目录 + 启动命令），失败返回空
+    static std::wstring WriteWindowsInitScript(const Profile& profile);
+    // wt.exe 的一个 new-tab 子命令，运行上面的初始化脚本
+    static std::wstring BuildWtTabArgs(const std::string& title, const std::wstring& scriptPath);
+    // 取远程内层脚本的缓存文件，返回 `ssh ... bash -s < "file"` 命令
+    static bool BuildWindowsRemoteCommand(const Profile& profile,
+                                          const std::string& sshCore,
+                                          std::wstring& sshCmdW,
+                                          std::string* errorMsg);
 #elif defined(__linux__)
-    static bool LaunchLinux(const Profile& profile,
-                            const std::map<std::string, std::string>& env,
-                            std::string* errorMsg);
+    static bool LaunchLinux(const Profile& profile, std::string* errorMsg);
+    // 解析配置所用终端的描述：terminalId 优先（条目已删除时退回 terminalType），
+    // TerminalType 按同名 id 查找（Auto = 第一个已安装的）；找不到返回空
+    static std::shared_ptr<const TerminalDescriptor> ResolveDescriptor(const Profile& profile);
+    // 同上，计入启动遥测的“探测终端”阶段并记下实际使用的终端
+    static std::shared_ptr<const TerminalDescriptor> ResolveTelemetered(const Profile& profile);
+    static std::string NoTerminalMessage();
+    // 经终端的控制通道在已运行的实例里开新窗口；成功返回 true，否则由调用方启动新进程
+    static bool TryLaunchViaIpc(const TerminalDescriptor& descriptor,
+                                const std::string& workingDirectory,
+                                const std::string& script);
+    static constexpr int kIpcTimeoutMs = 2000;
+    static bool LaunchTabs(const std::vector<LaunchSpec>& specs, const TerminalDescriptor& descriptor,
+                           std::string* errorMsg);
+    // 生成本地初始化脚本或远程 ssh 命令脚本（纯内存）；不需要时 script 为空
+    static bool BuildLinuxScript(const LaunchSpec& spec, std::string& script, std::string* errorMsg);
+    static std::string BuildLocalInitScript(const Profile& profile);
+    // 启动终端执行 script：终端能传递描述符时经 memfd（bash /dev/fd/3），否则经 WriteScriptFile。
+    // 脚本不进 argv；request 的 argv 由这里填写，其余字段由调用方设置
+    static bool SpawnWithScript(const TerminalDescriptor& descriptor, const std::string& script,
+                                SpawnRequest& request, std::string* errorMsg);
+    // 经常驻助手（若在运行）或本进程启动终端
+    static bool SpawnTerminal(const SpawnRequest& request, std::string* errorMsg);
 #elif defined(__APPLE__)
-    static bool LaunchMacOS(const Profile& profile,
-                            const std::map<std::string, std::string>& env,
-                            std::string* errorMsg);
+    static bool LaunchMacOS(const Profile& profile, std::string* errorMsg);
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+    // 落盘的初始化脚本在执行时自删；没被执行的（终端启动失败、崩溃）到期后由 TempArtifacts 清理
+    static constexpr int kScriptFileLifetimeSec = 600;
+    // 把脚本写进 MTC 临时目录下权限 0600 的文件（执行时先删掉自己），返回路径；失败返回空
+    static std::string WriteScriptFile(const std::string& script, std::string* errorMsg);
+    static void RemoveScriptFile(const std::string& path);
 #endif
 };
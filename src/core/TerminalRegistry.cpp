@@ -0,0 +1,165 @@
+#include "TerminalRegistry.h"
+#include "ProcessSpawner.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+
+using json = nlohmann::json;
+
+namespace {
+
+using DescriptorList = std::vector<std::shared_ptr<const TerminalDescriptor>>;
+
+std::mutex g_mutex;
+DescriptorList g_descriptors;
+bool g_initialized = false;
+std::shared_ptr<const TerminalDescriptor> g_detected;
+bool g_detectDone = false;
+
+DescriptorList MakeList(const std::vector<TerminalDescriptor>& descriptors) {
+    DescriptorList list;
+    for (const auto& d : descriptors) {
+        list.push_back(std::make_shared<const TerminalDescriptor>(d));
+    }
+    return list;
+}
+
+// 调用方持有 g_mutex
+void EnsureInitialized() {
+    if (!g_initialized) {
+        g_descriptors = MakeList(BuiltinTerminalDescriptors());
+        g_initialized = true;
+    }
+}
+
+void ReadStrings(const json& j, const char* key, std::vector<std::string>& out) {
+    if (j.contains(key) && j[key].is_array()) {
+        out.clear();
+        for (const auto& item : j[key]) {
+            if (item.is_string()) out.push_back(item.get<std::string>());
+        }
+    }
+}
+
+TerminalTabStyle StringToTabStyle(const std::string& str) {
+    if (str == "grouped") return TerminalTabStyle::Grouped;
+    if (str == "per-call") return TerminalTabStyle::PerCall;
+    return TerminalTabStyle::None;
+}
+
+// 在 base（内置条目或默认值）上叠加 JSON 中给出的字段
+void ApplyJson(const json& j, TerminalDescriptor& d) {
+    d.displayName = j.value("displayName", d.displayName.empty() ? d.id : d.displayName);
+    d.binary = j.value("binary", d.binary);
+    ReadStrings(j, "baseArgs", d.baseArgs);
+    ReadStrings(j, "execArgs", d.execArgs);
+    d.commandAsString = j.value("commandAsString", d.commandAsString);
+    ReadStrings(j, "workingDirArgs", d.workingDirArgs);
+    d.inheritsProcessState = j.value("inheritsProcessState", d.inheritsProcessState);
+    d.passesInheritedFds = j.value("passesInheritedFds", d.passesInheritedFds);
+    if (j.contains("tabStyle") && j["tabStyle"].is_string()) {
+        d.tabStyle = StringToTabStyle(j["tabStyle"].get<std::string>());
+    }
+    ReadStrings(j, "firstTabArgs", d.firstTabArgs);
+    ReadStrings(j, "nextTabArgs", d.nextTabArgs);
+    ReadStrings(j, "titleArgs", d.titleArgs);
+    ReadStrings(j, "tabCommandArgs", d.tabCommandArgs);
+    ReadStrings(j, "ipcArgs", d.ipcArgs);
+    ReadStrings(j, "ipcWorkingDirArgs", d.ipcWorkingDirArgs);
+    ReadStrings(j, "ipcExecArgs", d.ipcExecArgs);
+    d.ipcEnv = j.value("ipcEnv", d.ipcEnv);
+}
+
+} // namespace
+
+bool TerminalRegistry::LoadUserDescriptors(const std::filesystem::path& file, std::string* errorMsg) {
+    std::vector<TerminalDescriptor> builtins = BuiltinTerminalDescriptors();
+    std::vector<TerminalDescriptor> added;
+    bool ok = true;
+
+    std::error_code ec;
+    if (std::filesystem::exists(file, ec)) {
+        try {
+            std::ifstream in(file);
+            json j;
+            in >> j;
+            if (!j.is_array()) {
+                throw std::runtime_error("terminals.json must be an array");
+            }
+            for (const auto& item : j) {
+                std::string id = item.value("id", "");
+                if (id.empty()) continue;
+                auto it = std::find_if(builtins.begin(), builtins.end(),
+                    [&id](const TerminalDescriptor& d) { return d.id == id; });
+                if (it != builtins.end()) {
+                    ApplyJson(item, *it);
+                    continue;
+                }
+                TerminalDescriptor d;
+                d.id = id;
+                ApplyJson(item, d);
+                if (!d.binary.empty()) {
+                    added.push_back(d);
+                }
+            }
+        } catch (const std::exception& e) {
+            if (errorMsg) *errorMsg = e.what();
+            builtins = BuiltinTerminalDescriptors();
+            added.clear();
+            ok = false;
+        }
+    }
+
+    added.insert(added.end(), builtins.begin(), builtins.end());
+    DescriptorList list = MakeList(added);
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_descriptors = std::move(list);
+    g_initialized = true;
+    g_detected.reset();
+    g_detectDone = false;
+    return ok;
+}
+
+std::shared_ptr<const TerminalDescriptor> TerminalRegistry::Find(const std::string& id) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    EnsureInitialized();
+    for (const auto& d : g_descriptors) {
+        if (d->id == id) return d;
+    }
+    return nullptr;
+}
+
+std::vector<std::shared_ptr<const TerminalDescriptor>> TerminalRegistry::All() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    EnsureInitialized();
+    return g_descriptors;
+}
+
+bool TerminalRegistry::IsInstalled(const TerminalDescriptor& descriptor) {
+#ifdef _WIN32
+    return false;
+#else
+    return !descriptor.binary.empty() && !ProcessSpawner::FindExecutable(descriptor.binary).empty();
+#endif
+}
+
+std::shared_ptr<const TerminalDescriptor> TerminalRegistry::DetectInstalled() {
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (g_detectDone) return g_detected;
+    }
+    // 逐个查 PATH，放在锁外；并发检测结果相同
+    std::shared_ptr<const TerminalDescriptor> found;
+    for (const auto& d : All()) {
+        if (IsInstalled(*d)) {
+            found = d;
+            break;
+        }
+    }
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_detected = found;
+    g_detectDone = true;
+    return found;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "TerminalDescriptor.h"
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 终端描述注册表：内置条目 + 用户 data/terminals.json
+//
+// terminals.json 是一个对象数组，字段与 TerminalDescriptor 同名（tabStyle 取
+// "none" / "grouped" / "per-call"）。id 与内置条目相同时只覆盖给出的字段；
+// 新 id 需提供 binary，并排在内置条目之前参与自动检测。
+// 可在后台线程查询；返回的描述为只读快照，重新加载不影响已取得的指针。
+class TerminalRegistry {
+public:
+    // 文件不存在时只用内置条目；解析失败返回 false 并保留内置条目
+    static bool LoadUserDescriptors(const std::filesystem::path& file, std::string* errorMsg = nullptr);
+
+    static std::shared_ptr<const TerminalDescriptor> Find(const std::string& id);
+
+    // 自动检测的顺序
+    static std::vector<std::shared_ptr<const TerminalDescriptor>> All();
+
+    // binary 能否在 PATH 中找到
+    static bool IsInstalled(const TerminalDescriptor& descriptor);
+
+    // 按顺序第一个已安装的终端（结果缓存，重新加载后失效）；都没有时为空
+    static std::shared_ptr<const TerminalDescriptor> DetectInstalled();
+};
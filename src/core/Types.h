@@ -23,10 +23,14 @@ enum class TerminalType {
     Xfce4Terminal,
     MateTerminal,
     Alacritty,
+    Kitty,
+    WezTerm,
     Xterm,
     // macOS
     TerminalApp,
-    ITerm2
+    ITerm2,
+    // MTC 窗口内的终端面板（Linux）
+    Embedded
 };
 
 // SSH 主机（"连哪台机器、以谁身份"）
@@ -36,6 +40,7 @@ struct SshHost {
     std::string host;
     int port = 22;
     std::string username;          // 登录用户名
+    int connectTimeoutSec = 10;    // TCP 连接超时（秒），含各地址的全部尝试
     std::string createdAt;
     std::string updatedAt;
 };
@@ -76,12 +81,31 @@ struct Profile {
     std::string credentialId;              // 空 = 不带凭据（依赖 Agent / 默认密钥）
     std::string remoteWorkingDirectory;    // 远程初始目录（文件浏览器 & ssh cd 起点）
 
+    // data/terminals.json 中新增终端的 id；非空时优先于 terminalType（仅 Linux）
+    std::string terminalId;
+
     std::string GetWorkingDirectory() const;
 
     // 是否为远程配置
     bool IsRemote() const { return !sshHostId.empty(); }
 };
 
+// 工作区的打开方式
+enum class WorkspaceLayout {
+    Tabs,       // 同一终端模拟器窗口里的多个标签页（终端不支持时退回独立窗口）
+    Windows     // 每个配置一个独立窗口
+};
+
+// 工作区：一组按顺序一起打开的配置
+struct Workspace {
+    std::string id;
+    std::string name;
+    std::vector<std::string> profileIds;   // 打开顺序即标签顺序
+    WorkspaceLayout layout = WorkspaceLayout::Tabs;
+    std::string createdAt;
+    std::string updatedAt;
+};
+
 struct ProfileTreeNode {
     std::string label;
     std::string fullPath;
@@ -95,6 +119,8 @@ struct AppSettings {
     std::string language = "zh-CN";
     std::string theme = "system";
     bool autoBackup = true;
+    bool launchHelper = false;     // Linux：常驻启动助手进程，降低每次启动终端的延迟
+    bool residentTray = false;     // 常驻系统托盘：关闭主窗口只隐藏，配合快速启动面板
     std::vector<std::string> searchHistory;
 };
 
@@ -104,6 +130,7 @@ struct AppConfig {
     std::vector<Profile> profiles;
     std::vector<SshHost> sshHosts;
     std::vector<Credential> credentials;
+    std::vector<Workspace> workspaces;
     AppSettings settings;
 };
 
@@ -120,7 +147,10 @@ inline std::string TerminalTypeToString(TerminalType type) {
         case TerminalType::Xfce4Terminal: return "xfce4-terminal";
         case TerminalType::MateTerminal: return "mate-terminal";
         case TerminalType::Alacritty: return "alacritty";
+        case TerminalType::Kitty: return "kitty";
+        case TerminalType::WezTerm: return "wezterm";
         case TerminalType::Xterm: return "xterm";
+        case TerminalType::Embedded: return "embedded";
         case TerminalType::TerminalApp: return "terminal.app";
         case TerminalType::ITerm2: return "iterm2";
         default: return "auto";
@@ -138,7 +168,10 @@ inline TerminalType StringToTerminalType(const std::string& str) {
     if (str == "xfce4-terminal") return TerminalType::Xfce4Terminal;
     if (str == "mate-terminal") return TerminalType::MateTerminal;
     if (str == "alacritty") return TerminalType::Alacritty;
+    if (str == "kitty") return TerminalType::Kitty;
+    if (str == "wezterm") return TerminalType::WezTerm;
     if (str == "xterm") return TerminalType::Xterm;
+    if (str == "embedded") return TerminalType::Embedded;
     if (str == "terminal.app") return TerminalType::TerminalApp;
     if (str == "iterm2") return TerminalType::ITerm2;
     return TerminalType::Auto;
@@ -157,7 +190,10 @@ inline std::string TerminalTypeDisplayName(TerminalType type) {
         case TerminalType::Xfce4Terminal: return "Xfce Terminal";
         case TerminalType::MateTerminal: return "MATE Terminal";
         case TerminalType::Alacritty: return "Alacritty";
+        case TerminalType::Kitty: return "kitty";
+        case TerminalType::WezTerm: return "WezTerm";
         case TerminalType::Xterm: return "XTerm";
+        case TerminalType::Embedded: return "内置终端";
         case TerminalType::TerminalApp: return "Terminal.app";
         case TerminalType::ITerm2: return "iTerm2";
         default: return "未知";
@@ -205,3 +241,12 @@ inline std::string CredentialTypeDisplayName(CredentialType type) {
         default: return "密码";
     }
 }
+
+// 工作区布局转换工具
+inline std::string WorkspaceLayoutToString(WorkspaceLayout layout) {
+    return layout == WorkspaceLayout::Windows ? "windows" : "tabs";
+}
+
+inline WorkspaceLayout StringToWorkspaceLayout(const std::string& str) {
+    return str == "windows" ? WorkspaceLayout::Windows : WorkspaceLayout::Tabs;
+}
@@ -0,0 +1,683 @@
+#include "VtScreen.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr size_t kMaxParams = 16;
+constexpr size_t kMaxOscLength = 4096;
+
+// DEC 特殊图形字符集（ESC ( 0）中 0x60–0x7e 对应的制表符
+const char32_t kLineDrawing[31] = {
+    U'◆', U'▒', U'␉', U'␌', U'␍', U'␊', U'°', U'±', U'␤', U'␋', U'┘', U'┐', U'┌', U'└', U'┼', U'⎺',
+    U'⎻', U'─', U'⎼', U'⎽', U'├', U'┤', U'┴', U'┬', U'│', U'≤', U'≥', U'π', U'≠', U'£', U'·',
+};
+
+void AppendUtf8(std::string& out, char32_t ch) {
+    if (ch < 0x80) {
+        out += static_cast<char>(ch);
+    } else if (ch < 0x800) {
+        out += static_cast<char>(0xC0 | (ch >> 6));
+        out += static_cast<char>(0x80 | (ch & 0x3F));
+    } else if (ch < 0x10000) {
+        out += static_cast<char>(0xE0 | (ch >> 12));
+        out += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (ch & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (ch >> 18));
+        out += static_cast<char>(0x80 | ((ch >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (ch & 0x3F));
+    }
+}
+
+} // namespace
+
+VtScreen::VtScreen(int cols, int rows, size_t scrollbackLimit)
+    : m_cols(std::max(cols, 1)), m_rows(std::max(rows, 1)), m_scrollbackLimit(scrollbackLimit) {
+    Reset();
+}
+
+int VtScreen::CharWidth(char32_t ch) {
+    if ((ch >= 0x0300 && ch <= 0x036F) || (ch >= 0x200B && ch <= 0x200F) ||
+        (ch >= 0x20D0 && ch <= 0x20FF) || (ch >= 0xFE00 && ch <= 0xFE0F)) {
+        return 0;
+    }
+    if ((ch >= 0x1100 && ch <= 0x115F) || (ch >= 0x2E80 && ch <= 0x303E) ||
+        (ch >= 0x3041 && ch <= 0x33FF) || (ch >= 0x3400 && ch <= 0x4DBF) ||
+        (ch >= 0x4E00 && ch <= 0x9FFF) || (ch >= 0xA000 && ch <= 0xA4CF) ||
+        (ch >= 0xAC00 && ch <= 0xD7A3) || (ch >= 0xF900 && ch <= 0xFAFF) ||
+        (ch >= 0xFE30 && ch <= 0xFE4F) || (ch >= 0xFF00 && ch <= 0xFF60) ||
+        (ch >= 0xFFE0 && ch <= 0xFFE6) || (ch >= 0x1F300 && ch <= 0x1F64F) ||
+        (ch >= 0x1F900 && ch <= 0x1F9FF) || (ch >= 0x20000 && ch <= 0x3FFFD)) {
+        return 2;
+    }
+    return 1;
+}
+
+VtCell VtScreen::Blank() const {
+    // 擦除用当前背景色填充（xterm 的 BCE 行为），其余属性清空
+    VtCell cell;
+    cell.bg = m_pen.bg;
+    return cell;
+}
+
+void VtScreen::Reset() {
+    m_primary.assign(m_rows, VtLine(m_cols));
+    m_alternate.assign(m_rows, VtLine(m_cols));
+    m_altScreen = false;
+    m_cursorRow = m_cursorCol = 0;
+    m_wrapPending = false;
+    m_cursorVisible = true;
+    m_autoWrap = true;
+    m_insertMode = false;
+    m_appCursorKeys = false;
+    m_bracketedPaste = false;
+    m_lineDrawing = false;
+    m_scrollTop = 0;
+    m_scrollBottom = m_rows - 1;
+    m_pen = VtCell();
+    m_saved = SavedCursor();
+    m_state = State::Ground;
+}
+
+void VtScreen::Feed(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char byte = static_cast<unsigned char>(data[i]);
+        if (m_utf8Need > 0) {
+            if ((byte & 0xC0) == 0x80) {
+                m_utf8Code = (m_utf8Code << 6) | (byte & 0x3F);
+                if (--m_utf8Need == 0) Process(m_utf8Code);
+                continue;
+            }
+            // 序列被截断：补一个替换字符，当前字节重新按起始字节处理
+            m_utf8Need = 0;
+            Process(U'�');
+        }
+        if (byte < 0x80) {
+            Process(byte);
+        } else if ((byte & 0xE0) == 0xC0) {
+            m_utf8Code = byte & 0x1F;
+            m_utf8Need = 1;
+        } else if ((byte & 0xF0) == 0xE0) {
+            m_utf8Code = byte & 0x0F;
+            m_utf8Need = 2;
+        } else if ((byte & 0xF8) == 0xF0) {
+            m_utf8Code = byte & 0x07;
+            m_utf8Need = 3;
+        } else {
+            Process(U'�');
+        }
+    }
+}
+
+void VtScreen::Process(char32_t ch) {
+    switch (m_state) {
+        case State::Ground:
+            if (ch == 0x1B) {
+                m_state = State::Escape;
+            } else if (ch < 0x20 || ch == 0x7F) {
+                Control(ch);
+            } else {
+                Put(ch);
+            }
+            return;
+
+        case State::Escape:
+            EscapeDispatch(ch);
+            return;
+
+        case State::Charset:
+            // 只跟踪 G0：'0' = 制表符，其余（'B' 等）= ASCII
+            if (m_intermediate == '(') m_lineDrawing = (ch == '0');
+            m_state = State::Ground;
+            return;
+
+        case State::Csi:
+            if (ch >= '0' && ch <= '9') {
+                if (!m_paramStarted) {
+                    m_params.push_back(0);
+                    m_paramStarted = true;
+                }
+                int& value = m_params.back();
+                value = std::min(value * 10 + static_cast<int>(ch - '0'), 65535);
+            } else if (ch == ';' || ch == ':') {
+                // 冒号子参数按分号处理（38:5:n 与 38;5;n 等价）
+                if (!m_paramStarted) m_params.push_back(-1);
+                m_paramStarted = false;
+                if (m_params.size() > kMaxParams) m_params.resize(kMaxParams);
+            } else if (ch >= '<' && ch <= '?') {
+                m_private = static_cast<char>(ch);
+            } else if (ch >= 0x20 && ch <= 0x2F) {
+                m_intermediate = static_cast<char>(ch);
+            } else if (ch >= 0x40 && ch <= 0x7E) {
+                m_state = State::Ground;
+                CsiDispatch(ch);
+            } else if (ch == 0x1B) {
+                m_state = State::Escape;
+            } else if (ch < 0x20) {
+                Control(ch);   // 序列中间的控制字符照常执行
+            } else {
+                m_state = State::Ground;
+            }
+            return;
+
+        case State::Osc:
+            if (ch == 0x07) {
+                OscDispatch();
+                m_state = State::Ground;
+            } else if (ch == 0x1B) {
+                m_state = State::OscEscape;
+            } else if (m_oscText.size() < kMaxOscLength) {
+                AppendUtf8(m_oscText, ch);
+            }
+            return;
+
+        case State::OscEscape:
+            // ESC \ 结束；其他字符视作新的转义序列
+            OscDispatch();
+            m_state = State::Ground;
+            if (ch != '\\') {
+                Process(0x1B);
+                Process(ch);
+            }
+            return;
+
+        case State::Ignore:
+            if (ch == 0x07) m_state = State::Ground;
+            else if (ch == 0x1B) m_state = State::IgnoreEscape;
+            return;
+
+        case State::IgnoreEscape:
+            m_state = (ch == '\\') ? State::Ground : State::Ignore;
+            return;
+    }
+}
+
+void VtScreen::Control(char32_t ch) {
+    switch (ch) {
+        case '\r':
+            m_cursorCol = 0;
+            m_wrapPending = false;
+            break;
+        case '\n':
+        case 0x0B:
+        case 0x0C:
+            LineFeed();
+            break;
+        case '\b':
+            if (m_cursorCol > 0) --m_cursorCol;
+            m_wrapPending = false;
+            break;
+        case '\t':
+            m_cursorCol = std::min((m_cursorCol / 8 + 1) * 8, m_cols - 1);
+            m_wrapPending = false;
+            break;
+        default:
+            break;   // BEL、SO/SI 等忽略
+    }
+}
+
+void VtScreen::EscapeDispatch(char32_t ch) {
+    m_state = State::Ground;
+    switch (ch) {
+        case '[':
+            m_params.clear();
+            m_paramStarted = false;
+            m_private = 0;
+            m_intermediate = 0;
+            m_state = State::Csi;
+            break;
+        case ']':
+            m_oscText.clear();
+            m_state = State::Osc;
+            break;
+        case 'P': case 'X': case '^': case '_':
+            m_state = State::Ignore;   // DCS / SOS / PM / APC：内容丢弃
+            break;
+        case '(': case ')': case '*': case '+':
+            m_intermediate = static_cast<char>(ch);
+            m_state = State::Charset;
+            break;
+        case '7':
+            m_saved = {m_cursorRow, m_cursorCol, m_pen, m_lineDrawing};
+            break;
+        case '8':
+            MoveCursor(m_saved.row, m_saved.col);
+            m_pen = m_saved.pen;
+            m_lineDrawing = m_saved.lineDrawing;
+            break;
+        case 'D':
+            LineFeed();
+            break;
+        case 'E':
+            m_cursorCol = 0;
+            LineFeed();
+            break;
+        case 'M':
+            ReverseIndex();
+            break;
+        case 'c':
+            Reset();
+            break;
+        default:
+            break;   // ESC = / ESC > 等键盘模式忽略
+    }
+}
+
+int VtScreen::Param(size_t index, int fallback) const {
+    if (index >= m_params.size() || m_params[index] <= 0) return fallback;
+    return m_params[index];
+}
+
+void VtScreen::CsiDispatch(char32_t final) {
+    if (m_private == '?') {
+        if (final == 'h' || final == 'l') {
+            for (size_t i = 0; i < std::max<size_t>(m_params.size(), 1); ++i) {
+                SetMode(Param(i, 0), final == 'h');
+            }
+        }
+        return;
+    }
+    if (m_private != 0 || m_intermediate != 0) {
+        if (m_private == '>' && final == 'c') {
+            m_replies += "\x1b[>0;10;1c";   // 次设备属性
+        }
+        return;   // 光标样式（CSI n SP q）等忽略
+    }
+
+    std::vector<VtLine>& screen = Screen();
+    const int n = Param(0, 1);
+    switch (final) {
+        case '@': {
+            VtLine& line = screen[m_cursorRow];
+            int count = std::min(n, m_cols - m_cursorCol);
+            line.insert(line.begin() + m_cursorCol, count, Blank());
+            line.resize(m_cols);
+            break;
+        }
+        case 'A': MoveCursor(std::max(m_cursorRow - n, m_cursorRow >= m_scrollTop ? m_scrollTop : 0), m_cursorCol); break;
+        case 'B': MoveCursor(std::min(m_cursorRow + n, m_cursorRow <= m_scrollBottom ? m_scrollBottom : m_rows - 1), m_cursorCol); break;
+        case 'C': MoveCursor(m_cursorRow, m_cursorCol + n); break;
+        case 'D': MoveCursor(m_cursorRow, m_cursorCol - n); break;
+        case 'E': MoveCursor(m_cursorRow + n, 0); break;
+        case 'F': MoveCursor(m_cursorRow - n, 0); break;
+        case 'G': case '`': MoveCursor(m_cursorRow, n - 1); break;
+        case 'd': MoveCursor(n - 1, m_cursorCol); break;
+        case 'H': case 'f': MoveCursor(Param(0, 1) - 1, Param(1, 1) - 1); break;
+        case 'J': {
+            int mode = Param(0, 0);
+            if (mode == 0) {
+                EraseCells(m_cursorRow, m_cursorCol, m_cols);
+                for (int r = m_cursorRow + 1; r < m_rows; ++r) EraseCells(r, 0, m_cols);
+            } else if (mode == 1) {
+                for (int r = 0; r < m_cursorRow; ++r) EraseCells(r, 0, m_cols);
+                EraseCells(m_cursorRow, 0, m_cursorCol + 1);
+            } else if (mode == 2) {
+                for (int r = 0; r < m_rows; ++r) EraseCells(r, 0, m_cols);
+            } else if (mode == 3) {
+                m_scrollback.clear();
+            }
+            break;
+        }
+        case 'K': {
+            int mode = Param(0, 0);
+            if (mode == 0) EraseCells(m_cursorRow, m_cursorCol, m_cols);
+            else if (mode == 1) EraseCells(m_cursorRow, 0, m_cursorCol + 1);
+            else if (mode == 2) EraseCells(m_cursorRow, 0, m_cols);
+            break;
+        }
+        case 'L':
+            if (m_cursorRow >= m_scrollTop && m_cursorRow <= m_scrollBottom) {
+                ScrollDown(m_cursorRow, m_scrollBottom, n);
+                m_cursorCol = 0;
+            }
+            break;
+        case 'M':
+            if (m_cursorRow >= m_scrollTop && m_cursorRow <= m_scrollBottom) {
+                ScrollUp(m_cursorRow, m_scrollBottom, n, false);
+                m_cursorCol = 0;
+            }
+            break;
+        case 'P': {
+            VtLine& line = screen[m_cursorRow];
+            int count = std::min(n, m_cols - m_cursorCol);
+            line.erase(line.begin() + m_cursorCol, line.begin() + m_cursorCol + count);
+            line.resize(m_cols, Blank());
+            break;
+        }
+        case 'S': ScrollUp(m_scrollTop, m_scrollBottom, n, false); break;
+        case 'T': ScrollDown(m_scrollTop, m_scrollBottom, n); break;
+        case 'X': EraseCells(m_cursorRow, m_cursorCol, std::min(m_cursorCol + n, m_cols)); break;
+        case 'b':
+            for (int i = 0; i < n && m_lastChar != 0; ++i) Put(m_lastChar);
+            break;
+        case 'm':
+            SelectGraphicRendition();
+            break;
+        case 'n':
+            if (Param(0, 0) == 5) {
+                m_replies += "\x1b[0n";
+            } else if (Param(0, 0) == 6) {
+                m_replies += "\x1b[" + std::to_string(m_cursorRow + 1) + ";" +
+                             std::to_string(m_cursorCol + 1) + "R";
+            }
+            break;
+        case 'c':
+            if (Param(0, 0) == 0) m_replies += "\x1b[?62;22c";
+            break;
+        case 'r': {
+            int top = Param(0, 1) - 1;
+            int bottom = Param(1, m_rows) - 1;
+            if (top < bottom && bottom < m_rows) {
+                m_scrollTop = top;
+                m_scrollBottom = bottom;
+                MoveCursor(0, 0);
+            }
+            break;
+        }
+        case 's':
+            m_saved = {m_cursorRow, m_cursorCol, m_pen, m_lineDrawing};
+            break;
+        case 'u':
+            MoveCursor(m_saved.row, m_saved.col);
+            m_pen = m_saved.pen;
+            m_lineDrawing = m_saved.lineDrawing;
+            break;
+        case 'h':
+        case 'l':
+            if (Param(0, 0) == 4) m_insertMode = (final == 'h');
+            break;
+        default:
+            break;
+    }
+}
+
+void VtScreen::SetMode(int mode, bool enable) {
+    switch (mode) {
+        case 1: m_appCursorKeys = enable; break;
+        case 7: m_autoWrap = enable; break;
+        case 25: m_cursorVisible = enable; break;
+        case 47:
+        case 1047:
+            SwitchScreen(enable);
+            break;
+        case 1048:
+            if (enable) m_saved = {m_cursorRow, m_cursorCol, m_pen, m_lineDrawing};
+            else MoveCursor(m_saved.row, m_saved.col);
+            break;
+        case 1049:
+            // 保存光标 + 切到清空的备用屏幕；退出时恢复主屏与光标
+            if (enable && !m_altScreen) {
+                m_savedBeforeAlt = {m_cursorRow, m_cursorCol, m_pen, m_lineDrawing};
+                SwitchScreen(true);
+                for (int r = 0; r < m_rows; ++r) EraseCells(r, 0, m_cols);
+            } else if (!enable && m_altScreen) {
+                SwitchScreen(false);
+                MoveCursor(m_savedBeforeAlt.row, m_savedBeforeAlt.col);
+                m_pen = m_savedBeforeAlt.pen;
+                m_lineDrawing = m_savedBeforeAlt.lineDrawing;
+            }
+            break;
+        case 2004: m_bracketedPaste = enable; break;
+        default: break;
+    }
+}
+
+void VtScreen::SelectGraphicRendition() {
+    if (m_params.empty()) {
+        m_params.push_back(0);
+    }
+    for (size_t i = 0; i < m_params.size(); ++i) {
+        int p = std::max(m_params[i], 0);
+        if (p == 0) {
+            m_pen.fg = VtColor();
+            m_pen.bg = VtColor();
+            m_pen.attrs = 0;
+        } else if (p == 1) {
+            m_pen.attrs |= kVtBold;
+        } else if (p == 2) {
+            m_pen.attrs |= kVtDim;
+        } else if (p == 3) {
+            m_pen.attrs |= kVtItalic;
+        } else if (p == 4) {
+            m_pen.attrs |= kVtUnderline;
+        } else if (p == 7) {
+            m_pen.attrs |= kVtInverse;
+        } else if (p == 22) {
+            m_pen.attrs &= ~(kVtBold | kVtDim);
+        } else if (p == 23) {
+            m_pen.attrs &= ~kVtItalic;
+        } else if (p == 24) {
+            m_pen.attrs &= ~kVtUnderline;
+        } else if (p == 27) {
+            m_pen.attrs &= ~kVtInverse;
+        } else if (p >= 30 && p <= 37) {
+            m_pen.fg = VtColor::Indexed(static_cast<uint8_t>(p - 30));
+        } else if (p == 39) {
+            m_pen.fg = VtColor();
+        } else if (p >= 40 && p <= 47) {
+            m_pen.bg = VtColor::Indexed(static_cast<uint8_t>(p - 40));
+        } else if (p == 49) {
+            m_pen.bg = VtColor();
+        } else if (p >= 90 && p <= 97) {
+            m_pen.fg = VtColor::Indexed(static_cast<uint8_t>(p - 90 + 8));
+        } else if (p >= 100 && p <= 107) {
+            m_pen.bg = VtColor::Indexed(static_cast<uint8_t>(p - 100 + 8));
+        } else if (p == 38 || p == 48) {
+            // 38;5;n（256 色）或 38;2;r;g;b（真彩）
+            VtColor color;
+            int kind = Param(i + 1, 0);
+            if (kind == 5 && i + 2 < m_params.size()) {
+                color = VtColor::Indexed(static_cast<uint8_t>(std::clamp(m_params[i + 2], 0, 255)));
+                i += 2;
+            } else if (kind == 2 && i + 4 < m_params.size()) {
+                auto channel = [this](size_t k) {
+                    return static_cast<uint8_t>(std::clamp(m_params[k], 0, 255));
+                };
+                color = VtColor::Rgb(channel(i + 2), channel(i + 3), channel(i + 4));
+                i += 4;
+            } else {
+                break;
+            }
+            (p == 38 ? m_pen.fg : m_pen.bg) = color;
+        }
+    }
+}
+
+void VtScreen::OscDispatch() {
+    // OSC 0 / 2：窗口标题；其他（超链接、剪贴板等）忽略
+    size_t semi = m_oscText.find(';');
+    if (semi == std::string::npos) return;
+    std::string code = m_oscText.substr(0, semi);
+    if (code == "0" || code == "2") {
+        m_title = m_oscText.substr(semi + 1);
+    }
+}
+
+void VtScreen::Put(char32_t ch) {
+    if (m_lineDrawing && ch >= 0x60 && ch <= 0x7E) {
+        ch = kLineDrawing[ch - 0x60];
+    }
+    int width = CharWidth(ch);
+    if (width == 0) {
+        return;   // 组合字符不单独占格
+    }
+    m_lastChar = ch;
+
+    if (m_wrapPending && m_autoWrap) {
+        m_cursorCol = 0;
+        LineFeed();
+    }
+    m_wrapPending = false;
+    if (width == 2 && m_cursorCol == m_cols - 1) {
+        // 宽字符放不下：本行最后一格留空，换到下一行
+        if (!m_autoWrap) return;
+        EraseCells(m_cursorRow, m_cursorCol, m_cols);
+        m_cursorCol = 0;
+        LineFeed();
+    }
+    if (width > m_cols) return;
+
+    VtLine& line = Screen()[m_cursorRow];
+    if (m_insertMode) {
+        line.insert(line.begin() + m_cursorCol, width, Blank());
+        line.resize(m_cols);
+    }
+
+    // 覆盖宽字符的一半时，把另一半清掉
+    int end = m_cursorCol + width;
+    if (line[m_cursorCol].width == 0 && m_cursorCol > 0) {
+        line[m_cursorCol - 1] = Blank();
+    }
+    if (end < m_cols && line[end].width == 0) {
+        line[end] = Blank();
+    }
+
+    VtCell cell = m_pen;
+    cell.ch = ch;
+    cell.width = static_cast<uint8_t>(width);
+    line[m_cursorCol] = cell;
+    if (width == 2) {
+        cell.ch = U' ';
+        cell.width = 0;
+        line[m_cursorCol + 1] = cell;
+    }
+
+    if (end >= m_cols) {
+        m_cursorCol = m_cols - 1;
+        m_wrapPending = m_autoWrap;
+    } else {
+        m_cursorCol = end;
+    }
+}
+
+void VtScreen::LineFeed() {
+    m_wrapPending = false;
+    if (m_cursorRow == m_scrollBottom) {
+        ScrollUp(m_scrollTop, m_scrollBottom, 1, true);
+    } else if (m_cursorRow < m_rows - 1) {
+        ++m_cursorRow;
+    }
+}
+
+void VtScreen::ReverseIndex() {
+    m_wrapPending = false;
+    if (m_cursorRow == m_scrollTop) {
+        ScrollDown(m_scrollTop, m_scrollBottom, 1);
+    } else if (m_cursorRow > 0) {
+        --m_cursorRow;
+    }
+}
+
+void VtScreen::ScrollUp(int top, int bottom, int count, bool toScrollback) {
+    std::vector<VtLine>& screen = Screen();
+    count = std::min(count, bottom - top + 1);
+    for (int i = 0; i < count; ++i) {
+        // 只有换行使主屏顶行滚出时才进入回滚缓冲（删行、SU 不算）
+        if (toScrollback && !m_altScreen && top == 0 && m_scrollbackLimit > 0) {
+            m_scrollback.push_back(std::move(screen[top]));
+            if (m_scrollback.size() > m_scrollbackLimit) m_scrollback.pop_front();
+        }
+        screen.erase(screen.begin() + top);
+        screen.insert(screen.begin() + bottom, VtLine(m_cols, Blank()));
+    }
+}
+
+void VtScreen::ScrollDown(int top, int bottom, int count) {
+    std::vector<VtLine>& screen = Screen();
+    count = std::min(count, bottom - top + 1);
+    for (int i = 0; i < count; ++i) {
+        screen.erase(screen.begin() + bottom);
+        screen.insert(screen.begin() + top, VtLine(m_cols, Blank()));
+    }
+}
+
+void VtScreen::EraseCells(int row, int from, int to) {
+    VtLine& line = Screen()[row];
+    from = std::max(from, 0);
+    to = std::min(to, m_cols);
+    // 擦除范围切开宽字符时连同另一半一起擦
+    if (from > 0 && from < m_cols && line[from].width == 0) --from;
+    if (to < m_cols && line[to].width == 0) ++to;
+    std::fill(line.begin() + from, line.begin() + std::max(from, to), Blank());
+}
+
+void VtScreen::MoveCursor(int row, int col) {
+    m_cursorRow = std::clamp(row, 0, m_rows - 1);
+    m_cursorCol = std::clamp(col, 0, m_cols - 1);
+    m_wrapPending = false;
+}
+
+void VtScreen::SwitchScreen(bool alternate) {
+    if (m_altScreen == alternate) return;
+    m_altScreen = alternate;
+    m_wrapPending = false;
+}
+
+void VtScreen::Resize(int cols, int rows) {
+    cols = std::max(cols, 1);
+    rows = std::max(rows, 1);
+    if (cols == m_cols && rows == m_rows) return;
+
+    // 行数减少：主屏把光标上方多出的行推入回滚缓冲，其余从底部裁掉
+    for (auto* screen : {&m_primary, &m_alternate}) {
+        bool isCurrent = (screen == &Screen());
+        int excess = static_cast<int>(screen->size()) - rows;
+        if (excess > 0) {
+            int fromTop = isCurrent ? std::min(excess, std::max(m_cursorRow - rows + 1, 0)) : 0;
+            for (int i = 0; i < fromTop; ++i) {
+                if (screen == &m_primary && m_scrollbackLimit > 0) {
+                    m_scrollback.push_back(std::move(screen->front()));
+                    if (m_scrollback.size() > m_scrollbackLimit) m_scrollback.pop_front();
+                }
+                screen->erase(screen->begin());
+            }
+            if (isCurrent) m_cursorRow -= fromTop;
+            screen->resize(rows);
+        } else {
+            screen->resize(rows, VtLine(cols));
+        }
+        for (auto& line : *screen) {
+            line.resize(cols);
+            if (line.back().width == 2) line.back() = VtCell();   // 裁掉一半的宽字符
+        }
+    }
+    if (m_savedBeforeAlt.row >= rows) m_savedBeforeAlt.row = rows - 1;
+
+    m_cols = cols;
+    m_rows = rows;
+    m_scrollTop = 0;
+    m_scrollBottom = rows - 1;
+    MoveCursor(m_cursorRow, m_cursorCol);
+}
+
+const VtLine& VtScreen::ViewLine(int row, size_t scrollOffset) const {
+    // 备用屏幕（全屏程序）不显示回滚内容
+    if (m_altScreen || scrollOffset == 0) {
+        return Screen()[row];
+    }
+    scrollOffset = std::min(scrollOffset, m_scrollback.size());
+    size_t index = m_scrollback.size() - scrollOffset + static_cast<size_t>(row);
+    if (index < m_scrollback.size()) {
+        return m_scrollback[index];
+    }
+    return Screen()[index - m_scrollback.size()];
+}
+
+std::string VtScreen::TakeReplies() {
+    std::string replies;
+    replies.swap(m_replies);
+    return replies;
+}
+
+std::string VtScreen::LineText(int row) const {
+    std::string text;
+    for (const auto& cell : Screen()[row]) {
+        if (cell.width == 0) continue;
+        AppendUtf8(text, cell.ch);
+    }
+    size_t end = text.find_last_not_of(' ');
+    text.erase(end == std::string::npos ? 0 : end + 1);
+    return text;
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+// 单元格颜色：默认色 / 256 色调色板索引 / 24 位真彩
+struct VtColor {
+    enum class Kind : uint8_t { Default, Indexed, Rgb };
+    Kind kind = Kind::Default;
+    uint8_t index = 0;
+    uint8_t r = 0, g = 0, b = 0;
+
+    static VtColor Indexed(uint8_t i) { VtColor c; c.kind = Kind::Indexed; c.index = i; return c; }
+    static VtColor Rgb(uint8_t r, uint8_t g, uint8_t b) {
+        VtColor c; c.kind = Kind::Rgb; c.r = r; c.g = g; c.b = b; return c;
+    }
+    bool operator==(const VtColor& o) const {
+        return kind == o.kind && index == o.index && r == o.r && g == o.g && b == o.b;
+    }
+    bool operator!=(const VtColor& o) const { return !(*this == o); }
+};
+
+enum VtAttr : uint8_t {
+    kVtBold = 1,
+    kVtDim = 2,
+    kVtItalic = 4,
+    kVtUnderline = 8,
+    kVtInverse = 16,
+};
+
+struct VtCell {
+    char32_t ch = U' ';
+    VtColor fg;
+    VtColor bg;
+    uint8_t attrs = 0;       // VtAttr 组合
+    uint8_t width = 1;       // 2 = 宽字符（CJK 等）首格，0 = 宽字符占用的第二格
+
+    bool SameStyle(const VtCell& o) const { return fg == o.fg && bg == o.bg && attrs == o.attrs; }
+};
+
+using VtLine = std::vector<VtCell>;
+
+// VT100 / xterm 终端模拟的屏幕状态（内置终端面板用）
+//
+// Feed 接收 pty 输出的字节流（UTF-8），解析控制序列并更新单元格网格：光标移动、擦除、
+// 插入删除行列、滚动区域、SGR 颜色属性（16/256/真彩）、备用屏幕、OSC 标题等常用子集。
+// 滚出主屏顶部的行进入回滚缓冲。不做任何绘制，也不加锁，由调用方串行访问。
+class VtScreen {
+public:
+    VtScreen(int cols, int rows, size_t scrollbackLimit = 5000);
+
+    void Feed(const char* data, size_t size);
+    void Feed(const std::string& data) { Feed(data.data(), data.size()); }
+
+    // 改变行列数；行数减少时顶部的行进入回滚缓冲，保证光标仍在屏幕内
+    void Resize(int cols, int rows);
+
+    int Cols() const { return m_cols; }
+    int Rows() const { return m_rows; }
+    const VtLine& Line(int row) const { return Screen()[row]; }
+
+    size_t ScrollbackSize() const { return m_scrollback.size(); }
+    // 向上翻 scrollOffset 行时屏幕第 row 行显示的内容（可能短于或长于当前列数）
+    const VtLine& ViewLine(int row, size_t scrollOffset) const;
+
+    int CursorRow() const { return m_cursorRow; }
+    int CursorCol() const { return m_cursorCol; }
+    bool CursorVisible() const { return m_cursorVisible; }
+    bool ApplicationCursorKeys() const { return m_appCursorKeys; }
+    bool BracketedPaste() const { return m_bracketedPaste; }
+    bool AlternateScreen() const { return m_altScreen; }
+    const std::string& Title() const { return m_title; }
+
+    // 取走需要回写给 pty 的应答（光标位置报告、设备属性等）
+    std::string TakeReplies();
+
+    // 屏幕第 row 行的文本（UTF-8，去掉行尾空白）
+    std::string LineText(int row) const;
+
+    // 东亚宽字符 2 列、组合字符 0 列，其余 1 列
+    static int CharWidth(char32_t ch);
+
+private:
+    enum class State { Ground, Escape, Charset, Csi, Osc, OscEscape, Ignore, IgnoreEscape };
+
+    struct SavedCursor {
+        int row = 0;
+        int col = 0;
+        VtCell pen;
+        bool lineDrawing = false;
+    };
+
+    int m_cols;
+    int m_rows;
+    size_t m_scrollbackLimit;
+    std::vector<VtLine> m_primary;
+    std::vector<VtLine> m_alternate;
+    std::deque<VtLine> m_scrollback;
+    bool m_altScreen = false;
+
+    int m_cursorRow = 0;
+    int m_cursorCol = 0;
+    bool m_wrapPending = false;     // 写到最后一列后，下一个字符才换行
+    bool m_cursorVisible = true;
+    bool m_autoWrap = true;
+    bool m_insertMode = false;
+    bool m_appCursorKeys = false;
+    bool m_bracketedPaste = false;
+    bool m_lineDrawing = false;     // G0 = DEC 制表符字符集
+    int m_scrollTop = 0;
+    int m_scrollBottom = 0;
+    VtCell m_pen;                   // 当前颜色与属性
+    char32_t m_lastChar = 0;        // REP 重复的字符
+    SavedCursor m_saved;
+    SavedCursor m_savedBeforeAlt;
+
+    State m_state = State::Ground;
+    std::vector<int> m_params;
+    bool m_paramStarted = false;
+    char m_private = 0;             // CSI 私有前缀 ? > < =
+    char m_intermediate = 0;
+    std::string m_oscText;
+    uint32_t m_utf8Code = 0;
+    int m_utf8Need = 0;
+
+    std::string m_title;
+    std::string m_replies;
+
+    std::vector<VtLine>& Screen() { return m_altScreen ? m_alternate : m_primary; }
+    const std::vector<VtLine>& Screen() const { return m_altScreen ? m_alternate : m_primary; }
+    VtCell Blank() const;
+
+    void Process(char32_t ch);
+    void Control(char32_t ch);
+    void EscapeDispatch(char32_t ch);
+    void CsiDispatch(char32_t final);
+    void OscDispatch();
+    void SetMode(int mode, bool enable);
+    void SelectGraphicRendition();
+
+    void Put(char32_t ch);
+    void LineFeed();
+    void ReverseIndex();
+    void ScrollUp(int top, int bottom, int count, bool toScrollback);
+    void ScrollDown(int top, int bottom, int count);
+    void EraseCells(int row, int from, int to);   // [from, to)
+    void MoveCursor(int row, int col);
+    void SwitchScreen(bool alternate);
+    void Reset();
+    int Param(size_t index, int fallback) const;
+};
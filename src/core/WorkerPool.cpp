@@ -0,0 +1,77 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(size_t threadCount) : m_state(std::make_shared<State>()) {
+    if (threadCount == 0) threadCount = 1;
+    m_threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&WorkerPool::WorkerLoop, m_state);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    Shutdown();
+}
+
+void WorkerPool::Submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        if (m_state->stopping) return;
+        m_state->tasks.push_back(std::move(task));
+    }
+    m_state->taskCv.notify_one();
+}
+
+void WorkerPool::WaitIdle() {
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->idleCv.wait(lock, [this] { return m_state->tasks.empty() && m_state->running == 0; });
+}
+
+void WorkerPool::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->stopping = true;
+    }
+    m_state->taskCv.notify_all();
+    for (auto& t : m_threads) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void WorkerPool::Detach() {
+    std::deque<std::function<void()>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->stopping = true;
+        dropped.swap(m_state->tasks);
+    }
+    m_state->taskCv.notify_all();
+    m_state->idleCv.notify_all();
+    for (auto& t : m_threads) {
+        if (t.joinable()) t.detach();
+    }
+    // dropped 在锁外析构：任务捕获的对象析构时可能再提交任务
+}
+
+void WorkerPool::WorkerLoop(std::shared_ptr<State> state) {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->taskCv.wait(lock, [&state] { return state->stopping || !state->tasks.empty(); });
+            if (state->tasks.empty()) return;  // stopping 且队列已清空
+            task = std::move(state->tasks.front());
+            state->tasks.pop_front();
+            ++state->running;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            --state->running;
+            if (state->tasks.empty() && state->running == 0) {
+                state->idleCv.notify_all();
+            }
+        }
+    }
+}
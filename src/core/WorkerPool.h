@@ -0,0 +1,50 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定线程数的任务池：任务按提交顺序取出，最多 threadCount 个并发执行。
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // 提交任务；Shutdown / Detach 之后提交的任务被丢弃。
+    void Submit(std::function<void()> task);
+
+    // 阻塞直到队列为空且没有任务在执行。
+    void WaitIdle();
+
+    // 执行完已提交的任务后回收线程（可重复调用）。
+    void Shutdown();
+
+    // 丢弃尚未开始的任务，正在执行的任务留在分离的线程上跑完，不等待。
+    // 之后可以立即析构本对象；仍在跑的任务不得再访问调用方即将销毁的状态。
+    void Detach();
+
+    size_t ThreadCount() const { return m_threads.size(); }
+
+private:
+    // 线程共享的队列状态：Detach 后线程可能比池对象活得久
+    struct State {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable taskCv;
+        std::condition_variable idleCv;
+        size_t running = 0;
+        bool stopping = false;
+    };
+
+    std::vector<std::thread> m_threads;
+    std::shared_ptr<State> m_state;
+
+    static void WorkerLoop(std::shared_ptr<State> state);
+};
@@ -1,7 +1,11 @@
 #include <wx/wx.h>
 #include <wx/snglinst.h>
 #include "ui/MainFrame.h"
+#include "cli/CommandLine.h"
 #include "core/ConfigManager.h"
+#include "core/LaunchHelper.h"
+#include "core/InstanceChannel.h"
+#include "core/SshSessionPool.h"
 #include "utils/PathUtils.h"
 #include <libssh2.h>
 
@@ -9,6 +13,23 @@
 #include <windows.h>
 #endif
 
+namespace {
+// 命令行带 --launch / --search 但没有实例可转发时，由本实例启动后自己处理
+bool g_hasStartupRequest = false;
+InstanceRequest g_startupRequest;
+// 配置在 wxEntry 之前读入（见 PrepareGui），结果留给 OnInit 报告
+bool g_configLoaded = false;
+
+// wx 初始化之前的准备：读配置，按设置 fork 常驻启动助手。
+// 助手必须在 GTK 等建立后台线程之前 fork，此时进程还是单线程、堆也很小
+void PrepareGui() {
+    g_configLoaded = ConfigManager::GetInstance().Initialize(PathUtils::GetExecutableDir());
+    if (ConfigManager::GetInstance().GetSettings().launchHelper) {
+        LaunchHelper::Start();
+    }
+}
+}
+
 class MTCApp : public wxApp {
 public:
     bool OnInit() override {
@@ -30,12 +51,17 @@ public:
         m_instanceChecker = new wxSingleInstanceChecker("MTC-" + dirId);
 
         if (m_instanceChecker->IsAnotherRunning()) {
-            ActivateExistingWindow();
+            // 交给已运行的实例（无参数时只把它提到前台）；对方未监听时退回旧做法
+            InstanceRequest request = g_hasStartupRequest ? g_startupRequest : InstanceRequest();
+            if (!InstanceChannel::Send(request)) {
+                ActivateExistingWindow();
+            }
             delete m_instanceChecker;
+            LaunchHelper::Stop();
             return false;
         }
 
-        if (!ConfigManager::GetInstance().Initialize(appDir)) {
+        if (!g_configLoaded) {
             wxMessageBox(wxT("无法初始化配置，程序将使用默认设置"),
                          wxT("警告"), wxOK | wxICON_WARNING);
         }
@@ -43,12 +69,28 @@ public:
         MainFrame* frame = new MainFrame();
         frame->Show(true);
 
+        // 之后启动的实例把请求转发到这里；处理要回到 UI 线程
+        InstanceChannel::Start([](const InstanceRequest& request) {
+            wxTheApp->CallAfter([request] {
+                if (auto* mainFrame = dynamic_cast<MainFrame*>(wxTheApp->GetTopWindow())) {
+                    mainFrame->HandleInstanceRequest(request);
+                }
+            });
+        });
+
+        if (g_hasStartupRequest) {
+            frame->HandleInstanceRequest(g_startupRequest);
+        }
+
         return true;
     }
 
     int OnExit() override {
+        InstanceChannel::Stop();
         delete m_instanceChecker;
+        LaunchHelper::Stop();
         ConfigManager::GetInstance().SaveConfig();
+        SshSessionPool::Clear();
         libssh2_exit();
         return wxApp::OnExit();
     }
@@ -70,4 +112,35 @@ private:
     }
 };
 
-wxIMPLEMENT_APP(MTCApp);
+// 自定义入口：命令行子命令（mtc launch/list/search）在 wx 初始化之前处理并直接退出；
+// --launch / --search 优先转发给已运行的实例；其余情况交给 wxEntry 启动图形界面
+wxIMPLEMENT_APP_NO_MAIN(MTCApp);
+
+#ifdef __WXMSW__
+int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR, int nCmdShow) {
+    std::vector<std::string> args = CommandLine::GetWindowsArgs();
+    if (CommandLine::IsCommand(args)) {
+        CommandLine::AttachParentConsole();
+        return CommandLine::Run(args);
+    }
+    if (InstanceChannel::ParseArgs(args, g_startupRequest)) {
+        if (InstanceChannel::Send(g_startupRequest)) return 0;
+        g_hasStartupRequest = true;
+    }
+    PrepareGui();
+    return wxEntry(hInstance, hPrevInstance, nullptr, nCmdShow);
+}
+#else
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv, argv + argc);
+    if (CommandLine::IsCommand(args)) {
+        return CommandLine::Run(args);
+    }
+    if (InstanceChannel::ParseArgs(args, g_startupRequest)) {
+        if (InstanceChannel::Send(g_startupRequest)) return 0;
+        g_hasStartupRequest = true;
+    }
+    PrepareGui();
+    return wxEntry(argc, argv);
+}
+#endif
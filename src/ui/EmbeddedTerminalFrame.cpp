@@ -0,0 +1,106 @@
+#include "EmbeddedTerminalFrame.h"
+#include "TerminalPanel.h"
+
+wxBEGIN_EVENT_TABLE(EmbeddedTerminalFrame, wxFrame)
+    EVT_NOTEBOOK_PAGE_CHANGED(ID_TERMINAL_NOTEBOOK, EmbeddedTerminalFrame::OnPageChanged)
+    EVT_CLOSE(EmbeddedTerminalFrame::OnClose)
+wxEND_EVENT_TABLE()
+
+EmbeddedTerminalFrame::EmbeddedTerminalFrame(wxWindow* parent)
+    : wxFrame(parent, wxID_ANY, wxT("MTC 终端"), wxDefaultPosition, wxSize(860, 560)) {
+    m_notebook = new wxNotebook(this, ID_TERMINAL_NOTEBOOK);
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(m_notebook, 1, wxEXPAND);
+    SetSizer(sizer);
+}
+
+bool EmbeddedTerminalFrame::AddSession(const wxString& title, const SpawnRequest& request,
+                                       std::string* errorMsg) {
+    TerminalPanel* panel = new TerminalPanel(
+        m_notebook,
+        [this](TerminalPanel* p, const wxString& t) { OnSessionTitle(p, t); },
+        [this](TerminalPanel* p, int code) { OnSessionExit(p, code); });
+    m_notebook->AddPage(panel, title, true);
+    // 先加入标签页完成布局，pty 按实际大小启动
+    m_notebook->Layout();
+
+    if (!panel->Start(request, errorMsg)) {
+        m_notebook->DeletePage(static_cast<size_t>(PageIndex(panel)));
+        return false;
+    }
+    panel->SetFocus();
+    UpdateFrameTitle();
+    return true;
+}
+
+int EmbeddedTerminalFrame::PageIndex(const TerminalPanel* panel) const {
+    for (size_t i = 0; i < m_notebook->GetPageCount(); ++i) {
+        if (m_notebook->GetPage(i) == panel) {
+            return static_cast<int>(i);
+        }
+    }
+    return wxNOT_FOUND;
+}
+
+void EmbeddedTerminalFrame::UpdateFrameTitle() {
+    int selection = m_notebook->GetSelection();
+    SetTitle(selection == wxNOT_FOUND
+                 ? wxString(wxT("MTC 终端"))
+                 : m_notebook->GetPageText(static_cast<size_t>(selection)) + wxT(" - MTC 终端"));
+}
+
+size_t EmbeddedTerminalFrame::RunningSessions() const {
+    size_t running = 0;
+    for (size_t i = 0; i < m_notebook->GetPageCount(); ++i) {
+        auto* panel = static_cast<TerminalPanel*>(m_notebook->GetPage(i));
+        if (panel->IsRunning()) ++running;
+    }
+    return running;
+}
+
+void EmbeddedTerminalFrame::OnSessionTitle(TerminalPanel* panel, const wxString& title) {
+    int index = PageIndex(panel);
+    if (index == wxNOT_FOUND || title.empty()) {
+        return;
+    }
+    m_notebook->SetPageText(static_cast<size_t>(index), title);
+    UpdateFrameTitle();
+}
+
+void EmbeddedTerminalFrame::OnSessionExit(TerminalPanel* panel, int exitCode) {
+    // 回调来自面板自身的事件处理，删除放到下一轮事件循环
+    CallAfter([this, panel] {
+        int index = PageIndex(panel);
+        if (index == wxNOT_FOUND) {
+            return;
+        }
+        m_notebook->DeletePage(static_cast<size_t>(index));
+        if (m_notebook->GetPageCount() == 0) {
+            Destroy();
+            return;
+        }
+        UpdateFrameTitle();
+    });
+}
+
+void EmbeddedTerminalFrame::OnPageChanged(wxBookCtrlEvent& event) {
+    UpdateFrameTitle();
+    if (wxWindow* page = m_notebook->GetCurrentPage()) {
+        page->SetFocus();
+    }
+    event.Skip();
+}
+
+void EmbeddedTerminalFrame::OnClose(wxCloseEvent& event) {
+    const size_t running = RunningSessions();
+    if (running > 0 && event.CanVeto()) {
+        int answer = wxMessageBox(
+            wxString::Format(wxT("关闭窗口将结束 %zu 个正在运行的会话，确定关闭吗？"), running),
+            wxT("确认关闭"), wxYES_NO | wxICON_QUESTION, this);
+        if (answer != wxYES) {
+            event.Veto();
+            return;
+        }
+    }
+    Destroy();
+}
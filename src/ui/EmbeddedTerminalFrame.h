@@ -0,0 +1,39 @@
+#pragma once
+#include <wx/wx.h>
+#include <wx/notebook.h>
+#include "core/ProcessSpawner.h"
+#include <string>
+
+class TerminalPanel;
+
+// 内置终端窗口：每个会话一个标签页（TerminalPanel）
+//
+// shell 退出后关闭对应标签页，最后一个标签页关闭时窗口随之关闭。
+// 关闭窗口会挂断仍在运行的会话（先确认）。
+class EmbeddedTerminalFrame : public wxFrame {
+public:
+    explicit EmbeddedTerminalFrame(wxWindow* parent);
+
+    // 新开标签页运行 request 并切换过去；启动失败时不留下标签页
+    bool AddSession(const wxString& title, const SpawnRequest& request, std::string* errorMsg = nullptr);
+    size_t SessionCount() const { return m_notebook->GetPageCount(); }
+
+private:
+    wxNotebook* m_notebook;
+
+    int PageIndex(const TerminalPanel* panel) const;
+    void UpdateFrameTitle();
+    size_t RunningSessions() const;
+
+    void OnSessionTitle(TerminalPanel* panel, const wxString& title);
+    void OnSessionExit(TerminalPanel* panel, int exitCode);
+    void OnPageChanged(wxBookCtrlEvent& event);
+    void OnClose(wxCloseEvent& event);
+
+    wxDECLARE_EVENT_TABLE();
+};
+
+// 控件 ID
+enum {
+    ID_TERMINAL_NOTEBOOK = wxID_HIGHEST + 700
+};
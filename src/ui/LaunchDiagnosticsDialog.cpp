@@ -0,0 +1,130 @@
+#include "LaunchDiagnosticsDialog.h"
+#include "core/ConfigManager.h"
+#include <wx/msgdlg.h>
+#include <algorithm>
+
+wxBEGIN_EVENT_TABLE(LaunchDiagnosticsDialog, wxDialog)
+    EVT_CHOICE(ID_DIAG_GROUP, LaunchDiagnosticsDialog::OnChoiceChanged)
+    EVT_CHOICE(ID_DIAG_PHASE, LaunchDiagnosticsDialog::OnChoiceChanged)
+    EVT_BUTTON(ID_DIAG_REFRESH, LaunchDiagnosticsDialog::OnRefresh)
+    EVT_BUTTON(ID_DIAG_CLEAR, LaunchDiagnosticsDialog::OnClear)
+wxEND_EVENT_TABLE()
+
+LaunchDiagnosticsDialog::LaunchDiagnosticsDialog(wxWindow* parent)
+    : wxDialog(parent, wxID_ANY, wxT("启动统计"),
+               wxDefaultPosition, wxSize(640, 440),
+               wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER)
+{
+    wxPanel* panel = new wxPanel(this);
+    wxBoxSizer* mainSizer = new wxBoxSizer(wxVERTICAL);
+
+    wxBoxSizer* filterSizer = new wxBoxSizer(wxHORIZONTAL);
+    m_groupChoice = new wxChoice(panel, ID_DIAG_GROUP);
+    m_groupChoice->Append(wxT("按终端类型"));
+    m_groupChoice->Append(wxT("按配置"));
+    m_groupChoice->SetSelection(0);
+    m_phaseChoice = new wxChoice(panel, ID_DIAG_PHASE);
+    for (size_t i = 0; i < kLaunchPhaseCount; ++i) {
+        m_phaseChoice->Append(wxString::FromUTF8(LaunchPhaseDisplayName(static_cast<LaunchPhase>(i))));
+    }
+    m_phaseChoice->SetSelection(static_cast<int>(LaunchPhase::Total));
+    filterSizer->Add(new wxStaticText(panel, wxID_ANY, wxT("分组")), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    filterSizer->Add(m_groupChoice, 0, wxRIGHT, 15);
+    filterSizer->Add(new wxStaticText(panel, wxID_ANY, wxT("阶段")), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    filterSizer->Add(m_phaseChoice, 0);
+    mainSizer->Add(filterSizer, 0, wxEXPAND | wxALL, 10);
+
+    m_listView = new wxListView(panel, ID_DIAG_LIST, wxDefaultPosition, wxDefaultSize,
+                                wxLC_REPORT | wxLC_SINGLE_SEL);
+    m_listView->AppendColumn(wxT("名称"), wxLIST_FORMAT_LEFT, 200);
+    m_listView->AppendColumn(wxT("次数"), wxLIST_FORMAT_RIGHT, 60);
+    m_listView->AppendColumn(wxT("失败"), wxLIST_FORMAT_RIGHT, 60);
+    m_listView->AppendColumn(wxT("p50 (ms)"), wxLIST_FORMAT_RIGHT, 90);
+    m_listView->AppendColumn(wxT("p95 (ms)"), wxLIST_FORMAT_RIGHT, 90);
+    m_listView->AppendColumn(wxT("p99 (ms)"), wxLIST_FORMAT_RIGHT, 90);
+    m_listView->EnableAlternateRowColours();
+    mainSizer->Add(m_listView, 1, wxEXPAND | wxLEFT | wxRIGHT, 10);
+
+    m_summaryText = new wxStaticText(panel, wxID_ANY, wxEmptyString);
+    mainSizer->Add(m_summaryText, 0, wxEXPAND | wxALL, 10);
+
+    wxBoxSizer* btnSizer = new wxBoxSizer(wxHORIZONTAL);
+    btnSizer->Add(new wxButton(panel, ID_DIAG_REFRESH, wxT("刷新")), 0, wxRIGHT, 8);
+    btnSizer->Add(new wxButton(panel, ID_DIAG_CLEAR, wxT("清空日志")), 0);
+    btnSizer->AddStretchSpacer();
+    btnSizer->Add(new wxButton(panel, wxID_CANCEL, wxT("关闭")), 0);
+    mainSizer->Add(btnSizer, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 10);
+
+    panel->SetSizer(mainSizer);
+
+    wxBoxSizer* outer = new wxBoxSizer(wxVERTICAL);
+    outer->Add(panel, 1, wxEXPAND);
+    SetSizer(outer);
+
+    ReloadRecords();
+    Centre();
+}
+
+void LaunchDiagnosticsDialog::ReloadRecords() {
+    m_records = LaunchTelemetry::ReadAll();
+    RefreshList();
+}
+
+void LaunchDiagnosticsDialog::RefreshList() {
+    auto groupBy = m_groupChoice->GetSelection() == 1
+        ? LaunchTelemetry::GroupBy::Profile
+        : LaunchTelemetry::GroupBy::TerminalType;
+    auto phase = static_cast<LaunchPhase>(std::max(m_phaseChoice->GetSelection(), 0));
+    auto rows = LaunchTelemetry::Summarize(m_records, groupBy, phase);
+
+    m_listView->DeleteAllItems();
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto& row = rows[i];
+        long index = m_listView->InsertItem(static_cast<long>(i), DisplayKey(row.key, groupBy));
+        m_listView->SetItem(index, 1, wxString::Format(wxT("%zu"), row.count));
+        m_listView->SetItem(index, 2, wxString::Format(wxT("%zu"), row.failures));
+        m_listView->SetItem(index, 3, wxString::Format(wxT("%.1f"), row.p50Ms));
+        m_listView->SetItem(index, 4, wxString::Format(wxT("%.1f"), row.p95Ms));
+        m_listView->SetItem(index, 5, wxString::Format(wxT("%.1f"), row.p99Ms));
+    }
+
+    if (m_records.empty()) {
+        m_summaryText->SetLabel(wxT("暂无启动记录"));
+    } else {
+        m_summaryText->SetLabel(wxString::Format(wxT("共 %zu 次启动（日志保留最近 %u 次）"),
+                                                 m_records.size(), LaunchTelemetry::kDefaultCapacity));
+    }
+}
+
+wxString LaunchDiagnosticsDialog::DisplayKey(const std::string& key,
+                                             LaunchTelemetry::GroupBy groupBy) const {
+    if (groupBy == LaunchTelemetry::GroupBy::Profile) {
+        // 已删除的配置只能显示 id
+        if (const Profile* profile = ConfigManager::GetInstance().GetProfile(key)) {
+            return wxString::FromUTF8(profile->name);
+        }
+        return wxString::FromUTF8(key) + wxT("（已删除）");
+    }
+    TerminalType type = StringToTerminalType(key);
+    if (type != TerminalType::Auto) {
+        return wxString::FromUTF8(TerminalTypeDisplayName(type));
+    }
+    return wxString::FromUTF8(key);
+}
+
+void LaunchDiagnosticsDialog::OnChoiceChanged(wxCommandEvent& event) {
+    RefreshList();
+}
+
+void LaunchDiagnosticsDialog::OnRefresh(wxCommandEvent& event) {
+    ReloadRecords();
+}
+
+void LaunchDiagnosticsDialog::OnClear(wxCommandEvent& event) {
+    int result = wxMessageBox(wxT("确定清空启动日志吗？"), wxT("确认"),
+                              wxYES_NO | wxICON_QUESTION, this);
+    if (result == wxYES) {
+        LaunchTelemetry::Clear();
+        ReloadRecords();
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include "core/LaunchTelemetry.h"
+#include <vector>
+
+// 启动统计对话框：按终端类型或配置分组，列出某阶段耗时的 p50 / p95 / p99
+//
+// 数据来自 data/launch_log.bin（最近若干次启动的环形日志），打开时读一次，“刷新”重读。
+class LaunchDiagnosticsDialog : public wxDialog {
+public:
+    LaunchDiagnosticsDialog(wxWindow* parent);
+
+private:
+    wxChoice* m_groupChoice;
+    wxChoice* m_phaseChoice;
+    wxListView* m_listView;
+    wxStaticText* m_summaryText;
+    std::vector<LaunchRecord> m_records;
+
+    void ReloadRecords();
+    void RefreshList();
+    wxString DisplayKey(const std::string& key, LaunchTelemetry::GroupBy groupBy) const;
+
+    void OnChoiceChanged(wxCommandEvent& event);
+    void OnRefresh(wxCommandEvent& event);
+    void OnClear(wxCommandEvent& event);
+
+    wxDECLARE_EVENT_TABLE();
+};
+
+enum LaunchDiagnosticsIds {
+    ID_DIAG_GROUP = wxID_HIGHEST + 800,
+    ID_DIAG_PHASE,
+    ID_DIAG_LIST,
+    ID_DIAG_REFRESH,
+    ID_DIAG_CLEAR
+};
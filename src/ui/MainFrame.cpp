@@ -3,16 +3,23 @@
 #include "SshHostManagerDialog.h"
 #include "CredentialManagerDialog.h"
 #include "RemoteFileBrowserDialog.h"
+#include "QuickLaunchPalette.h"
+#include "TrayIcon.h"
+#include "LaunchDiagnosticsDialog.h"
 #include "core/TerminalLauncher.h"
+#include "core/TempArtifacts.h"
+#include "core/SshSessionPool.h"
 #include "ui/ProfileTreeBuilder.h"
 #include <wx/filedlg.h>
 #include <wx/msgdlg.h>
 #include <wx/statline.h>
 #include <wx/menu.h>
 #include <wx/choicdlg.h>
+#include <wx/textdlg.h>
 #include "utils/PathUtils.h"
 
 #include <algorithm>
+#include <chrono>
 #include <utility>
 
 wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
@@ -26,6 +33,8 @@ wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
     EVT_BUTTON(ID_BTN_OPEN_DIR, MainFrame::OnOpenWorkDir)
     EVT_BUTTON(ID_BTN_SSH_HOSTS, MainFrame::OnManageSshHosts)
     EVT_BUTTON(ID_BTN_CREDENTIALS, MainFrame::OnManageCredentials)
+    EVT_BUTTON(ID_BTN_WORKSPACES, MainFrame::OnWorkspaces)
+    EVT_BUTTON(ID_BTN_DIAGNOSTICS, MainFrame::OnLaunchDiagnostics)
     EVT_TEXT(ID_SEARCH_CTRL, MainFrame::OnSearchTextChanged)
     EVT_TEXT_ENTER(ID_SEARCH_CTRL, MainFrame::OnSearchEnter)
     EVT_BUTTON(ID_BTN_CLEAR_SEARCH, MainFrame::OnClearSearch)
@@ -33,20 +42,43 @@ wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
     EVT_LIST_ITEM_ACTIVATED(ID_LIST_PROFILES, MainFrame::OnListDoubleClick)
     EVT_LIST_ITEM_SELECTED(ID_LIST_PROFILES, MainFrame::OnListSelectionChanged)
     EVT_LIST_ITEM_DESELECTED(ID_LIST_PROFILES, MainFrame::OnListSelectionChanged)
+    EVT_THREAD(ID_LAUNCH_FINISHED, MainFrame::OnLaunchFinished)
+#if wxUSE_HOTKEY
+    EVT_HOTKEY(ID_HOTKEY_QUICK_LAUNCH, MainFrame::OnQuickLaunchHotKey)
+#endif
+    EVT_TIMER(ID_TIMER_SWEEP_TEMP, MainFrame::OnSweepTimer)
+    EVT_TIMER(ID_TIMER_SSH_POOL, MainFrame::OnSshPoolTimer)
     EVT_CLOSE(MainFrame::OnClose)
     EVT_SYS_COLOUR_CHANGED(MainFrame::OnSysColourChanged)
 wxEND_EVENT_TABLE()
 
 MainFrame::MainFrame()
     : wxFrame(nullptr, wxID_ANY, wxT("MTC - 终端环境管理器"),
-              wxDefaultPosition, wxSize(1000, 620)) {
+              wxDefaultPosition, wxSize(1000, 620)),
+      m_eventSink(std::make_shared<EventSink>()),
+      m_launchPool(std::make_unique<WorkerPool>(4)),
+      m_maintenancePool(std::make_unique<WorkerPool>(1)),
+      m_sweepTimer(this, ID_TIMER_SWEEP_TEMP),
+      m_sshPoolTimer(this, ID_TIMER_SSH_POOL) {
     SetMinSize(wxSize(760, 460));
+    m_eventSink->target = this;
 
     CreateControls();
     RefreshView();
     UpdateButtonStates();
     UpdateStatusBar();
 
+    // 终端探测要逐个 which，放到后台先做掉，第一次启动不再等它
+    m_launchPool->Submit([] { TerminalLauncher::Prewarm(); });
+    // 启动时清一次临时文件（含旧版本遗留在系统临时目录的 mtc_*），之后每 30 分钟一次
+    m_maintenancePool->Submit([] { TempArtifacts::Sweep(); });
+    m_sweepTimer.Start(30 * 60 * 1000);
+    m_sshPoolTimer.Start(30 * 1000);
+
+    if (ConfigManager::GetInstance().GetSettings().residentTray) {
+        SetupResidentMode();
+    }
+
 #ifdef __WXMSW__
     SetIcon(wxIcon(wxT("APP_ICON"), wxBITMAP_TYPE_ICO_RESOURCE));
 #elif defined(__LINUX__)
@@ -64,6 +96,8 @@ MainFrame::MainFrame()
     Centre();
 }
 
+MainFrame::~MainFrame() = default;
+
 void MainFrame::CreateControls() {
     wxPanel* panel = new wxPanel(this);
 
@@ -92,6 +126,7 @@ void MainFrame::CreateControls() {
     wxFont launchFont = m_btnLaunch->GetFont();
     launchFont.SetWeight(wxFONTWEIGHT_BOLD);
     m_btnLaunch->SetFont(launchFont);
+    m_btnWorkspaces = new wxButton(panel, ID_BTN_WORKSPACES, wxT("工作区..."), wxDefaultPosition, btnSize);
 
     m_btnDuplicate = new wxButton(panel, ID_BTN_DUPLICATE, wxT("复制"), wxDefaultPosition, btnSize);
     m_btnImport = new wxButton(panel, ID_BTN_IMPORT, wxT("导入..."), wxDefaultPosition, btnSize);
@@ -99,11 +134,13 @@ void MainFrame::CreateControls() {
     m_btnOpenDir = new wxButton(panel, ID_BTN_OPEN_DIR, wxT("打开目录"), wxDefaultPosition, btnSize);
     m_btnSshHosts = new wxButton(panel, ID_BTN_SSH_HOSTS, wxT("SSH 主机..."), wxDefaultPosition, btnSize);
     m_btnCredentials = new wxButton(panel, ID_BTN_CREDENTIALS, wxT("凭据..."), wxDefaultPosition, btnSize);
+    m_btnDiagnostics = new wxButton(panel, ID_BTN_DIAGNOSTICS, wxT("启动统计..."), wxDefaultPosition, btnSize);
 
     leftSizer->Add(m_btnNew, 0, wxEXPAND | wxBOTTOM, 8);
     leftSizer->Add(m_btnEdit, 0, wxEXPAND | wxBOTTOM, 8);
     leftSizer->Add(m_btnDelete, 0, wxEXPAND | wxBOTTOM, 14);
-    leftSizer->Add(m_btnLaunch, 0, wxEXPAND | wxBOTTOM, 14);
+    leftSizer->Add(m_btnLaunch, 0, wxEXPAND | wxBOTTOM, 8);
+    leftSizer->Add(m_btnWorkspaces, 0, wxEXPAND | wxBOTTOM, 14);
     leftSizer->Add(new wxStaticLine(panel, wxID_ANY), 0, wxEXPAND | wxBOTTOM, 14);
     leftSizer->Add(m_btnDuplicate, 0, wxEXPAND | wxBOTTOM, 8);
     leftSizer->Add(m_btnImport, 0, wxEXPAND | wxBOTTOM, 8);
@@ -111,7 +148,8 @@ void MainFrame::CreateControls() {
     leftSizer->Add(new wxStaticLine(panel, wxID_ANY), 0, wxEXPAND | wxBOTTOM, 14);
     leftSizer->Add(m_btnOpenDir, 0, wxEXPAND | wxBOTTOM, 8);
     leftSizer->Add(m_btnSshHosts, 0, wxEXPAND | wxBOTTOM, 8);
-    leftSizer->Add(m_btnCredentials, 0, wxEXPAND);
+    leftSizer->Add(m_btnCredentials, 0, wxEXPAND | wxBOTTOM, 8);
+    leftSizer->Add(m_btnDiagnostics, 0, wxEXPAND);
     leftSizer->AddStretchSpacer();
 
     mainSizer->Add(leftSizer, 0, wxEXPAND | wxALL, 15);
@@ -135,7 +173,8 @@ void MainFrame::CreateControls() {
     rightSizer->Add(searchSizer, 0, wxEXPAND | wxBOTTOM, 10);
 
     // 列表视图
-    long listStyle = wxLC_REPORT | wxLC_SINGLE_SEL;
+    // 支持多选：Ctrl/Shift 选中多个配置后一次性批量启动
+    long listStyle = wxLC_REPORT;
 #ifdef __WXOSX__
     listStyle |= wxLC_HRULES | wxLC_VRULES;
 #endif
@@ -216,9 +255,17 @@ std::string MainFrame::DetermineSelectionAfterDelete(const std::string& deleting
     return "";
 }
 
+ProfileSearchIndex& MainFrame::SearchIndex() {
+    const uint64_t revision = ConfigManager::GetInstance().GetProfilesRevision();
+    if (revision != m_indexedRevision) {
+        m_searchIndex.Build(ConfigManager::GetInstance().GetProfiles());
+        m_indexedRevision = revision;
+    }
+    return m_searchIndex;
+}
+
 void MainFrame::RefreshView() {
-    const auto& profiles = ConfigManager::GetInstance().GetProfiles();
-    m_visibleProfiles = FilterProfiles(profiles, m_searchText);
+    m_visibleProfiles = SearchIndex().Filter(m_searchText);
 
     RefreshListView();
     RestoreSelection();
@@ -238,7 +285,7 @@ void MainFrame::RefreshListView() {
         long index = m_listView->InsertItem(static_cast<long>(i), wxString::FromUTF8(profile->name));
         m_listView->SetItem(index, 1, wxString::FromUTF8(profile->description));
         m_listView->SetItem(index, 2, wxString::FromUTF8(profile->GetWorkingDirectory()));
-        m_listView->SetItem(index, 3, wxString::FromUTF8(TerminalTypeDisplayName(profile->terminalType)));
+        m_listView->SetItem(index, 3, wxString::FromUTF8(TerminalLauncher::GetTerminalDisplayName(*profile)));
     }
 }
 
@@ -264,11 +311,13 @@ void MainFrame::RestoreSelection() {
 }
 
 void MainFrame::UpdateButtonStates() {
-    bool hasSelection = GetSelectedProfileFromListView() != nullptr;
-    m_btnEdit->Enable(hasSelection);
-    m_btnDelete->Enable(hasSelection);
-    m_btnLaunch->Enable(hasSelection);
-    m_btnDuplicate->Enable(hasSelection);
+    // 编辑/删除/复制只针对单个配置；启动支持多选
+    const size_t selectedCount = GetSelectedProfiles().size();
+    const bool singleSelection = selectedCount == 1;
+    m_btnEdit->Enable(singleSelection);
+    m_btnDelete->Enable(singleSelection);
+    m_btnLaunch->Enable(selectedCount > 0);
+    m_btnDuplicate->Enable(singleSelection);
 
     bool hasProfiles = !ConfigManager::GetInstance().GetProfiles().empty();
     m_btnExport->Enable(hasProfiles);
@@ -346,28 +395,232 @@ void MainFrame::LaunchProfile(const Profile* profile) {
         return;
     }
 
-    std::string errorMsg;
-    if (TerminalLauncher::Launch(*profile, &errorMsg)) {
-        m_statusBar->SetStatusText(wxString::Format(wxT("终端已启动: %s"), wxString::FromUTF8(profile->name)));
+    std::vector<LaunchSpec> specs{TerminalLauncher::MakeLaunchSpec(*profile)};
+    if (profile->terminalType == TerminalType::Embedded) {
+        OpenEmbeddedTerminals(specs);
+        return;
+    }
+    StartLaunchJob(wxString::FromUTF8(profile->name), wxT("启动终端失败，请检查配置"),
+                   [specs] { return TerminalLauncher::LaunchBatch(specs); });
+}
+
+void MainFrame::HandleInstanceRequest(const InstanceRequest& request) {
+    if (request.kind == InstanceRequest::Kind::QuickLaunch) {
+        ShowQuickLaunch();
+        return;
+    }
+    ShowFromTray();
+
+    switch (request.kind) {
+        case InstanceRequest::Kind::Launch: {
+            const Profile* profile = ConfigManager::GetInstance().GetProfile(request.argument);
+            if (profile == nullptr) {
+                m_statusBar->SetStatusText(wxString::Format(wxT("未找到配置: %s"),
+                                                            wxString::FromUTF8(request.argument)));
+                return;
+            }
+            LaunchProfile(profile);
+            break;
+        }
+        case InstanceRequest::Kind::Search:
+            // SetValue 会触发 EVT_TEXT，由 OnSearchTextChanged 刷新列表
+            m_searchCtrl->SetValue(wxString::FromUTF8(request.argument));
+            break;
+        case InstanceRequest::Kind::Activate:
+        case InstanceRequest::Kind::QuickLaunch:
+            break;
+    }
+}
+
+void MainFrame::SetupResidentMode() {
+    if (wxTaskBarIcon::IsAvailable()) {
+        m_trayIcon = std::make_unique<TrayIcon>(this);
+    }
+#if wxUSE_HOTKEY
+    // Ctrl+Alt+Space 全局唤出快速启动面板（Windows / macOS）；
+    // Linux 上 wx 不支持全局快捷键，可在桌面环境里把快捷键绑定到 `mtc --palette`
+    RegisterHotKey(ID_HOTKEY_QUICK_LAUNCH, wxMOD_CONTROL | wxMOD_ALT, WXK_SPACE);
+#endif
+}
+
+void MainFrame::ShowQuickLaunch() {
+    if (m_palette == nullptr) {
+        m_palette = new QuickLaunchPalette(
+            this,
+            [this]() -> ProfileSearchIndex& { return SearchIndex(); },
+            [this](const Profile* profile) { LaunchProfile(profile); });
+    }
+    m_palette->Popup();
+}
+
+void MainFrame::ShowFromTray() {
+    if (IsIconized()) {
+        Iconize(false);
+    }
+    Show(true);
+    Raise();
+}
+
+void MainFrame::ExitApplication() {
+    m_exitRequested = true;
+    Close(true);
+}
+
+#if wxUSE_HOTKEY
+void MainFrame::OnQuickLaunchHotKey(wxKeyEvent& event) {
+    ShowQuickLaunch();
+}
+#endif
+
+void MainFrame::LaunchProfiles(const std::vector<const Profile*>& profiles) {
+    // 快照在 UI 线程上取，后台任务不再访问 ConfigManager
+    std::vector<LaunchSpec> specs;
+    std::vector<LaunchSpec> embedded;
+    specs.reserve(profiles.size());
+    for (const auto* profile : profiles) {
+        if (profile != nullptr) {
+            auto& target = profile->terminalType == TerminalType::Embedded ? embedded : specs;
+            target.push_back(TerminalLauncher::MakeLaunchSpec(*profile));
+        }
+    }
+    if (!embedded.empty()) {
+        OpenEmbeddedTerminals(embedded);
+    }
+    if (specs.empty()) {
+        return;
+    }
+
+    StartLaunchJob(wxString::Format(wxT("%zu 个配置"), specs.size()), wxEmptyString,
+                   [specs] { return TerminalLauncher::LaunchBatch(specs); });
+}
+
+void MainFrame::OpenEmbeddedTerminals(const std::vector<LaunchSpec>& specs) {
+    // 开伪终端再 fork 很快，直接在 UI 线程上做；所有会话进同一个窗口的标签页
+    if (!m_terminalFrame) {
+        m_terminalFrame = new EmbeddedTerminalFrame(this);
+    }
+
+    wxString failures;
+    size_t opened = 0;
+    for (const auto& spec : specs) {
+        SpawnRequest request;
+        std::string error;
+        if (TerminalLauncher::BuildEmbeddedSession(spec, request, &error) &&
+            m_terminalFrame->AddSession(wxString::FromUTF8(spec.profile.name), request, &error)) {
+            ++opened;
+        } else {
+            failures += wxString::FromUTF8(spec.profile.name + ": " + error) + wxT("\n");
+        }
+    }
+
+    if (opened > 0) {
+        m_terminalFrame->Show();
+        m_terminalFrame->Raise();
+        m_statusBar->SetStatusText(wxString::Format(wxT("已在内置终端打开 %zu 个会话"), opened));
+    } else if (m_terminalFrame->SessionCount() == 0) {
+        m_terminalFrame->Destroy();
+    }
+    if (!failures.empty()) {
+        wxMessageBox(wxT("打开内置终端失败：\n") + failures, wxT("错误"), wxOK | wxICON_ERROR, this);
+    }
+}
+
+void MainFrame::StartLaunchJob(const wxString& title, const wxString& failurePrompt,
+                               std::function<std::vector<LaunchResult>()> job) {
+    ++m_launchesInFlight;
+    m_statusBar->SetStatusText(wxString::Format(wxT("正在启动: %s（进行中 %zu 个任务）"),
+                                                title, m_launchesInFlight));
+
+    // 不捕获 this：窗口关闭时不等在途的启动，任务完成后经 sink 投递，已断开则丢弃结果
+    m_launchPool->Submit([sink = m_eventSink, title, failurePrompt, job] {
+        auto start = std::chrono::steady_clock::now();
+        LaunchOutcome outcome;
+        outcome.title = title;
+        outcome.failurePrompt = failurePrompt;
+        outcome.results = job();
+        outcome.elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(sink->mutex);
+        if (sink->target) {
+            wxThreadEvent* event = new wxThreadEvent(wxEVT_THREAD, ID_LAUNCH_FINISHED);
+            event->SetPayload(outcome);
+            wxQueueEvent(sink->target, event);
+        }
+    });
+}
+
+void MainFrame::OnLaunchFinished(wxThreadEvent& event) {
+    if (m_launchesInFlight > 0) {
+        --m_launchesInFlight;
+    }
+    LaunchOutcome outcome = event.GetPayload<LaunchOutcome>();
+    const auto& results = outcome.results;
+    if (results.empty()) {
         return;
     }
 
-    wxString msg = wxT("启动终端失败，请检查配置");
-    if (!errorMsg.empty()) {
-        msg += wxT("\n详细错误: ") + wxString::FromUTF8(errorMsg);
+    // 单个配置 / 工作区：沿用原有的提示方式
+    if (results.size() == 1) {
+        const LaunchResult& result = results.front();
+        if (result.success) {
+            m_statusBar->SetStatusText(wxString::Format(wxT("终端已启动: %s (%.0fms)"),
+                                                        outcome.title, outcome.elapsedMs));
+            return;
+        }
+
+        wxString msg = outcome.failurePrompt;
+        if (!result.errorMsg.empty()) {
+            msg += wxT("\n详细错误: ") + wxString::FromUTF8(result.errorMsg);
+        }
+        m_statusBar->SetStatusText(wxString::Format(wxT("启动失败: %s"), outcome.title));
+        wxMessageBox(msg, wxT("错误"), wxOK | wxICON_ERROR, this);
+        return;
     }
 
-    wxMessageBox(msg, wxT("错误"), wxOK | wxICON_ERROR, this);
+    // 批量：状态栏逐个配置显示耗时；失败项汇总成一个对话框
+    size_t succeeded = 0;
+    wxString timings;
+    wxString failures;
+    for (const auto& result : results) {
+        if (!timings.empty()) {
+            timings += wxT(", ");
+        }
+        timings += wxString::Format(wxT("%s %.0fms"),
+                                    wxString::FromUTF8(result.profileName), result.elapsedMs);
+        if (result.success) {
+            ++succeeded;
+            continue;
+        }
+        timings += wxT("(失败)");
+        failures += wxT("\n• ") + wxString::FromUTF8(result.profileName);
+        if (!result.errorMsg.empty()) {
+            failures += wxT(": ") + wxString::FromUTF8(result.errorMsg);
+        }
+    }
+
+    m_statusBar->SetStatusText(wxString::Format(wxT("已启动 %zu/%zu 个终端: "),
+                                                succeeded, results.size()) + timings);
+
+    if (!failures.empty()) {
+        wxMessageBox(wxString::Format(wxT("%zu 个配置启动失败:"), results.size() - succeeded) + failures,
+                     wxT("错误"), wxOK | wxICON_ERROR, this);
+    }
 }
 
 void MainFrame::OnLaunchTerminal(wxCommandEvent& event) {
-    const Profile* profile = GetSelectedProfile();
-    if (!profile) {
+    std::vector<const Profile*> selected = GetSelectedProfiles();
+    if (selected.empty()) {
         wxMessageBox(wxT("请先选择一个配置"), wxT("提示"), wxOK | wxICON_INFORMATION, this);
         return;
     }
 
-    LaunchProfile(profile);
+    if (selected.size() == 1) {
+        LaunchProfile(selected.front());
+        return;
+    }
+
+    LaunchProfiles(selected);
 }
 
 void MainFrame::OnDuplicateProfile(wxCommandEvent& event) {
@@ -468,6 +721,11 @@ void MainFrame::OnManageCredentials(wxCommandEvent& event) {
     dlg.ShowModal();
 }
 
+void MainFrame::OnLaunchDiagnostics(wxCommandEvent& event) {
+    LaunchDiagnosticsDialog dlg(this);
+    dlg.ShowModal();
+}
+
 void MainFrame::OnListDoubleClick(wxListEvent& event) {
     wxCommandEvent dummy;
     OnLaunchTerminal(dummy);
@@ -560,7 +818,157 @@ void MainFrame::ShowSearchHistoryMenu() {
     PopupMenu(&menu);
 }
 
+void MainFrame::OnWorkspaces(wxCommandEvent& event) {
+    ShowWorkspaceMenu();
+}
+
+void MainFrame::ShowWorkspaceMenu() {
+    const auto& workspaces = ConfigManager::GetInstance().GetWorkspaces();
+
+    wxMenu menu;
+
+    if (workspaces.empty()) {
+        menu.Append(wxID_ANY, wxT("暂无工作区"))->Enable(false);
+    } else {
+        for (size_t i = 0; i < workspaces.size(); ++i) {
+            Workspace workspace = workspaces[i];
+            int itemId = wxID_HIGHEST + 3000 + static_cast<int>(i);
+            wxString label = wxString::Format(wxT("%s (%zu 个%s)"),
+                wxString::FromUTF8(workspace.name), workspace.profileIds.size(),
+                workspace.layout == WorkspaceLayout::Tabs ? wxT("标签页") : wxT("窗口"));
+            menu.Append(itemId, label);
+            menu.Bind(wxEVT_MENU, [this, workspace](wxCommandEvent&) {
+                LaunchWorkspace(workspace);
+            }, itemId);
+        }
+    }
+
+    menu.AppendSeparator();
+    menu.Append(wxID_HIGHEST + 4000, wxT("将所选配置保存为工作区..."))
+        ->Enable(!GetSelectedProfiles().empty());
+    menu.Bind(wxEVT_MENU, [this](wxCommandEvent&) {
+        SaveSelectionAsWorkspace();
+    }, wxID_HIGHEST + 4000);
+
+    if (!workspaces.empty()) {
+        menu.Append(wxID_HIGHEST + 4001, wxT("删除工作区..."));
+        menu.Bind(wxEVT_MENU, [this](wxCommandEvent&) {
+            const auto& list = ConfigManager::GetInstance().GetWorkspaces();
+            if (list.empty()) {
+                return;
+            }
+
+            wxArrayString choices;
+            for (const auto& ws : list) {
+                choices.Add(wxString::FromUTF8(ws.name));
+            }
+
+            wxSingleChoiceDialog dlg(this, wxT("选择要删除的工作区："), wxT("删除工作区"), choices);
+            if (dlg.ShowModal() == wxID_OK) {
+                int selection = dlg.GetSelection();
+                if (selection >= 0 && selection < static_cast<int>(list.size())) {
+                    ConfigManager::GetInstance().DeleteWorkspace(list[selection].id);
+                }
+            }
+        }, wxID_HIGHEST + 4001);
+    }
+
+    PopupMenu(&menu);
+}
+
+void MainFrame::LaunchWorkspace(const Workspace& workspace) {
+    std::vector<LaunchSpec> specs = TerminalLauncher::ResolveWorkspace(workspace);
+    wxString name = wxString::FromUTF8(workspace.name);
+    if (specs.empty()) {
+        wxMessageBox(wxString::Format(wxT("工作区 \"%s\" 中没有可用的配置"), name),
+                     wxT("提示"), wxOK | wxICON_INFORMATION, this);
+        return;
+    }
+
+    // 整个工作区作为一个任务，结果汇总成一条
+    WorkspaceLayout layout = workspace.layout;
+    StartLaunchJob(wxT("工作区 ") + name,
+                   wxString::Format(wxT("启动工作区 \"%s\" 失败"), name),
+                   [specs, layout, workspaceName = workspace.name] {
+        LaunchResult result;
+        result.profileName = workspaceName;
+        result.success = TerminalLauncher::LaunchWorkspace(specs, layout, &result.errorMsg);
+        return std::vector<LaunchResult>{result};
+    });
+}
+
+void MainFrame::SaveSelectionAsWorkspace() {
+    std::vector<const Profile*> selected = GetSelectedProfiles();
+    if (selected.empty()) {
+        return;
+    }
+
+    wxTextEntryDialog nameDlg(this, wxT("工作区名称："), wxT("保存为工作区"));
+    if (nameDlg.ShowModal() != wxID_OK) {
+        return;
+    }
+    wxString name = nameDlg.GetValue().Trim().Trim(false);
+    if (name.IsEmpty()) {
+        wxMessageBox(wxT("工作区名称不能为空"), wxT("提示"), wxOK | wxICON_WARNING, this);
+        return;
+    }
+
+    wxArrayString layouts;
+    layouts.Add(wxT("同一窗口的多个标签页"));
+    layouts.Add(wxT("每个配置一个独立窗口"));
+    wxSingleChoiceDialog layoutDlg(this, wxT("打开方式："), wxT("保存为工作区"), layouts);
+    if (layoutDlg.ShowModal() != wxID_OK) {
+        return;
+    }
+
+    Workspace workspace;
+    workspace.name = name.utf8_string();
+    workspace.layout = layoutDlg.GetSelection() == 1 ? WorkspaceLayout::Windows : WorkspaceLayout::Tabs;
+    for (const auto* profile : selected) {
+        workspace.profileIds.push_back(profile->id);
+    }
+    ConfigManager::GetInstance().AddWorkspace(workspace);
+
+    m_statusBar->SetStatusText(wxString::Format(wxT("已保存工作区: %s"), name));
+}
+
+void MainFrame::OnSweepTimer(wxTimerEvent& event) {
+    m_maintenancePool->Submit([] { TempArtifacts::Sweep(); });
+}
+
+void MainFrame::OnSshPoolTimer(wxTimerEvent& event) {
+    if (SshSessionPool::IdleCount() > 0) {
+        m_maintenancePool->Submit([] { SshSessionPool::Maintain(); });
+    }
+}
+
 void MainFrame::OnClose(wxCloseEvent& event) {
+    // 常驻模式下关闭窗口只隐藏到托盘，从托盘菜单"退出"才真正关闭
+    if (m_trayIcon && !m_exitRequested && event.CanVeto()) {
+        Hide();
+        event.Veto();
+        return;
+    }
+#if wxUSE_HOTKEY
+    if (ConfigManager::GetInstance().GetSettings().residentTray) {
+        UnregisterHotKey(ID_HOTKEY_QUICK_LAUNCH);
+    }
+#endif
+    if (m_trayIcon) {
+        m_trayIcon->RemoveIcon();
+        m_trayIcon.reset();
+    }
+
+    // 不在 UI 线程上等在途的启动（可能卡在 SSH 连接上）：先断开投递出口，
+    // 再丢弃排队的任务，正在执行的留在后台线程跑完，结果不再送回本窗口
+    m_sweepTimer.Stop();
+    m_sshPoolTimer.Stop();
+    {
+        std::lock_guard<std::mutex> lock(m_eventSink->mutex);
+        m_eventSink->target = nullptr;
+    }
+    m_launchPool->Detach();
+    m_maintenancePool->Detach();
     ConfigManager::GetInstance().SaveConfig();
     event.Skip();
 }
@@ -580,6 +988,18 @@ const Profile* MainFrame::GetSelectedProfile() {
     return GetSelectedProfileFromListView();
 }
 
+std::vector<const Profile*> MainFrame::GetSelectedProfiles() {
+    std::vector<const Profile*> selected;
+    for (long index = m_listView->GetFirstSelected(); index != -1;
+         index = m_listView->GetNextSelected(index)) {
+        const size_t visibleIndex = static_cast<size_t>(index);
+        if (visibleIndex < m_visibleProfiles.size() && m_visibleProfiles[visibleIndex] != nullptr) {
+            selected.push_back(m_visibleProfiles[visibleIndex]);
+        }
+    }
+    return selected;
+}
+
 const Profile* MainFrame::GetSelectedProfileFromListView() {
     int index = GetSelectedIndex();
     if (index < 0) {
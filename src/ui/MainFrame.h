@@ -1,11 +1,41 @@
 #pragma once
 #include <wx/wx.h>
 #include <wx/listctrl.h>
+#include <wx/weakref.h>
 #include "core/ConfigManager.h"
+#include "core/TerminalLauncher.h"
+#include "core/WorkerPool.h"
+#include "core/InstanceChannel.h"
+#include "ui/ProfileSearchIndex.h"
+#include "ui/EmbeddedTerminalFrame.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+class QuickLaunchPalette;
+class TrayIcon;
+
+// 后台启动任务的结果，经 wxQueueEvent 送回 UI 线程
+struct LaunchOutcome {
+    wxString title;                       // 配置名 / "N 个配置" / 工作区名
+    wxString failurePrompt;               // 单项失败时对话框的首行
+    std::vector<LaunchResult> results;
+    double elapsedMs = 0;                 // 整个任务的耗时
+};
 
 class MainFrame : public wxFrame {
 public:
     MainFrame();
+    ~MainFrame() override;
+
+    // 处理命令行参数或其他实例转发来的请求（须在 UI 线程调用）
+    void HandleInstanceRequest(const InstanceRequest& request);
+
+    // 常驻模式：托盘图标 / 快捷键调用
+    void ShowQuickLaunch();
+    void ShowFromTray();
+    void ExitApplication();
 
 private:
     // 控件
@@ -23,12 +53,44 @@ private:
     wxButton* m_btnOpenDir;
     wxButton* m_btnSshHosts;
     wxButton* m_btnCredentials;
+    wxButton* m_btnWorkspaces;
+    wxButton* m_btnDiagnostics;
     wxStatusBar* m_statusBar;
 
     std::string m_searchText;
     std::string m_selectedProfileId;
     std::vector<const Profile*> m_visibleProfiles;
 
+    // 后台任务把结果投回本窗口的出口；OnClose 时断开，之后才完成的任务不再投递
+    struct EventSink {
+        std::mutex mutex;
+        wxEvtHandler* target = nullptr;
+    };
+    std::shared_ptr<EventSink> m_eventSink;
+
+    // 启动在后台线程执行，UI 不被 fork/exec、探测终端等阻塞；可同时有多个任务在途
+    std::unique_ptr<WorkerPool> m_launchPool;
+    // 清理临时文件、探测空闲 SSH 会话等维护工作用单独的线程，不占启动线程
+    std::unique_ptr<WorkerPool> m_maintenancePool;
+    size_t m_launchesInFlight = 0;
+
+    // 主窗口过滤与快速启动面板共用的搜索索引，配置列表变化后按需重建
+    ProfileSearchIndex m_searchIndex;
+    uint64_t m_indexedRevision = UINT64_MAX;
+
+    // 常驻托盘模式（设置项 residentTray）：关闭主窗口只隐藏
+    std::unique_ptr<TrayIcon> m_trayIcon;
+    QuickLaunchPalette* m_palette = nullptr;
+    bool m_exitRequested = false;
+
+    // 内置终端窗口（终端类型为“内置终端”的配置在这里以标签页打开），关闭后自动置空
+    wxWeakRef<EmbeddedTerminalFrame> m_terminalFrame;
+
+    // 定时清理到期的临时文件（下载的远程文件等）
+    wxTimer m_sweepTimer;
+    // 定时维护 SSH 会话池：keepalive 与空闲回收
+    wxTimer m_sshPoolTimer;
+
     // 初始化
     void CreateControls();
     void RefreshProfileList();
@@ -38,12 +100,23 @@ private:
     void ClearCurrentViewSelection();
     std::string DetermineSelectionAfterDelete(const std::string& deletingProfileId) const;
     void LaunchProfile(const Profile* profile);
+    void LaunchProfiles(const std::vector<const Profile*>& profiles);
+    void OpenEmbeddedTerminals(const std::vector<LaunchSpec>& specs);
+    void StartLaunchJob(const wxString& title, const wxString& failurePrompt,
+                        std::function<std::vector<LaunchResult>()> job);
     void UpdateButtonStates();
     void UpdateStatusBar();
+    ProfileSearchIndex& SearchIndex();
+    void SetupResidentMode();
 
     // 搜索历史
     void ShowSearchHistoryMenu();
 
+    // 工作区
+    void ShowWorkspaceMenu();
+    void LaunchWorkspace(const Workspace& workspace);
+    void SaveSelectionAsWorkspace();
+
     // 事件处理
     void OnNewProfile(wxCommandEvent& event);
     void OnEditProfile(wxCommandEvent& event);
@@ -55,12 +128,20 @@ private:
     void OnOpenWorkDir(wxCommandEvent& event);
     void OnManageSshHosts(wxCommandEvent& event);
     void OnManageCredentials(wxCommandEvent& event);
+    void OnWorkspaces(wxCommandEvent& event);
+    void OnLaunchDiagnostics(wxCommandEvent& event);
     void OnListDoubleClick(wxListEvent& event);
     void OnListSelectionChanged(wxListEvent& event);
     void OnSearchTextChanged(wxCommandEvent& event);
     void OnSearchEnter(wxCommandEvent& event);
     void OnClearSearch(wxCommandEvent& event);
     void OnSearchHistoryClicked(wxCommandEvent& event);
+    void OnLaunchFinished(wxThreadEvent& event);
+#if wxUSE_HOTKEY
+    void OnQuickLaunchHotKey(wxKeyEvent& event);
+#endif
+    void OnSweepTimer(wxTimerEvent& event);
+    void OnSshPoolTimer(wxTimerEvent& event);
     void OnClose(wxCloseEvent& event);
     void OnSysColourChanged(wxSysColourChangedEvent& event);
 
@@ -68,6 +149,7 @@ private:
     int GetSelectedIndex();
     const Profile* GetSelectedProfile();
     const Profile* GetSelectedProfileFromListView();
+    std::vector<const Profile*> GetSelectedProfiles();
 
     wxDECLARE_EVENT_TABLE();
 };
@@ -87,5 +169,11 @@ enum {
     ID_BTN_EXPORT,
     ID_BTN_OPEN_DIR,
     ID_BTN_SSH_HOSTS,
-    ID_BTN_CREDENTIALS
+    ID_BTN_CREDENTIALS,
+    ID_BTN_WORKSPACES,
+    ID_BTN_DIAGNOSTICS,
+    ID_LAUNCH_FINISHED,
+    ID_HOTKEY_QUICK_LAUNCH,
+    ID_TIMER_SWEEP_TEMP,
+    ID_TIMER_SSH_POOL
 };
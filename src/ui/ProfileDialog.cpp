@@ -7,6 +7,7 @@
 #include <wx/dirdlg.h>
 #include <wx/statline.h>
 #include <wx/tokenzr.h>
+#include <cstring>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -17,6 +18,11 @@
 #include <cstdlib>
 #endif
 
+namespace {
+// 终端下拉框里自定义终端的客户端数据前缀，其余项为 TerminalTypeToString 的结果
+const char* const kCustomTerminalPrefix = "custom:";
+}  // namespace
+
 wxBEGIN_EVENT_TABLE(ProfileDialog, wxDialog)
     EVT_BUTTON(ID_PROFILE_BROWSE, ProfileDialog::OnBrowse)
     EVT_BUTTON(ID_PROFILE_BROWSE_LINUX, ProfileDialog::OnBrowseLinux)
@@ -118,6 +124,13 @@ void ProfileDialog::CreateControls() {
             new wxStringClientData(wxString::FromUTF8(TerminalTypeToString(type)))
         );
     }
+    // terminals.json 新增的终端按 id 指定；客户端数据加前缀与终端类型区分
+    for (const auto& custom : TerminalLauncher::GetCustomTerminals()) {
+        m_choiceTerminal->Append(
+            wxString::FromUTF8(custom.second),
+            new wxStringClientData(wxString::FromUTF8(kCustomTerminalPrefix + custom.first))
+        );
+    }
     m_choiceTerminal->SetSelection(0);
     formSizer->Add(m_choiceTerminal, 0, wxEXPAND);
 
@@ -222,8 +235,10 @@ void ProfileDialog::InitializeFromProfile(const Profile& profile) {
     m_txtLinuxWorkingDir->SetValue(wxString::FromUTF8(profile.linuxWorkingDirectory));
     m_txtMacWorkingDir->SetValue(wxString::FromUTF8(profile.macWorkingDirectory));
     
-    // 设置终端类型
-    std::string terminalStr = TerminalTypeToString(profile.terminalType);
+    // 设置终端类型（指定了自定义终端时选中它；条目已删除则停在第一项"自动检测"）
+    std::string terminalStr = profile.terminalId.empty()
+        ? TerminalTypeToString(profile.terminalType)
+        : kCustomTerminalPrefix + profile.terminalId;
     for (unsigned int i = 0; i < m_choiceTerminal->GetCount(); i++) {
         wxStringClientData* data = static_cast<wxStringClientData*>(
             m_choiceTerminal->GetClientObject(i));
@@ -373,7 +388,14 @@ Profile ProfileDialog::GetProfile() const {
         wxStringClientData* data = static_cast<wxStringClientData*>(
             m_choiceTerminal->GetClientObject(selection));
         if (data) {
-            profile.terminalType = StringToTerminalType(data->GetData().ToStdString());
+            std::string value = data->GetData().ToStdString();
+            if (value.rfind(kCustomTerminalPrefix, 0) == 0) {
+                profile.terminalType = TerminalType::Auto;
+                profile.terminalId = value.substr(std::strlen(kCustomTerminalPrefix));
+            } else {
+                profile.terminalType = StringToTerminalType(value);
+                profile.terminalId.clear();
+            }
         }
     }
 
@@ -0,0 +1,155 @@
+#include "ui/ProfileSearchIndex.h"
+
+#include <algorithm>
+
+#include "ui/ProfileTreeBuilder.h"
+
+namespace {
+bool IsWordBoundary(const std::string& text, size_t pos) {
+    if (pos == 0) {
+        return true;
+    }
+    const char prev = text[pos - 1];
+    return prev == ' ' || prev == '-' || prev == '_' || prev == '/' || prev == '.' || prev == '\\';
+}
+
+// 名称的子序列匹配得分；不匹配返回 0。连续命中、词首命中加分，跨度越大扣分越多
+int SubsequenceScore(const std::string& text, const std::string& query) {
+    int score = 0;
+    size_t pos = 0;
+    size_t first = std::string::npos;
+    size_t last = 0;
+    for (char ch : query) {
+        size_t found = text.find(ch, pos);
+        if (found == std::string::npos) {
+            return 0;
+        }
+        if (first == std::string::npos) {
+            first = found;
+        } else if (found == last + 1) {
+            score += 5;
+        }
+        if (IsWordBoundary(text, found)) {
+            score += 8;
+        }
+        score += 1;
+        last = found;
+        pos = found + 1;
+    }
+    const int span = static_cast<int>(last - first + 1) - static_cast<int>(query.size());
+    return std::max(1, 100 + score - span);
+}
+}  // namespace
+
+void ProfileSearchIndex::Build(const std::vector<Profile>& profiles) {
+    m_entries.clear();
+    m_entries.reserve(profiles.size());
+    for (const auto& profile : profiles) {
+        Entry entry;
+        entry.profile = &profile;
+        entry.name = NormalizeSearchText(profile.name);
+        entry.fields = NormalizeSearchText(profile.description) + '\n'
+            + NormalizeSearchText(profile.workingDirectory) + '\n'
+            + NormalizeSearchText(profile.linuxWorkingDirectory) + '\n'
+            + NormalizeSearchText(profile.macWorkingDirectory);
+        m_entries.push_back(std::move(entry));
+    }
+    m_hasLast = false;
+    m_lastMatches.clear();
+}
+
+std::vector<const Profile*> ProfileSearchIndex::Filter(const std::string& searchText) const {
+    const std::string query = NormalizeSearchText(searchText);
+
+    std::vector<const Profile*> filtered;
+    filtered.reserve(m_entries.size());
+    for (const auto& entry : m_entries) {
+        if (query.empty() || entry.name.find(query) != std::string::npos
+            || entry.fields.find(query) != std::string::npos) {
+            filtered.push_back(entry.profile);
+        }
+    }
+    return filtered;
+}
+
+int ProfileSearchIndex::Score(const Entry& entry, const std::string& query) {
+    const size_t pos = entry.name.find(query);
+    if (pos != std::string::npos) {
+        if (entry.name.size() == query.size()) {
+            return 1000;
+        }
+        if (pos == 0) {
+            return 800;
+        }
+        return IsWordBoundary(entry.name, pos) ? 600 : 500;
+    }
+    if (entry.fields.find(query) != std::string::npos) {
+        return 300;
+    }
+    return SubsequenceScore(entry.name, query);
+}
+
+std::vector<ProfileSearchHit> ProfileSearchIndex::Rank(const std::string& query, size_t limit) {
+    const std::string normalized = NormalizeSearchText(query);
+
+    std::vector<ProfileSearchHit> hits;
+    if (normalized.empty()) {
+        m_hasLast = false;
+        for (size_t i = 0; i < m_entries.size() && hits.size() < limit; ++i) {
+            hits.push_back({m_entries[i].profile, 0});
+        }
+        return hits;
+    }
+
+    // 追加字符只会让命中集合变小（子串、子序列都如此），可以在上次结果里继续筛
+    const bool narrowing = m_hasLast && normalized.size() > m_lastQuery.size()
+        && normalized.compare(0, m_lastQuery.size(), m_lastQuery) == 0;
+
+    std::vector<size_t> matches;
+    std::vector<int> scores;
+    auto consider = [&](size_t index) {
+        const int score = Score(m_entries[index], normalized);
+        if (score > 0) {
+            matches.push_back(index);
+            scores.push_back(score);
+        }
+    };
+    if (narrowing) {
+        for (size_t index : m_lastMatches) {
+            consider(index);
+        }
+    } else {
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            consider(i);
+        }
+    }
+
+    // 只对前 limit 项排序；同分时名称短的优先，再按原顺序
+    std::vector<size_t> order(matches.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    const size_t top = std::min(limit, order.size());
+    std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(top), order.end(),
+                      [&](size_t a, size_t b) {
+        if (scores[a] != scores[b]) {
+            return scores[a] > scores[b];
+        }
+        const size_t lenA = m_entries[matches[a]].name.size();
+        const size_t lenB = m_entries[matches[b]].name.size();
+        if (lenA != lenB) {
+            return lenA < lenB;
+        }
+        return matches[a] < matches[b];
+    });
+
+    hits.reserve(top);
+    for (size_t i = 0; i < top; ++i) {
+        hits.push_back({m_entries[matches[order[i]]].profile, scores[order[i]]});
+    }
+
+    m_lastQuery = normalized;
+    m_lastMatches = std::move(matches);
+    m_hasLast = true;
+    return hits;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "core/Types.h"
+
+// 模糊匹配结果：得分越高越靠前
+struct ProfileSearchHit {
+    const Profile* profile = nullptr;
+    int score = 0;
+};
+
+// 配置搜索索引
+//
+// 建立时把各字段按 NormalizeSearchText 归一化一次，之后每次按键只做子串/子序列扫描，
+// 不再为每个配置重复分配、转换小写。主窗口的过滤与快速启动面板共用这一份索引。
+// 索引持有 Profile 指针，配置列表变化后（见 ConfigManager::GetProfilesRevision）须重新 Build。
+class ProfileSearchIndex {
+public:
+    void Build(const std::vector<Profile>& profiles);
+    size_t Size() const { return m_entries.size(); }
+
+    // 与 FilterProfiles 语义相同：名称、描述或任一工作目录包含关键字，保持原顺序
+    std::vector<const Profile*> Filter(const std::string& searchText) const;
+
+    // 模糊匹配并按得分取前 limit 项：名称精确/前缀/子串优先，其次其他字段子串，最后名称子序列。
+    // 关键字在上一次的基础上追加字符时，只在上一次的命中里继续筛选。
+    std::vector<ProfileSearchHit> Rank(const std::string& query, size_t limit);
+
+private:
+    struct Entry {
+        const Profile* profile;
+        std::string name;        // 归一化后的名称
+        std::string fields;      // 归一化后的描述与各平台工作目录，以 '\n' 分隔
+    };
+
+    std::vector<Entry> m_entries;
+
+    // 增量筛选缓存：上一次关键字及其全部命中（m_entries 下标）
+    std::string m_lastQuery;
+    std::vector<size_t> m_lastMatches;
+    bool m_hasLast = false;
+
+    static int Score(const Entry& entry, const std::string& query);
+};
@@ -0,0 +1,132 @@
+#include "QuickLaunchPalette.h"
+
+wxBEGIN_EVENT_TABLE(QuickLaunchPalette, wxFrame)
+    EVT_TEXT(ID_PALETTE_QUERY, QuickLaunchPalette::OnQueryChanged)
+    EVT_TEXT_ENTER(ID_PALETTE_QUERY, QuickLaunchPalette::OnQueryEnter)
+    EVT_LISTBOX_DCLICK(ID_PALETTE_RESULTS, QuickLaunchPalette::OnResultActivated)
+    EVT_CHAR_HOOK(QuickLaunchPalette::OnCharHook)
+    EVT_ACTIVATE(QuickLaunchPalette::OnActivate)
+    EVT_CLOSE(QuickLaunchPalette::OnClose)
+wxEND_EVENT_TABLE()
+
+QuickLaunchPalette::QuickLaunchPalette(wxWindow* parent, IndexProvider indexProvider, LaunchCallback onLaunch)
+    : wxFrame(parent, wxID_ANY, wxT("快速启动"), wxDefaultPosition, wxSize(560, 360),
+              wxFRAME_TOOL_WINDOW | wxFRAME_NO_TASKBAR | wxSTAY_ON_TOP | wxBORDER_SIMPLE),
+      m_indexProvider(std::move(indexProvider)),
+      m_onLaunch(std::move(onLaunch)) {
+    wxPanel* panel = new wxPanel(this);
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+
+    m_queryCtrl = new wxTextCtrl(panel, ID_PALETTE_QUERY, wxEmptyString,
+                                 wxDefaultPosition, wxDefaultSize, wxTE_PROCESS_ENTER);
+    m_queryCtrl->SetHint(wxT("输入配置名称，回车启动"));
+    m_resultList = new wxListBox(panel, ID_PALETTE_RESULTS);
+
+    sizer->Add(m_queryCtrl, 0, wxEXPAND | wxALL, 8);
+    sizer->Add(m_resultList, 1, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 8);
+    panel->SetSizer(sizer);
+}
+
+void QuickLaunchPalette::Popup() {
+    // ChangeValue 不触发 EVT_TEXT，这里手动刷新一次
+    m_queryCtrl->ChangeValue(wxEmptyString);
+    UpdateResults();
+    CentreOnScreen();
+    Show(true);
+    Raise();
+    m_queryCtrl->SetFocus();
+}
+
+void QuickLaunchPalette::UpdateResults() {
+    auto hits = m_indexProvider().Rank(m_queryCtrl->GetValue().utf8_string(), kMaxResults);
+
+    m_results.clear();
+    wxArrayString items;
+    items.reserve(hits.size());
+    for (const auto& hit : hits) {
+        m_results.push_back(hit.profile);
+        wxString label = wxString::FromUTF8(hit.profile->name);
+        const std::string dir = hit.profile->GetWorkingDirectory();
+        if (!dir.empty()) {
+            label += wxT("    ") + wxString::FromUTF8(dir);
+        }
+        items.push_back(label);
+    }
+
+    m_resultList->Freeze();
+    m_resultList->Set(items);
+    if (!m_results.empty()) {
+        m_resultList->SetSelection(0);
+    }
+    m_resultList->Thaw();
+}
+
+void QuickLaunchPalette::LaunchSelection() {
+    const int selection = m_resultList->GetSelection();
+    if (selection == wxNOT_FOUND || static_cast<size_t>(selection) >= m_results.size()) {
+        return;
+    }
+    const Profile* profile = m_results[static_cast<size_t>(selection)];
+    Hide();
+    m_onLaunch(profile);
+}
+
+void QuickLaunchPalette::MoveSelection(int delta) {
+    const int count = static_cast<int>(m_resultList->GetCount());
+    if (count == 0) {
+        return;
+    }
+    int selection = m_resultList->GetSelection();
+    selection = selection == wxNOT_FOUND ? 0 : (selection + delta + count) % count;
+    m_resultList->SetSelection(selection);
+}
+
+void QuickLaunchPalette::OnQueryChanged(wxCommandEvent& event) {
+    UpdateResults();
+}
+
+void QuickLaunchPalette::OnQueryEnter(wxCommandEvent& event) {
+    LaunchSelection();
+}
+
+void QuickLaunchPalette::OnResultActivated(wxCommandEvent& event) {
+    LaunchSelection();
+}
+
+void QuickLaunchPalette::OnCharHook(wxKeyEvent& event) {
+    switch (event.GetKeyCode()) {
+        case WXK_ESCAPE:
+            Hide();
+            return;
+        case WXK_UP:
+            MoveSelection(-1);
+            return;
+        case WXK_DOWN:
+            MoveSelection(1);
+            return;
+        case WXK_RETURN:
+        case WXK_NUMPAD_ENTER:
+            LaunchSelection();
+            return;
+        default:
+            event.Skip();
+    }
+}
+
+void QuickLaunchPalette::OnActivate(wxActivateEvent& event) {
+    // 点到别处即收起，行为与常见的启动器一致
+    if (!event.GetActive() && IsShown()) {
+        Hide();
+    }
+    event.Skip();
+}
+
+void QuickLaunchPalette::OnClose(wxCloseEvent& event) {
+    // 主窗口持有本面板并反复复用；用户关闭（如 Alt+F4）时只隐藏，随主窗口一起销毁
+    if (event.CanVeto()) {
+        Hide();
+        event.Veto();
+        return;
+    }
+    event.Skip();
+}
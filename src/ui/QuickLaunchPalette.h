@@ -0,0 +1,48 @@
+#pragma once
+#include <wx/wx.h>
+#include "ui/ProfileSearchIndex.h"
+#include <functional>
+#include <vector>
+
+// 快速启动面板：输入关键字模糊匹配配置，回车启动第一项（或上下键选中的一项）
+//
+// 与主窗口共用同一份搜索索引，只刷新面板自己的结果列表，不触碰主窗口的列表。
+// 失去焦点或按 Esc 时隐藏，下次弹出复用同一窗口。
+class QuickLaunchPalette : public wxFrame {
+public:
+    using IndexProvider = std::function<ProfileSearchIndex&()>;
+    using LaunchCallback = std::function<void(const Profile*)>;
+
+    QuickLaunchPalette(wxWindow* parent, IndexProvider indexProvider, LaunchCallback onLaunch);
+
+    // 清空关键字，居中显示并聚焦输入框
+    void Popup();
+
+private:
+    static constexpr size_t kMaxResults = 50;
+
+    wxTextCtrl* m_queryCtrl;
+    wxListBox* m_resultList;
+    IndexProvider m_indexProvider;
+    LaunchCallback m_onLaunch;
+    std::vector<const Profile*> m_results;
+
+    void UpdateResults();
+    void LaunchSelection();
+    void MoveSelection(int delta);
+
+    void OnQueryChanged(wxCommandEvent& event);
+    void OnQueryEnter(wxCommandEvent& event);
+    void OnResultActivated(wxCommandEvent& event);
+    void OnCharHook(wxKeyEvent& event);
+    void OnActivate(wxActivateEvent& event);
+    void OnClose(wxCloseEvent& event);
+
+    wxDECLARE_EVENT_TABLE();
+};
+
+// 控件 ID
+enum {
+    ID_PALETTE_QUERY = wxID_HIGHEST + 500,
+    ID_PALETTE_RESULTS
+};
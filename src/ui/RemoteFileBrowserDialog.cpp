@@ -1,23 +1,36 @@
 #include "RemoteFileBrowserDialog.h"
 #include "core/SecretStore.h"
-#include <wx/busyinfo.h>
+#include "core/TempArtifacts.h"
+#include "core/FolderDownloader.h"
 #include <wx/utils.h>
 #include <wx/filename.h>
 #include <wx/filefn.h>
 #include <wx/msgdlg.h>
+#include <wx/dirdlg.h>
+#include <wx/progdlg.h>
 
+#include <atomic>
 #include <filesystem>
+#include <future>
+#include <thread>
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <ctime>
 #include <cstring>
 
 namespace fs = std::filesystem;
 
+namespace {
+// 下载后交给默认程序打开的临时文件保留时长
+constexpr std::chrono::hours kDownloadLifetime(24);
+}
+
 wxBEGIN_EVENT_TABLE(RemoteFileBrowserDialog, wxDialog)
     EVT_BUTTON(ID_RB_UP, RemoteFileBrowserDialog::OnUp)
     EVT_BUTTON(ID_RB_REFRESH, RemoteFileBrowserDialog::OnRefresh)
     EVT_BUTTON(ID_RB_PICKDIR, RemoteFileBrowserDialog::OnPickDir)
+    EVT_BUTTON(ID_RB_DOWNLOAD_DIR, RemoteFileBrowserDialog::OnDownloadFolder)
     EVT_LIST_ITEM_ACTIVATED(ID_RB_LIST, RemoteFileBrowserDialog::OnListDoubleClick)
 wxEND_EVENT_TABLE()
 
@@ -42,31 +55,113 @@ RemoteFileBrowserDialog::RemoteFileBrowserDialog(
 
     CreateControls();
 
-    // 连接（阻塞，期间显示忙等待）
-    {
-        wxBusyCursor busy;
-        bool ok = false;
-        if (m_hasCredential) {
-            ok = m_client.Connect(m_host, m_cred);
-        }
-        if (!ok) {
-            wxMessageBox(
-                wxT("无法连接到远程主机：\n") + wxString::FromUTF8(m_client.LastError()) +
-                wxT("\n\n请检查主机、端口、用户名与凭据。"),
-                wxT("连接失败"), wxOK | wxICON_ERROR, this);
-            EndModal(wxID_CANCEL);
-            return;
-        }
-        m_connected = true;
+    if (!m_hasCredential) {
+        wxMessageBox(
+            wxT("无法连接到远程主机：未指定凭据\n\n请检查主机、端口、用户名与凭据。"),
+            wxT("连接失败"), wxOK | wxICON_ERROR, this);
+        EndModal(wxID_CANCEL);
+        return;
     }
 
-    // 初始目录：优先 startPath，否则用登录用户家目录 "."
+    // 在工作线程上取池中的空闲会话或新建连接，连上后再列初始目录：
+    // 优先 startPath，否则用登录用户家目录 "."
     std::string initial = startPath.empty() ? "." : startPath;
-    Navigate(initial);
+    m_pathLabel->SetLabel(wxT("正在连接..."));
+    m_worker = std::make_unique<SshWorker>(m_host, m_cred);
+    m_worker->Connect([this, initial](const SshResult& result) {
+        CallAfter([this, initial, result] { OnConnected(result, initial); });
+    });
 
     Centre();
 }
 
+RemoteFileBrowserDialog::~RemoteFileBrowserDialog() {
+    // 先停工作线程：之后不会再有回调投递到本对话框
+    m_worker.reset();
+}
+
+void RemoteFileBrowserDialog::OnConnected(const SshResult& result, const std::string& initialPath) {
+    if (!result.ok) {
+        wxMessageBox(
+            wxT("无法连接到远程主机：\n") + wxString::FromUTF8(result.error) +
+            wxT("\n\n请检查主机、端口、用户名与凭据。"),
+            wxT("连接失败"), wxOK | wxICON_ERROR, this);
+        if (IsModal()) {
+            EndModal(wxID_CANCEL);
+        }
+        return;
+    }
+    m_connected = true;
+    Navigate(initialPath);
+}
+
+static std::string FormatSize(uint64_t bytes, bool isDir) {
+    if (isDir) return "<DIR>";
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    size_t u = 0;
+    double s = static_cast<double>(bytes);
+    while (s >= 1024 && u < 4) { s /= 1024; ++u; }
+    char buf[64];
+    if (u == 0) {
+        std::snprintf(buf, sizeof(buf), "%llu B",
+                      static_cast<unsigned long long>(bytes));
+    } else {
+        std::snprintf(buf, sizeof(buf), "%.1f %s", s, units[u]);
+    }
+    return buf;
+}
+
+static std::string FormatTime(int64_t t) {
+    if (t <= 0) return "";
+    std::time_t tt = static_cast<std::time_t>(t);
+    std::tm tm;
+#ifdef _WIN32
+    localtime_s(&tm, &tt);
+#else
+    localtime_r(&tt, &tm);
+#endif
+    char buf[64];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", &tm);
+    return buf;
+}
+
+namespace {
+// 虚拟列表：行文本按需从 RemoteListing 取，几十万项的目录也只为可见行生成文本
+class RemoteListView : public wxListView {
+public:
+    RemoteListView(wxWindow* parent, wxWindowID id, const RemoteListing& listing, const bool& hasParentRow)
+        : wxListView(parent, id, wxDefaultPosition, wxDefaultSize,
+                     wxLC_REPORT | wxLC_SINGLE_SEL | wxLC_VIRTUAL)
+        , m_listing(listing)
+        , m_hasParentRow(hasParentRow) {}
+
+protected:
+    wxString OnGetItemText(long item, long column) const override {
+        if (m_hasParentRow) {
+            if (item == 0) {
+                if (column == 0) return wxT("..");
+                if (column == 2) return wxT("上级目录");
+                return wxEmptyString;
+            }
+            --item;
+        }
+        if (item < 0 || static_cast<size_t>(item) >= m_listing.Size()) return wxEmptyString;
+        const auto& e = m_listing.At(static_cast<size_t>(item));
+        switch (column) {
+            case 0: return wxString::FromUTF8(e.name);
+            case 1: return wxString::FromUTF8(FormatSize(e.size, e.isDir));
+            case 2: return e.isDir ? wxT("目录") : wxT("文件");
+            case 3: return wxString::FromUTF8(FormatTime(e.mtime));
+            default: return wxEmptyString;
+        }
+    }
+
+private:
+    const RemoteListing& m_listing;
+    const bool& m_hasParentRow;
+};
+}  // namespace
+
 void RemoteFileBrowserDialog::CreateControls() {
     wxPanel* panel = new wxPanel(this);
     wxBoxSizer* mainSizer = new wxBoxSizer(wxVERTICAL);
@@ -86,8 +181,7 @@ void RemoteFileBrowserDialog::CreateControls() {
     mainSizer->Add(topSizer, 0, wxEXPAND | wxALL, 10);
 
     // 文件列表
-    m_listView = new wxListView(panel, ID_RB_LIST, wxDefaultPosition, wxDefaultSize,
-                                wxLC_REPORT | wxLC_SINGLE_SEL);
+    m_listView = new RemoteListView(panel, ID_RB_LIST, m_listing, m_hasParentRow);
     m_listView->AppendColumn(wxT("名称"), wxLIST_FORMAT_LEFT, 280);
     m_listView->AppendColumn(wxT("大小"), wxLIST_FORMAT_RIGHT, 100);
     m_listView->AppendColumn(wxT("类型"), wxLIST_FORMAT_LEFT, 100);
@@ -100,6 +194,9 @@ void RemoteFileBrowserDialog::CreateControls() {
     if (m_mode == RemoteBrowserMode::PickDir) {
         wxButton* btnPick = new wxButton(panel, ID_RB_PICKDIR, wxT("选择此目录"));
         btnSizer->Add(btnPick, 0);
+    } else {
+        // 下载选中的目录；未选中目录时下载当前目录
+        btnSizer->Add(new wxButton(panel, ID_RB_DOWNLOAD_DIR, wxT("下载文件夹...")), 0);
     }
     btnSizer->AddStretchSpacer();
     btnSizer->Add(new wxButton(panel, wxID_CANCEL, wxT("关闭")), 0);
@@ -112,73 +209,97 @@ void RemoteFileBrowserDialog::CreateControls() {
     SetSizer(outer);
 }
 
-static std::string FormatSize(uint64_t bytes, bool isDir) {
-    if (isDir) return "<DIR>";
-    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
-    size_t u = 0;
-    double s = static_cast<double>(bytes);
-    while (s >= 1024 && u < 4) { s /= 1024; ++u; }
-    char buf[64];
-    if (u == 0) {
-        std::snprintf(buf, sizeof(buf), "%llu B",
-                      static_cast<unsigned long long>(bytes));
-    } else {
-        std::snprintf(buf, sizeof(buf), "%.1f %s", s, units[u]);
+void RemoteFileBrowserDialog::Navigate(const std::string& path, bool refresh) {
+    if (!m_connected) return;
+
+    // 新的跳转取代还没返回的：让它在下一批之间停下，会话留给新的请求
+    if (m_listPending) {
+        *m_listStop = true;
     }
-    return buf;
+    const unsigned seq = ++m_listSeq;
+    m_listPending = true;
+    m_listStop = std::make_shared<std::atomic<bool>>(false);
+    m_listStarted = false;
+    m_pathLabel->SetLabel(wxString::FromUTF8(path) + wxT("  (正在读取...)"));
+    // 原列表保留到新目录的第一批到达，读取失败时不会留下空白
+    m_worker->ListDir(path, [this, seq, path](const SshListResult& result) {
+        CallAfter([this, seq, path, result] { OnListed(seq, path, result); });
+    }, refresh, [this, seq, path](const std::vector<SshClient::RemoteEntry>& batch) {
+        CallAfter([this, seq, path, batch] { OnListBatch(seq, path, batch); });
+    }, m_listStop);
 }
 
-static std::string FormatTime(int64_t t) {
-    if (t <= 0) return "";
-    std::time_t tt = static_cast<std::time_t>(t);
-    std::tm tm;
-#ifdef _WIN32
-    localtime_s(&tm, &tt);
-#else
-    localtime_r(&tt, &tm);
-#endif
-    char buf[64];
-    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", &tm);
-    return buf;
+void RemoteFileBrowserDialog::BeginListing(const std::string& path) {
+    m_listStarted = true;
+    m_currentPath = path;
+    m_listing.Clear();
+    long sel = m_listView->GetFirstSelected();
+    if (sel >= 0) m_listView->Select(sel, false);
+    // ".." 返回上级（除非已是根）
+    m_hasParentRow = path != "/" && path != "//";
+    m_listView->SetItemCount(m_hasParentRow ? 1 : 0);
+    m_listView->Refresh();
 }
 
-void RemoteFileBrowserDialog::Navigate(const std::string& path) {
-    if (!m_connected) return;
+void RemoteFileBrowserDialog::OnListBatch(unsigned seq, const std::string& path,
+                                          const std::vector<SshClient::RemoteEntry>& batch) {
+    if (seq != m_listSeq) return;
+    if (!m_listStarted) {
+        BeginListing(path);
+    }
 
-    std::vector<SshClient::RemoteEntry> entries;
-    {
-        wxBusyCursor busy;
-        entries = m_client.ListDir(path);
-        if (entries.empty() && !m_client.LastError().empty()) {
-            wxMessageBox(wxString::FromUTF8(m_client.LastError()),
-                         wxT("读取目录失败"), wxOK | wxICON_WARNING, this);
-            return;
+    // 归并会移动已有行，按名称找回选中项
+    const SshClient::RemoteEntry* selected = EntryAt(m_listView->GetFirstSelected());
+    const bool hadSelection = selected != nullptr;
+    const std::string selectedName = selected ? selected->name : std::string();
+    const bool selectedIsDir = selected && selected->isDir;
+
+    m_listing.Append(batch);
+
+    const long offset = m_hasParentRow ? 1 : 0;
+    m_listView->SetItemCount(static_cast<long>(m_listing.Size()) + offset);
+    if (hadSelection) {
+        size_t index = m_listing.Find(selectedName, selectedIsDir);
+        long oldRow = m_listView->GetFirstSelected();
+        long newRow = index == RemoteListing::npos ? -1 : static_cast<long>(index) + offset;
+        if (newRow != oldRow) {
+            m_listView->Select(oldRow, false);
+            if (newRow >= 0) {
+                m_listView->Select(newRow);
+                m_listView->Focus(newRow);
+            }
         }
     }
+    m_listView->Refresh();
+    m_pathLabel->SetLabel(wxString::FromUTF8(path) +
+                          wxString::Format(wxT("  (已读取 %zu 项...)"), m_listing.Size()));
+}
 
-    m_currentPath = path;
-    m_pathLabel->SetLabel(wxString::FromUTF8(path));
-
-    m_listView->DeleteAllItems();
+void RemoteFileBrowserDialog::OnListed(unsigned seq, const std::string& path, const SshListResult& result) {
+    if (seq != m_listSeq) return;
+    m_listPending = false;
 
-    // ".." 返回上级（除非已是根）
-    if (path != "/" && path != "//") {
-        long index = m_listView->InsertItem(0, wxT(".."));
-        m_listView->SetItem(index, 1, wxT(""));
-        m_listView->SetItem(index, 2, wxT("上级目录"));
-        m_listView->SetItem(index, 3, wxT(""));
-        m_listView->SetItemData(index, -1);
+    if (!result.ok) {
+        // 已显示的部分保留
+        m_pathLabel->SetLabel(wxString::FromUTF8(m_currentPath));
+        wxMessageBox(wxString::FromUTF8(result.error),
+                     wxT("读取目录失败"), wxOK | wxICON_WARNING, this);
+        return;
+    }
+    if (!m_listStarted) {
+        BeginListing(path);     // 空目录：没有批次
     }
+    m_pathLabel->SetLabel(wxString::FromUTF8(path));
+}
 
-    long row = m_listView->GetItemCount();
-    for (const auto& e : entries) {
-        long idx = m_listView->InsertItem(row, wxString::FromUTF8(e.name));
-        m_listView->SetItem(idx, 1, wxString::FromUTF8(FormatSize(e.size, e.isDir)));
-        m_listView->SetItem(idx, 2, wxString::FromUTF8(e.isDir ? "目录" : "文件"));
-        m_listView->SetItem(idx, 3, wxString::FromUTF8(FormatTime(e.mtime)));
-        m_listView->SetItemData(idx, e.isDir ? 1 : 0);
-        ++row;
+const SshClient::RemoteEntry* RemoteFileBrowserDialog::EntryAt(long row) const {
+    if (row < 0) return nullptr;
+    if (m_hasParentRow) {
+        if (row == 0) return nullptr;
+        --row;
     }
+    if (static_cast<size_t>(row) >= m_listing.Size()) return nullptr;
+    return &m_listing.At(static_cast<size_t>(row));
 }
 
 void RemoteFileBrowserDialog::OnUp(wxCommandEvent& event) {
@@ -195,33 +316,34 @@ void RemoteFileBrowserDialog::OnUp(wxCommandEvent& event) {
 }
 
 void RemoteFileBrowserDialog::OnRefresh(wxCommandEvent& event) {
-    if (!m_currentPath.empty()) Navigate(m_currentPath);
+    if (!m_currentPath.empty()) Navigate(m_currentPath, true);
 }
 
 void RemoteFileBrowserDialog::OnListDoubleClick(wxListEvent& event) {
     long sel = m_listView->GetFirstSelected();
     if (sel < 0) return;
 
-    wxString name = m_listView->GetItemText(sel, 0);
-
-    if (name == wxT("..")) {
+    if (m_hasParentRow && sel == 0) {
         wxCommandEvent dummy;
         OnUp(dummy);
         return;
     }
+    const SshClient::RemoteEntry* entry = EntryAt(sel);
+    if (!entry) return;
+    // 先拷贝：进入目录后列表内容会被替换
+    const std::string name = entry->name;
 
-    long data = m_listView->GetItemData(sel);
     // 拼接远程完整路径
     std::string base = m_currentPath;
     if (base.empty() || base.back() != '/') base += "/";
-    std::string fullPath = base + name.ToStdString();
+    std::string fullPath = base + name;
 
-    if (data == 1) {
+    if (entry->isDir) {
         // 目录：进入
         Navigate(fullPath);
     } else {
         // 文件：下载并打开
-        OpenRemoteFile(name.ToStdString());
+        OpenRemoteFile(name);
     }
 }
 
@@ -230,24 +352,58 @@ void RemoteFileBrowserDialog::OpenRemoteFile(const std::string& name) {
     if (base.empty() || base.back() != '/') base += "/";
     std::string remotePath = base + name;
 
-    // 本地临时文件：保留扩展名以便关联打开
-    fs::path tempDir = fs::temp_directory_path();
-    fs::path localPath = tempDir / ("mtc_remote_" + name);
-    // 防止同名残留影响，先移除
-    std::error_code ec;
-    fs::remove(localPath, ec);
+    // 本地临时文件：保留文件名以便关联打开；外部程序打开后仍要读，保留一天后由清理任务删除。
+    // 同一主机上的同一文件总是落在同一个条目里，上次没下完的部分可以接着下
+    std::string error;
+    const std::string key = m_host.host + ":" + std::to_string(m_host.port) + ":" +
+                            m_host.username + ":" + remotePath;
+    fs::path localPath = TempArtifacts::AllocateKeyed(key, name, kDownloadLifetime, &error);
+    if (localPath.empty()) {
+        wxMessageBox(wxString::FromUTF8(error), wxT("下载失败"), wxOK | wxICON_ERROR, this);
+        return;
+    }
 
+    // 下载在工作线程上进行；进度对话框轮询进度，取消时打断传输（部分文件保留，下次续传）
+    std::atomic<uint64_t> done{0};
+    std::atomic<uint64_t> total{0};
+    SftpDownloadOptions options;
+    options.resume = true;
+    options.progress = [&done, &total](uint64_t d, uint64_t t) {
+        done = d;
+        total = t;
+        return true;
+    };
+    std::future<SshResult> future = m_worker->Download(remotePath, localPath.string(), options);
+
+    bool cancelling = false;
     {
-        wxString busyMsg = wxString::FromUTF8("正在下载 ") +
-                           wxString::FromUTF8(name) +
-                           wxString::FromUTF8(" ...");
-        wxBusyInfo info(busyMsg, this);
-        wxWindowDisabler disableAll;
-        if (!m_client.DownloadFile(remotePath, localPath.string())) {
-            wxMessageBox(wxString::FromUTF8(m_client.LastError()),
+        wxProgressDialog progressDlg(wxT("下载"), wxT("正在下载 ") + wxString::FromUTF8(name),
+                                     1000, this,
+                                     wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME);
+        // 取消后也要等操作结束：progress 回调引用着这里的局部变量
+        while (future.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready) {
+            uint64_t t = total;
+            uint64_t d = done;
+            int value = t > 0 ? static_cast<int>(std::min<uint64_t>(d * 1000 / t, 999)) : 0;
+            wxString message = wxString::FromUTF8(name) + wxT("\n") +
+                               wxString::FromUTF8(FormatSize(d, false)) + wxT(" / ") +
+                               wxString::FromUTF8(FormatSize(t, false));
+            if (cancelling) {
+                progressDlg.Pulse(wxT("正在取消..."));
+            } else if (!progressDlg.Update(value, message)) {
+                cancelling = true;
+                m_worker->Cancel();
+            }
+        }
+    }
+
+    SshResult result = future.get();
+    if (!result.ok) {
+        if (!cancelling) {
+            wxMessageBox(wxString::FromUTF8(result.error),
                          wxT("下载失败"), wxOK | wxICON_ERROR, this);
-            return;
         }
+        return;
     }
 
     if (!wxLaunchDefaultApplication(wxString::FromUTF8(localPath.string()))) {
@@ -261,3 +417,90 @@ void RemoteFileBrowserDialog::OnPickDir(wxCommandEvent& event) {
     m_selectedDir = m_currentPath;
     EndModal(wxID_OK);
 }
+
+void RemoteFileBrowserDialog::OnDownloadFolder(wxCommandEvent& event) {
+    std::string remoteDir = m_currentPath;
+    const SshClient::RemoteEntry* entry = EntryAt(m_listView->GetFirstSelected());
+    if (entry && entry->isDir) {
+        std::string base = m_currentPath;
+        if (base.empty() || base.back() != '/') base += "/";
+        remoteDir = base + entry->name;
+    }
+    if (remoteDir.empty()) return;
+    DownloadFolder(remoteDir);
+}
+
+void RemoteFileBrowserDialog::DownloadFolder(const std::string& remoteDir) {
+    wxDirDialog dirDlg(this, wxT("选择保存位置"), wxEmptyString,
+                       wxDD_DEFAULT_STYLE | wxDD_DIR_MUST_EXIST);
+    if (dirDlg.ShowModal() != wxID_OK) return;
+
+    // 在所选位置下建一个与远程目录同名的子目录；根目录或家目录用主机名
+    std::string name = remoteDir;
+    while (name.size() > 1 && name.back() == '/') name.pop_back();
+    size_t slash = name.find_last_of('/');
+    if (slash != std::string::npos) name = name.substr(slash + 1);
+    if (name.empty() || name == "." || name == "/") name = m_host.name;
+    fs::path localDir = fs::u8path(dirDlg.GetPath().ToUTF8().data()) / fs::u8path(name);
+
+    FolderDownloader downloader(m_host, m_cred);
+    std::atomic<bool> finished{false};
+    bool ok = false;
+    std::string error;
+    std::thread worker([&] {
+        ok = downloader.Run(remoteDir, localDir, &error);
+        finished = true;
+    });
+
+    // 进度对话框轮询共享进度；取消后等工作线程把在途的传输收尾
+    {
+        wxProgressDialog progressDlg(wxT("下载文件夹"), wxT("正在读取远程目录..."), 1000, this,
+                                     wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME);
+        while (!finished) {
+            wxMilliSleep(100);
+            FolderDownloadProgress p = downloader.Progress();
+            int value = 0;
+            wxString message;
+            if (p.scanning) {
+                message = wxT("正在读取远程目录...");
+            } else {
+                if (p.bytesTotal > 0) {
+                    value = static_cast<int>(std::min<uint64_t>(p.bytesDone * 1000 / p.bytesTotal, 999));
+                }
+                message = wxString::Format(wxT("%zu / %zu 个文件，%s / %s\n%s"),
+                                           p.filesDone, p.filesTotal,
+                                           wxString::FromUTF8(FormatSize(p.bytesDone, false)),
+                                           wxString::FromUTF8(FormatSize(p.bytesTotal, false)),
+                                           wxString::FromUTF8(p.currentFile));
+            }
+            if (downloader.IsCancelled()) {
+                progressDlg.Pulse(wxT("正在取消..."));
+            } else if (!progressDlg.Update(value, message)) {
+                downloader.Cancel();
+            }
+        }
+    }
+    worker.join();
+
+    if (ok) {
+        wxMessageBox(wxT("已下载到：\n") + wxString::FromUTF8(localDir.u8string()),
+                     wxT("下载完成"), wxOK | wxICON_INFORMATION, this);
+        return;
+    }
+    if (downloader.IsCancelled()) {
+        return;
+    }
+
+    // 列出前几个失败项
+    wxString details = wxString::FromUTF8(error);
+    auto failures = downloader.Failures();
+    const size_t kShown = 10;
+    for (size_t i = 0; i < failures.size() && i < kShown; ++i) {
+        details += wxT("\n  ") + wxString::FromUTF8(failures[i].relativePath) +
+                   wxT(": ") + wxString::FromUTF8(failures[i].error);
+    }
+    if (failures.size() > kShown) {
+        details += wxString::Format(wxT("\n  ……等 %zu 项"), failures.size());
+    }
+    wxMessageBox(details, wxT("下载文件夹"), wxOK | wxICON_WARNING, this);
+}
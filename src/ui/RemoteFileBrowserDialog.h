@@ -1,7 +1,9 @@
 #pragma once
 #include <wx/wx.h>
 #include <wx/listctrl.h>
-#include "core/SshClient.h"
+#include <memory>
+#include "core/RemoteListing.h"
+#include "core/SshWorker.h"
 #include "core/Types.h"
 
 enum class RemoteBrowserMode {
@@ -9,7 +11,10 @@ enum class RemoteBrowserMode {
     PickDir    // 选择一个目录返回
 };
 
-// 远程文件浏览器（基于 SFTP）。构造时连接，失败则弹错并以取消结束。
+// 远程文件浏览器（基于 SFTP）。连接、列目录、下载都在 SshWorker 的工作线程上进行，
+// 慢速服务器不会卡住界面；结果经 CallAfter 回到界面线程。目录边读边显示：
+// 条目分批并入 RemoteListing（始终有序），列表是虚拟列表，只为可见行取文本。连接失败则弹错并以取消结束；
+// 关闭时连接归还会话池，短时间内再打开同一主机无需重新连接认证。
 class RemoteFileBrowserDialog : public wxDialog {
 public:
     RemoteFileBrowserDialog(wxWindow* parent,
@@ -17,6 +22,7 @@ public:
                             const Credential* cred,
                             const std::string& startPath,
                             RemoteBrowserMode mode = RemoteBrowserMode::Browse);
+    ~RemoteFileBrowserDialog() override;
 
     // PickDir 模式下返回选定的目录（成功结束时有效）
     std::string GetSelectedDir() const { return m_selectedDir; }
@@ -26,8 +32,15 @@ private:
     Credential m_cred;          // 拷贝一份（cred 可能为 nullptr → 默认 Password 但无秘密）
     bool m_hasCredential;
     RemoteBrowserMode m_mode;
-    SshClient m_client;
+    std::unique_ptr<SshWorker> m_worker;
     bool m_connected = false;
+    unsigned m_listSeq = 0;     // 最近一次列目录请求的序号，过期的结果直接丢弃
+    bool m_listPending = false;
+    SshWorker::StopFlag m_listStop; // 最近一次列目录请求的停止标志
+    bool m_listStarted = false; // 本次请求已收到第一批，列表已切换到新目录
+
+    RemoteListing m_listing;    // 当前目录的条目（虚拟列表按行号从这里取）
+    bool m_hasParentRow = false;    // 第 0 行是 ".."
 
     std::string m_currentPath;
     std::string m_selectedDir;
@@ -36,13 +49,22 @@ private:
     wxListView* m_listView;
 
     void CreateControls();
-    void Navigate(const std::string& path);
+    // refresh 为 true 时跳过目录缓存
+    void Navigate(const std::string& path, bool refresh = false);
+    void OnConnected(const SshResult& result, const std::string& initialPath);
+    void OnListBatch(unsigned seq, const std::string& path, const std::vector<SshClient::RemoteEntry>& batch);
+    void OnListed(unsigned seq, const std::string& path, const SshListResult& result);
+    void BeginListing(const std::string& path);
+    // 行号对应的条目；".." 行与越界返回 nullptr
+    const SshClient::RemoteEntry* EntryAt(long row) const;
     void OnUp(wxCommandEvent& event);
     void OnListDoubleClick(wxListEvent& event);
     void OnPickDir(wxCommandEvent& event);
     void OnRefresh(wxCommandEvent& event);
+    void OnDownloadFolder(wxCommandEvent& event);
 
     void OpenRemoteFile(const std::string& name);
+    void DownloadFolder(const std::string& remoteDir);
 
     wxDECLARE_EVENT_TABLE();
 };
@@ -51,5 +73,6 @@ enum RemoteBrowserIds {
     ID_RB_LIST = wxID_HIGHEST + 380,
     ID_RB_UP,
     ID_RB_REFRESH,
-    ID_RB_PICKDIR
+    ID_RB_PICKDIR,
+    ID_RB_DOWNLOAD_DIR
 };
@@ -29,7 +29,7 @@ void SshHostDialog::CreateControls() {
     wxPanel* panel = new wxPanel(this);
     wxBoxSizer* mainSizer = new wxBoxSizer(wxVERTICAL);
 
-    wxFlexGridSizer* form = new wxFlexGridSizer(4, 2, 8, 12);
+    wxFlexGridSizer* form = new wxFlexGridSizer(5, 2, 8, 12);
     form->AddGrowableCol(1, 1);
 
     form->Add(new wxStaticText(panel, wxID_ANY, wxT("名称:")), 0, wxALIGN_CENTER_VERTICAL);
@@ -52,6 +52,13 @@ void SshHostDialog::CreateControls() {
     m_txtUsername = new wxTextCtrl(panel, wxID_ANY);
     form->Add(m_txtUsername, 1, wxEXPAND);
 
+    form->Add(new wxStaticText(panel, wxID_ANY, wxT("连接超时(秒):")), 0, wxALIGN_CENTER_VERTICAL);
+    m_txtTimeout = new wxTextCtrl(panel, wxID_ANY, wxT("10"));
+    wxIntegerValidator<int> timeoutValidator;
+    timeoutValidator.SetRange(1, 300);
+    m_txtTimeout->SetValidator(timeoutValidator);
+    form->Add(m_txtTimeout, 1, wxEXPAND);
+
     mainSizer->Add(form, 1, wxEXPAND | wxALL, 12);
 
     wxBoxSizer* btnSizer = new wxBoxSizer(wxHORIZONTAL);
@@ -75,6 +82,7 @@ void SshHostDialog::InitializeFromHost(const SshHost& host) {
     m_txtHost->SetValue(wxString::FromUTF8(host.host));
     m_txtPort->SetValue(wxString::Format(wxT("%d"), host.port));
     m_txtUsername->SetValue(wxString::FromUTF8(host.username));
+    m_txtTimeout->SetValue(wxString::Format(wxT("%d"), host.connectTimeoutSec));
 }
 
 void SshHostDialog::OnOK(wxCommandEvent& event) {
@@ -101,5 +109,8 @@ SshHost SshHostDialog::GetSshHost() const {
     m_txtPort->GetValue().ToLong(&port);
     host.port = static_cast<int>(port);
     host.username = m_txtUsername->GetValue().ToStdString();
+    long timeout = 10;
+    m_txtTimeout->GetValue().ToLong(&timeout);
+    host.connectTimeoutSec = static_cast<int>(timeout);
     return host;
 }
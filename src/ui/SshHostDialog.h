@@ -2,7 +2,7 @@
 #include <wx/wx.h>
 #include "core/Types.h"
 
-// 单条 SSH 主机编辑对话框（name / host / port / username）
+// 单条 SSH 主机编辑对话框（name / host / port / username / 连接超时）
 class SshHostDialog : public wxDialog {
 public:
     SshHostDialog(wxWindow* parent, const wxString& title);
@@ -15,6 +15,7 @@ private:
     wxTextCtrl* m_txtHost;
     wxTextCtrl* m_txtPort;
     wxTextCtrl* m_txtUsername;
+    wxTextCtrl* m_txtTimeout;
 
     SshHost m_original;
     bool m_isEdit;
@@ -0,0 +1,379 @@
+#include "TerminalPanel.h"
+#include <wx/clipbrd.h>
+#include <wx/dcbuffer.h>
+#include <algorithm>
+
+namespace {
+
+const wxColour kDefaultForeground(0xD0, 0xD0, 0xD0);
+const wxColour kDefaultBackground(0x1E, 0x1E, 0x1E);
+
+// xterm 前 16 色
+const unsigned char kAnsiColors[16][3] = {
+    {0x00, 0x00, 0x00}, {0xCD, 0x00, 0x00}, {0x00, 0xCD, 0x00}, {0xCD, 0xCD, 0x00},
+    {0x00, 0x00, 0xEE}, {0xCD, 0x00, 0xCD}, {0x00, 0xCD, 0xCD}, {0xE5, 0xE5, 0xE5},
+    {0x7F, 0x7F, 0x7F}, {0xFF, 0x00, 0x00}, {0x00, 0xFF, 0x00}, {0xFF, 0xFF, 0x00},
+    {0x5C, 0x5C, 0xFF}, {0xFF, 0x00, 0xFF}, {0x00, 0xFF, 0xFF}, {0xFF, 0xFF, 0xFF},
+};
+
+wxString CellText(char32_t ch) {
+    return wxString(wxUniChar(static_cast<unsigned int>(ch)));
+}
+
+} // namespace
+
+wxBEGIN_EVENT_TABLE(TerminalPanel, wxPanel)
+    EVT_PAINT(TerminalPanel::OnPaint)
+    EVT_SIZE(TerminalPanel::OnSize)
+    EVT_CHAR(TerminalPanel::OnChar)
+    EVT_MOUSEWHEEL(TerminalPanel::OnMouseWheel)
+    EVT_LEFT_DOWN(TerminalPanel::OnMouseDown)
+    EVT_SET_FOCUS(TerminalPanel::OnFocusChanged)
+    EVT_KILL_FOCUS(TerminalPanel::OnFocusChanged)
+wxEND_EVENT_TABLE()
+
+TerminalPanel::TerminalPanel(wxWindow* parent, TitleCallback onTitle, ExitCallback onExit)
+    : wxPanel(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxWANTS_CHARS | wxBORDER_NONE),
+      m_screen(kDefaultCols, kDefaultRows),
+      m_onTitle(std::move(onTitle)),
+      m_onExit(std::move(onExit)) {
+    SetBackgroundStyle(wxBG_STYLE_PAINT);
+    m_font = wxFont(wxFontInfo(11).Family(wxFONTFAMILY_TELETYPE));
+    m_boldFont = m_font.Bold();
+    SetFont(m_font);
+    GetTextExtent(wxT("M"), &m_charWidth, &m_charHeight);
+    m_charWidth = std::max(m_charWidth, 1);
+    m_charHeight = std::max(m_charHeight, 1);
+    SetInitialSize(wxSize(m_charWidth * kDefaultCols, m_charHeight * kDefaultRows));
+}
+
+TerminalPanel::~TerminalPanel() {
+    // 先停读线程，之后不会再有回调访问本对象
+    m_session.Close();
+}
+
+bool TerminalPanel::Start(const SpawnRequest& request, std::string* errorMsg) {
+    UpdateGridSize();
+    int cols;
+    int rows;
+    {
+        std::lock_guard<std::mutex> lock(m_screenMutex);
+        cols = m_screen.Cols();
+        rows = m_screen.Rows();
+    }
+    return m_session.Start(request, cols, rows,
+        [this](const char* data, size_t size) { OnPtyOutput(data, size); },
+        [this](int exitCode) {
+            CallAfter([this, exitCode] {
+                if (m_onExit) m_onExit(this, exitCode);
+            });
+        },
+        errorMsg);
+}
+
+void TerminalPanel::OnPtyOutput(const char* data, size_t size) {
+    std::string replies;
+    {
+        std::lock_guard<std::mutex> lock(m_screenMutex);
+        m_screen.Feed(data, size);
+        replies = m_screen.TakeReplies();
+    }
+    if (!replies.empty()) {
+        m_session.Write(replies);
+    }
+    // 大量输出时只排一次刷新，UI 线程处理时再取最新状态
+    if (!m_refreshQueued.exchange(true)) {
+        CallAfter(&TerminalPanel::FlushOutput);
+    }
+}
+
+void TerminalPanel::FlushOutput() {
+    m_refreshQueued = false;
+    std::string title;
+    {
+        std::lock_guard<std::mutex> lock(m_screenMutex);
+        title = m_screen.Title();
+    }
+    if (title != m_lastTitle) {
+        m_lastTitle = title;
+        if (m_onTitle) m_onTitle(this, wxString::FromUTF8(title));
+    }
+    Refresh(false);
+}
+
+void TerminalPanel::UpdateGridSize() {
+    wxSize client = GetClientSize();
+    int cols = client.GetWidth() > 0 ? std::max(client.GetWidth() / m_charWidth, 1) : kDefaultCols;
+    int rows = client.GetHeight() > 0 ? std::max(client.GetHeight() / m_charHeight, 1) : kDefaultRows;
+    {
+        std::lock_guard<std::mutex> lock(m_screenMutex);
+        if (cols == m_screen.Cols() && rows == m_screen.Rows()) {
+            return;
+        }
+        m_screen.Resize(cols, rows);
+    }
+    m_session.Resize(cols, rows);
+}
+
+void TerminalPanel::ScrollView(int lines) {
+    size_t limit;
+    {
+        std::lock_guard<std::mutex> lock(m_screenMutex);
+        limit = m_screen.AlternateScreen() ? 0 : m_screen.ScrollbackSize();
+    }
+    long long offset = static_cast<long long>(m_scrollOffset) + lines;
+    m_scrollOffset = static_cast<size_t>(std::clamp<long long>(offset, 0, static_cast<long long>(limit)));
+    Refresh(false);
+}
+
+void TerminalPanel::Paste() {
+    std::string text;
+    if (wxTheClipboard->Open()) {
+        if (wxTheClipboard->IsSupported(wxDF_UNICODETEXT)) {
+            wxTextDataObject data;
+            wxTheClipboard->GetData(data);
+            text = data.GetText().utf8_string();
+        }
+        wxTheClipboard->Close();
+    }
+    if (text.empty()) {
+        return;
+    }
+    // 换行按回车发送；程序开启括号粘贴模式时加上首尾标记
+    std::string normalized;
+    normalized.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\r' && i + 1 < text.size() && text[i + 1] == '\n') continue;
+        normalized += (text[i] == '\n') ? '\r' : text[i];
+    }
+    bool bracketed;
+    {
+        std::lock_guard<std::mutex> lock(m_screenMutex);
+        bracketed = m_screen.BracketedPaste();
+    }
+    m_session.Write(bracketed ? "\x1b[200~" + normalized + "\x1b[201~" : normalized);
+}
+
+wxColour TerminalPanel::ToColour(const VtColor& color, bool foreground) const {
+    switch (color.kind) {
+        case VtColor::Kind::Default:
+            return foreground ? kDefaultForeground : kDefaultBackground;
+        case VtColor::Kind::Rgb:
+            return wxColour(color.r, color.g, color.b);
+        case VtColor::Kind::Indexed:
+            break;
+    }
+    int i = color.index;
+    if (i < 16) {
+        return wxColour(kAnsiColors[i][0], kAnsiColors[i][1], kAnsiColors[i][2]);
+    }
+    if (i < 232) {
+        // 6x6x6 色立方
+        i -= 16;
+        auto level = [](int v) { return static_cast<unsigned char>(v == 0 ? 0 : 55 + v * 40); };
+        return wxColour(level(i / 36), level((i / 6) % 6), level(i % 6));
+    }
+    unsigned char grey = static_cast<unsigned char>(8 + (i - 232) * 10);
+    return wxColour(grey, grey, grey);
+}
+
+void TerminalPanel::OnPaint(wxPaintEvent& event) {
+    wxAutoBufferedPaintDC dc(this);
+    dc.SetBackground(wxBrush(kDefaultBackground));
+    dc.Clear();
+    dc.SetBackgroundMode(wxBRUSHSTYLE_TRANSPARENT);
+
+    std::lock_guard<std::mutex> lock(m_screenMutex);
+    const int cols = m_screen.Cols();
+    const int rows = m_screen.Rows();
+    const size_t offset = std::min(m_scrollOffset, m_screen.ScrollbackSize());
+
+    for (int row = 0; row < rows; ++row) {
+        const VtLine& line = m_screen.ViewLine(row, offset);
+        const int limit = std::min(cols, static_cast<int>(line.size()));
+        const int y = row * m_charHeight;
+
+        // 同样式的相邻格子合成一段：先填背景，窄字符拼成一个字符串画，宽字符按格子单独定位
+        for (int col = 0; col < limit; ) {
+            const VtCell& first = line[col];
+            int end = col + 1;
+            while (end < limit && line[end].SameStyle(first)) ++end;
+
+            wxColour fg = ToColour(first.fg, true);
+            wxColour bg = ToColour(first.bg, false);
+            if (first.attrs & kVtInverse) std::swap(fg, bg);
+            if (first.attrs & kVtDim) fg = fg.ChangeLightness(60);
+
+            if (bg != kDefaultBackground) {
+                dc.SetPen(*wxTRANSPARENT_PEN);
+                dc.SetBrush(wxBrush(bg));
+                dc.DrawRectangle(col * m_charWidth, y, (end - col) * m_charWidth, m_charHeight);
+            }
+            dc.SetFont((first.attrs & kVtBold) ? m_boldFont : m_font);
+            dc.SetTextForeground(fg);
+
+            wxString run;
+            int runStart = col;
+            auto flush = [&] {
+                if (!run.empty() && run.find_first_not_of(wxT(' ')) != wxString::npos) {
+                    dc.DrawText(run, runStart * m_charWidth, y);
+                }
+                run.clear();
+            };
+            for (int c = col; c < end; ++c) {
+                const VtCell& cell = line[c];
+                if (cell.width == 0) continue;
+                if (cell.width == 2) {
+                    flush();
+                    dc.DrawText(CellText(cell.ch), c * m_charWidth, y);
+                    continue;
+                }
+                if (run.empty()) runStart = c;
+                run += CellText(cell.ch);
+            }
+            flush();
+
+            if (first.attrs & kVtUnderline) {
+                dc.SetPen(wxPen(fg));
+                dc.DrawLine(col * m_charWidth, y + m_charHeight - 1, end * m_charWidth, y + m_charHeight - 1);
+            }
+            col = end;
+        }
+    }
+
+    // 光标：有焦点时实心块，否则空心框；翻看回滚内容时不画
+    if (offset == 0 && m_screen.CursorVisible()) {
+        const int row = m_screen.CursorRow();
+        const int col = m_screen.CursorCol();
+        const VtCell& cell = m_screen.Line(row)[col];
+        const int width = (cell.width == 2 ? 2 : 1) * m_charWidth;
+        wxRect rect(col * m_charWidth, row * m_charHeight, width, m_charHeight);
+        if (HasFocus()) {
+            dc.SetPen(*wxTRANSPARENT_PEN);
+            dc.SetBrush(wxBrush(kDefaultForeground));
+            dc.DrawRectangle(rect);
+            if (cell.ch != U' ') {
+                dc.SetFont((cell.attrs & kVtBold) ? m_boldFont : m_font);
+                dc.SetTextForeground(kDefaultBackground);
+                dc.DrawText(CellText(cell.ch), rect.GetLeft(), rect.GetTop());
+            }
+        } else {
+            dc.SetPen(wxPen(kDefaultForeground));
+            dc.SetBrush(*wxTRANSPARENT_BRUSH);
+            dc.DrawRectangle(rect);
+        }
+    }
+}
+
+void TerminalPanel::OnSize(wxSizeEvent& event) {
+    UpdateGridSize();
+    Refresh(false);
+    event.Skip();
+}
+
+std::string TerminalPanel::KeyToBytes(const wxKeyEvent& event, bool appCursorKeys) const {
+    const int key = event.GetKeyCode();
+    const bool ctrl = event.RawControlDown();
+    const bool shift = event.ShiftDown();
+
+    // 方向键：应用模式（vim、less 等开启）用 SS3，带修饰键时用 CSI 1;m
+    auto cursorKey = [&](char final) -> std::string {
+        int modifier = 1 + (shift ? 1 : 0) + (event.AltDown() ? 2 : 0) + (ctrl ? 4 : 0);
+        if (modifier > 1) return "\x1b[1;" + std::to_string(modifier) + final;
+        return std::string(appCursorKeys ? "\x1bO" : "\x1b[") + final;
+    };
+
+    switch (key) {
+        case WXK_RETURN:
+        case WXK_NUMPAD_ENTER: return "\r";
+        case WXK_BACK: return "\x7f";
+        case WXK_TAB: return shift ? "\x1b[Z" : "\t";
+        case WXK_ESCAPE: return "\x1b";
+        case WXK_UP: case WXK_NUMPAD_UP: return cursorKey('A');
+        case WXK_DOWN: case WXK_NUMPAD_DOWN: return cursorKey('B');
+        case WXK_RIGHT: case WXK_NUMPAD_RIGHT: return cursorKey('C');
+        case WXK_LEFT: case WXK_NUMPAD_LEFT: return cursorKey('D');
+        case WXK_HOME: case WXK_NUMPAD_HOME: return cursorKey('H');
+        case WXK_END: case WXK_NUMPAD_END: return cursorKey('F');
+        case WXK_INSERT: case WXK_NUMPAD_INSERT: return "\x1b[2~";
+        case WXK_DELETE: case WXK_NUMPAD_DELETE: return "\x1b[3~";
+        case WXK_PAGEUP: case WXK_NUMPAD_PAGEUP: return "\x1b[5~";
+        case WXK_PAGEDOWN: case WXK_NUMPAD_PAGEDOWN: return "\x1b[6~";
+        case WXK_F1: return "\x1bOP";
+        case WXK_F2: return "\x1bOQ";
+        case WXK_F3: return "\x1bOR";
+        case WXK_F4: return "\x1bOS";
+        case WXK_F5: return "\x1b[15~";
+        case WXK_F6: return "\x1b[17~";
+        case WXK_F7: return "\x1b[18~";
+        case WXK_F8: return "\x1b[19~";
+        case WXK_F9: return "\x1b[20~";
+        case WXK_F10: return "\x1b[21~";
+        case WXK_F11: return "\x1b[23~";
+        case WXK_F12: return "\x1b[24~";
+        default: break;
+    }
+
+    wxChar uc = event.GetUnicodeKey();
+    if (uc == WXK_NONE) {
+        return std::string();
+    }
+    // Ctrl+字母 / Ctrl+[ 等映射为 C0 控制字符（部分平台在 EVT_CHAR 里已经换算好）
+    if (ctrl && ((uc >= 'a' && uc <= 'z') || (uc >= '@' && uc <= '_'))) {
+        uc = static_cast<wxChar>(uc & 0x1F);
+    } else if (ctrl && uc == ' ') {
+        uc = 0;
+    }
+    std::string bytes = uc == 0 ? std::string(1, '\0') : wxString(uc).utf8_string();
+    // Alt 作为 Meta：前缀 ESC
+    return event.AltDown() ? "\x1b" + bytes : bytes;
+}
+
+void TerminalPanel::OnChar(wxKeyEvent& event) {
+    const int key = event.GetKeyCode();
+    if (event.RawControlDown() && event.ShiftDown() && (key == 'V' || key == 'v' || key == 0x16)) {
+        Paste();
+        return;
+    }
+    if (event.ShiftDown() && (key == WXK_PAGEUP || key == WXK_PAGEDOWN)) {
+        int page;
+        {
+            std::lock_guard<std::mutex> lock(m_screenMutex);
+            page = std::max(m_screen.Rows() - 1, 1);
+        }
+        ScrollView(key == WXK_PAGEUP ? page : -page);
+        return;
+    }
+
+    bool appCursorKeys;
+    {
+        std::lock_guard<std::mutex> lock(m_screenMutex);
+        appCursorKeys = m_screen.ApplicationCursorKeys();
+    }
+    std::string bytes = KeyToBytes(event, appCursorKeys);
+    if (bytes.empty()) {
+        event.Skip();
+        return;
+    }
+    // 有输入时回到底部
+    if (m_scrollOffset != 0) {
+        m_scrollOffset = 0;
+        Refresh(false);
+    }
+    m_session.Write(bytes);
+}
+
+void TerminalPanel::OnMouseWheel(wxMouseEvent& event) {
+    const int delta = event.GetWheelDelta() > 0 ? event.GetWheelDelta() : 120;
+    ScrollView(event.GetWheelRotation() / delta * 3);
+}
+
+void TerminalPanel::OnMouseDown(wxMouseEvent& event) {
+    SetFocus();
+    event.Skip();
+}
+
+void TerminalPanel::OnFocusChanged(wxFocusEvent& event) {
+    Refresh(false);
+    event.Skip();
+}
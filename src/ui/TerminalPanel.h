@@ -0,0 +1,61 @@
+#pragma once
+#include <wx/wx.h>
+#include "core/PtySession.h"
+#include "core/VtScreen.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// 内置终端面板：一个 pty 会话 + VtScreen 网格的绘制与键盘输入
+//
+// pty 输出在读线程上喂给 VtScreen，随后合并成一次 CallAfter 刷新界面；
+// 标题（OSC 0/2）变化和 shell 退出经回调通知所在的标签页窗口（UI 线程）。
+class TerminalPanel : public wxPanel {
+public:
+    using TitleCallback = std::function<void(TerminalPanel*, const wxString&)>;
+    using ExitCallback = std::function<void(TerminalPanel*, int exitCode)>;
+
+    TerminalPanel(wxWindow* parent, TitleCallback onTitle, ExitCallback onExit);
+    ~TerminalPanel() override;
+
+    // 按当前面板大小启动会话
+    bool Start(const SpawnRequest& request, std::string* errorMsg = nullptr);
+    bool IsRunning() const { return m_session.IsRunning(); }
+
+private:
+    static constexpr int kDefaultCols = 80;
+    static constexpr int kDefaultRows = 24;
+
+    PtySession m_session;
+    VtScreen m_screen;
+    mutable std::mutex m_screenMutex;       // m_screen 由读线程写、UI 线程读
+    std::atomic<bool> m_refreshQueued{false};
+    std::string m_lastTitle;
+    size_t m_scrollOffset = 0;              // 向上翻看回滚内容的行数，0 = 跟随底部
+
+    wxFont m_font;
+    wxFont m_boldFont;
+    int m_charWidth = 8;
+    int m_charHeight = 16;
+
+    TitleCallback m_onTitle;
+    ExitCallback m_onExit;
+
+    void OnPtyOutput(const char* data, size_t size);   // 读线程
+    void FlushOutput();                                 // UI 线程
+    void UpdateGridSize();
+    void Paste();
+    void ScrollView(int lines);
+    wxColour ToColour(const VtColor& color, bool foreground) const;
+    std::string KeyToBytes(const wxKeyEvent& event, bool appCursorKeys) const;
+
+    void OnPaint(wxPaintEvent& event);
+    void OnSize(wxSizeEvent& event);
+    void OnChar(wxKeyEvent& event);
+    void OnMouseWheel(wxMouseEvent& event);
+    void OnMouseDown(wxMouseEvent& event);
+    void OnFocusChanged(wxFocusEvent& event);
+
+    wxDECLARE_EVENT_TABLE();
+};
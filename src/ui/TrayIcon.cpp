@@ -0,0 +1,49 @@
+#include "TrayIcon.h"
+#include "MainFrame.h"
+#include "utils/PathUtils.h"
+
+wxBEGIN_EVENT_TABLE(TrayIcon, wxTaskBarIcon)
+    EVT_TASKBAR_LEFT_DCLICK(TrayIcon::OnLeftDoubleClick)
+    EVT_MENU(ID_TRAY_QUICK_LAUNCH, TrayIcon::OnQuickLaunch)
+    EVT_MENU(ID_TRAY_SHOW, TrayIcon::OnShowWindow)
+    EVT_MENU(ID_TRAY_EXIT, TrayIcon::OnExit)
+wxEND_EVENT_TABLE()
+
+TrayIcon::TrayIcon(MainFrame* frame)
+    : m_frame(frame) {
+    wxIcon icon;
+#ifdef __WXMSW__
+    icon = wxIcon(wxT("APP_ICON"), wxBITMAP_TYPE_ICO_RESOURCE);
+#else
+    wxString iconFile = wxString(PathUtils::GetExecutableDir().string()) + wxT("/mtc.png");
+    if (wxFileExists(iconFile)) {
+        icon.LoadFile(iconFile, wxBITMAP_TYPE_PNG);
+    }
+#endif
+    SetIcon(icon, wxT("MTC - 终端环境管理器"));
+}
+
+wxMenu* TrayIcon::CreatePopupMenu() {
+    wxMenu* menu = new wxMenu();
+    menu->Append(ID_TRAY_QUICK_LAUNCH, wxT("快速启动..."));
+    menu->Append(ID_TRAY_SHOW, wxT("显示主窗口"));
+    menu->AppendSeparator();
+    menu->Append(ID_TRAY_EXIT, wxT("退出"));
+    return menu;
+}
+
+void TrayIcon::OnLeftDoubleClick(wxTaskBarIconEvent& event) {
+    m_frame->ShowFromTray();
+}
+
+void TrayIcon::OnQuickLaunch(wxCommandEvent& event) {
+    m_frame->ShowQuickLaunch();
+}
+
+void TrayIcon::OnShowWindow(wxCommandEvent& event) {
+    m_frame->ShowFromTray();
+}
+
+void TrayIcon::OnExit(wxCommandEvent& event) {
+    m_frame->ExitApplication();
+}
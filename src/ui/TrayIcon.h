@@ -0,0 +1,31 @@
+#pragma once
+#include <wx/wx.h>
+#include <wx/taskbar.h>
+
+class MainFrame;
+
+// 常驻托盘图标：双击显示主窗口，右键菜单提供快速启动 / 显示主窗口 / 退出
+class TrayIcon : public wxTaskBarIcon {
+public:
+    explicit TrayIcon(MainFrame* frame);
+
+protected:
+    wxMenu* CreatePopupMenu() override;
+
+private:
+    MainFrame* m_frame;
+
+    void OnLeftDoubleClick(wxTaskBarIconEvent& event);
+    void OnQuickLaunch(wxCommandEvent& event);
+    void OnShowWindow(wxCommandEvent& event);
+    void OnExit(wxCommandEvent& event);
+
+    wxDECLARE_EVENT_TABLE();
+};
+
+// 控件 ID
+enum {
+    ID_TRAY_QUICK_LAUNCH = wxID_HIGHEST + 600,
+    ID_TRAY_SHOW,
+    ID_TRAY_EXIT
+};
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "core/AsyncFileWriter.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path TestFile(const std::string& name) {
+    return fs::temp_directory_path() /
+           ("mtc_async_writer_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+            "_" + name);
+}
+
+std::string ReadFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+TEST(AsyncFileWriterTests, WritesBlocksInOrderAndRecyclesBuffers) {
+    fs::path path = TestFile("order");
+    std::string expected;
+    {
+        AsyncFileWriter writer(2);
+        ASSERT_TRUE(writer.Open(path.string(), false));
+        for (int i = 0; i < 200; ++i) {
+            std::vector<char> block = writer.AcquireBuffer(64);
+            std::string text = std::to_string(i) + ",";
+            std::copy(text.begin(), text.end(), block.begin());
+            expected += text;
+            // 只写前 text.size() 字节，缓冲其余部分不落盘
+            ASSERT_TRUE(writer.Write(std::move(block), text.size()));
+        }
+        ASSERT_TRUE(writer.Finish());
+        EXPECT_EQ(writer.BytesWritten(), expected.size());
+    }
+    EXPECT_EQ(ReadFile(path), expected);
+
+    // append 接在已有内容之后
+    {
+        AsyncFileWriter writer;
+        ASSERT_TRUE(writer.Open(path.string(), true));
+        std::vector<char> block = writer.AcquireBuffer(3);
+        std::copy_n("end", 3, block.begin());
+        ASSERT_TRUE(writer.Write(std::move(block), 3));
+        ASSERT_TRUE(writer.Finish());
+    }
+    EXPECT_EQ(ReadFile(path), expected + "end");
+    fs::remove(path);
+}
+
+TEST(AsyncFileWriterTests, OpenFailsForMissingDirectory) {
+    AsyncFileWriter writer;
+    std::string error;
+    EXPECT_FALSE(writer.Open((TestFile("missing_dir") / "file").string(), false, &error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_TRUE(writer.Finish());
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "core/DnsCache.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace {
+
+using Clock = DnsCache::Clock;
+using std::chrono::seconds;
+
+// 计数的假解析器：ok 为 false 时解析失败；每次成功返回一个以调用次数区分的地址
+struct FakeResolver {
+    std::atomic<int> calls{0};
+    std::atomic<bool> ok{true};
+
+    DnsCache::Resolver Get() {
+        return [this](const std::string&, DnsCache::Addresses& out, std::string& err) {
+            int n = ++calls;
+            if (!ok) {
+                err = "无法解析主机";
+                return false;
+            }
+            ResolvedAddress address;
+            address.family = n;
+            out = {address};
+            return true;
+        };
+    }
+};
+
+} // namespace
+
+TEST(DnsCacheTests, ReusesFreshResultsAndRefreshesStaleInBackground) {
+    FakeResolver resolver;
+    DnsCache cache(resolver.Get());
+    const auto t0 = Clock::now();
+    DnsCache::Addresses out;
+    std::string err;
+
+    ASSERT_TRUE(cache.Resolve("Example.COM", out, err, t0));
+    ASSERT_TRUE(cache.Resolve("example.com", out, err, t0 + seconds(30)));
+    EXPECT_EQ(resolver.calls, 1);
+    EXPECT_EQ(out.front().family, 1);
+
+    // 过了 TTL：先返回旧地址，后台重新解析
+    ASSERT_TRUE(cache.Resolve("example.com", out, err, t0 + seconds(61)));
+    EXPECT_EQ(out.front().family, 1);
+    cache.WaitIdle();
+    EXPECT_EQ(resolver.calls, 2);
+    ASSERT_TRUE(cache.Resolve("example.com", out, err));
+    EXPECT_EQ(out.front().family, 2);
+
+    // 过期太久的不再先用旧地址
+    ASSERT_TRUE(cache.Resolve("example.com", out, err, Clock::now() + seconds(60 + 601)));
+    EXPECT_EQ(resolver.calls, 3);
+    EXPECT_EQ(out.front().family, 3);
+}
+
+TEST(DnsCacheTests, CachesFailuresBriefly) {
+    FakeResolver resolver;
+    resolver.ok = false;
+    DnsCache cache(resolver.Get());
+    const auto t0 = Clock::now();
+    DnsCache::Addresses out;
+    std::string err;
+
+    EXPECT_FALSE(cache.Resolve("missing.invalid", out, err, t0));
+    err.clear();
+    EXPECT_FALSE(cache.Resolve("missing.invalid", out, err, t0 + seconds(2)));
+    EXPECT_FALSE(err.empty());
+    EXPECT_EQ(resolver.calls, 1);
+
+    // 失败结果过期后同步重试
+    resolver.ok = true;
+    EXPECT_TRUE(cache.Resolve("missing.invalid", out, err, t0 + seconds(6)));
+    EXPECT_EQ(resolver.calls, 2);
+
+    cache.Invalidate("MISSING.invalid");
+    EXPECT_EQ(cache.Size(), 0u);
+}
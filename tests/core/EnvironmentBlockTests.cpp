@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "core/EnvironmentBlock.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+#ifndef _WIN32
+std::string SnapshotValue(const std::string& name) {
+    for (const auto& e : EnvironmentSnapshot::Current()->Entries()) {
+        if (e.name == name) return e.value;
+    }
+    return "<unset>";
+}
+#endif
+
+std::vector<std::string> Names(const std::vector<EnvEntry>& entries) {
+    std::vector<std::string> names;
+    for (const auto& e : entries) {
+        names.push_back(e.name);
+    }
+    return names;
+}
+
+} // namespace
+
+TEST(EnvironmentBlockTests, SnapshotIsSortedAndDeduplicated) {
+    EnvironmentSnapshot snap({{"PATH", "/bin"}, {"HOME", "/root"}, {"PATH", "/usr/bin"}},
+                             EnvKeyRule::CaseSensitive);
+    ASSERT_EQ(snap.Entries().size(), 2u);
+    EXPECT_EQ(snap.Entries()[0].name, "HOME");
+    EXPECT_EQ(snap.Entries()[1].name, "PATH");
+    EXPECT_EQ(snap.Entries()[1].value, "/usr/bin");
+}
+
+TEST(EnvironmentBlockTests, MergeOverridesAndInsertsInOrder) {
+    EnvironmentSnapshot snap({{"A", "1"}, {"C", "3"}, {"E", "5"}}, EnvKeyRule::CaseSensitive);
+    std::vector<EnvVariable> overlay = {{"D", "4"}, {"A", "one"}, {"F", "6"}};
+
+    auto merged = snap.Merge(overlay);
+    EXPECT_EQ(Names(merged), (std::vector<std::string>{"A", "C", "D", "E", "F"}));
+    EXPECT_EQ(merged[0].value, "one");
+    EXPECT_EQ(merged[2].value, "4");
+}
+
+TEST(EnvironmentBlockTests, MergeLastOverlayEntryWins) {
+    EnvironmentSnapshot snap({{"X", "base"}}, EnvKeyRule::CaseSensitive);
+    auto merged = snap.Merge({{"X", "first"}, {"X", "second"}});
+    ASSERT_EQ(merged.size(), 1u);
+    EXPECT_EQ(merged[0].value, "second");
+}
+
+TEST(EnvironmentBlockTests, CaseSensitiveKeepsDistinctNames) {
+    EnvironmentSnapshot snap({{"Path", "a"}}, EnvKeyRule::CaseSensitive);
+    auto merged = snap.Merge({{"PATH", "b"}});
+    EXPECT_EQ(merged.size(), 2u);
+}
+
+TEST(EnvironmentBlockTests, CaseInsensitiveReplacesAndKeepsOverlayCasing) {
+    EnvironmentSnapshot snap({{"Path", "C:\\Windows"}, {"temp", "C:\\Temp"}}, EnvKeyRule::CaseInsensitive);
+    auto merged = snap.Merge({{"PATH", "D:\\Tools"}});
+    ASSERT_EQ(merged.size(), 2u);
+    EXPECT_EQ(merged[0].name, "PATH");
+    EXPECT_EQ(merged[0].value, "D:\\Tools");
+    EXPECT_EQ(merged[1].name, "temp");
+}
+
+TEST(EnvironmentBlockTests, BuildEnvpFormatsAndSkipsEmptyNames) {
+    EnvironmentSnapshot snap({{"HOME", "/root"}}, EnvKeyRule::CaseSensitive);
+    auto envp = snap.BuildEnvp({{"", "ignored"}, {"LANG", "C.UTF-8"}});
+    EXPECT_EQ(envp, (std::vector<std::string>{"HOME=/root", "LANG=C.UTF-8"}));
+}
+
+#ifndef _WIN32
+TEST(EnvironmentBlockTests, CurrentSeesOverwrittenVariable) {
+    setenv("MTC_SNAPSHOT_TEST", "one", 1);
+    EXPECT_EQ(SnapshotValue("MTC_SNAPSHOT_TEST"), "one");
+
+    // 覆盖已有变量：environ 与条目数都不变
+    setenv("MTC_SNAPSHOT_TEST", "two", 1);
+    EXPECT_EQ(SnapshotValue("MTC_SNAPSHOT_TEST"), "two");
+
+    unsetenv("MTC_SNAPSHOT_TEST");
+    EXPECT_EQ(SnapshotValue("MTC_SNAPSHOT_TEST"), "<unset>");
+}
+#endif
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "core/FolderDownloader.h"
+
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+SshClient::RemoteEntry Make(const std::string& name, bool isDir = false, uint64_t size = 0) {
+    SshClient::RemoteEntry entry;
+    entry.name = name;
+    entry.isDir = isDir;
+    entry.size = size;
+    return entry;
+}
+
+std::set<std::string> FailedPaths(const FolderDownloader& downloader) {
+    std::set<std::string> paths;
+    for (const auto& failure : downloader.Failures()) {
+        paths.insert(failure.relativePath);
+    }
+    return paths;
+}
+
+} // namespace
+
+TEST(FolderDownloaderTests, ScanRejectsNamesThatLeaveTheTarget) {
+    // 不可信的服务器：名称里带路径分隔符、上级目录或 NUL
+    std::map<std::string, std::vector<SshClient::RemoteEntry>> tree = {
+        {"/srv", {Make("ok.txt", false, 1), Make("../../.bashrc", false, 10), Make("/etc/x", false, 10),
+                  Make("a\\b", false, 10), Make("sub", true), Make("..", true), Make("", false, 10),
+                  Make(std::string("nul\0x", 5), false, 10)}},
+        {"/srv/sub", {Make("good", false, 2), Make(".", true), Make("x/../../y", false, 10)}},
+    };
+    std::vector<std::string> listed;
+    FolderDownloader::Lister list = [&](const std::string& path, std::vector<SshClient::RemoteEntry>& entries,
+                                        std::string&) {
+        listed.push_back(path);
+        entries = tree[path];
+        return true;
+    };
+
+    FolderDownloader downloader{SshHost(), Credential()};
+    std::string err;
+    ASSERT_TRUE(downloader.Scan(list, "/srv", &err)) << err;
+
+    // 被拒的目录不再往下列
+    EXPECT_EQ(listed, (std::vector<std::string>{"/srv", "/srv/sub"}));
+    FolderDownloadProgress progress = downloader.Progress();
+    EXPECT_FALSE(progress.scanning);
+    EXPECT_EQ(progress.filesTotal, 2u);
+    EXPECT_EQ(progress.bytesTotal, 3u);
+    EXPECT_EQ(progress.filesFailed, 8u);
+    EXPECT_EQ(FailedPaths(downloader),
+              (std::set<std::string>{"../../.bashrc", "/etc/x", "a\\b", "..", "", std::string("nul\0x", 5),
+                                     "sub/.", "sub/x/../../y"}));
+}
+
+#ifndef _WIN32
+TEST(FolderDownloaderTests, ResolvesOnlyPathsInsideTheTarget) {
+    fs::path dir = fs::temp_directory_path() /
+                   ("mtc_folder_download_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+    fs::remove_all(dir);
+    fs::create_directories(dir / "target" / "sub");
+    fs::create_directories(dir / "outside");
+    fs::create_directory_symlink(dir / "outside", dir / "target" / "link");
+    fs::create_directories(dir / "target2");
+
+    fs::path out;
+    EXPECT_TRUE(FolderDownloader::ResolveLocalPath(dir / "target", "sub/file", out));
+    EXPECT_EQ(out, dir / "target" / "sub" / "file");
+    EXPECT_TRUE(FolderDownloader::ResolveLocalPath(dir / "target", "new/dir/file", out));   // 尚未创建
+
+    EXPECT_FALSE(FolderDownloader::ResolveLocalPath(dir / "target", "../outside/x", out));
+    EXPECT_FALSE(FolderDownloader::ResolveLocalPath(dir / "target", "../target2/x", out));  // 前缀相同的兄弟目录
+    EXPECT_FALSE(FolderDownloader::ResolveLocalPath(dir / "target", (dir / "outside" / "x").string(), out));
+    EXPECT_FALSE(FolderDownloader::ResolveLocalPath(dir / "target", "link/x", out));       // 本地符号链接指向外面
+    EXPECT_FALSE(FolderDownloader::ResolveLocalPath(dir / "target", ".", out));
+
+    fs::remove_all(dir);
+}
+#endif
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "core/InstanceChannel.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+TEST(InstanceChannelTests, EncodesAndDecodesRequests) {
+    const InstanceRequest::Kind kinds[] = {InstanceRequest::Kind::Activate, InstanceRequest::Kind::Launch,
+                                           InstanceRequest::Kind::Search, InstanceRequest::Kind::QuickLaunch};
+    for (auto kind : kinds) {
+        InstanceRequest request;
+        request.kind = kind;
+        request.argument = "two\nlines";     // 参数里的换行原样保留
+        InstanceRequest decoded;
+        ASSERT_TRUE(InstanceChannel::Decode(InstanceChannel::Encode(request), decoded));
+        EXPECT_EQ(decoded.kind, kind);
+        EXPECT_EQ(decoded.argument, "two\nlines");
+    }
+
+    InstanceRequest decoded;
+    EXPECT_TRUE(InstanceChannel::Decode("activate", decoded));
+    EXPECT_EQ(decoded.argument, "");
+    EXPECT_FALSE(InstanceChannel::Decode("delete\nall", decoded));
+    EXPECT_FALSE(InstanceChannel::Decode("", decoded));
+}
+
+TEST(InstanceChannelTests, ParsesForwardedArguments) {
+    InstanceRequest request;
+    EXPECT_TRUE(InstanceChannel::ParseArgs({"mtc", "--launch", "p1"}, request));
+    EXPECT_EQ(request.kind, InstanceRequest::Kind::Launch);
+    EXPECT_EQ(request.argument, "p1");
+    EXPECT_TRUE(InstanceChannel::ParseArgs({"mtc", "--search", "web api"}, request));
+    EXPECT_EQ(request.kind, InstanceRequest::Kind::Search);
+    EXPECT_EQ(request.argument, "web api");
+    EXPECT_TRUE(InstanceChannel::ParseArgs({"mtc", "--palette"}, request));
+    EXPECT_EQ(request.kind, InstanceRequest::Kind::QuickLaunch);
+    EXPECT_FALSE(InstanceChannel::ParseArgs({"mtc", "--launch"}, request));
+    EXPECT_FALSE(InstanceChannel::ParseArgs({"mtc"}, request));
+}
+
+#ifndef _WIN32
+#include <sys/stat.h>
+
+namespace {
+
+// socket 目录指向测试自己的目录（XDG_RUNTIME_DIR 优先于临时根目录）
+class InstanceChannelSocketTests : public ::testing::Test {
+protected:
+    fs::path dir;
+    std::string oldRuntimeDir;
+    bool hadRuntimeDir = false;
+
+    void SetUp() override {
+        dir = fs::temp_directory_path() /
+              ("mtc_instance_channel_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+               "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        const char* old = std::getenv("XDG_RUNTIME_DIR");
+        hadRuntimeDir = old != nullptr;
+        oldRuntimeDir = old ? old : "";
+    }
+
+    void TearDown() override {
+        InstanceChannel::Stop();
+        if (hadRuntimeDir) {
+            setenv("XDG_RUNTIME_DIR", oldRuntimeDir.c_str(), 1);
+        } else {
+            unsetenv("XDG_RUNTIME_DIR");
+        }
+        fs::remove_all(dir);
+    }
+};
+
+} // namespace
+
+TEST_F(InstanceChannelSocketTests, SendReachesTheHandler) {
+    fs::create_directory(dir / "run");
+    chmod((dir / "run").c_str(), 0755);    // 多余的权限位会被收回
+    setenv("XDG_RUNTIME_DIR", (dir / "run").c_str(), 1);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<InstanceRequest> received;
+    ASSERT_TRUE(InstanceChannel::Start([&](const InstanceRequest& request) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back(request);
+        cv.notify_all();
+    }));
+    struct stat st {};
+    ASSERT_EQ(stat((dir / "run").c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 0777, 0700u);
+
+    InstanceRequest launch;
+    launch.kind = InstanceRequest::Kind::Launch;
+    launch.argument = "profile-1";
+    std::string err;
+    EXPECT_TRUE(InstanceChannel::Send(launch, &err)) << err;
+    InstanceRequest search;
+    search.kind = InstanceRequest::Kind::Search;
+    search.argument = "web api";
+    EXPECT_TRUE(InstanceChannel::Send(search, &err)) << err;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(2), [&] { return received.size() == 2; }));
+    }
+    EXPECT_EQ(received[0].kind, InstanceRequest::Kind::Launch);
+    EXPECT_EQ(received[0].argument, "profile-1");
+    EXPECT_EQ(received[1].kind, InstanceRequest::Kind::Search);
+    EXPECT_EQ(received[1].argument, "web api");
+
+    // 停止后没有实例在监听
+    InstanceChannel::Stop();
+    EXPECT_FALSE(InstanceChannel::Send(launch, &err));
+}
+
+TEST_F(InstanceChannelSocketTests, RefusesSocketDirectoryThatIsASymlink) {
+    // 别人预先放好的符号链接：既不在那里监听，也不往那里发
+    fs::create_directory(dir / "elsewhere");
+    fs::create_directory_symlink(dir / "elsewhere", dir / "run");
+    setenv("XDG_RUNTIME_DIR", (dir / "run").c_str(), 1);
+
+    EXPECT_FALSE(InstanceChannel::Start([](const InstanceRequest&) {}));
+    std::string err;
+    EXPECT_FALSE(InstanceChannel::Send(InstanceRequest(), &err));
+    EXPECT_TRUE(fs::is_empty(dir / "elsewhere"));
+}
+#endif
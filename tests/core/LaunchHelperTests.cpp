@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "core/LaunchHelper.h"
+
+#ifdef __linux__
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <csignal>
+#include <unistd.h>
+
+namespace {
+
+// 测试结束（含断言失败提前返回）时关掉助手
+struct HelperGuard {
+    HelperGuard() { LaunchHelper::Start(); }
+    ~HelperGuard() { LaunchHelper::Stop(); }
+};
+
+std::filesystem::path TempPath(const std::string& name) {
+    return std::filesystem::temp_directory_path() /
+           ("mtc_helper_" + name + "_" + std::to_string(getpid()));
+}
+
+// 等分离启动的进程写出文件（写临时文件再改名，读到的总是完整内容）
+bool WaitForFile(const std::filesystem::path& path, std::string& content) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::ifstream in(path);
+        if (in) {
+            std::ostringstream ss;
+            ss << in.rdbuf();
+            content = ss.str();
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+// /proc/<pid>/status 里十六进制的信号位图
+unsigned long long SignalMask(const std::string& status, const std::string& field) {
+    size_t pos = status.find(field + ":");
+    if (pos == std::string::npos) return ~0ULL;
+    return std::stoull(status.substr(pos + field.size() + 1), nullptr, 16);
+}
+
+} // namespace
+
+TEST(LaunchHelperTests, SpawnedProcessStartsWithDefaultSignals) {
+    HelperGuard helper;
+    ASSERT_TRUE(LaunchHelper::IsRunning());
+
+    auto out = TempPath("status");
+    std::filesystem::remove(out);
+    SpawnRequest request;
+    request.argv = {"/bin/sh", "-c", "cat /proc/self/status > \"$0.tmp\" && mv \"$0.tmp\" \"$0\"",
+                    out.string()};
+    std::string err;
+    ASSERT_TRUE(LaunchHelper::Spawn(request, &err)) << err;
+
+    std::string status;
+    ASSERT_TRUE(WaitForFile(out, status));
+    const unsigned long long ignored = SignalMask(status, "SigIgn");
+    EXPECT_EQ(ignored & (1ULL << (SIGPIPE - 1)), 0u) << status;
+    EXPECT_EQ(ignored & (1ULL << (SIGCHLD - 1)), 0u) << status;
+    EXPECT_EQ(SignalMask(status, "SigBlk"), 0u) << status;
+    std::filesystem::remove(out);
+}
+
+TEST(LaunchHelperTests, ConcurrentSpawnsGetTheirOwnReplies) {
+    HelperGuard helper;
+    ASSERT_TRUE(LaunchHelper::IsRunning());
+
+    constexpr int kThreads = 8;
+    std::vector<std::filesystem::path> outputs;
+    std::vector<std::string> errors(kThreads);
+    std::vector<int> results(kThreads, -1);
+    for (int i = 0; i < kThreads; ++i) {
+        outputs.push_back(TempPath("concurrent" + std::to_string(i)));
+        std::filesystem::remove(outputs.back());
+    }
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&, i] {
+            SpawnRequest request;
+            // 奇数号 exec 失败，应答里必须是它自己的错误
+            if (i % 2) {
+                request.argv = {"/nonexistent/mtc-terminal-" + std::to_string(i)};
+            } else {
+                request.argv = {"/bin/sh", "-c", "echo $0 > \"$0\"", outputs[i].string()};
+            }
+            results[i] = LaunchHelper::Spawn(request, &errors[i]) ? 1 : 0;
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    for (int i = 0; i < kThreads; ++i) {
+        if (i % 2) {
+            EXPECT_EQ(results[i], 0);
+            EXPECT_NE(errors[i].find("mtc-terminal-" + std::to_string(i)), std::string::npos) << errors[i];
+        } else {
+            EXPECT_EQ(results[i], 1) << errors[i];
+            std::string content;
+            EXPECT_TRUE(WaitForFile(outputs[i], content));
+            std::filesystem::remove(outputs[i]);
+        }
+    }
+    EXPECT_TRUE(LaunchHelper::IsRunning());
+}
+
+TEST(LaunchHelperTests, ForwardsInheritedScript) {
+    HelperGuard helper;
+    ASSERT_TRUE(LaunchHelper::IsRunning());
+
+    auto out = TempPath("script");
+    std::filesystem::remove(out);
+    SpawnRequest request;
+    request.argv = {"/bin/sh", ProcessSpawner::kInheritedScriptPath};
+    request.inheritedScript = "echo from-fd > \"" + out.string() + ".tmp\" && mv \"" +
+                              out.string() + ".tmp\" \"" + out.string() + "\"\n";
+    std::string err;
+    ASSERT_TRUE(LaunchHelper::Spawn(request, &err)) << err;
+
+    std::string content;
+    ASSERT_TRUE(WaitForFile(out, content));
+    EXPECT_EQ(content, "from-fd\n");
+    std::filesystem::remove(out);
+}
+TEST(LaunchHelperTests, RefusesToForkFromMultiThreadedProcess) {
+    // 助手 fork 后不 exec 就建线程，父进程已有别的线程时不能 fork
+    std::atomic<bool> release{false};
+    std::thread other([&release] {
+        while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    EXPECT_FALSE(LaunchHelper::Start());
+    EXPECT_FALSE(LaunchHelper::IsRunning());
+    release = true;
+    other.join();
+}
+#endif
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "core/LaunchTelemetry.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class LaunchTelemetryTests : public ::testing::Test {
+protected:
+    fs::path dir;
+
+    void SetUp() override {
+        dir = fs::temp_directory_path() /
+              ("mtc_launch_telemetry_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+               "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::remove_all(dir);
+        LaunchTelemetry::SetFile(dir / "launch_log.bin", 4);
+    }
+
+    void TearDown() override {
+        LaunchTelemetry::SetFile(fs::path());
+        fs::remove_all(dir);
+    }
+};
+
+LaunchRecord MakeRecord(const std::string& profileId, const std::string& terminal, uint32_t totalMicros) {
+    LaunchRecord record;
+    record.profileId = profileId;
+    record.terminal = terminal;
+    record.success = true;
+    record.phaseMicros[static_cast<size_t>(LaunchPhase::Total)] = totalMicros;
+    return record;
+}
+
+} // namespace
+
+TEST_F(LaunchTelemetryTests, RingBufferKeepsNewestRecordsInOrder) {
+    for (uint32_t i = 1; i <= 6; ++i) {
+        ASSERT_TRUE(LaunchTelemetry::Append(MakeRecord("p" + std::to_string(i), "xterm", i * 1000)));
+    }
+
+    auto records = LaunchTelemetry::ReadAll();
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(records.front().profileId, "p3");
+    EXPECT_EQ(records.back().profileId, "p6");
+    EXPECT_EQ(records.back().terminal, "xterm");
+    EXPECT_EQ(records.back().phaseMicros[static_cast<size_t>(LaunchPhase::Total)], 6000u);
+
+    // 文件大小固定：写满后覆盖旧槽位
+    auto size = fs::file_size(dir / "launch_log.bin");
+    LaunchTelemetry::Append(MakeRecord("p7", "xterm", 7000));
+    EXPECT_EQ(fs::file_size(dir / "launch_log.bin"), size);
+
+    LaunchTelemetry::Clear();
+    EXPECT_TRUE(LaunchTelemetry::ReadAll().empty());
+}
+
+TEST_F(LaunchTelemetryTests, TraceRecordsPhasesAndOutermostOnly) {
+    {
+        LaunchTelemetry::Trace trace("outer", true);
+        {
+            LaunchTelemetry::Trace nested("inner", false);
+            LaunchTelemetry::PhaseTimer timer(LaunchPhase::Spawn);
+        }
+        LaunchTelemetry::SetTerminal("kitty");
+        trace.SetSuccess(true);
+    }
+
+    auto records = LaunchTelemetry::ReadAll();
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].profileId, "outer");
+    EXPECT_EQ(records[0].terminal, "kitty");
+    EXPECT_TRUE(records[0].remote);
+    EXPECT_TRUE(records[0].success);
+    EXPECT_GT(records[0].timestampMs, 0);
+    EXPECT_GE(records[0].phaseMicros[static_cast<size_t>(LaunchPhase::Total)],
+              records[0].phaseMicros[static_cast<size_t>(LaunchPhase::Spawn)]);
+
+    // 没有 Trace 时计时器什么也不记
+    { LaunchTelemetry::PhaseTimer timer(LaunchPhase::Resolve); }
+    EXPECT_EQ(LaunchTelemetry::ReadAll().size(), 1u);
+}
+
+TEST_F(LaunchTelemetryTests, PercentilesAndGrouping) {
+    std::vector<uint32_t> values;
+    for (uint32_t i = 1; i <= 100; ++i) values.push_back(i);
+    EXPECT_EQ(LaunchTelemetry::Percentile(values, 50), 50u);
+    EXPECT_EQ(LaunchTelemetry::Percentile(values, 95), 95u);
+    EXPECT_EQ(LaunchTelemetry::Percentile(values, 99), 99u);
+    EXPECT_EQ(LaunchTelemetry::Percentile({7}, 99), 7u);
+    EXPECT_EQ(LaunchTelemetry::Percentile({}, 50), 0u);
+
+    std::vector<LaunchRecord> records = {
+        MakeRecord("a", "kitty", 1000), MakeRecord("a", "kitty", 3000),
+        MakeRecord("b", "kitty", 2000), MakeRecord("b", "xterm", 9000),
+    };
+    records[3].success = false;
+
+    auto byTerminal = LaunchTelemetry::Summarize(records, LaunchTelemetry::GroupBy::TerminalType,
+                                                 LaunchPhase::Total);
+    ASSERT_EQ(byTerminal.size(), 2u);
+    EXPECT_EQ(byTerminal[0].key, "kitty");
+    EXPECT_EQ(byTerminal[0].count, 3u);
+    EXPECT_DOUBLE_EQ(byTerminal[0].p50Ms, 2.0);
+    EXPECT_DOUBLE_EQ(byTerminal[0].p99Ms, 3.0);
+    EXPECT_EQ(byTerminal[1].key, "xterm");
+    EXPECT_EQ(byTerminal[1].failures, 1u);
+
+    auto byProfile = LaunchTelemetry::Summarize(records, LaunchTelemetry::GroupBy::Profile,
+                                                LaunchPhase::Total);
+    ASSERT_EQ(byProfile.size(), 2u);
+    EXPECT_EQ(byProfile[0].key, "a");
+    EXPECT_DOUBLE_EQ(byProfile[1].p95Ms, 9.0);
+}
+
+#ifndef _WIN32
+TEST_F(LaunchTelemetryTests, ConcurrentProcessesDoNotLoseRecords) {
+    // 命令行与界面同时启动：两个进程交替追加，累计条数不能被对方覆盖
+    constexpr int kPerProcess = 2000;
+    LaunchTelemetry::SetFile(dir / "launch_log.bin", 4096);
+    pid_t child = fork();
+    ASSERT_NE(child, -1);
+    if (child == 0) {
+        for (int i = 0; i < kPerProcess; ++i) {
+            LaunchTelemetry::Append(MakeRecord("child", "xterm", 1000));
+        }
+        _exit(0);
+    }
+    for (int i = 0; i < kPerProcess; ++i) {
+        LaunchTelemetry::Append(MakeRecord("parent", "xterm", 1000));
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    EXPECT_EQ(LaunchTelemetry::ReadAll().size(), 2u * kPerProcess);
+}
+#endif
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "core/PartialDownload.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class PartialDownloadTests : public ::testing::Test {
+protected:
+    fs::path dir;
+    fs::path target;
+    PartialDownloadState remote;
+
+    void SetUp() override {
+        dir = fs::temp_directory_path() /
+              ("mtc_partial_download_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+               "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        target = dir / "data.bin";
+        remote.remotePath = "/srv/a=b/data.bin";
+        remote.remoteSize = 100;
+        remote.remoteMtime = 1700000000;
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir);
+    }
+
+    void WritePart(const std::string& content) {
+        std::ofstream(PartialDownload::PartPath(target), std::ios::binary) << content;
+    }
+};
+
+std::string ReadFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+TEST_F(PartialDownloadTests, ResumesFromPartLengthWhenRemoteUnchanged) {
+    WritePart("0123456789");
+    PartialDownloadState saved = remote;
+    saved.bytesDone = 10;
+    ASSERT_TRUE(PartialDownload::SaveState(target, saved));
+
+    PartialDownloadState loaded;
+    ASSERT_TRUE(PartialDownload::LoadState(target, loaded));
+    EXPECT_EQ(loaded.remotePath, remote.remotePath);   // 路径里的 '=' 不影响解析
+    EXPECT_EQ(loaded.remoteMtime, remote.remoteMtime);
+    EXPECT_EQ(loaded.bytesDone, 10u);
+
+    EXPECT_EQ(PartialDownload::ResumeOffset(target, remote), 10u);
+
+    ASSERT_TRUE(PartialDownload::Truncate(target, 4));
+    EXPECT_EQ(PartialDownload::ResumeOffset(target, remote), 4u);
+
+    std::ofstream(target) << "old";
+    ASSERT_TRUE(PartialDownload::Commit(target));
+    EXPECT_EQ(ReadFile(target), "0123");
+    EXPECT_FALSE(fs::exists(PartialDownload::PartPath(target)));
+    EXPECT_FALSE(fs::exists(PartialDownload::MetaPath(target)));
+}
+
+TEST_F(PartialDownloadTests, DiscardsPartWhenRemoteChangedOrStateMissing) {
+    WritePart("0123456789");
+    EXPECT_EQ(PartialDownload::ResumeOffset(target, remote), 0u);   // 没有记录
+    EXPECT_FALSE(fs::exists(PartialDownload::PartPath(target)));
+
+    WritePart("0123456789");
+    ASSERT_TRUE(PartialDownload::SaveState(target, remote));
+    PartialDownloadState changed = remote;
+    changed.remoteMtime += 1;
+    EXPECT_EQ(PartialDownload::ResumeOffset(target, changed), 0u);
+    EXPECT_FALSE(fs::exists(PartialDownload::PartPath(target)));
+    EXPECT_FALSE(fs::exists(PartialDownload::MetaPath(target)));
+
+    // 部分文件比远程文件还长：不可能是它的前缀
+    WritePart(std::string(200, 'x'));
+    ASSERT_TRUE(PartialDownload::SaveState(target, remote));
+    EXPECT_EQ(PartialDownload::ResumeOffset(target, remote), 0u);
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "core/ProcessSpawner.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// 假的终端控制命令：按参数决定退出码，模拟“有实例 / 无实例 / 卡住”
+std::filesystem::path WriteFakeTerminal() {
+    auto path = std::filesystem::temp_directory_path() /
+                ("mtc_fake_term_" + std::to_string(getpid()));
+    std::ofstream(path) << "#!/bin/sh\n"
+                           "case \"$1\" in\n"
+                           "  running) exit 0 ;;\n"
+                           "  hang) sleep 5 ;;\n"
+                           "  *) exit 1 ;;\n"
+                           "esac\n";
+    chmod(path.c_str(), 0700);
+    return path;
+}
+
+} // namespace
+
+TEST(ProcessSpawnerTests, RunAndWaitReportsExitCodeAndTimeout) {
+    auto fake = WriteFakeTerminal();
+
+    SpawnRequest request;
+    request.argv = {fake.string(), "running"};
+    EXPECT_EQ(ProcessSpawner::RunAndWait(request, 2000), 0);
+
+    request.argv = {fake.string(), "absent"};
+    EXPECT_EQ(ProcessSpawner::RunAndWait(request, 2000), 1);
+
+    request.argv = {fake.string(), "hang"};
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(ProcessSpawner::RunAndWait(request, 100), -1);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+
+    std::error_code ec;
+    std::filesystem::remove(fake, ec);
+}
+
+#ifdef __linux__
+TEST(ProcessSpawnerTests, InheritedScriptRunsFromFdThree) {
+    SpawnRequest request;
+    request.argv = {"/bin/sh", ProcessSpawner::kInheritedScriptPath};
+    // 脚本只在 memfd 里，不出现在 argv 中
+    request.inheritedScript = "grep -q MTC_SECRET /proc/$$/cmdline && exit 3\n"
+                              "MTC_SECRET=1\n"
+                              "exit 7\n";
+    EXPECT_EQ(ProcessSpawner::RunAndWait(request, 2000), 7);
+
+    // 超过单个参数上限（128 KiB）的脚本照样能传
+    request.inheritedScript = "# " + std::string(256 * 1024, 'x') + "\nexit 5\n";
+    EXPECT_EQ(ProcessSpawner::RunAndWait(request, 2000), 5);
+}
+#endif
+#endif
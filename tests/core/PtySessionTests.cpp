@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include "core/PtySession.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#ifndef _WIN32
+TEST(PtySessionTests, RunsShellInPtyWithSizeAndTerm) {
+    std::mutex mutex;
+    std::condition_variable exited;
+    std::string output;
+    int exitCode = -2;
+
+    SpawnRequest request;
+    request.argv = {"/bin/sh", "-c", "printf '%s|' \"$TERM\"; stty size; read line; echo \"got $line\"; exit 3"};
+
+    PtySession session;
+    ASSERT_TRUE(session.Start(request, 30, 7,
+        [&](const char* data, size_t size) {
+            std::lock_guard<std::mutex> lock(mutex);
+            output.append(data, size);
+        },
+        [&](int code) {
+            std::lock_guard<std::mutex> lock(mutex);
+            exitCode = code;
+            exited.notify_all();
+        }));
+    session.Write("ping\n");
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(exited.wait_for(lock, std::chrono::seconds(5), [&] { return exitCode != -2; }));
+    EXPECT_EQ(exitCode, 3);
+    // 输入回显可能插在输出中间，分别检查
+    EXPECT_NE(output.find("xterm-256color|"), std::string::npos) << output;
+    EXPECT_NE(output.find("7 30"), std::string::npos) << output;
+    EXPECT_NE(output.find("got ping"), std::string::npos) << output;
+    lock.unlock();
+
+    session.Close();
+    EXPECT_FALSE(session.IsRunning());
+}
+#endif
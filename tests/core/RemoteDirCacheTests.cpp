@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "core/RemoteDirCache.h"
+
+#include <chrono>
+#include <string>
+
+namespace {
+
+RemoteDirCache::Entries MakeEntries(const std::string& name) {
+    SshClient::RemoteEntry entry;
+    entry.name = name;
+    return {entry};
+}
+
+} // namespace
+
+TEST(RemoteDirCacheTests, FreshWithinTtlThenRevalidatedByMtime) {
+    RemoteDirCache cache(std::chrono::seconds(30));
+    const auto t0 = RemoteDirCache::Clock::now();
+    EXPECT_EQ(cache.Lookup("/srv", t0), RemoteDirCache::State::Missing);
+
+    cache.Store("/srv/", 1000, 2000, MakeEntries("a.txt"), t0);
+    RemoteDirCache::Entries entries;
+    ASSERT_EQ(cache.Lookup("/srv", t0 + std::chrono::seconds(10), &entries), RemoteDirCache::State::Fresh);
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].name, "a.txt");
+
+    // 过期后修改时间没变：续期，TTL 从确认时重新算起
+    const auto t1 = t0 + std::chrono::seconds(40);
+    EXPECT_EQ(cache.Lookup("/srv", t1), RemoteDirCache::State::Stale);
+    EXPECT_TRUE(cache.Revalidate("/srv", 1000, t1, &entries));
+    EXPECT_EQ(cache.Lookup("/srv", t1 + std::chrono::seconds(20)), RemoteDirCache::State::Fresh);
+
+    // 修改时间变了：丢弃
+    const auto t2 = t1 + std::chrono::seconds(40);
+    EXPECT_FALSE(cache.Revalidate("/srv", 1001, t2));
+    EXPECT_EQ(cache.Lookup("/srv", t2), RemoteDirCache::State::Missing);
+
+    // 修改时间未知的项过期后不能续期
+    cache.Store("/tmp", 0, 2000, MakeEntries("b"), t0);
+    EXPECT_FALSE(cache.Revalidate("/tmp", 0, t1));
+}
+
+TEST(RemoteDirCacheTests, ListingInTheSameSecondAsTheMtimeIsNotRevalidated) {
+    RemoteDirCache cache(std::chrono::seconds(30));
+    const auto t0 = RemoteDirCache::Clock::now();
+    const auto t1 = t0 + std::chrono::seconds(40);
+
+    // 修改与列出在同一秒：之后同一秒内的修改不会再推进修改时间
+    cache.Store("/srv", 1000, 1000, MakeEntries("a"), t0);
+    EXPECT_FALSE(cache.Revalidate("/srv", 1000, t1));
+    EXPECT_EQ(cache.Lookup("/srv", t1), RemoteDirCache::State::Missing);
+
+    // 前一秒也不可靠（时钟粒度与取整）
+    cache.Store("/srv", 1000, 1001, MakeEntries("a"), t0);
+    EXPECT_FALSE(cache.Revalidate("/srv", 1000, t1));
+
+    // 服务器时钟比本地快，修改时间落在列出时刻之后：同样重新列
+    cache.Store("/srv", 1005, 1001, MakeEntries("a"), t0);
+    EXPECT_FALSE(cache.Revalidate("/srv", 1005, t1));
+
+    // 早两秒以上才可续期
+    cache.Store("/srv", 1000, 1002, MakeEntries("a"), t0);
+    EXPECT_TRUE(cache.Revalidate("/srv", 1000, t1));
+}
+
+TEST(RemoteDirCacheTests, EvictsLeastRecentlyUsed) {
+    RemoteDirCache cache(std::chrono::seconds(30), 2);
+    const auto now = RemoteDirCache::Clock::now();
+    cache.Store("/a", 1, 2000, MakeEntries("1"), now);
+    cache.Store("/b", 1, 2000, MakeEntries("2"), now);
+    EXPECT_EQ(cache.Lookup("/a", now), RemoteDirCache::State::Fresh);   // /b 成为最久未用
+
+    cache.Store("/c", 1, 2000, MakeEntries("3"), now);
+    EXPECT_EQ(cache.Size(), 2u);
+    EXPECT_EQ(cache.Lookup("/b", now), RemoteDirCache::State::Missing);
+    EXPECT_EQ(cache.Lookup("/a", now), RemoteDirCache::State::Fresh);
+
+    cache.Invalidate("/a/");
+    EXPECT_EQ(cache.Lookup("/a", now), RemoteDirCache::State::Missing);
+    EXPECT_EQ(RemoteDirCache::Normalize("/"), "/");
+}
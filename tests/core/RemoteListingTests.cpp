@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "core/RemoteListing.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+SshClient::RemoteEntry Make(const std::string& name, bool isDir = false) {
+    SshClient::RemoteEntry entry;
+    entry.name = name;
+    entry.isDir = isDir;
+    return entry;
+}
+
+std::vector<std::string> Names(const RemoteListing& listing) {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < listing.Size(); ++i) {
+        names.push_back(listing.At(i).name);
+    }
+    return names;
+}
+
+} // namespace
+
+TEST(RemoteListingTests, IncrementalBatchesMatchFullSort) {
+    std::vector<SshClient::RemoteEntry> all = {
+        Make("zeta"), Make("Beta", true), Make("alpha"), Make("ALPHA"), Make("src", true),
+        Make("b.txt"), Make("Alpha", true), Make("c"), Make("readme"), Make("a.log"),
+    };
+
+    RemoteListing listing;
+    listing.Append({all.begin(), all.begin() + 3});
+    EXPECT_EQ(Names(listing), (std::vector<std::string>{"Beta", "alpha", "zeta"}));
+    listing.Append({all.begin() + 3, all.begin() + 7});
+    listing.Append({all.begin() + 7, all.end()});
+
+    std::vector<SshClient::RemoteEntry> sorted = all;
+    RemoteListing::Sort(sorted);
+    std::vector<std::string> expected;
+    for (const auto& e : sorted) expected.push_back(e.name);
+    EXPECT_EQ(Names(listing), expected);
+    // 目录在前；名称只差大小写时保持到达顺序
+    EXPECT_EQ(expected, (std::vector<std::string>{"Alpha", "Beta", "src", "a.log", "alpha", "ALPHA",
+                                                  "b.txt", "c", "readme", "zeta"}));
+
+    EXPECT_EQ(listing.Find("ALPHA", false), 5u);
+    EXPECT_EQ(listing.Find("Alpha", true), 0u);
+    EXPECT_EQ(listing.Find("Alpha", false), RemoteListing::npos);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "core/ScriptCache.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+Profile MakeProfile(const std::string& id) {
+    Profile p;
+    p.id = id;
+    p.name = id;
+    p.environmentVariables = {{"FOO", "bar"}};
+    p.startupCommands = {"echo hi"};
+    return p;
+}
+
+class ScriptCacheTests : public ::testing::Test {
+protected:
+    fs::path dir;
+
+    void SetUp() override {
+        dir = fs::temp_directory_path() /
+              ("mtc_script_cache_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+               "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::remove_all(dir);
+        ScriptCache::SetDirectory(dir);
+    }
+
+    void TearDown() override {
+        ScriptCache::Collect({});
+        fs::remove_all(dir);
+    }
+};
+
+} // namespace
+
+TEST_F(ScriptCacheTests, FingerprintTracksScriptFields) {
+    Profile a = MakeProfile("a");
+    Profile b = a;
+    b.name = "renamed";
+    EXPECT_EQ(ScriptCache::Fingerprint(a), ScriptCache::Fingerprint(b));
+
+    b.startupCommands.push_back("ls");
+    EXPECT_NE(ScriptCache::Fingerprint(a), ScriptCache::Fingerprint(b));
+}
+
+TEST_F(ScriptCacheTests, GetOrBuildReusesUntilProfileChanges) {
+    Profile p = MakeProfile("p1");
+    int builds = 0;
+    auto build = [&builds] { ++builds; return std::string("script"); };
+
+    EXPECT_EQ(ScriptCache::GetOrBuild(p, "init", build), "script");
+    EXPECT_EQ(ScriptCache::GetOrBuild(p, "init", build), "script");
+    EXPECT_EQ(builds, 1);
+
+    p.environmentVariables[0].value = "baz";
+    ScriptCache::GetOrBuild(p, "init", build);
+    EXPECT_EQ(builds, 2);
+}
+
+TEST_F(ScriptCacheTests, MaterializeWritesOnceAndCollectRemovesStale) {
+    Profile keep = MakeProfile("keep-id");
+    Profile gone = MakeProfile("gone-id");
+
+    fs::path keepPath = ScriptCache::Materialize(keep, "init", ".sh", [] { return std::string("k"); });
+    fs::path gonePath = ScriptCache::Materialize(gone, "init", ".sh", [] { return std::string("g"); });
+    ASSERT_TRUE(fs::exists(keepPath));
+    ASSERT_TRUE(fs::exists(gonePath));
+    EXPECT_EQ(ScriptCache::Materialize(keep, "init", ".sh", [] { return std::string("other"); }), keepPath);
+
+    std::ifstream in(keepPath);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(content, "k");
+#ifndef _WIN32
+    EXPECT_EQ(fs::status(keepPath).permissions(), fs::perms::owner_read | fs::perms::owner_write);
+#endif
+
+    ScriptCache::Collect({keep});
+    EXPECT_TRUE(fs::exists(keepPath));
+    EXPECT_FALSE(fs::exists(gonePath));
+
+    keep.startupCommands.clear();
+    ScriptCache::Collect({keep});
+    EXPECT_FALSE(fs::exists(keepPath));
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "core/SocketConnector.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+TEST(SocketConnectorTests, AttemptOrderInterleavesFamiliesPreferredFirst) {
+    const int v4 = AF_INET;
+    const int v6 = AF_INET6;
+    std::vector<int> families = {v6, v6, v4, v4, v6};
+
+    // 默认按解析顺序：首个地址的地址族先行，之后交替
+    EXPECT_EQ(SocketConnector::AttemptOrder(families, AF_UNSPEC), (std::vector<size_t>{0, 2, 1, 3, 4}));
+    // 记住的地址族排在前面，同族内保持原有顺序
+    EXPECT_EQ(SocketConnector::AttemptOrder(families, v4), (std::vector<size_t>{2, 0, 3, 1, 4}));
+    EXPECT_EQ(SocketConnector::AttemptOrder({v4}, v6), (std::vector<size_t>{0}));
+    EXPECT_TRUE(SocketConnector::AttemptOrder({}, v4).empty());
+}
+
+#ifndef _WIN32
+namespace {
+
+// 在 127.0.0.1 的随机端口上监听，返回端口
+int Listen(int& fd) {
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    listen(fd, 4);
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    return ntohs(addr.sin_port);
+}
+
+} // namespace
+
+TEST(SocketConnectorTests, ConnectsAndRemembersWinningFamily) {
+    SocketConnector::ForgetFamilies();
+    int listener = -1;
+    int port = Listen(listener);
+
+    int sock = -1;
+    std::string err;
+    ASSERT_TRUE(SocketConnector::Connect("127.0.0.1", port, SocketConnector::Options(), sock, err)) << err;
+    EXPECT_GE(sock, 0);
+    EXPECT_EQ(SocketConnector::PreferredFamily("127.0.0.1"), AF_INET);
+    close(sock);
+
+    // 端口关闭后连接被拒绝，立即失败而不是等到超时
+    close(listener);
+    std::string refused;
+    EXPECT_FALSE(SocketConnector::Connect("127.0.0.1", port, SocketConnector::Options(), sock, refused));
+    EXPECT_NE(refused.find("失败"), std::string::npos) << refused;
+}
+
+TEST(SocketConnectorTests, CancelledBeforeConnecting) {
+    int listener = -1;
+    int port = Listen(listener);
+    std::atomic<bool> cancel{true};
+    SocketConnector::Options options;
+    options.cancel = &cancel;
+
+    int sock = -1;
+    std::string err;
+    EXPECT_FALSE(SocketConnector::Connect("127.0.0.1", port, options, sock, err));
+    EXPECT_EQ(err, "操作已取消");
+    close(listener);
+}
+#endif
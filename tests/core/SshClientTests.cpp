@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "core/SshClient.h"
+#include "core/SecretStore.h"
+
+#ifndef _WIN32
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// 测试进程不接系统钥匙串：SshClient 只会调到 Get，认证前就被取消
+bool SecretStore::Set(const std::string&, const std::string&) { return false; }
+bool SecretStore::Get(const std::string&, std::string&) { return false; }
+bool SecretStore::Delete(const std::string&) { return true; }
+
+namespace {
+
+// 只发版本串、之后一言不发的“服务器”：客户端停在密钥交换里等应答
+class StalledServer {
+public:
+    StalledServer() {
+        m_listen = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(m_listen, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(m_listen, 1);
+        socklen_t len = sizeof(addr);
+        getsockname(m_listen, reinterpret_cast<sockaddr*>(&addr), &len);
+        m_port = ntohs(addr.sin_port);
+        m_thread = std::thread([this] { Serve(); });
+    }
+
+    ~StalledServer() {
+        m_stop = true;
+        m_thread.join();
+        close(m_listen);
+    }
+
+    int Port() const { return m_port; }
+    // 客户端关掉连接后为 true（读到 EOF 或连接被重置）
+    bool PeerClosed() const { return m_peerClosed; }
+
+private:
+    int m_listen = -1;
+    int m_port = 0;
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_peerClosed{false};
+
+    void Serve() {
+        pollfd pfd = {m_listen, POLLIN, 0};
+        while (!m_stop && poll(&pfd, 1, 50) == 0) {
+        }
+        if (m_stop) return;
+        int conn = accept(m_listen, nullptr, nullptr);
+        const char banner[] = "SSH-2.0-OpenSSH_9.6\r\n";
+        send(conn, banner, sizeof(banner) - 1, MSG_NOSIGNAL);
+        // 客户端的 KEXINIT 读掉不回，直到对方关闭连接
+        char buf[4096];
+        pollfd cfd = {conn, POLLIN, 0};
+        while (!m_stop) {
+            if (poll(&cfd, 1, 50) > 0 && recv(conn, buf, sizeof(buf), 0) <= 0) {
+                m_peerClosed = true;
+                break;
+            }
+        }
+        close(conn);
+    }
+};
+
+} // namespace
+
+TEST(SshClientTests, CancelMidHandshakeThenCloseReleasesConnection) {
+    StalledServer server;
+    SshHost host;
+    host.host = "127.0.0.1";
+    host.port = server.Port();
+    host.username = "mtc";
+    Credential cred;
+    cred.type = CredentialType::Password;
+
+    SshClient client;
+    std::atomic<bool> cancel{false};
+    client.SetCancelFlag(&cancel);
+    std::thread canceller([&cancel] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        cancel = true;
+    });
+
+    // 会话停在密钥交换中途；取消后 Connect 内部的 Close 不能再等网络
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(client.Connect(host, cred));
+    canceller.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(3));
+    EXPECT_EQ(client.LastError(), "操作已取消");
+    EXPECT_FALSE(client.IsConnected());
+
+    // 再次 Close 无事可做；服务器看到连接已关
+    client.Close();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!server.PeerClosed() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_TRUE(server.PeerClosed());
+}
+#endif
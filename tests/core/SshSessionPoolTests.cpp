@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "core/SshSessionPool.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 池是进程级的：每个用例前后清空，恢复默认超时
+class SshSessionPoolTests : public ::testing::Test {
+protected:
+    void SetUp() override { SshSessionPool::Clear(); }
+
+    void TearDown() override {
+        SshSessionPool::SetIdleTimeout(SshSessionPool::kDefaultIdleTimeout);
+        SshSessionPool::Clear();
+    }
+};
+
+} // namespace
+
+TEST_F(SshSessionPoolTests, KeepsAtMostTwoIdleSessionsPerHost) {
+    for (int i = 0; i < 3; ++i) {
+        SshSessionPool::Adopt("a", std::make_unique<SshClient>());
+    }
+    SshSessionPool::Adopt("b", std::make_unique<SshClient>());
+    EXPECT_EQ(SshSessionPool::IdleCount(), SshSessionPool::kMaxIdlePerKey + 1);
+
+    SshSessionPool::Clear();
+    EXPECT_EQ(SshSessionPool::IdleCount(), 0u);
+}
+
+TEST_F(SshSessionPoolTests, MaintainClosesExpiredAndDeadSessions) {
+    const auto now = std::chrono::steady_clock::now();
+    SshSessionPool::SetIdleTimeout(std::chrono::seconds(60));
+    SshSessionPool::Adopt("expired", std::make_unique<SshClient>(), now - std::chrono::minutes(2));
+    // 未超时，但从未连上：Ping 失败
+    SshSessionPool::Adopt("dead", std::make_unique<SshClient>(), now);
+
+    EXPECT_EQ(SshSessionPool::Maintain(now), 2u);
+    EXPECT_EQ(SshSessionPool::IdleCount(), 0u);
+    EXPECT_EQ(SshSessionPool::Maintain(now), 0u);
+}
+
+#ifndef _WIN32
+TEST_F(SshSessionPoolTests, AcquireDiscardsDeadIdleSessionsBeforeConnecting) {
+    // 取一个随即关闭的端口：重新连接立即被拒绝
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    close(fd);
+
+    SshHost host;
+    host.host = "127.0.0.1";
+    host.port = ntohs(addr.sin_port);
+    host.username = "mtc";
+    Credential cred;
+    cred.type = CredentialType::Password;
+    SshSessionPool::Adopt(SshSessionPool::MakeKey(host, cred), std::make_unique<SshClient>());
+    SshSessionPool::Adopt(SshSessionPool::MakeKey(host, cred), std::make_unique<SshClient>());
+    SshSessionPool::Adopt("other", std::make_unique<SshClient>());
+
+    std::string err;
+    SshSessionPool::Lease lease = SshSessionPool::Acquire(host, cred, &err);
+    EXPECT_FALSE(lease);
+    EXPECT_FALSE(err.empty());
+    // 该主机断开的空闲会话都被丢弃，其他主机的不动
+    EXPECT_EQ(SshSessionPool::IdleCount(), 1u);
+
+    // 空 Lease 归还不放回任何东西
+    lease.Release();
+    EXPECT_EQ(SshSessionPool::IdleCount(), 1u);
+}
+#endif
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "core/TempArtifacts.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class TempArtifactsTests : public ::testing::Test {
+protected:
+    fs::path dir;
+
+    void SetUp() override {
+        dir = fs::temp_directory_path() /
+              ("mtc_temp_artifacts_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+               "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        TempArtifacts::SetRoot(dir / "root");
+    }
+
+    void TearDown() override {
+        TempArtifacts::SetRoot(fs::path());
+        fs::remove_all(dir);
+    }
+};
+
+void Touch(const fs::path& path, std::chrono::hours age) {
+    std::ofstream(path) << "x";
+    fs::last_write_time(path, fs::file_time_type::clock::now() - age);
+}
+
+} // namespace
+
+TEST_F(TempArtifactsTests, AllocatesUniquePathsAndSweepsExpiredEntries) {
+    fs::path shortLived = TempArtifacts::Allocate("a/b.txt", std::chrono::seconds(60));
+    fs::path longLived = TempArtifacts::Allocate("b.txt", std::chrono::hours(24));
+    ASSERT_FALSE(shortLived.empty());
+    ASSERT_FALSE(longLived.empty());
+    EXPECT_EQ(shortLived.filename(), "a_b.txt");   // 分隔符被替换，不会逃出条目目录
+    EXPECT_EQ(shortLived.parent_path().parent_path(), dir / "root");
+    EXPECT_NE(shortLived.parent_path(), longLived.parent_path());
+    std::ofstream(shortLived) << "data";
+    std::ofstream(longLived) << "data";
+
+    EXPECT_EQ(TempArtifacts::SweepExpired(), 0u);
+    EXPECT_EQ(TempArtifacts::SweepExpired(std::chrono::system_clock::now() + std::chrono::minutes(5)), 1u);
+    EXPECT_FALSE(fs::exists(shortLived.parent_path()));
+    EXPECT_TRUE(fs::exists(longLived));
+}
+
+TEST_F(TempArtifactsTests, SweepLegacyRemovesOnlyOldMtcFiles) {
+    Touch(dir / "mtc_init_1.sh", std::chrono::hours(3));
+    Touch(dir / "mtc_remote_notes.txt", std::chrono::hours(3));
+    Touch(dir / "mtc_startup_2.sh", std::chrono::hours(0));   // 可能仍在使用
+    Touch(dir / "other_init_1.sh", std::chrono::hours(3));
+
+    EXPECT_EQ(TempArtifacts::SweepLegacy(dir, std::chrono::hours(1)), 2u);
+    EXPECT_FALSE(fs::exists(dir / "mtc_init_1.sh"));
+    EXPECT_FALSE(fs::exists(dir / "mtc_remote_notes.txt"));
+    EXPECT_TRUE(fs::exists(dir / "mtc_startup_2.sh"));
+    EXPECT_TRUE(fs::exists(dir / "other_init_1.sh"));
+}
+
+TEST_F(TempArtifactsTests, AllocateKeyedReusesEntryAndExtendsExpiry) {
+    fs::path first = TempArtifacts::AllocateKeyed("host:22:user:/a/b.txt", "b.txt", std::chrono::seconds(60));
+    ASSERT_FALSE(first.empty());
+    std::ofstream(first.string() + ".part") << "partial";
+
+    fs::path second = TempArtifacts::AllocateKeyed("host:22:user:/a/b.txt", "b.txt", std::chrono::hours(24));
+    EXPECT_EQ(second.filename(), "b.txt");
+    EXPECT_TRUE(fs::exists(second.string() + ".part"));
+
+    fs::path other = TempArtifacts::AllocateKeyed("host:22:user:/c/b.txt", "b.txt", std::chrono::hours(24));
+    EXPECT_NE(other.parent_path(), second.parent_path());
+
+    // 到期时间已顺延：一分钟后的清理不会删掉它
+    EXPECT_EQ(TempArtifacts::SweepExpired(std::chrono::system_clock::now() + std::chrono::minutes(5)), 0u);
+    EXPECT_TRUE(fs::exists(second.string() + ".part"));
+}
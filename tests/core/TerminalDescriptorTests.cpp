@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "core/TerminalDescriptor.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+TerminalDescriptor ServerStyle() {
+    TerminalDescriptor d;
+    d.id = "gnome-terminal";
+    d.binary = "gnome-terminal";
+    d.execArgs = {"--"};
+    d.workingDirArgs = {"--working-directory={cwd}"};
+    d.inheritsProcessState = false;
+    d.tabStyle = TerminalTabStyle::Grouped;
+    d.firstTabArgs = {"--window"};
+    d.nextTabArgs = {"--tab"};
+    d.titleArgs = {"--title={title}"};
+    d.tabCommandArgs = {"--command={command}"};
+    return d;
+}
+
+TerminalDescriptor PlainStyle() {
+    TerminalDescriptor d;
+    d.id = "xterm";
+    d.binary = "xterm";
+    d.execArgs = {"-e"};
+    return d;
+}
+
+Profile LocalProfile(const std::string& dir) {
+    Profile p;
+    p.workingDirectory = dir;
+    p.linuxWorkingDirectory = dir;
+    p.macWorkingDirectory = dir;
+    return p;
+}
+
+} // namespace
+
+TEST(TerminalDescriptorTests, SkipsScriptOnlyWhenTerminalCanCarryState) {
+    Profile p = LocalProfile("/srv/app");
+    EXPECT_TRUE(CanLaunchWithoutScript(ServerStyle(), p));   // 目录走 --working-directory
+    EXPECT_TRUE(CanLaunchWithoutScript(PlainStyle(), p));    // 目录由 chdir 继承
+
+    p.environmentVariables = {{"FOO", "1"}};
+    EXPECT_FALSE(CanLaunchWithoutScript(ServerStyle(), p));  // 服务端派生的 shell 拿不到变量
+    EXPECT_TRUE(CanLaunchWithoutScript(PlainStyle(), p));
+
+    p.environmentVariables.clear();
+    p.startupCommands = {"make"};
+    EXPECT_FALSE(CanLaunchWithoutScript(PlainStyle(), p));
+
+    TerminalDescriptor noCwdFlag = ServerStyle();
+    noCwdFlag.workingDirArgs.clear();
+    EXPECT_FALSE(CanLaunchWithoutScript(noCwdFlag, LocalProfile("/srv/app")));
+    EXPECT_TRUE(CanLaunchWithoutScript(noCwdFlag, LocalProfile("")));
+}
+
+TEST(TerminalDescriptorTests, BuildsDirectAndScriptArgv) {
+    EXPECT_EQ(BuildDirectTerminalArgv(ServerStyle(), "/srv/a b"),
+              (std::vector<std::string>{"gnome-terminal", "--working-directory=/srv/a b"}));
+    EXPECT_EQ(BuildDirectTerminalArgv(PlainStyle(), "/srv"), (std::vector<std::string>{"xterm"}));
+
+    EXPECT_EQ(BuildScriptTerminalArgv(PlainStyle(), "/dev/fd/3"),
+              (std::vector<std::string>{"xterm", "-e", "/bin/bash", "/dev/fd/3"}));
+
+    TerminalDescriptor asString = PlainStyle();
+    asString.baseArgs = {"--launch", "TerminalEmulator"};
+    asString.execArgs.clear();
+    asString.commandAsString = true;
+    EXPECT_EQ(BuildScriptTerminalArgv(asString, "/tmp/it's.sh"),
+              (std::vector<std::string>{"xterm", "--launch", "TerminalEmulator",
+                                        "/bin/bash '/tmp/it'\\''s.sh'"}));
+}
+
+TEST(TerminalDescriptorTests, BuildsGroupedAndPerCallTabs) {
+    std::vector<std::pair<std::string, std::string>> tabs{{"A", "/tmp/a.sh"}, {"B {cwd}", ""}};
+
+    auto grouped = BuildTabbedTerminalArgv(ServerStyle(), tabs);
+    ASSERT_EQ(grouped.size(), 1u);
+    EXPECT_EQ(grouped[0], (std::vector<std::string>{
+        "gnome-terminal", "--window", "--title=A", "--command=/bin/bash '/tmp/a.sh'",
+        "--tab", "--title=B {cwd}", "--command=/bin/bash"}));
+
+    TerminalDescriptor konsole = PlainStyle();
+    konsole.binary = "konsole";
+    konsole.tabStyle = TerminalTabStyle::PerCall;
+    konsole.nextTabArgs = {"--new-tab"};
+    konsole.titleArgs = {"-p", "tabtitle={title}"};
+    auto perCall = BuildTabbedTerminalArgv(konsole, tabs);
+    ASSERT_EQ(perCall.size(), 2u);
+    EXPECT_EQ(perCall[0], (std::vector<std::string>{
+        "konsole", "--new-tab", "-p", "tabtitle=A", "-e", "/bin/bash", "/tmp/a.sh"}));
+    EXPECT_EQ(perCall[1], (std::vector<std::string>{"konsole", "--new-tab", "-p", "tabtitle=B {cwd}"}));
+
+    EXPECT_TRUE(BuildTabbedTerminalArgv(PlainStyle(), tabs).empty());
+}
+
+TEST(TerminalDescriptorTests, BuildsIpcArgv) {
+    TerminalDescriptor wezterm = PlainStyle();
+    wezterm.binary = "wezterm";
+    wezterm.ipcArgs = {"cli", "spawn", "--new-window"};
+    wezterm.ipcWorkingDirArgs = {"--cwd", "{cwd}"};
+    wezterm.ipcExecArgs = {"--"};
+
+    EXPECT_EQ(BuildIpcTerminalArgv(wezterm, "/srv", ""),
+              (std::vector<std::string>{"wezterm", "cli", "spawn", "--new-window", "--cwd", "/srv"}));
+    EXPECT_EQ(BuildIpcTerminalArgv(wezterm, "", "/tmp/a.sh"),
+              (std::vector<std::string>{"wezterm", "cli", "spawn", "--new-window",
+                                        "--", "/bin/bash", "/tmp/a.sh"}));
+
+    Profile p = LocalProfile("/srv");
+    EXPECT_TRUE(CanUseIpcWithoutScript(wezterm, p));
+    EXPECT_FALSE(CanUseIpcWithoutScript(PlainStyle(), p));   // 无法把目录交给已运行的实例
+    p.environmentVariables = {{"FOO", "1"}};
+    EXPECT_FALSE(CanUseIpcWithoutScript(wezterm, p));        // 变量只能经脚本带过去
+}
+
+#ifndef _WIN32
+TEST(TerminalDescriptorTests, IpcWaitsForItsEnvironmentVariable) {
+    TerminalDescriptor kitty = PlainStyle();
+    EXPECT_FALSE(HasIpc(kitty));
+    kitty.ipcArgs = {"@", "launch"};
+    EXPECT_TRUE(HasIpc(kitty));
+
+    kitty.ipcEnv = "MTC_TEST_LISTEN_ON";
+    unsetenv("MTC_TEST_LISTEN_ON");
+    EXPECT_FALSE(HasIpc(kitty));
+    setenv("MTC_TEST_LISTEN_ON", "", 1);
+    EXPECT_FALSE(HasIpc(kitty));
+    setenv("MTC_TEST_LISTEN_ON", "unix:/tmp/kitty", 1);
+    EXPECT_TRUE(HasIpc(kitty));
+    unsetenv("MTC_TEST_LISTEN_ON");
+}
+#endif
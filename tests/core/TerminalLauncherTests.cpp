@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+#include "core/TerminalLauncher.h"
+#include "core/ProcessSpawner.h"
+#include "core/EnvironmentBlock.h"
+#include "core/TempArtifacts.h"
+#include "core/TerminalRegistry.h"
+
+#ifdef __linux__
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::chrono::milliseconds kIpcTimeout(2000);     // TerminalLauncher::kIpcTimeoutMs
+
+std::string ReadFile(const fs::path& path) {
+    std::ifstream in(path);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+void WriteExecutable(const fs::path& path, const std::string& content) {
+    std::ofstream(path) << content;
+    chmod(path.c_str(), 0700);
+}
+
+// PATH 最前面放假的 kitty / alacritty：
+// 控制通道调用（kitty @ / alacritty msg）按 ipc 文件的内容失败或卡住，并记下自己的 pid；
+// 其余调用当作启动新进程，直接执行传进来的命令（alacritty 的 -e 去掉）。
+// 配置的启动命令写出收到的变量；初始化脚本经 "$SHELL" 执行启动命令，
+// SHELL 指向 shell.sh：带参数时去掉 -i 交给 /bin/sh，最后不带参数的那次直接退出。
+class TerminalLauncherTests : public ::testing::Test {
+protected:
+    fs::path dir;
+    std::string oldPath;
+    std::string oldKittyListen;
+    bool hadKittyListen = false;
+
+    void SetUp() override {
+        dir = fs::temp_directory_path() /
+              ("mtc_launcher_test_" + std::to_string(getpid()) + "_" +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::remove_all(dir);
+        fs::create_directories(dir / "bin");
+        TempArtifacts::SetRoot(dir / "tmp");
+
+        const std::string d = dir.string();
+        const std::string fake =
+            "#!/bin/sh\n"
+            "case \"$1\" in\n"
+            "  @|msg)\n"
+            "    echo $$ >> '" + d + "/ipc.pids'\n"
+            "    [ \"$(cat '" + d + "/ipc')\" = hang ] && exec sleep 30\n"
+            "    exit 1 ;;\n"
+            "esac\n"
+            "[ \"$1\" = -e ] && shift\n"
+            "exec \"$@\"\n";
+        WriteExecutable(dir / "bin" / "kitty", fake);
+        WriteExecutable(dir / "bin" / "alacritty", fake);
+        // 假的 ssh：记下每次的参数；-T（上传）把 stdin 存下并报告远程文件名
+        WriteExecutable(dir / "bin" / "ssh",
+                        "#!/bin/sh\n"
+                        "printf '%s\\n' \"$*\" >> '" + d + "/ssh.argv'\n"
+                        "for a; do [ \"$a\" = -T ] && { cat > '" + d + "/upload'; echo /rtmp/mtc-init.x1; }; done\n"
+                        "exit 0\n");
+        WriteExecutable(dir / "shell.sh",
+                        "#!/bin/sh\n"
+                        "[ \"$1\" = -i ] && shift\n"
+                        "[ $# -gt 0 ] && exec /bin/sh \"$@\"\n"
+                        "exit 0\n");
+
+        const char* path = std::getenv("PATH");
+        oldPath = path ? path : "";
+        setenv("PATH", ((dir / "bin").string() + ":" + oldPath).c_str(), 1);
+        // kitty 的控制通道只在设置了 KITTY_LISTEN_ON 时尝试，由用例自己决定
+        const char* listen = std::getenv("KITTY_LISTEN_ON");
+        hadKittyListen = listen != nullptr;
+        oldKittyListen = listen ? listen : "";
+        unsetenv("KITTY_LISTEN_ON");
+        EnvironmentSnapshot::Refresh();
+    }
+
+    void TearDown() override {
+        setenv("PATH", oldPath.c_str(), 1);
+        if (hadKittyListen) {
+            setenv("KITTY_LISTEN_ON", oldKittyListen.c_str(), 1);
+        }
+        EnvironmentSnapshot::Refresh();
+        TempArtifacts::SetRoot(fs::path());
+        fs::remove_all(dir);
+    }
+
+    Profile MakeProfile(TerminalType type) const {
+        Profile p;
+        p.id = "launcher-test";
+        p.name = "launcher-test";
+        p.terminalType = type;
+        p.environmentVariables = {{"SHELL", (dir / "shell.sh").string()}, {"MTC_LAUNCH_TEST", "it's set"}};
+        const std::string out = "'" + (dir / "out").string();
+        p.startupCommands = {"echo \"$MTC_LAUNCH_TEST\" > " + out + ".tmp' && mv " + out + ".tmp' " + out + "'"};
+        return p;
+    }
+
+    bool WaitForOutput(std::string& content) const {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (fs::exists(dir / "out")) {
+                content = ReadFile(dir / "out");
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    // 临时目录里剩下的脚本文件数（条目目录本身由 Sweep 清理）
+    size_t LeftoverScripts() const {
+        size_t count = 0;
+        std::error_code ec;
+        for (auto it = fs::recursive_directory_iterator(dir / "tmp", ec);
+             it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file()) ++count;
+        }
+        return count;
+    }
+};
+
+} // namespace
+
+TEST_F(TerminalLauncherTests, FallsBackToSpawnWhenIpcFails) {
+    std::ofstream(dir / "ipc") << "fail";
+    setenv("KITTY_LISTEN_ON", "unix:/nonexistent", 1);
+
+    std::string err;
+    ASSERT_TRUE(TerminalLauncher::Launch(MakeProfile(TerminalType::Kitty), &err)) << err;
+    EXPECT_FALSE(ReadFile(dir / "ipc.pids").empty());    // 先试过控制通道
+
+    // 新进程经临时脚本拿到变量；控制通道用过的脚本已删，启动用的脚本执行时自删
+    std::string content;
+    ASSERT_TRUE(WaitForOutput(content));
+    EXPECT_EQ(content, "it's set\n");
+    EXPECT_EQ(LeftoverScripts(), 0u);
+}
+
+TEST_F(TerminalLauncherTests, SkipsKittyIpcWithoutListenAddress) {
+    std::ofstream(dir / "ipc") << "fail";
+
+    std::string err;
+    ASSERT_TRUE(TerminalLauncher::Launch(MakeProfile(TerminalType::Kitty), &err)) << err;
+    std::string content;
+    ASSERT_TRUE(WaitForOutput(content));
+    EXPECT_EQ(content, "it's set\n");
+    EXPECT_FALSE(fs::exists(dir / "ipc.pids"));     // 没有先起注定失败的 kitty @
+}
+
+TEST_F(TerminalLauncherTests, KillsHungIpcAfterTimeout) {
+    std::ofstream(dir / "ipc") << "hang";
+
+    const auto start = std::chrono::steady_clock::now();
+    std::string err;
+    ASSERT_TRUE(TerminalLauncher::Launch(MakeProfile(TerminalType::Alacritty), &err)) << err;
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, kIpcTimeout);
+    EXPECT_LT(elapsed, kIpcTimeout + std::chrono::seconds(3));
+
+    // 卡住的控制通道进程已被杀掉并回收
+    const std::string pid = ReadFile(dir / "ipc.pids");
+    ASSERT_FALSE(pid.empty());
+    EXPECT_FALSE(fs::exists("/proc/" + std::to_string(std::stoi(pid))));
+
+    // alacritty 能传递描述符：脚本经 /dev/fd/3 交给 bash，不落盘
+    std::string content;
+    ASSERT_TRUE(WaitForOutput(content));
+    EXPECT_EQ(content, "it's set\n");
+    EXPECT_EQ(LeftoverScripts(), 0u);
+}
+TEST_F(TerminalLauncherTests, CustomTerminalIsChosenPerProfile) {
+    // terminals.json 新增的终端没有对应的 TerminalType，按 id 指定给配置
+    WriteExecutable(dir / "bin" / "myterm",
+                    "#!/bin/sh\n"
+                    "echo ran >> '" + dir.string() + "/myterm.log'\n"
+                    "[ \"$1\" = -e ] && shift\n"
+                    "exec \"$@\"\n");
+    std::ofstream(dir / "terminals.json")
+        << R"([{"id": "myterm", "displayName": "My Term", "binary": "myterm", "execArgs": ["-e"],
+               "passesInheritedFds": true}])";
+    std::string err;
+    ASSERT_TRUE(TerminalRegistry::LoadUserDescriptors(dir / "terminals.json", &err)) << err;
+
+    const auto custom = TerminalLauncher::GetCustomTerminals();
+    ASSERT_EQ(custom.size(), 1u);
+    EXPECT_EQ(custom[0], std::make_pair(std::string("myterm"), std::string("My Term")));
+
+    // terminalId 优先于 terminalType（自动检测本来也会先选新增条目，这里用具体类型区分）
+    Profile profile = MakeProfile(TerminalType::Alacritty);
+    profile.terminalId = "myterm";
+    EXPECT_EQ(TerminalLauncher::GetTerminalDisplayName(profile), "My Term");
+    const bool launched = TerminalLauncher::Launch(profile, &err);
+    TerminalRegistry::LoadUserDescriptors(dir / "missing.json");
+    ASSERT_TRUE(launched) << err;
+
+    std::string content;
+    ASSERT_TRUE(WaitForOutput(content));
+    EXPECT_EQ(content, "it's set\n");
+    EXPECT_EQ(ReadFile(dir / "myterm.log"), "ran\n");
+
+    // 条目删除后按 id 找不到：显示回退为 id，启动退回终端类型
+    EXPECT_EQ(TerminalLauncher::GetTerminalDisplayName(profile), "myterm");
+    EXPECT_TRUE(TerminalLauncher::GetCustomTerminals().empty());
+}
+
+TEST_F(TerminalLauncherTests, RemoteScriptStaysOutOfSshArgv) {
+    LaunchSpec spec;
+    spec.profile = MakeProfile(TerminalType::Embedded);
+    spec.profile.sshHostId = "host";
+    spec.profile.environmentVariables = {{"MTC_SECRET", "s3cret value"}};
+    SshHost host;
+    host.host = "example.test";
+    host.username = "me";
+    host.port = 2222;
+    spec.sshHost = host;
+
+    SpawnRequest request;
+    std::string err;
+    ASSERT_TRUE(TerminalLauncher::BuildEmbeddedSession(spec, request, &err)) << err;
+    for (const auto& arg : request.argv) {
+        EXPECT_EQ(arg.find("s3cret"), std::string::npos) << arg;
+    }
+    fs::create_directories(dir / "ltmp");
+    request.env = {{"TMPDIR", (dir / "ltmp").string()}};
+    EXPECT_EQ(ProcessSpawner::RunAndWait(request, 5000), 0);
+
+    // 变量值只经 stdin 上传，任何一次 ssh 的参数里都没有
+    const std::string argv = ReadFile(dir / "ssh.argv");
+    EXPECT_EQ(argv.find("s3cret"), std::string::npos) << argv;
+    EXPECT_NE(argv.find("-f -N -M -S "), std::string::npos) << argv;
+    EXPECT_NE(argv.find("-p 2222 me@example.test bash /rtmp/mtc-init.x1\n"), std::string::npos) << argv;
+    EXPECT_NE(argv.find("-O exit"), std::string::npos) << argv;
+    const std::string upload = ReadFile(dir / "upload");
+    EXPECT_EQ(upload.rfind("rm -f -- \"$0\"\n", 0), 0u) << upload;
+    EXPECT_NE(upload.find("export MTC_SECRET='s3cret value'\n"), std::string::npos) << upload;
+
+    // 本地的控制套接字目录退出时删掉
+    EXPECT_TRUE(fs::is_empty(dir / "ltmp"));
+}
+#endif
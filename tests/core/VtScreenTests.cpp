@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "core/VtScreen.h"
+
+#include <string>
+
+TEST(VtScreenTests, WritesTextWrapsAndScrollsIntoScrollback) {
+    VtScreen screen(5, 2);
+    screen.Feed("hello world\r\nabc");
+
+    // 写满一行后到下一个字符才换行；滚出顶部的 "hello"、" worl" 进入回滚缓冲
+    EXPECT_EQ(screen.LineText(0), "d");
+    EXPECT_EQ(screen.LineText(1), "abc");
+    EXPECT_EQ(screen.CursorRow(), 1);
+    ASSERT_EQ(screen.ScrollbackSize(), 2u);
+    EXPECT_EQ(screen.ViewLine(0, 2)[0].ch, U'h');
+    EXPECT_EQ(screen.ViewLine(1, 2)[1].ch, U'w');
+
+    // 续上次被截断的 UTF-8 序列；宽字符占两格
+    VtScreen wide(6, 1);
+    std::string text = "a中b";
+    wide.Feed(text.data(), 2);
+    wide.Feed(text.data() + 2, text.size() - 2);
+    EXPECT_EQ(wide.LineText(0), "a中b");
+    EXPECT_EQ(wide.Line(0)[1].width, 2);
+    EXPECT_EQ(wide.Line(0)[2].width, 0);
+    EXPECT_EQ(wide.CursorCol(), 4);
+}
+
+TEST(VtScreenTests, HandlesCursorEraseAndGraphicRendition) {
+    VtScreen screen(10, 3);
+    screen.Feed("0123456789\x1b[2;3Hxy\x1b[1;5H\x1b[K\x1b[3;1H\x1b[1;31;48;5;200mR\x1b[38;2;1;2;3mG\x1b[0m.");
+
+    EXPECT_EQ(screen.LineText(0), "0123");
+    EXPECT_EQ(screen.LineText(1), "  xy");
+    EXPECT_EQ(screen.LineText(2), "RG.");
+
+    const VtLine& line = screen.Line(2);
+    EXPECT_EQ(line[0].attrs, kVtBold);
+    EXPECT_EQ(line[0].fg, VtColor::Indexed(1));
+    EXPECT_EQ(line[0].bg, VtColor::Indexed(200));
+    EXPECT_EQ(line[1].fg, VtColor::Rgb(1, 2, 3));
+    EXPECT_EQ(line[2].fg, VtColor());
+    EXPECT_EQ(line[2].attrs, 0);
+
+    screen.Feed("\x1b[6n");
+    EXPECT_EQ(screen.TakeReplies(), "\x1b[3;4R");
+    EXPECT_TRUE(screen.TakeReplies().empty());
+}
+
+TEST(VtScreenTests, AlternateScreenScrollRegionAndTitle) {
+    VtScreen screen(4, 3);
+    screen.Feed("main\x1b]0;标题\x07\x1b[?1049h\x1b[?1h");
+    EXPECT_TRUE(screen.AlternateScreen());
+    EXPECT_TRUE(screen.ApplicationCursorKeys());
+    EXPECT_EQ(screen.LineText(0), "");
+    EXPECT_EQ(screen.Title(), "标题");
+
+    // 滚动区域 2–3 行内换行，第一行不动
+    screen.Feed("\x1b[Htop\x1b[2;3r\x1b[3;1Ha\nb\nc");
+    EXPECT_EQ(screen.LineText(0), "top");
+    EXPECT_EQ(screen.LineText(1), " b");
+    EXPECT_EQ(screen.LineText(2), "  c");
+    EXPECT_EQ(screen.ScrollbackSize(), 0u);
+
+    screen.Feed("\x1b[?1049l");
+    EXPECT_FALSE(screen.AlternateScreen());
+    EXPECT_EQ(screen.LineText(0), "main");
+    EXPECT_EQ(screen.CursorRow(), 0);
+    EXPECT_EQ(screen.CursorCol(), 3);
+}
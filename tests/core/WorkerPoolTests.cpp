@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include "core/WorkerPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+
+TEST(WorkerPoolTests, RunsEverySubmittedTask) {
+    WorkerPool pool(3);
+    std::atomic<int> count{0};
+    for (int i = 0; i < 50; ++i) {
+        pool.Submit([&count] { ++count; });
+    }
+    pool.WaitIdle();
+    EXPECT_EQ(count, 50);
+
+    pool.Shutdown();
+    pool.Submit([&count] { ++count; });   // 关闭后提交的任务被丢弃
+    EXPECT_EQ(count, 50);
+}
+
+TEST(WorkerPoolTests, DetachDropsQueuedTasksWithoutWaiting) {
+    // 任务引用的状态由任务自己持有：池对象先于任务销毁
+    auto started = std::make_shared<std::promise<void>>();
+    auto release = std::make_shared<std::promise<void>>();
+    auto finished = std::make_shared<std::promise<void>>();
+    auto queuedRan = std::make_shared<std::atomic<bool>>(false);
+    std::shared_future<void> releaseFuture = release->get_future().share();
+    {
+        auto pool = std::make_unique<WorkerPool>(1);
+        pool->Submit([started, releaseFuture, finished] {
+            started->set_value();
+            releaseFuture.wait();
+            finished->set_value();
+        });
+        pool->Submit([queuedRan] { *queuedRan = true; });
+        started->get_future().wait();
+
+        const auto begin = std::chrono::steady_clock::now();
+        pool->Detach();
+        pool.reset();
+        EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::seconds(1));
+    }
+
+    release->set_value();
+    EXPECT_EQ(finished->get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_FALSE(*queuedRan);
+}
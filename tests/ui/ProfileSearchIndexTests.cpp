@@ -0,0 +1,104 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "core/Types.h"
+#include "ui/ProfileSearchIndex.h"
+#include "ui/ProfileTreeBuilder.h"
+
+#if defined(MTC_HAS_GTEST) && MTC_HAS_GTEST
+#include <gtest/gtest.h>
+
+namespace {
+// 只填搜索用到的字段，其余保持默认
+Profile MakeProfile(const std::string& id, const std::string& name, const std::string& description = "",
+                    const std::string& workingDirectory = "", const std::string& linuxWorkingDirectory = "") {
+    Profile profile;
+    profile.id = id;
+    profile.name = name;
+    profile.description = description;
+    profile.workingDirectory = workingDirectory;
+    profile.linuxWorkingDirectory = linuxWorkingDirectory;
+    return profile;
+}
+
+std::vector<Profile> SampleProfiles() {
+    return {
+        MakeProfile("1", "Prod API", "Release config", "D:/Work/Proj/A"),
+        MakeProfile("2", "api-gateway", "", "", "/srv/gateway"),
+        MakeProfile("3", "Staging", "mirrors prod api"),
+        MakeProfile("4", "Api"),
+        MakeProfile("5", "a p i loose"),
+    };
+}
+}  // namespace
+
+TEST(ProfileSearchIndexTests, FilterMatchesFilterProfiles) {
+    const auto profiles = SampleProfiles();
+    ProfileSearchIndex index;
+    index.Build(profiles);
+
+    for (const std::string query : {"", "api", " PROD ", "/srv", "d:/work", "missing"}) {
+        EXPECT_EQ(index.Filter(query), FilterProfiles(profiles, query)) << query;
+    }
+}
+
+TEST(ProfileSearchIndexTests, RanksExactThenPrefixThenFieldsThenSubsequence) {
+    const auto profiles = SampleProfiles();
+    ProfileSearchIndex index;
+    index.Build(profiles);
+
+    auto hits = index.Rank("api", 10);
+    std::vector<std::string> ids;
+    for (const auto& hit : hits) {
+        ids.push_back(hit.profile->id);
+    }
+    // 精确 > 前缀 > 名称中词首子串 > 其他字段 > 子序列
+    EXPECT_EQ(ids, (std::vector<std::string>{"4", "2", "1", "3", "5"}));
+
+    EXPECT_EQ(index.Rank("api", 2).size(), 2u);
+}
+
+TEST(ProfileSearchIndexTests, NarrowingQueryReusesPreviousMatches) {
+    const auto profiles = SampleProfiles();
+    ProfileSearchIndex index;
+    index.Build(profiles);
+
+    index.Rank("a", 10);
+    auto hits = index.Rank("ap", 10);
+    auto fresh = ProfileSearchIndex();
+    fresh.Build(profiles);
+    auto expected = fresh.Rank("ap", 10);
+
+    ASSERT_EQ(hits.size(), expected.size());
+    for (size_t i = 0; i < hits.size(); ++i) {
+        EXPECT_EQ(hits[i].profile, expected[i].profile);
+    }
+
+    // 改写而不是追加时从头扫描
+    EXPECT_EQ(index.Rank("staging", 10).size(), 1u);
+}
+
+TEST(ProfileSearchIndexTests, RanksHundredThousandProfilesWithinBudget) {
+    std::vector<Profile> profiles(100000);
+    for (size_t i = 0; i < profiles.size(); ++i) {
+        profiles[i].id = std::to_string(i);
+        profiles[i].name = "service-" + std::to_string(i) + "-worker";
+        profiles[i].description = "cluster node " + std::to_string(i % 97);
+        profiles[i].linuxWorkingDirectory = "/srv/apps/service" + std::to_string(i);
+    }
+    ProfileSearchIndex index;
+    index.Build(profiles);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string query : {"s", "sw", "swk", "service-4", "service-42", "service-4242"}) {
+        index.Rank(query, 50);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    EXPECT_EQ(index.Rank("service-42421-worker", 50).front().profile->id, "42421");
+    // 六次按键合计，远低于单次 50ms 的预算（调试构建也留有余量）
+    EXPECT_LT(elapsed.count(), 300);
+}
+
+#endif